@@ -0,0 +1,139 @@
+#!/bin/sh
+# Regressão dos modos determinísticos de war.c
+#
+# Compila war.c e roda cada modo com semente fixa em várias contagens de
+# threads. As linhas de resultado (filtradas e ordenadas) precisam ser
+# idênticas entre as execuções e, quando houver, bater com a assinatura
+# esperada.
+#
+# Uso: sh testes/regressao.sh [compilador]
+
+set -eu
+
+RAIZ=$(cd "$(dirname "$0")/.." && pwd)
+CC=${1:-${CC:-gcc}}
+TEMP=$(mktemp -d)
+WAR="$TEMP/war"
+THREADS="1 2 4"
+FALHAS=0
+
+trap 'rm -rf "$TEMP"' EXIT
+
+echo "🔧 Compilando war.c com $CC"
+"$CC" -Wall -Wextra -O2 -pthread -o "$WAR" "$RAIZ/war.c" -lm
+
+# verificar NOME FILTRO ESPERADO ARGUMENTOS...
+#   FILTRO: expressão do grep -E que seleciona as linhas de resultado
+#   ESPERADO: trecho que precisa aparecer na saída ("-" para nenhum)
+verificar() {
+    nome=$1
+    filtro=$2
+    esperado=$3
+    shift 3
+    referencia=""
+    for t in $THREADS; do
+        saida="$TEMP/saida.$t"
+        if ! "$WAR" "$@" --threads "$t" > "$saida" 2>&1; then
+            echo "❌ $nome: falhou com --threads $t"
+            FALHAS=$((FALHAS + 1))
+            return
+        fi
+        linhas=$(grep -E "$filtro" "$saida" | sort || true)
+        if [ -z "$linhas" ]; then
+            echo "❌ $nome: nenhuma linha de resultado com --threads $t"
+            FALHAS=$((FALHAS + 1))
+            return
+        fi
+        if [ "$esperado" != "-" ] && ! grep -qF -- "$esperado" "$saida"; then
+            echo "❌ $nome: '$esperado' ausente com --threads $t"
+            FALHAS=$((FALHAS + 1))
+            return
+        fi
+        if [ -z "$referencia" ]; then
+            referencia=$linhas
+        elif [ "$linhas" != "$referencia" ]; then
+            echo "❌ $nome: resultado com --threads $t difere de --threads 1"
+            FALHAS=$((FALHAS + 1))
+            return
+        fi
+    done
+    echo "✅ $nome"
+}
+
+verificar "sprt" '^ +[0-9]+ \|' - \
+    --sprt 6 --jogos 2000 --semente 3
+verificar "comparar" '±' - \
+    --comparar 3 --jogos 4000 --semente 5
+
+verificar "autojogo estrategista" 'Assinatura' - \
+    --autojogo "$TEMP/autojogo" --politica estrategista --jogos 200 --semente 4
+verificar "autojogo expectimax" 'Assinatura' - \
+    --autojogo "$TEMP/autojogo" --politica expectimax:2000:4 --jogos 40 --semente 4
+
+verificar "motor" 'Turnos:' - \
+    --motor heuristico --jogos 2000 --semente 7
+verificar "fibras" 'Turnos:' - \
+    --fibras estrategista --jogos 300 --semente 11
+verificar "simultaneo" 'Assinatura' abe2a4828f505a1f \
+    --simultaneo estrategista --jogos 2000 --semente 5 --jogadores 5 --territorios 20
+verificar "mapa massivo" 'Assinatura|Territórios por jogador' 1bc81f0f479d1ee2 \
+    --mapa-massivo 2000000 --turnos 40 --semente 9
+
+# Ajuste direto e ajuste interrompido e retomado com outras threads
+AJUSTE="--politica expectimax:500:3 --jogos 40 --semente 3"
+"$WAR" --ajuste "$TEMP/ajuste.direto" --geracoes 4 --threads 1 $AJUSTE > "$TEMP/ajuste.1"
+"$WAR" --ajuste "$TEMP/ajuste.retomado" --geracoes 2 --threads 2 $AJUSTE > /dev/null
+"$WAR" --ajuste "$TEMP/ajuste.retomado" --geracoes 4 --threads 4 $AJUSTE > "$TEMP/ajuste.2"
+if [ "$(grep 'Pesos após' "$TEMP/ajuste.1" | cut -d'(' -f1)" = \
+     "$(grep 'Pesos após' "$TEMP/ajuste.2" | cut -d'(' -f1)" ] && grep -q 'Pesos após 4' "$TEMP/ajuste.1"; then
+    echo "✅ ajuste retomado"
+else
+    echo "❌ ajuste retomado: pesos diferem do ajuste direto"
+    FALHAS=$((FALHAS + 1))
+fi
+
+# A tabela gravada precisa ser a mesma byte a byte para qualquer --threads
+antes=$FALHAS
+for t in $THREADS; do
+    "$WAR" --resolver "$TEMP/tabela.$t" --threads "$t" > /dev/null
+    if ! cmp -s "$TEMP/tabela.1" "$TEMP/tabela.$t"; then
+        echo "❌ resolver: tabela com --threads $t difere de --threads 1"
+        FALHAS=$((FALHAS + 1))
+    fi
+done
+[ "$FALHAS" -eq "$antes" ] && echo "✅ resolver"
+
+# Servidor: a mesma carga precisa dar o mesmo placar nos dois backends, e
+# o servidor precisa encerrar normalmente com SIGINT
+antes=$FALHAS
+referencia=""
+for backend in epoll io_uring; do
+    rm -f "$TEMP/servidor.sock"
+    "$WAR" --servidor "$TEMP/servidor.sock" --backend "$backend" --threads 2 > "$TEMP/servidor.$backend" 2>&1 &
+    pid=$!
+    for _ in 1 2 3 4 5 6 7 8 9 10; do
+        [ -S "$TEMP/servidor.sock" ] && break
+        sleep 0.2
+    done
+    placar=$("$WAR" --carga "$TEMP/servidor.sock" --conexoes 50 --jogos 500 --semente 3 --threads 2 | grep '🏆' || true)
+    kill -INT "$pid"
+    if ! wait "$pid"; then
+        echo "❌ servidor: backend $backend não encerrou normalmente"
+        FALHAS=$((FALHAS + 1))
+    elif [ -z "$placar" ]; then
+        echo "❌ servidor: carga sem placar no backend $backend"
+        FALHAS=$((FALHAS + 1))
+    elif [ -z "$referencia" ]; then
+        referencia=$placar
+    elif [ "$placar" != "$referencia" ]; then
+        echo "❌ servidor: placar do backend $backend difere do epoll"
+        FALHAS=$((FALHAS + 1))
+    fi
+done
+[ "$FALHAS" -eq "$antes" ] && echo "✅ servidor"
+
+if [ "$FALHAS" -ne 0 ]; then
+    echo "💥 $FALHAS verificação(ões) falharam"
+    exit 1
+fi
+echo "🏆 Todas as verificações passaram"
@@ -14,6 +14,34 @@
  *   - Transferência de territórios entre exércitos
  *   - Atualização automática de tropas após batalhas
  *   - Gerenciamento adequado de memória
+ *   - Estimativa de vitória em segundo plano enquanto o jogador decide
+ *   - Comparação de variantes de regras com redução de variância
+ *   - Varredura paralela de parâmetros de balanceamento
+ *   - Comparações com parada antecipada por teste sequencial (SPRT)
+ *   - Resolução exata de mapas pequenos em tabela final mapeada em memória
+ *   - Jogadores humanos ou bots através de controladores intercambiáveis
+ *   - Hash Zobrist do estado compacto atualizado a cada batalha
+ *   - Bot MCTS com busca paralela na mesma árvore (perda virtual)
+ *   - Tabela de transposição sem travas compartilhada entre threads
+ *   - Bot expectimax reprodutível com poda Star1/Star2 sobre os dados
+ *   - Autojogo paralelo gravando amostras de treino em arquivos binários
+ *   - Avaliador neural quantizado (AVX2) com atualização incremental
+ *   - Fila de avaliação em lote entre muitas partidas simultâneas
+ *   - Bots com prazo por jogada (orçamento por fase) e medição de latência
+ *   - Ajuste dos pesos do bot heurístico por SPSA com checkpoint
+ *   - Torneio entre bots com ratings Glicko-2 atualizados ao vivo
+ *   - Motor reentrante: todo o estado da partida num contexto explícito
+ *   - Pool com roubo de tarefas e fork/join aninhado para as simulações
+ *   - Milhares de partidas interativas em fibras sobre poucas threads
+ *   - Servidor de partidas em socket Unix (epoll) e gerador de carga
+ *   - Backend io_uring do servidor com buffers registrados e diário assíncrono
+ *   - Rodadas com ordens simultâneas resolvidas em ondas paralelas determinísticas
+ *   - Lotes de ataques com verificação vetorizada e ondas sem conflito
+ *   - Mapas massivos divididos em shards por thread com troca de halo
+ *   - Trabalhadores fixados em núcleos com memória no próprio nó NUMA
+ * 
+ * Compilação:
+ *   gcc -O2 -pthread war.c -o war -lm
  * 
  * Conceitos Aplicados:
  *   - Alocação dinâmica (malloc/calloc)
@@ -25,12 +53,39 @@
  * ============================================================================
  */
 
+#define _GNU_SOURCE  // Para nanosleep, clock_gettime e páginas grandes (MAP_HUGETLB)
+
 #include <stdio.h>      // Para funções de entrada/saída
 #include <stdlib.h>     // Para alocação dinâmica e números aleatórios
 #include <string.h>     // Para manipulação de strings
 #include <time.h>       // Para semente de números aleatórios
 #include <ctype.h>      // Para conversão de caracteres
+#include <stdarg.h>     // Para a saída de eventos do motor (estilo printf)
+#include <math.h>       // Para intervalos de confiança (sqrt)
 #include <stdbool.h>    // Para usar tipo bool, true e false
+#include <stdint.h>     // Para inteiros de tamanho fixo
+#include <stdatomic.h>  // Para comunicação sem bloqueio entre threads
+#include <pthread.h>    // Para a análise em segundo plano
+#include <unistd.h>     // Para consultar o número de núcleos
+#include <sched.h>      // Para ceder o processador entre tarefas
+#include <fcntl.h>      // Para abrir a tabela final
+#include <sys/mman.h>   // Para mapear a tabela final em memória
+#include <sys/stat.h>   // Para obter o tamanho da tabela final e criar diretórios
+#include <errno.h>      // Para distinguir diretório já existente
+#include <ucontext.h>   // Para as fibras das partidas interativas
+#include <signal.h>     // Para encerrar o servidor com SIGINT/SIGTERM
+#include <sys/socket.h> // Para o servidor de partidas
+#include <sys/un.h>     // Para sockets de domínio Unix
+#include <sys/epoll.h>  // Para o laço de eventos do servidor
+#include <sys/eventfd.h>   // Para os trabalhadores acordarem o laço de eventos
+#include <sys/signalfd.h>  // Para receber sinais pelo laço de eventos
+#include <sys/syscall.h>   // Para chamar o io_uring sem liburing
+#include <sys/uio.h>       // Para registrar os buffers fixos do io_uring
+#include <linux/io_uring.h>   // Estruturas e constantes do io_uring
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>  // Para o avaliador neural com AVX2
+#define NN_SUPORTE_AVX2 1
+#endif
 
 // ============================================================================
 // DEFINIÇÃO DA ESTRUTURA
@@ -61,6 +116,7 @@ typedef struct {
  * - missao: ponteiro para string da missão (alocada dinamicamente)
  * - ativo: flag indicando se o jogador ainda está no jogo
  * - territoriosControlados: contador de territórios sob controle
+ * - controlador: quem decide os ataques do jogador (humano ou bot)
  */
 typedef struct {
     char nome[30];           // Nome do jogador
@@ -68,6 +124,7 @@ typedef struct {
     char *missao;           // Missão alocada dinamicamente
     bool ativo;             // Status do jogador (ativo/eliminado)
     int territoriosControlados; // Número de territórios controlados
+    struct ControladorJogador *controlador; // Controlador alocado dinamicamente
 } Jogador;
 
 // ============================================================================
@@ -88,13 +145,812 @@ typedef struct {
 // Macros utilitárias
 #define LIMPAR_BUFFER while(getchar() != '\n')  // Limpar buffer de entrada
 
+// Constantes da simulação (partidas rápidas sem entrada/saída)
+#define MAX_ATAQUES (MAX_TERRITORIOS * MAX_TERRITORIOS)  // Pares atacante/defensor possíveis
+#define MAX_THREADS 256         // Threads de trabalho aceitas por qualquer modo (--threads)
+#define ROLLOUT_MAX_TURNOS 200  // Limite de turnos de uma partida simulada
+#define ANALISE_MAX_ROLLOUTS 20000  // Simulações por estado antes de pausar
+#define ANALISE_PAUSA_NS 10000000L  // Espera do analisador ocioso (10 ms)
+#define SIM_JOGOS_PADRAO 20000  // Partidas por comparação em linha de comando
+#define SIM_JOGADORES_PADRAO 3  // Jogadores nas partidas simuladas
+#define SIM_TERRITORIOS_PADRAO 12  // Territórios nas partidas simuladas
+#define VARREDURA_BLOCO 256     // Partidas por tarefa de um trabalhador
+#define COMPARACAO_BLOCO 128    // Replicações por tarefa da comparação de variantes
+#define VARREDURA_MAX_CONJUNTOS 1024  // Conjuntos de regras por varredura
+#define POOL_CAPACIDADE_DEQUE 1024  // Tarefas pendentes por trabalhador (potência de 2)
+#define POOL_PAUSA_NS 200000L   // Espera de um trabalhador sem raiz ativa (0,2 ms)
+#define NUMA_PAGINA 4096        // Alinhamento de memória por trabalhador (uma página)
+#define NUMA_MAX_NOS 64         // Nós NUMA consultados em /sys/devices/system/node
+#define NUMA_MAX_CPUS 1024      // CPUs representáveis no mapa de CPU para nó
+#define NUMA_PAGINAS_CONSULTA 512  // Páginas por chamada a move_pages na bancada NUMA
+#define FIBRA_PILHA (32 * 1024) // Pilha fixa de cada partida hospedada em fibra
+#define FIBRA_SENTINELA 0xDEADC0DEF1B4A5EDULL  // Marca no fim da pilha (estouro)
+#define FIBRA_PENSAR_PADRAO_MS 20  // Espera máxima simulada por decisão de jogador
+#define PROTO_MAX_QUADRO 128    // Bytes de tipo + carga de um quadro do protocolo
+#define PROTO_NOVA_PARTIDA 1    // Tipos de quadro (ver protocolo do servidor)
+#define PROTO_ATAQUE 2
+#define PROTO_ESTADO 3
+#define PROTO_FIM 4
+#define PROTO_ERRO 5
+#define PROTO_SEM_ATAQUE 0xFF   // Atacante de um ATAQUE que apenas passa a vez
+#define SERVIDOR_BUFFER 512     // Bytes de entrada por conexão
+#define SERVIDOR_SAIDA (PROTO_MAX_QUADRO + 2) // Uma resposta (cabeçalho + tipo + carga) por conexão
+#define SERVIDOR_EVENTOS 256    // Eventos tratados por chamada a epoll_wait
+#define SERVIDOR_FILA_ESCUTA 4096  // Conexões aguardando accept
+#define CARGA_CONEXOES_PADRAO 256  // Conexões simultâneas do gerador de carga
+#define SERVIDOR_MAX_CONEXOES 4096 // Vagas de conexão (buffer fixo do io_uring)
+#define URING_ENTRADAS 4096        // Tamanho da fila de submissão do io_uring
+#define URING_TENTATIVAS 16        // Submissões sem progresso antes de desistir da fila cheia
+#define SERVIDOR_PAUSA_ACEITE_MS 10 // Pausa do accept sem descritores ou memória
+#define DIARIO_REGISTROS 4096      // Registros por buffer do diário do servidor
+#define URING_LEITURA 1            // Operação no user_data (3 bits baixos)
+#define URING_ESCRITA 2
+#define URING_ACEITAR 3
+#define URING_AVISO 4
+#define URING_SINAL 5
+#define URING_DIARIO 6
+#define URING_PAUSA 7              // Fim da pausa do accept (IORING_OP_TIMEOUT)
+#define URING_MASCARA 7
+#define ORDENS_POR_JOGADOR 3    // Ordens de cada jogador por rodada simultânea
+#define ORDENS_BLOCO 4          // Ordens de uma onda resolvidas por tarefa
+#define SIMULTANEO_BLOCO 16     // Partidas simultâneas por tarefa de um trabalhador
+#define LOTE_MAX_ORDENS 256     // Ordens por lote de ataques
+#define LOTE_JOGADORES 8        // Entradas da tabela de territórios por jogador (>= MAX_JOGADORES)
+#define LOTE_BITS_CODIGO 2      // Bits do código de batalha no resultado de uma ordem
+#define LOTE_MASCARA_CODIGO 3
+#define LOTE_INVALIDA 3         // Código de ordem recusada ou que perdeu a validade
+#define LOTE_ONDA(resultado) ((resultado) >> LOTE_BITS_CODIGO)  // Onda em que a ordem foi resolvida
+#define MASSIVO_LARGURA 4096    // Colunas da grade do mapa massivo
+#define MASSIVO_BLOCO_DONO 64   // Lado dos blocos de mesmo dono na distribuição inicial
+#define MASSIVO_TURNOS_PADRAO 100  // Turnos simulados no mapa massivo
+#define MASSIVO_REFORCO 4       // Turnos entre reforços de 1 tropa por território
+#define MASSIVO_MAX_TROPAS 1000 // Teto de tropas de um território do mapa massivo
+#define SPRT_LOTE 64            // Pares de partidas por atualização do teste
+#define SPRT_ALFA 0.05          // Erro tipo I do teste sequencial
+#define SPRT_BETA 0.05          // Erro tipo II do teste sequencial
+#define SPRT_DELTA 0.05         // Vantagem mínima relevante nos pares discordantes
+#define SOLVER_MAX_TERRITORIOS 6  // Maior mapa com espaço de estados enumerável
+#define SOLVER_MAX_TROPAS 8     // Maior contagem de tropas representável na tabela
+#define SOLVER_TOLERANCIA 1e-7  // Variação máxima para considerar convergido
+#define SOLVER_MAX_ITERACOES 100000  // Limite de varreduras da iteração de valor
+#define TABELA_ASSINATURA "WARTB01"  // Identificação do arquivo de tabela final
+#define ZOBRIST_MAX_TROPAS 128  // Contagens de tropas com chave tabelada
+#define TT_ENTRADAS_BALDE 4     // Entradas de 16 bytes por linha de cache
+#define TT_LINHA_CACHE 64       // Tamanho da linha de cache (bytes)
+#define TT_PAGINA_GRANDE (2u << 20)  // Página grande do Linux (2 MB)
+#define TT_MEMORIA_PADRAO_MB 8  // Memória da tabela de transposição por bot
+#define TT_SEM_TERRITORIO 31    // Campo de ataque vazio na entrada
+#define TT_EXATO 0              // Valor exato
+#define TT_LIMITE_INFERIOR 1    // Valor é no mínimo o armazenado
+#define TT_LIMITE_SUPERIOR 2    // Valor é no máximo o armazenado
+#define EXPECTIMAX_NOS_PADRAO 200000  // Orçamento de nós por jogada
+#define EXPECTIMAX_MAX_PROFUNDIDADE 32  // Limite do aprofundamento iterativo
+#define AUTOJOGO_ASSINATURA "WARSP01"  // Identificação dos arquivos de amostras
+#define AUTOJOGO_SHARD_PADRAO_MB 64  // Tamanho máximo de cada arquivo de amostras
+#define AUTOJOGO_BUFFER 4096    // Registros acumulados por thread antes de gravar
+#define AUTOJOGO_SEM_VENCEDOR 255  // Partida encerrada pelo limite de turnos
+#define NN_FAIXAS_TROPAS 8      // Faixas de tropas nas características da rede
+#define NN_BASE_MISSAO (MAX_TERRITORIOS * MAX_JOGADORES * NN_FAIXAS_TROPAS)
+#define NN_CARACTERISTICA_VEZ (NN_BASE_MISSAO + TOTAL_MISSOES)
+#define NN_ENTRADAS (NN_CARACTERISTICA_VEZ + 1)  // Características esparsas
+#define NN_MAX_ATIVAS (MAX_TERRITORIOS + 2)  // Características ativas por posição
+#define NN_OCULTA1 64           // Acumulador (int16)
+#define NN_OCULTA2 32           // Segunda camada (int8)
+#define NN_ESCALA_ATIVACAO 127  // 1.0 nas ativações quantizadas
+#define NN_DESLOCAMENTO_PESOS 6 // Pesos int8 em 1/64
+#define NN_ASSINATURA "WARNN01" // Identificação do arquivo de pesos
+#define REDE_SEMENTE_PADRAO 2024  // Pesos sorteados quando nenhum arquivo é dado
+#define LOTE_TAMANHO 64         // Posições avaliadas juntas pela fila da rede
+#define LOTE_PARTIDAS_PADRAO 256  // Partidas simultâneas alimentando a fila
+#define RATING_INICIAL 1500.0   // Rating Glicko-2 de um bot novo
+#define RATING_RD_INICIAL 350.0 // Desvio inicial do rating
+#define RATING_VOLATILIDADE_INICIAL 0.06
+#define RATING_TAU 0.5          // Restrição da variação da volatilidade
+#define RATING_ESCALA 173.7178  // Conversão entre a escala Glicko e a Glicko-2
+#define RATING_PERIODO 64       // Partidas de um bot por período de avaliação
+#define RATING_FILA 4096        // Resultados pendentes (potência de 2)
+#define TORNEIO_MAX_BOTS 16     // Bots por torneio
+#define TORNEIO_PAINEL_MS 1000  // Intervalo entre atualizações do placar
+#define TORNEIO_BLOCO 8         // Partidas por tarefa do torneio
+#define HEURISTICA_NUM_PESOS 4  // Características da avaliação heurística
+#define AJUSTE_ASSINATURA "WARSPSA1" // Identificação do arquivo de checkpoint
+#define AJUSTE_GERACOES_PADRAO 50  // Gerações do ajuste de pesos
+#define AJUSTE_PASSO 0.5        // Passo inicial do SPSA (a)
+#define AJUSTE_ESTABILIDADE 10  // Atraso do decaimento do passo (A)
+#define AJUSTE_PERTURBACAO 0.1  // Perturbação inicial dos pesos (c)
+#define AJUSTE_ALFA 0.602       // Decaimento do passo
+#define AJUSTE_GAMA 0.101       // Decaimento da perturbação
+#define TEMPO_MARGEM 0.8        // Fração do prazo usada pela busca (resto: folga para parar)
+#define TEMPO_FATOR_ABERTURA 0.5  // Orçamento relativo nas fases da partida
+#define TEMPO_FATOR_MEIO 1.0
+#define TEMPO_FATOR_FINAL 0.75
+#define TEMPO_VERIFICACAO_NOS 256  // Nós do expectimax entre consultas ao relógio
+#define LATENCIA_SUBFAIXAS 64   // Subdivisões de cada potência de 2 (precisão ~1,6%)
+#define LATENCIA_FAIXAS 40      // Potências de 2 cobertas, em nanossegundos
+#define MCTS_MAX_THREADS 64     // Threads de busca por decisão
+#define MCTS_MAX_NOS (1 << 17)  // Nós de decisão reservados por bot MCTS
+#define MCTS_MAX_ARESTAS (1 << 20)  // Ataques (arestas) reservados por bot MCTS
+#define MCTS_TEMPO_PADRAO_MS 100  // Orçamento de tempo por jogada
+#define MCTS_PERDA_VIRTUAL 3    // Visitas fictícias que desviam outras threads
+#define MCTS_EXPLORACAO 0.7     // Constante de exploração do UCT
+#define MCTS_ESCALA 1000        // Recompensas em milésimos (inteiros atômicos)
+
+// Decisões do teste sequencial
+#define SPRT_PENDENTE 0
+#define SPRT_A_MELHOR 1
+#define SPRT_B_MELHOR 2
+#define SPRT_INCONCLUSIVO 3
+
+// Resultados possíveis de uma batalha
+#define BATALHA_INVALIDA -1
+#define BATALHA_EMPATE 0
+#define BATALHA_CONQUISTA 1
+#define BATALHA_DEFESA 2
+
+/*
+ * Enum: TipoMissao
+ *
+ * Índices das missões na mesma ordem de inicializarMissoes, usados pela
+ * simulação para verificar objetivos sem comparar strings.
+ */
+typedef enum {
+    MISSAO_CONQUISTADOR = 0,
+    MISSAO_DOMINACAO,
+    MISSAO_ESTRATEGISTA,
+    MISSAO_EXPANSIONISTA,
+    MISSAO_GENERAL,
+    MISSAO_LIBERTADOR,
+    MISSAO_FORTALEZA,
+    MISSAO_IMPERADOR,
+    MISSAO_DESCONHECIDA = -1
+} TipoMissao;
+
+// ============================================================================
+// ESTRUTURAS DE SIMULAÇÃO
+// ============================================================================
+
+/*
+ * Struct: GeradorAleatorio
+ *
+ * Gerador xorshift64* com estado próprio. Ao contrário de rand(), cada
+ * thread pode ter o seu sem interferir nas demais.
+ * - antitetico: espelha os dados (d → DADO_MIN + DADO_MAX - d), gerando
+ *   a sequência antitética da mesma semente
+ */
+typedef struct {
+    uint64_t estado;
+    bool antitetico;
+} GeradorAleatorio;
+
+/*
+ * Struct: Regras
+ *
+ * Constantes de balanceamento do jogo:
+ * - tropasIniciaisMin/Max: tropas sorteadas por território na distribuição
+ * - divisorTransferencia: conquistador move tropas / divisor ao território
+ * - penalidadeDerrota: tropas perdidas pelo atacante derrotado
+ * - conquistadorTerritorios: territórios exigidos pela missão CONQUISTADOR
+ * - estrategistaTerritorios/Tropas: territórios com mais de N tropas (ESTRATEGISTA)
+ * - expansionistaTerritorios: territórios exigidos pela missão EXPANSIONISTA
+ * - generalTropas: total de tropas a superar na missão GENERAL SUPREMO
+ */
+typedef struct {
+    int tropasIniciaisMin;
+    int tropasIniciaisMax;
+    int divisorTransferencia;
+    int penalidadeDerrota;
+    int conquistadorTerritorios;
+    int estrategistaTerritorios;
+    int estrategistaTropas;
+    int expansionistaTerritorios;
+    int generalTropas;
+} Regras;
+
+/*
+ * Struct: TesteSequencial
+ *
+ * Teste sequencial da razão de probabilidades (SPRT) sobre pares
+ * discordantes: em cada par de partidas com a mesma semente, conta-se
+ * apenas quando exatamente uma variante produz o evento medido.
+ * - p0/p1: chance de o evento favorecer A sob "B melhor" e "A melhor"
+ * - llr: logaritmo acumulado da razão de verossimilhança
+ * - limiteInferior/limiteSuperior: fronteiras de Wald para decidir
+ */
+typedef struct {
+    double p0;
+    double p1;
+    double llr;
+    double limiteInferior;
+    double limiteSuperior;
+    long favoraveisA;
+    long favoraveisB;
+    long pares;
+    int decisao;
+} TesteSequencial;
+
+/*
+ * Struct: CabecalhoTabela
+ *
+ * Cabeçalho do arquivo de tabela final (tablebase), seguido de um float
+ * por estado com a chance de vitória do jogador 1 em jogo ótimo.
+ * Vale para partidas de 2 jogadores com as missões e regras registradas.
+ */
+typedef struct {
+    char assinatura[8];
+    int32_t numTerritorios;
+    int32_t maxTropas;
+    int32_t missao[2];
+    Regras regras;
+    int64_t numEstados;
+    int32_t iteracoes;
+    float residuo;
+} CabecalhoTabela;
+
+/*
+ * Struct: TabelaFinal
+ *
+ * Tabela final mapeada em memória para consultas O(1).
+ */
+typedef struct {
+    void* mapeamento;
+    size_t tamanho;
+    const CabecalhoTabela* cabecalho;
+    const float* valores;
+} TabelaFinal;
+
+/*
+ * Struct: ResultadoVarredura
+ *
+ * Métricas agregadas de um conjunto de regras durante a varredura.
+ * Os contadores são atômicos porque vários trabalhadores jogam blocos
+ * de partidas do mesmo conjunto ao mesmo tempo.
+ */
+typedef struct {
+    Regras regras;
+    atomic_long vitorias[MAX_JOGADORES];
+    atomic_long empates;
+    atomic_long somaTurnos;
+    atomic_long somaTurnosQuadrado;
+} ResultadoVarredura;
+
+/*
+ * Struct: OpcoesSimulacao
+ *
+ * Parâmetros dos modos de simulação em linha de comando.
+ */
+typedef struct {
+    long numJogos;
+    int numJogadores;
+    int numTerritorios;
+    uint64_t semente;
+    bool numaIngenuo;           // Sem fixar núcleos (linha de base da bancada NUMA)
+} OpcoesSimulacao;
+
+/*
+ * Struct: MedicaoNuma
+ *
+ * Resultado de uma execução para a bancada NUMA: tempo e páginas da
+ * memória dos trabalhadores que ficaram fora do nó de quem as usa.
+ * - paginasRemotas: -1 se o kernel não informa o nó das páginas
+ */
+typedef struct {
+    double segundos;
+    long paginas;
+    long paginasRemotas;
+} MedicaoNuma;
+
+/*
+ * Struct: EstatisticaAmostral
+ *
+ * Média e variância acumuladas incrementalmente (algoritmo de Welford).
+ */
+typedef struct {
+    long n;
+    double media;
+    double m2;
+} EstatisticaAmostral;
+
+/*
+ * Struct: EstadoSimulacao
+ *
+ * Cópia compacta do jogo usada pelas simulações:
+ * - dono: índice do jogador que controla cada território
+ * - tropas: tropas de cada território
+ * - missao: tipo de missão de cada jogador
+ * - ativo: jogadores que ainda possuem territórios
+ * - jogadorDaVez: jogador que realiza o próximo ataque
+ * - hash: assinatura Zobrist de todos os campos acima, mantida por XOR
+ *   a cada mudança (ver calcularHashEstado)
+ */
+typedef struct {
+    int numTerritorios;
+    int numJogadores;
+    int jogadorDaVez;
+    int8_t dono[MAX_TERRITORIOS];
+    int tropas[MAX_TERRITORIOS];
+    int8_t missao[MAX_JOGADORES];
+    bool ativo[MAX_JOGADORES];
+    uint64_t hash;
+} EstadoSimulacao;
+
+/*
+ * Struct: LoteAtaques
+ * 
+ * Ordens de ataque em estrutura de arrays, para que a verificação trate
+ * várias ordens por instrução (territórios em índices de 0 a 255).
+ * - identificador: somado à semente do lote, fixa os dados da ordem
+ */
+typedef struct {
+    int numOrdens;
+    uint8_t jogador[LOTE_MAX_ORDENS];
+    uint8_t atacante[LOTE_MAX_ORDENS];
+    uint8_t defensor[LOTE_MAX_ORDENS];
+    uint16_t identificador[LOTE_MAX_ORDENS];
+} LoteAtaques;
+
+/*
+ * Struct: RatingBot
+ *
+ * Rating Glicko-2 de um bot (escala Glicko: 1500 ± 350 no início),
+ * acumuladores do período de avaliação em curso e contagem de resultados.
+ */
+typedef struct {
+    double rating;
+    double desvio;
+    double volatilidade;
+    double desvioPeriodo;       // Desvio (escala Glicko-2) no início do período
+    double informacaoPeriodo;   // Soma de g² E (1 - E) no período
+    double surpresaPeriodo;     // Soma de g (s - E) no período
+    int partidasPeriodo;
+    long partidas;
+    long vitorias;
+    long empates;
+} RatingBot;
+
+/*
+ * Struct: PlacarRatings
+ *
+ * Fotografia dos ratings publicada pelo serviço a cada atualização.
+ */
+typedef struct {
+    long partidas;
+    int numBots;
+    RatingBot bots[TORNEIO_MAX_BOTS];
+} PlacarRatings;
+
+/*
+ * Struct: CelulaResultado
+ *
+ * Posição da fila de resultados: o número de sequência diz se a célula
+ * está livre para o produtor da volta atual ou pronta para o consumidor.
+ */
+typedef struct {
+    atomic_size_t sequencia;
+    int botA;
+    int botB;
+    double pontosA;             // 1 vitória de A, 0 vitória de B, 0,5 empate
+} CelulaResultado;
+
+/*
+ * Struct: ServicoRatings
+ *
+ * Thread que recebe resultados de partidas de muitas threads por uma
+ * fila circular sem bloqueio (vários produtores, um consumidor),
+ * atualiza os ratings a cada resultado e publica o placar por seqlock,
+ * como o analisador em segundo plano: quem lê nunca espera.
+ */
+typedef struct {
+    pthread_t thread;
+    atomic_bool encerrar;
+    _Alignas(64) atomic_size_t posicaoEscrita;
+    _Alignas(64) size_t posicaoLeitura;
+    CelulaResultado fila[RATING_FILA];
+    PlacarRatings atual;            // Só a thread do serviço acessa
+    atomic_uint seqPlacar;          // Ímpar enquanto o placar é escrito
+    PlacarRatings placar;
+} ServicoRatings;
+
+/*
+ * Struct: PesosHeuristica
+ *
+ * Pesos da avaliação heurística de posições, na ordem: fatia de
+ * territórios, fatia de tropas, progresso da própria missão e atraso
+ * da missão adversária mais adiantada. Só as proporções importam.
+ */
+typedef struct {
+    double peso[HEURISTICA_NUM_PESOS];
+} PesosHeuristica;
+
+/*
+ * Struct: GerenciadorTempo
+ *
+ * Orçamento de tempo das buscas:
+ * - prazoMs: limite rígido por jogada (0 = sem limite)
+ * - limite: instante (relógio monotônico) em que a jogada atual para
+ * - ativo: false quando a jogada não tem limite de tempo
+ */
+typedef struct {
+    long prazoMs;
+    struct timespec limite;
+    bool ativo;
+} GerenciadorTempo;
+
+/*
+ * Struct: HistogramaLatencia
+ *
+ * Histograma log-linear de latências em nanossegundos: cada potência
+ * de 2 é dividida em LATENCIA_SUBFAIXAS faixas, o que permite
+ * percentis altos (p99,9) sem guardar cada amostra.
+ */
+typedef struct {
+    long contagem[LATENCIA_FAIXAS * LATENCIA_SUBFAIXAS];
+    long total;
+    long maximoNs;
+} HistogramaLatencia;
+
+/*
+ * Struct: ControladorJogador
+ *
+ * Interface de quem decide os ataques de um jogador (tabela de funções):
+ * - nome: descrição exibida no jogo
+ * - decidirAtaque: recebe uma visão somente leitura do mapa (jogadorDaVez
+ *   é o próprio jogador) e devolve os índices 0-based do ataque; false
+ *   significa passar a vez. Bots não fazem entrada/saída.
+ * - liberar: libera o controlador e seus dados
+ * - dados: estado próprio da implementação
+ * - latencias: tempo de cada decisão (NULL = não medir)
+ */
+typedef struct ControladorJogador {
+    const char* nome;
+    bool (*decidirAtaque)(struct ControladorJogador* controlador, const EstadoSimulacao* visao,
+                          int* atacante, int* defensor);
+    void (*liberar)(struct ControladorJogador* controlador);
+    void* dados;
+    HistogramaLatencia* latencias;
+} ControladorJogador;
+
+/*
+ * Struct: SaidaEventos
+ *
+ * Para onde vão as mensagens do motor (batalhas, eliminações, ataques
+ * inválidos). Campos NULL descartam o evento, o que deixa partidas sem
+ * interface rodarem em qualquer thread sem tocar em stdout.
+ * - escrever: recebe a mensagem no formato de printf
+ * - limpar: limpa a tela
+ * - dados: contexto próprio da saída
+ */
+typedef struct {
+    void (*escrever)(void* dados, const char* formato, va_list argumentos);
+    void (*limpar)(void* dados);
+    void* dados;
+} SaidaEventos;
+
+/*
+ * Struct: EntradaJogo
+ *
+ * De onde vêm as respostas que o jogo pede fora dos controladores
+ * (pausas, índices da arena, confirmações). Campos NULL respondem
+ * sem esperar: pausas seguem direto, leituras falham e confirmações
+ * dizem não, o que encerra as interações das partidas sem interface.
+ * - pausar: espera o jogador continuar
+ * - lerNumero: lê um inteiro em [minimo, maximo]; minimo - 1 sem entrada
+ * - confirmar: pergunta s/N
+ * - dados: contexto próprio da entrada
+ */
+typedef struct {
+    void (*pausar)(void* dados);
+    int (*lerNumero)(void* dados, int minimo, int maximo);
+    bool (*confirmar)(void* dados);
+    void* dados;
+} EntradaJogo;
+
+/*
+ * Struct: ContextoJogo
+ *
+ * Todo o estado de uma partida do motor completo: mapa, jogadores,
+ * gerador dos dados e sorteios, regras, saída de eventos e entrada. As funções
+ * do motor recebem o contexto explicitamente e não usam estado global,
+ * então partidas em contextos diferentes podem correr em paralelo.
+ */
+typedef struct {
+    Territorio* mapa;
+    int numTerritorios;
+    Jogador* jogadores;
+    int numJogadores;
+    GeradorAleatorio gerador;
+    const Regras* regras;
+    SaidaEventos saida;
+    EntradaJogo entrada;
+} ContextoJogo;
+
+typedef struct TrabalhadorPool TrabalhadorPool;
+
+/*
+ * Struct: GrupoTarefas
+ *
+ * Conjunto de tarefas bifurcadas que um pai aguarda (fork/join).
+ * - pendentes: tarefas bifurcadas ainda não concluídas
+ */
+typedef struct {
+    atomic_long pendentes;
+} GrupoTarefas;
+
+/*
+ * Struct: TarefaPool
+ *
+ * Unidade de trabalho do pool. Pertence a quem a bifurca e deve
+ * continuar válida até o aguardarGrupo correspondente retornar.
+ * - executar: corpo da tarefa; recebe o trabalhador que a executa, por
+ *   onde pode bifurcar subtarefas (paralelismo aninhado)
+ * - argumento: dados próprios da tarefa
+ * - grupo: grupo avisado ao concluir
+ */
+typedef struct {
+    void (*executar)(TrabalhadorPool* trabalhador, void* argumento);
+    void* argumento;
+    GrupoTarefas* grupo;
+} TarefaPool;
+
+/*
+ * Struct: DequeTrabalho
+ *
+ * Deque de Chase-Lev de capacidade fixa: o dono empilha e desempilha
+ * na base sem disputa; ladrões retiram do topo com um CAS. Topo e base
+ * ficam em linhas de cache separadas.
+ */
+typedef struct {
+    _Alignas(64) atomic_long topo;
+    _Alignas(64) atomic_long base;
+    _Alignas(64) TarefaPool* _Atomic itens[POOL_CAPACIDADE_DEQUE];
+} DequeTrabalho;
+
+/*
+ * Struct: TrabalhadorPool
+ *
+ * Um trabalhador do pool com sua deque e seu gerador de vítimas de
+ * roubo. Os contadores só são escritos pelo próprio trabalhador. Cada
+ * trabalhador ocupa páginas próprias: com posicionamento local, ele as
+ * toca primeiro já fixado no seu núcleo, e elas ficam no seu nó NUMA.
+ * - local: estatísticas do trabalhador (tamanhoLocal bytes do pool)
+ * - pilha: pilha da thread, onde as tarefas guardam as partidas e as
+ *   cópias do mapa que jogam
+ * - no: nó NUMA em que o trabalhador executou sua última tarefa
+ */
+struct TrabalhadorPool {
+    _Alignas(NUMA_PAGINA) DequeTrabalho deque;
+    struct PoolTrabalho* pool;
+    int indice;
+    GeradorAleatorio gerador;
+    long executadas;
+    long roubadas;
+    void* local;
+    void* pilha;
+    size_t tamanhoPilha;
+    int no;
+};
+
+/*
+ * Struct: PoolTrabalho
+ *
+ * Pool com roubo de tarefas: o trabalhador 0 é a thread que chama
+ * executarRaizPool e os demais rodam em segundo plano, roubando de
+ * vítimas sorteadas. Não há fila nem trava central.
+ * - raizesAtivas: trabalhadores ociosos só giram enquanto é 1
+ * - ingenuo: sem fixar núcleos; a thread criadora prepara tudo (linha
+ *   de base da bancada NUMA)
+ * - proximoIndice: cada thread iniciada reserva o seu trabalhador
+ * - prontos: trabalhadores que já prepararam a própria memória
+ * - liberados: ninguém procura tarefas antes de todos estarem prontos
+ */
+typedef struct PoolTrabalho {
+    TrabalhadorPool* trabalhadores;     // Páginas mapeadas sem tocar
+    size_t tamanhoMapeado;
+    int numTrabalhadores;
+    int iniciados;
+    atomic_bool encerrar;
+    atomic_int raizesAtivas;
+    size_t tamanhoLocal;
+    void* locaisIngenuos;               // Estatísticas contíguas no modo ingênuo
+    bool ingenuo;
+    uint64_t semente;
+    pthread_t threads[MAX_THREADS];
+    atomic_int proximoIndice;
+    atomic_int prontos;
+    atomic_bool liberados;
+    bool fixouPrincipal;
+    cpu_set_t afinidadePrincipal;       // Restaurada ao liberar o pool
+} PoolTrabalho;
+
+/*
+ * Struct: NoMcts
+ *
+ * Nó de decisão da árvore de busca (jogador da vez escolhe um ataque).
+ * - expansao: 0 folha, 1 em expansão por alguma thread, 2 expandido
+ * - primeiraAresta/numArestas: bloco de arestas na arena da árvore
+ */
+typedef struct {
+    atomic_int expansao;
+    atomic_int visitas;
+    atomic_int jogador;         // Lido também por quem chega pela tabela de transposição
+    int primeiraAresta;
+    int numArestas;
+} NoMcts;
+
+/*
+ * Struct: ArestaMcts
+ *
+ * Um ataque possível (ou passar a vez, atacante = -1) seguido do nó de
+ * acaso dos dados: cada resultado da batalha leva a um nó filho próprio.
+ * Estatísticas atômicas, sem travas.
+ */
+typedef struct {
+    int8_t atacante;
+    int8_t defensor;
+    atomic_int visitas;
+    atomic_long recompensa;
+    atomic_int filhos[3];       // Índice do NoMcts por resultado (0 = ainda não criado)
+} ArestaMcts;
+
+/*
+ * Struct: EntradaTransposicao
+ *
+ * Entrada sem trava (esquema XOR): chave guarda hash ^ dados. Uma
+ * leitura só é aceita se chave ^ dados reproduzir o hash procurado, o
+ * que descarta entradas misturadas por escritas simultâneas.
+ * dados: valor (32 bits) | profundidade (8) | idade (8) | tipo (2) |
+ *        atacante (5) | defensor (5) | ocupada (1)
+ */
+typedef struct {
+    _Atomic uint64_t chave;
+    _Atomic uint64_t dados;
+} EntradaTransposicao;
+
+/*
+ * Struct: BaldeTransposicao
+ *
+ * Entradas que disputam a mesma posição, alinhadas a uma linha de cache.
+ */
+typedef struct {
+    _Alignas(TT_LINHA_CACHE) EntradaTransposicao entradas[TT_ENTRADAS_BALDE];
+} BaldeTransposicao;
+
+/*
+ * Struct: TabelaTransposicao
+ *
+ * Tabela de tamanho fixo indexada pelo hash Zobrist, compartilhada
+ * pelas threads de uma busca.
+ * - idade: geração da busca atual (entradas antigas são substituídas antes)
+ * - paginasGrandes: memória obtida com MAP_HUGETLB
+ */
+typedef struct {
+    BaldeTransposicao* baldes;
+    uint64_t mascara;
+    size_t bytes;
+    bool paginasGrandes;
+    atomic_uint idade;
+} TabelaTransposicao;
+
+/*
+ * Struct: RegistroTransposicao
+ *
+ * Conteúdo decodificado de uma entrada.
+ */
+typedef struct {
+    uint32_t valor;
+    int profundidade;
+    int idade;
+    int tipo;
+    int atacante;
+    int defensor;
+} RegistroTransposicao;
+
+/*
+ * Struct: RegistroAutojogo
+ *
+ * Uma posição gravada pelo autojogo (tamanho fixo, sem ponteiros):
+ * estado antes da decisão, ataque escolhido (política) e vencedor da
+ * partida (resultado). Tropas acima de 255 são gravadas como 255.
+ */
+typedef struct {
+    uint8_t numTerritorios;
+    uint8_t numJogadores;
+    uint8_t jogadorDaVez;
+    uint8_t vencedor;
+    int8_t dono[MAX_TERRITORIOS];
+    uint8_t tropas[MAX_TERRITORIOS];
+    int8_t missao[MAX_JOGADORES];
+    int8_t atacante;
+    int8_t defensor;
+    uint16_t turno;
+} RegistroAutojogo;
+
+/*
+ * Struct: CabecalhoShard
+ *
+ * Início de cada arquivo de amostras; os registros vêm logo depois e a
+ * quantidade sai do tamanho do arquivo.
+ */
+typedef struct {
+    char assinatura[8];
+    uint32_t tamanhoRegistro;
+    uint32_t thread;
+} CabecalhoShard;
+
+/*
+ * Struct: RedeAvaliacao
+ *
+ * Rede pequena quantizada no estilo NNUE: a primeira camada soma
+ * colunas de w1 das características ativas num acumulador int16; as
+ * demais camadas são densas com pesos int8 e ativações entre 0 e 127.
+ */
+typedef struct {
+    _Alignas(32) int16_t w1[NN_ENTRADAS][NN_OCULTA1];
+    _Alignas(32) int16_t b1[NN_OCULTA1];
+    _Alignas(32) int8_t w2[NN_OCULTA2][NN_OCULTA1];
+    _Alignas(32) int32_t b2[NN_OCULTA2];
+    _Alignas(32) int8_t w3[NN_OCULTA2];
+    int32_t b3;
+} RedeAvaliacao;
+
+/*
+ * Struct: AcumuladorRede
+ *
+ * Primeira camada da rede para uma posição, do ponto de vista de um
+ * jogador. Atualizado por diferença quando poucos territórios mudam.
+ */
+typedef struct {
+    _Alignas(32) int16_t valores[NN_OCULTA1];
+    int jogador;
+} AcumuladorRede;
+
+/*
+ * Struct: ResultadoAnalise
+ *
+ * Estimativas publicadas pelo analisador em segundo plano:
+ * - vitorias: partidas simuladas vencidas por cada jogador
+ * - rollouts: total de partidas simuladas (incluindo as de sugestão)
+ * - rolloutsEstado: partidas simuladas diretamente a partir do estado
+ * - melhorAtacante/melhorDefensor: ataque sugerido ao jogador da vez
+ * - chanceMelhorAtaque: chance de vitória estimada após o ataque sugerido
+ */
+typedef struct {
+    unsigned int geracao;
+    int rollouts;
+    int rolloutsEstado;
+    int vitorias[MAX_JOGADORES];
+    int melhorAtacante;
+    int melhorDefensor;
+    double chanceMelhorAtaque;
+} ResultadoAnalise;
+
+/*
+ * Struct: AnalisadorFundo
+ *
+ * Thread que simula partidas a partir do estado atual enquanto o jogo
+ * aguarda a entrada do usuário. A comunicação usa apenas contadores
+ * atômicos (seqlock), então a thread principal nunca espera o analisador.
+ */
+typedef struct {
+    pthread_t thread;
+    bool iniciado;
+    atomic_bool encerrar;
+    atomic_uint geracao;            // Incrementada a cada novo estado
+    atomic_uint seqEstado;          // Ímpar enquanto o estado é escrito
+    EstadoSimulacao estado;
+    atomic_uint seqResultado;       // Ímpar enquanto o resultado é escrito
+    ResultadoAnalise resultado;
+    int ataques[MAX_ATAQUES][2];    // Só a thread do analisador acessa
+    int vitoriasAtaque[MAX_ATAQUES];
+    int tentativasAtaque[MAX_ATAQUES];
+} AnalisadorFundo;
+
 // ============================================================================
 // PROTÓTIPOS DE FUNÇÕES
 // ============================================================================
 
 // Funções de inicialização e configuração
 void exibirCabecalho(void);
-void inicializarSistema(void);
+void inicializarSistema(ContextoJogo* contexto);
 int obterNumeroTerritorios(void);
 int obterNumeroJogadores(void);
 
@@ -105,33 +961,280 @@ void liberarMemoriaCompleta(Territorio* mapa, Jogador* jogadores, int numJogador
 
 // Funções de missões estratégicas
 void inicializarMissoes(char missoes[][MAX_MISSAO]);
-void atribuirMissao(char* destino, char missoes[][MAX_MISSAO], int totalMissoes);
-int verificarMissao(char* missao, Territorio* mapa, int tamanho, const char* corJogador);
+void preencherMissoes(char missoes[][MAX_MISSAO]);
+void atribuirMissao(ContextoJogo* contexto, char* destino, char missoes[][MAX_MISSAO], int totalMissoes);
+int verificarMissao(const Regras* regras, const char* missao, const Territorio* mapa, int tamanho,
+                    const char* corJogador);
+bool avaliarMissao(const Regras* regras, TipoMissao tipo, int territoriosControlados, int tropasTotais,
+                   int territoriosFortes, int numTerritorios);
 void exibirMissao(const char* missao, const char* nomeJogador);
 void exibirTodasMissoes(Jogador* jogadores, int numJogadores);
 
 // Funções de jogadores
-void cadastrarJogadores(Jogador* jogadores, int numJogadores, char missoes[][MAX_MISSAO]);
-void distribuirTerritorios(Territorio* mapa, int numTerritorios, Jogador* jogadores, int numJogadores);
-void atualizarEstatisticasJogadores(Jogador* jogadores, int numJogadores, Territorio* mapa, int numTerritorios);
-int verificarVencedor(Jogador* jogadores, int numJogadores, Territorio* mapa, int numTerritorios);
+void cadastrarJogadores(ContextoJogo* contexto, char missoes[][MAX_MISSAO]);
+void distribuirTerritorios(ContextoJogo* contexto);
+void atualizarEstatisticasJogadores(ContextoJogo* contexto);
+int verificarVencedor(const ContextoJogo* contexto);
 
 // Funções de cadastro e exibição de territórios
 void cadastrarTerritorio(Territorio *t, int numero);
-void exibirTerritorio(const Territorio *t, int numero);
-void exibirTodosTeritorios(const Territorio *territorios, int total);
+void exibirTerritorio(const ContextoJogo* contexto, const Territorio *t, int numero);
+void exibirTodosTeritorios(const ContextoJogo* contexto);
 void exibirMapaSimplificado(const Territorio *territorios, int total);
 
 // Funções de batalha e simulação
-bool atacar(Territorio* atacante, Territorio* defensor);
-int simularDado(void);
-void executarBatalhaMultiplayer(Territorio *mapa, int numTerritorios, Jogador* jogadores, int numJogadores);
-bool validarAtaque(const Territorio* atacante, const Territorio* defensor);
+bool atacar(ContextoJogo* contexto, Territorio* atacante, Territorio* defensor);
+int simularDado(ContextoJogo* contexto);
+void executarBatalhaMultiplayer(ContextoJogo* contexto, int jogadorDaVez, AnalisadorFundo* analisador);
+bool validarAtaque(ContextoJogo* contexto, const Jogador* jogador, const Territorio* atacante,
+                   const Territorio* defensor);
+
+// Funções do contexto de jogo (motor reentrante)
+void emitirEvento(const ContextoJogo* contexto, const char* formato, ...) __attribute__((format(printf, 2, 3)));
+void limparTelaContexto(const ContextoJogo* contexto);
+void pausarContexto(const ContextoJogo* contexto);
+int lerNumeroContexto(const ContextoJogo* contexto, int minimo, int maximo);
+bool confirmarContexto(const ContextoJogo* contexto);
+int contarJogadoresAtivos(const ContextoJogo* contexto);
+int jogarTurnoContexto(ContextoJogo* contexto, int* jogadorDaVez, AnalisadorFundo* analisador);
+bool criarContextoJogo(ContextoJogo* contexto, int numJogadores, int numTerritorios, uint64_t semente,
+                       const Regras* regras, SaidaEventos saida);
+void liberarContextoJogo(ContextoJogo* contexto);
+int jogarPartidaContexto(ContextoJogo* contexto, int maxTurnos, int* turnosJogados);
+void executarEscalaMotor(const char* politica, const OpcoesSimulacao* opcoes, int numThreads);
+
+// Funções do escalonador de fibras (partidas interativas M:N)
+void executarFibras(const char* politica, const OpcoesSimulacao* opcoes, long pensarMs, int numThreads);
+
+// Funções do modo de ordens simultâneas (resolução paralela determinística)
+void executarSimultaneo(const char* politica, const OpcoesSimulacao* opcoes, int numThreads, MedicaoNuma* medicao);
+
+// Funções do mapa massivo em shards (troca de halo entre threads)
+void executarMapaMassivo(long numTerritorios, int turnos, const OpcoesSimulacao* opcoes, int numThreads,
+                         MedicaoNuma* medicao);
+
+// Funções do servidor de partidas (socket Unix, protocolo binário)
+size_t montarQuadro(uint8_t* destino, int tipo, const uint8_t* carga, size_t tamanho);
+int extrairQuadro(uint8_t* buffer, size_t* usado, int* tipo, uint8_t* carga, size_t* tamanho);
+size_t codificarEstadoProtocolo(uint8_t* destino, const EstadoSimulacao* estado, int resultado);
+bool decodificarEstadoProtocolo(const uint8_t* carga, size_t tamanho, EstadoSimulacao* estado, int* resultado);
+int executarServidor(const char* caminho, int numThreads, const char* backend, const char* arquivoDiario);
+void executarCargaServidor(const char* caminho, const char* politica, const OpcoesSimulacao* opcoes,
+                           int conexoes, int numThreads);
+
+// Funções de simulação rápida
+void inicializarGerador(GeradorAleatorio* gerador, uint64_t semente);
+uint64_t proximoAleatorio(GeradorAleatorio* gerador);
+int sortearIntervalo(GeradorAleatorio* gerador, int limite);
+int rolarDado(GeradorAleatorio* gerador);
+TipoMissao identificarMissao(const char* missao);
+void gerarPartidaAleatoria(EstadoSimulacao* estado, const Regras* regras, int numJogadores,
+                           int numTerritorios, GeradorAleatorio* gerador);
+void montarEstadoSimulacao(EstadoSimulacao* estado, const Territorio* mapa, int numTerritorios,
+                           const Jogador* jogadores, int numJogadores, int jogadorDaVez);
+int listarAtaques(const EstadoSimulacao* estado, int jogador, int ataques[][2]);
+int rolarBatalha(GeradorAleatorio* gerador);
+int tropasAposBatalha(const Regras* regras, int resultado, int tropasAtacante, int* tropasDefensor);
+int resolverBatalhaEstado(EstadoSimulacao* estado, const Regras* regras, int atacante, int defensor,
+                          GeradorAleatorio* gerador);
+void aplicarResultadoBatalha(EstadoSimulacao* estado, const Regras* regras, int atacante, int defensor,
+                             int resultado);
+void calcularChancesBatalha(double chances[3]);
+int resolverLoteAtaques(EstadoSimulacao* estado, const Regras* regras, const LoteAtaques* lote, uint64_t semente,
+                        uint16_t* resultados);
+int agruparOndasLote(const LoteAtaques* lote, LoteAtaques* porOnda, uint16_t* origem, uint16_t* limites,
+                     uint16_t* resultados);
+void avaliarOrdensLote(const EstadoSimulacao* estado, const LoteAtaques* porOnda, int inicio, int fim,
+                       uint64_t semente, const uint16_t* origem, uint16_t* resultados);
+int aplicarOrdensLote(EstadoSimulacao* estado, const Regras* regras, const LoteAtaques* porOnda, int inicio,
+                      int fim, const uint16_t* origem, const uint16_t* resultados);
+bool verificarMissaoEstado(const EstadoSimulacao* estado, const Regras* regras, int jogador);
+int verificarVencedorEstado(EstadoSimulacao* estado, const Regras* regras);
+void avancarJogadorDaVez(EstadoSimulacao* estado);
+int simularPartidaAleatoria(EstadoSimulacao* estado, const Regras* regras, GeradorAleatorio* dados,
+                            GeradorAleatorio* politica, int maxTurnos, int* turnosJogados);
+
+// Funções de comparação de variantes (Monte Carlo com redução de variância)
+void acumularAmostra(EstatisticaAmostral* estatistica, double valor);
+double varianciaAmostral(const EstatisticaAmostral* estatistica);
+void compararVariantes(const Regras* regrasA, const Regras* regrasB, const OpcoesSimulacao* opcoes,
+                       int numThreads);
+
+// Funções do pool de trabalho com roubo de tarefas (fork/join)
+PoolTrabalho* criarPoolTrabalho(int numTrabalhadores, uint64_t semente, size_t tamanhoLocal, bool ingenuo);
+void executarRaizPool(PoolTrabalho* pool, void (*executar)(TrabalhadorPool*, void*), void* argumento);
+void bifurcarTarefa(TrabalhadorPool* trabalhador, GrupoTarefas* grupo, TarefaPool* tarefa);
+void aguardarGrupo(TrabalhadorPool* trabalhador, GrupoTarefas* grupo);
+void liberarPoolTrabalho(PoolTrabalho* pool);
+long contarPaginasRemotasPool(const PoolTrabalho* pool, long* paginas);
+
+// Funções de topologia NUMA e fixação de núcleos
+int contarNosNuma(void);
+int fixarThreadNucleo(int indice, int total, cpu_set_t* anterior);
+int noDaThreadAtual(void);
+long contarPaginasRemotas(const void* inicio, size_t tamanho, int no, long* paginas);
+void exibirPosicionamentoNuma(bool ingenuo, long paginas, long paginasRemotas);
+void executarBancadaNuma(long numTerritorios, int turnos, const OpcoesSimulacao* opcoes, int numThreads);
+
+// Funções de varredura de parâmetros
+int contarNucleos(void);
+int montarGradeRegras(Regras* conjuntos, int maxConjuntos);
+int sortearConjuntosRegras(Regras* conjuntos, int quantidade, GeradorAleatorio* gerador);
+void executarVarredura(const Regras* conjuntos, int numConjuntos, const OpcoesSimulacao* opcoes, int numThreads);
+
+// Funções de teste sequencial (parada antecipada de comparações)
+void inicializarTesteSequencial(TesteSequencial* teste, double delta, double alfa, double beta);
+int atualizarTesteSequencial(TesteSequencial* teste, long favoraveisA, long favoraveisB);
+void executarComparacoesSequenciais(const Regras* base, const Regras* variantes, int numVariantes,
+                                    const OpcoesSimulacao* opcoes, int numThreads);
+
+// Funções do resolvedor exato e da tabela final
+int64_t contarEstadosTabela(int numTerritorios, int maxTropas);
+int64_t indexarEstadoTabela(const CabecalhoTabela* cabecalho, const EstadoSimulacao* estado);
+bool resolverTabelaFinal(const char* caminho, int numTerritorios, const int missoes[2],
+                         const Regras* regras, int numThreads);
+bool abrirTabelaFinal(TabelaFinal* tabela, const char* caminho);
+float consultarTabelaFinal(const TabelaFinal* tabela, const EstadoSimulacao* estado);
+bool melhorAtaqueTabela(const TabelaFinal* tabela, const EstadoSimulacao* estado, int* atacante, int* defensor);
+void fecharTabelaFinal(TabelaFinal* tabela);
+void exibirConsultasTabela(const TabelaFinal* tabela, const OpcoesSimulacao* opcoes);
+
+// Funções de controladores de jogadores (humano, script e bots)
+ControladorJogador* criarControlador(const char* tipo, uint64_t semente);
+void conectarControladorHumano(ControladorJogador* controlador, AnalisadorFundo* analisador,
+                               const Territorio* mapa, const Jogador* jogadores);
+bool controladorEhHumano(const ControladorJogador* controlador);
+int jogarPartidaControladores(EstadoSimulacao* estado, const Regras* regras, ControladorJogador** controladores,
+                              GeradorAleatorio* dados, int maxTurnos, int* turnosJogados);
+void executarPartidasBots(char* lista, const OpcoesSimulacao* opcoes, long prazoMs);
+double avaliarHeuristica(const EstadoSimulacao* estado, const Regras* regras, int jogador,
+                         const PesosHeuristica* pesos);
+
+// Funções do serviço de ratings (Glicko-2 incremental)
+bool iniciarServicoRatings(ServicoRatings* servico, int numBots);
+void registrarResultadoRating(ServicoRatings* servico, int botA, int botB, double pontosA);
+bool lerPlacarRatings(ServicoRatings* servico, PlacarRatings* placar);
+void encerrarServicoRatings(ServicoRatings* servico);
+void executarTorneio(char* lista, const OpcoesSimulacao* opcoes, int numThreads);
+
+// Funções de ajuste de pesos (SPSA com partidas paralelas)
+void executarAjuste(const char* caminho, const char* politica, int geracoes,
+                    const OpcoesSimulacao* opcoes, int numThreads);
+void definirPrazoControlador(ControladorJogador* controlador, long prazoMs);
+void definirRegrasControlador(ControladorJogador* controlador, const Regras* regras);
+void reiniciarControlador(ControladorJogador* controlador, uint64_t semente);
+
+// Funções de hash Zobrist do estado compacto
+uint64_t calcularHashEstado(const EstadoSimulacao* estado);
+void definirDonoEstado(EstadoSimulacao* estado, int territorio, int dono);
+void definirTropasEstado(EstadoSimulacao* estado, int territorio, int tropas);
+void definirJogadorDaVez(EstadoSimulacao* estado, int jogador);
+void definirAtivoEstado(EstadoSimulacao* estado, int jogador, bool ativo);
+
+// Funções da tabela de transposição compartilhada
+bool criarTabelaTransposicao(TabelaTransposicao* tabela, size_t megabytes);
+void novaBuscaTransposicao(TabelaTransposicao* tabela);
+void limparTabelaTransposicao(TabelaTransposicao* tabela);
+bool consultarTransposicao(TabelaTransposicao* tabela, uint64_t hash, RegistroTransposicao* registro);
+void gravarTransposicao(TabelaTransposicao* tabela, uint64_t hash, const RegistroTransposicao* registro);
+void liberarTabelaTransposicao(TabelaTransposicao* tabela);
+
+// Funções do avaliador neural quantizado
+RedeAvaliacao* criarRedePadrao(uint64_t semente);
+RedeAvaliacao* carregarRede(const char* arquivo);
+void liberarRede(RedeAvaliacao* rede);
+int extrairCaracteristicas(const EstadoSimulacao* estado, int jogador, int* indices);
+void inicializarAcumulador(const RedeAvaliacao* rede, AcumuladorRede* acumulador,
+                           const EstadoSimulacao* estado, int jogador);
+void atualizarAcumulador(const RedeAvaliacao* rede, AcumuladorRede* acumulador,
+                         const EstadoSimulacao* antes, const EstadoSimulacao* depois);
+double avaliarRede(const RedeAvaliacao* rede, const AcumuladorRede* acumulador);
+void avaliarLoteRede(const RedeAvaliacao* rede, const AcumuladorRede* acumuladores, int quantidade, double* valores);
+void executarTesteRede(const char* arquivo, const OpcoesSimulacao* opcoes);
+void executarPartidasLoteRede(const char* arquivo, const OpcoesSimulacao* opcoes);
+
+bool escolherAtaqueRede(const RedeAvaliacao* rede, const EstadoSimulacao* estado, int* atacante, int* defensor);
+
+// Funções do bot expectimax (busca em profundidade com nós de acaso)
+void* criarBuscaExpectimax(long orcamentoNos, int maxProfundidade, int megabytes, const char* arquivoRede);
+bool buscarAtaqueExpectimax(void* busca, const EstadoSimulacao* estado, int* atacante, int* defensor);
+void liberarBuscaExpectimax(void* busca);
+
+// Funções de gerenciamento de tempo e latência
+int faseJogo(const EstadoSimulacao* estado);
+void iniciarJogadaTempo(GerenciadorTempo* tempo, const EstadoSimulacao* estado, long padraoMs);
+bool tempoEsgotado(const GerenciadorTempo* tempo);
+void registrarLatencia(HistogramaLatencia* histograma, long nanossegundos);
+long percentilLatencia(const HistogramaLatencia* histograma, double fracao);
+long percentilFaixaLatencia(int faixa);
+
+// Funções do bot MCTS (busca em árvore Monte Carlo paralela)
+void* criarArvoreMcts(int numThreads, int milissegundos, int megabytes, uint64_t semente);
+bool buscarAtaqueMcts(void* arvore, const EstadoSimulacao* estado, int* atacante, int* defensor);
+void liberarArvoreMcts(void* arvore);
+void definirPrazoMcts(void* arvore, long prazoMs);
+void definirRegrasMcts(void* arvore, const Regras* regras);
+void reiniciarArvoreMcts(void* arvore, uint64_t semente);
+void definirPrazoExpectimax(void* busca, long prazoMs);
+void definirRegrasExpectimax(void* busca, const Regras* regras);
+void reiniciarBuscaExpectimax(void* busca);
+
+// Funções de geração de dados por autojogo
+void executarAutojogo(const char* diretorio, const char* politica, size_t limiteShardMB,
+                      const OpcoesSimulacao* opcoes, int numThreads);
+
+// Funções de linha de comando
+int executarModoLinhaComando(int argc, char* argv[]);
+int jogarPartidaComSemente(const Regras* regras, const OpcoesSimulacao* opcoes, uint64_t semente,
+                           bool antitetico, int* duracao);
+
+// Funções do analisador em segundo plano
+void iniciarAnalisador(AnalisadorFundo* analisador);
+void publicarEstadoAnalise(AnalisadorFundo* analisador, const EstadoSimulacao* estado);
+void reiniciarAnalise(AnalisadorFundo* analisador);
+bool lerResultadoAnalise(AnalisadorFundo* analisador, ResultadoAnalise* resultado);
+void exibirAnalise(AnalisadorFundo* analisador, const Territorio* mapa, const Jogador* jogadores);
+void encerrarAnalisador(AnalisadorFundo* analisador);
 
 // Funções utilitárias
 void limparTela(void);
+void escreverConsole(void* dados, const char* formato, va_list argumentos);
+void limparConsole(void* dados);
+void pausarConsole(void* dados);
+int lerNumeroConsole(void* dados, int minimo, int maximo);
+bool confirmarConsole(void* dados);
 void aguardarEnter(void);
-void exibirEstatisticas(Territorio *mapa, int numTerritorios);
+void exibirEstatisticas(const ContextoJogo* contexto);
+
+// Regras oficiais do jogo
+static const Regras regrasPadrao = {
+    .tropasIniciaisMin = 2,
+    .tropasIniciaisMax = 6,
+    .divisorTransferencia = 2,
+    .penalidadeDerrota = 1,
+    .conquistadorTerritorios = 5,
+    .estrategistaTerritorios = 3,
+    .estrategistaTropas = 5,
+    .expansionistaTerritorios = 4,
+    .generalTropas = 30
+};
+
+// Palavras-chave das missões, na ordem de TipoMissao e de preencherMissoes
+static const char* const chavesMissoes[TOTAL_MISSOES] = {
+    "CONQUISTADOR", "DOMINAÇÃO TOTAL", "ESTRATEGISTA", "EXPANSIONISTA",
+    "GENERAL SUPREMO", "LIBERTADOR", "FORTALEZA", "IMPERADOR"
+};
+
+// Saídas de eventos do motor: terminal e descarte (partidas sem interface)
+static const SaidaEventos saidaConsole = {escreverConsole, limparConsole, NULL};
+static const SaidaEventos saidaSilenciosa = {NULL, NULL, NULL};
+
+// Entrada do jogo interativo pelo terminal (sem interface: tudo NULL)
+static const EntradaJogo entradaConsole = {pausarConsole, lerNumeroConsole, confirmarConsole, NULL};
+
+// Pesos da avaliação heurística usados pelo expectimax (reproduzem a
+// avaliação original: metade fatia do mapa, metade progresso da missão)
+static const PesosHeuristica pesosHeuristicaPadrao = {{0.25, 0.25, 0.5, 0.0}};
 
 // ============================================================================
 // FUNÇÃO PRINCIPAL
@@ -153,9 +1256,14 @@ void exibirEstatisticas(Territorio *mapa, int numTerritorios);
  *   6. Loop principal de batalhas com verificação de vitória
  *   7. Liberação completa de memória
  * 
+ * Com argumentos (ex.: --comparar) executa um modo de simulação
+ * sem interação em vez do jogo.
+ * 
+ * @param argc Número de argumentos
+ * @param argv Argumentos da linha de comando
  * @return 0 se execução foi bem-sucedida, 1 em caso de erro
  */
-int main(void) {
+int main(int argc, char* argv[]) {
     // Variáveis principais do jogo
     Territorio *mapa = NULL;        // Array de territórios (alocação dinâmica)
     Jogador *jogadores = NULL;      // Array de jogadores (alocação dinâmica)
@@ -165,12 +1273,20 @@ int main(void) {
     // Array de missões disponíveis (alocação estática)
     char missoes[TOTAL_MISSOES][MAX_MISSAO];
     
+    // Contexto da partida: mapa, jogadores, gerador, regras, saída e entrada
+    ContextoJogo contexto = {.regras = &regrasPadrao, .saida = saidaConsole, .entrada = entradaConsole};
+    
+    // Modos de simulação sem interação
+    if (argc > 1) {
+        return executarModoLinhaComando(argc, argv);
+    }
+    
     // ========================================================================
     // FASE 1: INICIALIZAÇÃO DO SISTEMA
     // ========================================================================
     limparTela();
     exibirCabecalho();
-    inicializarSistema();
+    inicializarSistema(&contexto);
     
     // ========================================================================
     // FASE 2: INICIALIZAÇÃO DO SISTEMA DE MISSÕES
@@ -222,6 +1338,11 @@ int main(void) {
         return 1;
     }
     
+    contexto.mapa = mapa;
+    contexto.numTerritorios = numTerritorios;
+    contexto.jogadores = jogadores;
+    contexto.numJogadores = numJogadores;
+    
     printf("✅ Alocação bem-sucedida!\n");
     printf("   🏰 Territórios: %d (%zu bytes)\n", numTerritorios, numTerritorios * sizeof(Territorio));
     printf("   � Jogadores: %d (%zu bytes)\n", numJogadores, numJogadores * sizeof(Jogador));
@@ -232,7 +1353,7 @@ int main(void) {
     aguardarEnter();
     limparTela();
     
-    cadastrarJogadores(jogadores, numJogadores, missoes);
+    cadastrarJogadores(&contexto, missoes);
     
     printf("\n🎯 Exibindo missões atribuídas:\n");
     exibirTodasMissoes(jogadores, numJogadores);
@@ -258,7 +1379,7 @@ int main(void) {
     }
     
     // Distribuição automática entre jogadores
-    distribuirTerritorios(mapa, numTerritorios, jogadores, numJogadores);
+    distribuirTerritorios(&contexto);
     
     // ========================================================================
     // FASE 7: EXIBIÇÃO DO ESTADO INICIAL DO JOGO
@@ -267,8 +1388,8 @@ int main(void) {
     limparTela();
     
     printf("\n🗺️ MAPA INICIAL DO JOGO:\n");
-    exibirTodosTeritorios(mapa, numTerritorios);
-    atualizarEstatisticasJogadores(jogadores, numJogadores, mapa, numTerritorios);
+    exibirTodosTeritorios(&contexto);
+    atualizarEstatisticasJogadores(&contexto);
     
     // ========================================================================
     // FASE 8: LOOP PRINCIPAL DE BATALHAS COM VERIFICAÇÃO DE MISSÕES
@@ -290,61 +1411,59 @@ int main(void) {
     // Loop principal do jogo
     int turno = 1;
     int vencedor = -1;
-    char continuar;
+    int jogadorDaVez = 0;
+    bool continuar = true;
     
-    do {
-        limparTela();
-        printf("🔄 ═══════════════════════════════════════════════════════════\n");
-        printf("                        TURNO %d\n", turno);
-        printf("═══════════════════════════════════════════════════════════🔄\n");
+    // Analisador que estima as chances enquanto os jogadores decidem
+    AnalisadorFundo analisador;
+    iniciarAnalisador(&analisador);
+    for (int i = 0; i < numJogadores; i++) {
+        conectarControladorHumano(jogadores[i].controlador, &analisador, mapa, jogadores);
+    }
+    
+    while (continuar) {
+        limparTelaContexto(&contexto);
+        emitirEvento(&contexto, "🔄 ═══════════════════════════════════════════════════════════\n");
+        emitirEvento(&contexto, "                        TURNO %d\n", turno);
+        emitirEvento(&contexto, "═══════════════════════════════════════════════════════════🔄\n");
         
         // Mostrar estado atual
-        printf("\n📊 SITUAÇÃO ATUAL DOS JOGADORES:\n");
+        emitirEvento(&contexto, "\n📊 SITUAÇÃO ATUAL DOS JOGADORES:\n");
         for (int i = 0; i < numJogadores; i++) {
             if (jogadores[i].ativo) {
-                printf("👤 %s (%s): %d territórios\n", 
-                       jogadores[i].nome, jogadores[i].cor, jogadores[i].territoriosControlados);
+                emitirEvento(&contexto, "👤 %s (%s): %d territórios\n", 
+                             jogadores[i].nome, jogadores[i].cor, jogadores[i].territoriosControlados);
             }
         }
         
-        // Executar uma rodada de batalha
-        executarBatalhaMultiplayer(mapa, numTerritorios, jogadores, numJogadores);
-        
-        // Atualizar estatísticas
-        atualizarEstatisticasJogadores(jogadores, numJogadores, mapa, numTerritorios);
-        
-        // Verificar se alguém cumpriu sua missão
-        vencedor = verificarVencedor(jogadores, numJogadores, mapa, numTerritorios);
+        // Jogador da vez (em rodízio entre os ativos) ataca com as
+        // sugestões do analisador; mesmo turno de jogarPartidaContexto
+        vencedor = jogarTurnoContexto(&contexto, &jogadorDaVez, &analisador);
         
         if (vencedor != -1) {
             // Anunciar vencedor
-            printf("\n🏆 ═══════════════════════════════════════════════════════════\n");
-            printf("                      TEMOS UM VENCEDOR!\n");
-            printf("═══════════════════════════════════════════════════════════🏆\n");
-            printf("🎉 %s cumpriu sua missão e venceu o jogo!\n", jogadores[vencedor].nome);
-            printf("🎯 Missão: %s\n", jogadores[vencedor].missao);
-            printf("🏰 Territórios controlados: %d\n", jogadores[vencedor].territoriosControlados);
+            emitirEvento(&contexto, "\n🏆 ═══════════════════════════════════════════════════════════\n");
+            emitirEvento(&contexto, "                      TEMOS UM VENCEDOR!\n");
+            emitirEvento(&contexto, "═══════════════════════════════════════════════════════════🏆\n");
+            emitirEvento(&contexto, "🎉 %s cumpriu sua missão e venceu o jogo!\n", jogadores[vencedor].nome);
+            emitirEvento(&contexto, "🎯 Missão: %s\n", jogadores[vencedor].missao);
+            emitirEvento(&contexto, "🏰 Territórios controlados: %d\n", jogadores[vencedor].territoriosControlados);
             break;
         }
         
         // Verificar se ainda há jogadores ativos
-        int jogadoresAtivos = 0;
-        for (int i = 0; i < numJogadores; i++) {
-            if (jogadores[i].ativo) jogadoresAtivos++;
-        }
-        
-        if (jogadoresAtivos <= 1) {
-            printf("\n🏁 Jogo terminado - apenas 1 jogador restante!\n");
+        if (contarJogadoresAtivos(&contexto) <= 1) {
+            emitirEvento(&contexto, "\n🏁 Jogo terminado - apenas 1 jogador restante!\n");
             break;
         }
         
         // Perguntar se quer continuar
-        printf("\n🎮 Continuar para o próximo turno? (s/N): ");
-        while (getchar() != '\n'); // Limpar buffer
-        continuar = getchar();
+        emitirEvento(&contexto, "\n🎮 Continuar para o próximo turno? (s/N): ");
+        continuar = confirmarContexto(&contexto);
         turno++;
-        
-    } while (continuar == 's' || continuar == 'S');
+    }
+    
+    encerrarAnalisador(&analisador);
     
     // ========================================================================
     // FASE 9: RELATÓRIO FINAL E LIBERAÇÃO DE MEMÓRIA
@@ -387,14 +1506,16 @@ int main(void) {
 /**
  * Inicializa o sistema de batalha
  * 
- * Configura a semente do gerador de números aleatórios baseado no
- * tempo atual, garantindo que cada execução tenha sequências
- * diferentes para simular batalhas mais realistas.
+ * Configura a semente do gerador do contexto baseado no tempo atual,
+ * garantindo que cada execução tenha sequências diferentes para
+ * simular batalhas mais realistas.
+ * 
+ * @param contexto Contexto da partida (gerador e saída de eventos)
  */
-void inicializarSistema(void) {
-    srand(time(NULL));  // Semente baseada no tempo atual
-    printf("🎲 Sistema de números aleatórios inicializado!\n");
-    printf("   Cada batalha terá resultados únicos baseados no tempo.\n");
+void inicializarSistema(ContextoJogo* contexto) {
+    inicializarGerador(&contexto->gerador, (uint64_t)time(NULL));  // Semente baseada no tempo atual
+    emitirEvento(contexto, "🎲 Sistema de números aleatórios inicializado!\n");
+    emitirEvento(contexto, "   Cada batalha terá resultados únicos baseados no tempo.\n");
 }
 
 /**
@@ -495,13 +1616,15 @@ void liberarMemoria(Territorio *mapa) {
 /**
  * Simula o resultado de um dado de 6 faces
  * 
- * Gera um número aleatório entre 1 e 6, simulando o lançamento
- * de um dado tradicional usado nas batalhas entre territórios.
+ * Gera um número aleatório entre 1 e 6 com o gerador do contexto,
+ * simulando o lançamento de um dado tradicional usado nas batalhas
+ * entre territórios.
  * 
+ * @param contexto Contexto da partida
  * @return Valor do dado (1-6)
  */
-int simularDado(void) {
-    return (rand() % 6) + 1;  // Gera número entre 1 e 6
+int simularDado(ContextoJogo* contexto) {
+    return rolarDado(&contexto->gerador);  // Gera número entre 1 e 6
 }
 
 /**
@@ -514,77 +1637,79 @@ int simularDado(void) {
  * - Defensor vence: atacante perde 1 tropa
  * - Empate: nada acontece
  * 
+ * @param contexto Contexto da partida (regras, dados e saída de eventos)
  * @param atacante Ponteiro para território atacante
  * @param defensor Ponteiro para território defensor
  * @return true se ataque foi bem-sucedido, false caso contrário
  */
-bool atacar(Territorio *atacante, Territorio *defensor) {
+bool atacar(ContextoJogo* contexto, Territorio *atacante, Territorio *defensor) {
     if (atacante == NULL || defensor == NULL) {
-        printf("❌ Erro: Ponteiros inválidos na batalha!\n");
+        emitirEvento(contexto, "❌ Erro: Ponteiros inválidos na batalha!\n");
         return false;
     }
     
     // Verificar se atacante tem tropas suficientes
     if (atacante->tropas <= 1) {
-        printf("❌ %s não tem tropas suficientes para atacar!\n", atacante->nome);
-        printf("   (Necessário: mín. 2 tropas, atual: %d)\n", atacante->tropas);
+        emitirEvento(contexto, "❌ %s não tem tropas suficientes para atacar!\n", atacante->nome);
+        emitirEvento(contexto, "   (Necessário: mín. 2 tropas, atual: %d)\n", atacante->tropas);
         return false;
     }
     
-    printf("\n⚔️ ═══════════════════════════════════════════════════════════\n");
-    printf("              BATALHA EM ANDAMENTO\n");
-    printf("═══════════════════════════════════════════════════════════⚔️\n");
-    printf("🏴 Atacante: %s (👥 %d tropas)\n", atacante->nome, atacante->tropas);
-    printf("🏰 Defensor: %s (👥 %d tropas)\n", defensor->nome, defensor->tropas);
+    emitirEvento(contexto, "\n⚔️ ═══════════════════════════════════════════════════════════\n");
+    emitirEvento(contexto, "              BATALHA EM ANDAMENTO\n");
+    emitirEvento(contexto, "═══════════════════════════════════════════════════════════⚔️\n");
+    emitirEvento(contexto, "🏴 Atacante: %s (👥 %d tropas)\n", atacante->nome, atacante->tropas);
+    emitirEvento(contexto, "🏰 Defensor: %s (👥 %d tropas)\n", defensor->nome, defensor->tropas);
     
     // Simular dados de batalha
-    int dadoAtacante = simularDado();
-    int dadoDefensor = simularDado();
+    int dadoAtacante = simularDado(contexto);
+    int dadoDefensor = simularDado(contexto);
     
-    printf("\n🎲 Lançamento dos dados:\n");
-    printf("   🏴 %s rolou: %d\n", atacante->nome, dadoAtacante);
-    printf("   🏰 %s rolou: %d\n", defensor->nome, dadoDefensor);
+    emitirEvento(contexto, "\n🎲 Lançamento dos dados:\n");
+    emitirEvento(contexto, "   🏴 %s rolou: %d\n", atacante->nome, dadoAtacante);
+    emitirEvento(contexto, "   🏰 %s rolou: %d\n", defensor->nome, dadoDefensor);
     
     // Determinar resultado da batalha
     if (dadoAtacante > dadoDefensor) {
         // Atacante vence - conquista território
-        printf("\n🏆 VITÓRIA DO ATACANTE!\n");
-        printf("   %s conquista %s!\n", atacante->dono, defensor->nome);
+        emitirEvento(contexto, "\n🏆 VITÓRIA DO ATACANTE!\n");
+        emitirEvento(contexto, "   %s conquista %s!\n", atacante->dono, defensor->nome);
         
-        // Calcular transferência de tropas (metade das tropas do atacante)
-        int tropasTranferidas = atacante->tropas / 2;
-        if (tropasTranferidas == 0) tropasTranferidas = 1; // Mínimo 1 tropa
+        // Transferência pela mesma fórmula dos demais caminhos de batalha
+        int tropasTranferidas;
+        atacante->tropas = tropasAposBatalha(contexto->regras, BATALHA_CONQUISTA, atacante->tropas,
+                                             &tropasTranferidas);
         
         // Transferir cor e tropas conforme especificado
         strcpy(defensor->cor, atacante->cor);
         strcpy(defensor->dono, atacante->dono);
         defensor->tropas = tropasTranferidas;
-        atacante->tropas -= tropasTranferidas;
         
-        printf("   🔄 Transferindo controle...\n");
-        printf("   📊 %s transferiu %d tropas para %s\n", 
+        emitirEvento(contexto, "   🔄 Transferindo controle...\n");
+        emitirEvento(contexto, "   📊 %s transferiu %d tropas para %s\n", 
                atacante->nome, tropasTranferidas, defensor->nome);
-        printf("   🏴 %s mantém %d tropas\n", atacante->nome, atacante->tropas);
+        emitirEvento(contexto, "   🏴 %s mantém %d tropas\n", atacante->nome, atacante->tropas);
         
         return true;
     } 
     else if (dadoDefensor > dadoAtacante) {
         // Defensor vence - atacante perde uma tropa
-        printf("\n🛡️ VITÓRIA DO DEFENSOR!\n");
-        printf("   %s defendeu com sucesso!\n", defensor->nome);
+        emitirEvento(contexto, "\n🛡️ VITÓRIA DO DEFENSOR!\n");
+        emitirEvento(contexto, "   %s defendeu com sucesso!\n", defensor->nome);
         
-        if (atacante->tropas > 1) {
-            atacante->tropas--;
-            printf("   💀 %s perde 1 tropa (restam: %d)\n", 
-                   atacante->nome, atacante->tropas);
-        }
+        // Penalidade limitada para sempre restar 1 tropa
+        int restantes = tropasAposBatalha(contexto->regras, BATALHA_DEFESA, atacante->tropas, NULL);
+        int perdas = atacante->tropas - restantes;
+        atacante->tropas = restantes;
+        emitirEvento(contexto, "   💀 %s perde %d tropa(s) (restam: %d)\n", 
+               atacante->nome, perdas, atacante->tropas);
         
         return false;
     } 
     else {
         // Empate - nada acontece
-        printf("\n🤝 EMPATE!\n");
-        printf("   Ambos os lados rolaram %d - nenhuma mudança!\n", dadoAtacante);
+        emitirEvento(contexto, "\n🤝 EMPATE!\n");
+        emitirEvento(contexto, "   Ambos os lados rolaram %d - nenhuma mudança!\n", dadoAtacante);
         return false;
     }
 }
@@ -596,67 +1721,59 @@ bool atacar(Territorio *atacante, Territorio *defensor) {
  * para batalhar, visualizar resultados e continuar jogando até
  * decidir parar.
  * 
- * @param mapa Array de territórios
- * @param numTerritorios Número total de territórios
+ * @param contexto Contexto da partida (mapa, dados, saída de eventos e entrada)
  */
-void executarBatalha(Territorio *mapa, int numTerritorios) {
-    char continuar;
-    int indiceAtacante, indiceDefensor;
+void executarBatalha(ContextoJogo* contexto) {
+    Territorio* mapa = contexto->mapa;
+    int numTerritorios = contexto->numTerritorios;
+    bool continuar = true;
     
-    do {
-        limparTela();
-        printf("⚔️ ═══════════════════════════════════════════════════════════\n");
-        printf("                    ARENA DE BATALHA\n");
-        printf("═══════════════════════════════════════════════════════════⚔️\n\n");
+    while (continuar) {
+        limparTelaContexto(contexto);
+        emitirEvento(contexto, "⚔️ ═══════════════════════════════════════════════════════════\n");
+        emitirEvento(contexto, "                    ARENA DE BATALHA\n");
+        emitirEvento(contexto, "═══════════════════════════════════════════════════════════⚔️\n\n");
         
         // Mostrar territórios disponíveis
-        printf("🗺️ TERRITÓRIOS DISPONÍVEIS:\n");
+        emitirEvento(contexto, "🗺️ TERRITÓRIOS DISPONÍVEIS:\n");
         for (int i = 0; i < numTerritorios; i++) {
-            printf("   [%d] %s - %s (👥 %d tropas)\n", 
-                   i + 1, mapa[i].nome, mapa[i].dono, mapa[i].tropas);
+            emitirEvento(contexto, "   [%d] %s - %s (👥 %d tropas)\n", 
+                         i + 1, mapa[i].nome, mapa[i].dono, mapa[i].tropas);
         }
         
-        // Escolher atacante
-        printf("\n🏴 Escolha o território ATACANTE (1-%d): ", numTerritorios);
-        while (scanf("%d", &indiceAtacante) != 1 || 
-               indiceAtacante < 1 || indiceAtacante > numTerritorios) {
-            printf("❌ Índice inválido! Escolha entre 1 e %d: ", numTerritorios);
-            while (getchar() != '\n');  // Limpar buffer
+        // Escolher atacante e defensor (sem entrada, a arena termina)
+        emitirEvento(contexto, "\n🏴 Escolha o território ATACANTE (1-%d): ", numTerritorios);
+        int indiceAtacante = lerNumeroContexto(contexto, 1, numTerritorios) - 1;  // Converter para 0-based
+        if (indiceAtacante < 0) {
+            break;
         }
-        indiceAtacante--;  // Converter para índice 0-based
-        
-        // Escolher defensor
-        printf("🏰 Escolha o território DEFENSOR (1-%d): ", numTerritorios);
-        while (scanf("%d", &indiceDefensor) != 1 || 
-               indiceDefensor < 1 || indiceDefensor > numTerritorios) {
-            printf("❌ Índice inválido! Escolha entre 1 e %d: ", numTerritorios);
-            while (getchar() != '\n');  // Limpar buffer
+        emitirEvento(contexto, "🏰 Escolha o território DEFENSOR (1-%d): ", numTerritorios);
+        int indiceDefensor = lerNumeroContexto(contexto, 1, numTerritorios) - 1;
+        if (indiceDefensor < 0) {
+            break;
         }
-        indiceDefensor--;  // Converter para índice 0-based
         
         // Verificar se são territórios diferentes
         if (indiceAtacante == indiceDefensor) {
-            printf("❌ Um território não pode atacar a si mesmo!\n");
-            aguardarEnter();
+            emitirEvento(contexto, "❌ Um território não pode atacar a si mesmo!\n");
+            pausarContexto(contexto);
             continue;
         }
         
         // Executar batalha
-        atacar(&mapa[indiceAtacante], &mapa[indiceDefensor]);
+        atacar(contexto, &mapa[indiceAtacante], &mapa[indiceDefensor]);
         
         // Mostrar estado atual após batalha
-        printf("\n📊 ESTADO ATUAL DOS TERRITÓRIOS:\n");
-        exibirTodosTeritorios(mapa, numTerritorios);
-        exibirEstatisticas(mapa, numTerritorios);
+        emitirEvento(contexto, "\n📊 ESTADO ATUAL DOS TERRITÓRIOS:\n");
+        exibirTodosTeritorios(contexto);
+        exibirEstatisticas(contexto);
         
         // Perguntar se quer continuar
-        printf("\n🎮 Deseja realizar outra batalha? (s/N): ");
-        while (getchar() != '\n');  // Limpar buffer
-        continuar = getchar();
-        
-    } while (continuar == 's' || continuar == 'S');
+        emitirEvento(contexto, "\n🎮 Deseja realizar outra batalha? (s/N): ");
+        continuar = confirmarContexto(contexto);
+    }
     
-    printf("\n🏁 Fim das batalhas!\n");
+    emitirEvento(contexto, "\n🏁 Fim das batalhas!\n");
 }
 
 /**
@@ -665,12 +1782,14 @@ void executarBatalha(Territorio *mapa, int numTerritorios) {
  * Calcula e mostra informações agregadas como total de tropas,
  * território com mais tropas, distribuição de donos, etc.
  * 
- * @param mapa Array de territórios
- * @param numTerritorios Número total de territórios
+ * @param contexto Contexto da partida (mapa e saída de eventos)
  */
-void exibirEstatisticas(Territorio *mapa, int numTerritorios) {
+void exibirEstatisticas(const ContextoJogo* contexto) {
+    const Territorio* mapa = contexto->mapa;
+    int numTerritorios = contexto->numTerritorios;
+    
     if (mapa == NULL || numTerritorios <= 0) {
-        printf("❌ Dados inválidos para calcular estatísticas.\n");
+        emitirEvento(contexto, "❌ Dados inválidos para calcular estatísticas.\n");
         return;
     }
     
@@ -691,15 +1810,15 @@ void exibirEstatisticas(Territorio *mapa, int numTerritorios) {
     
     double mediaTropas = (double)totalTropas / numTerritorios;
     
-    printf("\n📊 ═══════════════════════════════════════════════════════════\n");
-    printf("                      ESTATÍSTICAS DO MAPA\n");
-    printf("═══════════════════════════════════════════════════════════📊\n");
-    printf("🏗️  Total de territórios: %d\n", numTerritorios);
-    printf("👥 Total de tropas: %d\n", totalTropas);
-    printf("📈 Média de tropas por território: %.1f\n", mediaTropas);
-    printf("🏆 Território mais forte: %s (%s) - %d tropas\n", 
-           territorioMaisForte, donoMaisForte, maxTropas);
-    printf("═══════════════════════════════════════════════════════════📊\n");
+    emitirEvento(contexto, "\n📊 ═══════════════════════════════════════════════════════════\n");
+    emitirEvento(contexto, "                      ESTATÍSTICAS DO MAPA\n");
+    emitirEvento(contexto, "═══════════════════════════════════════════════════════════📊\n");
+    emitirEvento(contexto, "🏗️  Total de territórios: %d\n", numTerritorios);
+    emitirEvento(contexto, "👥 Total de tropas: %d\n", totalTropas);
+    emitirEvento(contexto, "📈 Média de tropas por território: %.1f\n", mediaTropas);
+    emitirEvento(contexto, "🏆 Território mais forte: %s (%s) - %d tropas\n", 
+                 territorioMaisForte, donoMaisForte, maxTropas);
+    emitirEvento(contexto, "═══════════════════════════════════════════════════════════📊\n");
 }
 
 // ============================================================================
@@ -816,88 +1935,158 @@ void cadastrarTerritorio(Territorio *t, int numero) {
 /*
  * Função: exibirTerritorio
  * Parâmetros:
+ *   - contexto: contexto da partida (saída de eventos)
  *   - t: ponteiro constante para a struct Territorio a ser exibida
  *   - numero: número do território para identificação
  * 
  * Descrição: Exibe os dados de um único território formatado
  */
-void exibirTerritorio(const Territorio *t, int numero) {
-    printf("┌────────────────────────────────────────────────────────────┐\n");
-    printf("│  🏰 TERRITÓRIO #%d                                         │\n", numero);
-    printf("├────────────────────────────────────────────────────────────┤\n");
-    printf("│  📍 Nome:     %-43s │\n", t->nome);
-    printf("│  👑 Dono:     %-43s │\n", t->dono);
-    printf("│  🎨 Cor:      %-43s │\n", t->cor);
-    printf("│  ⚔️  Tropas:   %-43d │\n", t->tropas);
-    printf("└────────────────────────────────────────────────────────────┘\n");
+void exibirTerritorio(const ContextoJogo* contexto, const Territorio *t, int numero) {
+    emitirEvento(contexto, "┌────────────────────────────────────────────────────────────┐\n");
+    emitirEvento(contexto, "│  🏰 TERRITÓRIO #%d                                         │\n", numero);
+    emitirEvento(contexto, "├────────────────────────────────────────────────────────────┤\n");
+    emitirEvento(contexto, "│  📍 Nome:     %-43s │\n", t->nome);
+    emitirEvento(contexto, "│  👑 Dono:     %-43s │\n", t->dono);
+    emitirEvento(contexto, "│  🎨 Cor:      %-43s │\n", t->cor);
+    emitirEvento(contexto, "│  ⚔️  Tropas:   %-43d │\n", t->tropas);
+    emitirEvento(contexto, "└────────────────────────────────────────────────────────────┘\n");
 }
 
 /*
  * Função: exibirTodosTeritorios
  * Parâmetros:
- *   - territorios: array de structs Territorio
- *   - total: número total de territórios no array
+ *   - contexto: contexto da partida (mapa e saída de eventos)
  * 
- * Descrição: Percorre o array e exibe todos os territórios cadastrados.
+ * Descrição: Percorre o mapa e exibe todos os territórios cadastrados.
  *            Também calcula e exibe estatísticas gerais.
  */
-void exibirTodosTeritorios(const Territorio territorios[], int total) {
+void exibirTodosTeritorios(const ContextoJogo* contexto) {
+    const Territorio* territorios = contexto->mapa;
+    int total = contexto->numTerritorios;
     int total_tropas = 0;  // Contador de tropas totais
     
-    printf("\n");
-    printf("╔════════════════════════════════════════════════════════════╗\n");
-    printf("║              📊 RELATÓRIO DE TERRITÓRIOS                   ║\n");
-    printf("╚════════════════════════════════════════════════════════════╝\n");
-    printf("\n");
+    emitirEvento(contexto, "\n");
+    emitirEvento(contexto, "╔════════════════════════════════════════════════════════════╗\n");
+    emitirEvento(contexto, "║              📊 RELATÓRIO DE TERRITÓRIOS                   ║\n");
+    emitirEvento(contexto, "╚════════════════════════════════════════════════════════════╝\n");
+    emitirEvento(contexto, "\n");
     
     /*
      * Loop para exibir cada território.
      * Utiliza const para garantir que os dados não sejam modificados.
      */
     for (int i = 0; i < total; i++) {
-        exibirTerritorio(&territorios[i], i + 1);
+        exibirTerritorio(contexto, &territorios[i], i + 1);
         total_tropas += territorios[i].tropas;  // Acumula tropas
-        printf("\n");
+        emitirEvento(contexto, "\n");
     }
     
 }
 
 /*
  * Função: limparTela
- * Descrição: Limpa a tela do terminal (multiplataforma)
+ * Descrição: Limpa a tela do terminal com sequências ANSI (aceitas
+ *            pelos terminais Linux/macOS e pelo Windows 10 em diante),
+ *            sem criar um processo de shell a cada turno
  */
 void limparTela(void) {
-    #ifdef _WIN32
-        system("cls");    // Windows
-    #else
-        system("clear");  // Linux/macOS
-    #endif
+    fputs("\033[H\033[2J", stdout);
+    fflush(stdout);
 }
 
 /*
- * Função: aguardarEnter
- * Descrição: Aguarda o usuário pressionar Enter para continuar
+ * Função: escreverConsole
+ * Descrição: Saída de eventos do motor no terminal (saidaConsole)
  */
-void aguardarEnter(void) {
-    printf("\n");
-    printf("  ⏎  Pressione ENTER para continuar...");
-    LIMPAR_BUFFER;
+void escreverConsole(void* dados, const char* formato, va_list argumentos) {
+    (void)dados;
+    vprintf(formato, argumentos);
 }
 
-// ============================================================================
-// IMPLEMENTAÇÃO DAS FUNÇÕES - SISTEMA DE MISSÕES ESTRATÉGICAS
-// ============================================================================
+/*
+ * Função: limparConsole
+ * Descrição: Limpeza de tela da saída no terminal (saidaConsole)
+ */
+void limparConsole(void* dados) {
+    (void)dados;
+    limparTela();
+}
 
-/**
- * Inicializa o vetor de missões pré-definidas
- * 
- * Esta função preenche um vetor com diferentes tipos de missões
- * estratégicas que serão sorteadas para os jogadores. Cada missão
- * representa um objetivo específico que deve ser cumprido para vencer.
- * 
- * @param missoes Array de strings onde serão armazenadas as missões
+/*
+ * Função: pausarConsole
+ * Descrição: Pausa da entrada pelo terminal (entradaConsole)
  */
-void inicializarMissoes(char missoes[][MAX_MISSAO]) {
+void pausarConsole(void* dados) {
+    (void)dados;
+    aguardarEnter();
+}
+
+/*
+ * Função: lerNumeroConsole
+ * Descrição: Lê pelo terminal um inteiro em [minimo, maximo], repetindo
+ *            até ser válido (entradaConsole); minimo - 1 no fim da entrada
+ */
+int lerNumeroConsole(void* dados, int minimo, int maximo) {
+    int valor;
+    int c;
+    (void)dados;
+    while (scanf("%d", &valor) != 1 || valor < minimo || valor > maximo) {
+        if (feof(stdin)) {
+            return minimo - 1;
+        }
+        printf("❌ Índice inválido! Escolha entre %d e %d: ", minimo, maximo);
+        while ((c = getchar()) != '\n' && c != EOF);  // Limpar buffer
+    }
+    return valor;
+}
+
+/*
+ * Função: confirmarConsole
+ * Descrição: Resposta s/N pelo terminal (entradaConsole), lida na
+ *            linha seguinte à entrada pendente
+ */
+bool confirmarConsole(void* dados) {
+    int c;
+    (void)dados;
+    while ((c = getchar()) != '\n' && c != EOF);  // Limpar buffer
+    c = getchar();
+    return c == 's' || c == 'S';
+}
+
+/*
+ * Função: aguardarEnter
+ * Descrição: Aguarda o usuário pressionar Enter para continuar
+ */
+void aguardarEnter(void) {
+    printf("\n");
+    printf("  ⏎  Pressione ENTER para continuar...");
+    LIMPAR_BUFFER;
+}
+
+// ============================================================================
+// IMPLEMENTAÇÃO DAS FUNÇÕES - SISTEMA DE MISSÕES ESTRATÉGICAS
+// ============================================================================
+
+/**
+ * Inicializa o vetor de missões pré-definidas
+ * 
+ * Esta função preenche um vetor com diferentes tipos de missões
+ * estratégicas que serão sorteadas para os jogadores. Cada missão
+ * representa um objetivo específico que deve ser cumprido para vencer.
+ * 
+ * @param missoes Array de strings onde serão armazenadas as missões
+ */
+void inicializarMissoes(char missoes[][MAX_MISSAO]) {
+    preencherMissoes(missoes);
+    printf("🎯 Sistema de missões inicializado com %d objetivos estratégicos!\n", TOTAL_MISSOES);
+}
+
+/**
+ * Preenche o vetor de missões sem escrever nada (partidas sem interface)
+ * 
+ * @param missoes Array de strings onde serão armazenadas as missões
+ */
+void preencherMissoes(char missoes[][MAX_MISSAO]) {
     strcpy(missoes[0], "CONQUISTADOR: Controle pelo menos 5 territórios simultaneamente");
     strcpy(missoes[1], "DOMINAÇÃO TOTAL: Elimine completamente 1 jogador (capture todos seus territórios)");
     strcpy(missoes[2], "ESTRATEGISTA: Mantenha 3 territórios com mais de 5 tropas cada por 2 turnos");
@@ -906,8 +2095,6 @@ void inicializarMissoes(char missoes[][MAX_MISSAO]) {
     strcpy(missoes[5], "LIBERTADOR: Conquiste territórios de pelo menos 3 jogadores diferentes");
     strcpy(missoes[6], "FORTALEZA: Defenda com sucesso 5 ataques consecutivos sem perder território");
     strcpy(missoes[7], "IMPERADOR: Controle mais da metade de todos os territórios do mapa");
-    
-    printf("🎯 Sistema de missões inicializado com %d objetivos estratégicos!\n", TOTAL_MISSOES);
 }
 
 /**
@@ -917,23 +2104,24 @@ void inicializarMissoes(char missoes[][MAX_MISSAO]) {
  * dinamicamente memória para armazenar a string da missão do jogador.
  * Utiliza malloc e strcpy conforme especificado nos requisitos.
  * 
+ * @param contexto Contexto da partida (gerador do sorteio e saída de eventos)
  * @param destino Ponteiro para onde será armazenado o endereço da missão
  * @param missoes Array de missões disponíveis
  * @param totalMissoes Número total de missões no array
  */
-void atribuirMissao(char* destino, char missoes[][MAX_MISSAO], int totalMissoes) {
+void atribuirMissao(ContextoJogo* contexto, char* destino, char missoes[][MAX_MISSAO], int totalMissoes) {
     if (destino == NULL || missoes == NULL || totalMissoes <= 0) {
-        printf("❌ Erro: Parâmetros inválidos para atribuição de missão!\n");
+        emitirEvento(contexto, "❌ Erro: Parâmetros inválidos para atribuição de missão!\n");
         return;
     }
     
     // Sorteia uma missão aleatória
-    int indiceSorteado = rand() % totalMissoes;
+    int indiceSorteado = sortearIntervalo(&contexto->gerador, totalMissoes);
     
     // Aloca memória dinamicamente para a missão
     char* missaoAlocada = (char*)malloc(MAX_MISSAO * sizeof(char));
     if (missaoAlocada == NULL) {
-        printf("❌ Erro: Falha na alocação de memória para missão!\n");
+        emitirEvento(contexto, "❌ Erro: Falha na alocação de memória para missão!\n");
         return;
     }
     
@@ -943,7 +2131,7 @@ void atribuirMissao(char* destino, char missoes[][MAX_MISSAO], int totalMissoes)
     // Atribui o ponteiro para a missão alocada
     *(char**)&destino = missaoAlocada;
     
-    printf("🎯 Missão sorteada e atribuída: Índice %d\n", indiceSorteado);
+    emitirEvento(contexto, "🎯 Missão sorteada e atribuída: Índice %d\n", indiceSorteado);
 }
 
 /**
@@ -953,13 +2141,15 @@ void atribuirMissao(char* destino, char missoes[][MAX_MISSAO], int totalMissoes)
  * da missão do jogador foram satisfeitas. Implementa lógicas
  * específicas para diferentes tipos de objetivos.
  * 
+ * @param regras Regras com os limites das missões
  * @param missao String da missão a ser verificada
  * @param mapa Array de territórios do jogo
  * @param tamanho Número de territórios no mapa
  * @param corJogador Cor que identifica os territórios do jogador
  * @return 1 se missão foi cumprida, 0 caso contrário
  */
-int verificarMissao(char* missao, Territorio* mapa, int tamanho, const char* corJogador) {
+int verificarMissao(const Regras* regras, const char* missao, const Territorio* mapa, int tamanho,
+                    const char* corJogador) {
     if (missao == NULL || mapa == NULL || corJogador == NULL || tamanho <= 0) {
         return 0; // Parâmetros inválidos
     }
@@ -974,31 +2164,42 @@ int verificarMissao(char* missao, Territorio* mapa, int tamanho, const char* cor
         if (strcmp(mapa[i].cor, corJogador) == 0) {
             territoriosControlados++;
             tropasTotais += mapa[i].tropas;
-            if (mapa[i].tropas > 5) {
+            if (mapa[i].tropas > regras->estrategistaTropas) {
                 territoriosComMais5Tropas++;
             }
         }
     }
     
-    // Verificação baseada no conteúdo da missão (lógica simples inicial)
-    if (strstr(missao, "CONQUISTADOR") != NULL) {
-        return territoriosControlados >= 5;
-    }
-    else if (strstr(missao, "GENERAL SUPREMO") != NULL) {
-        return tropasTotais > 30;
-    }
-    else if (strstr(missao, "ESTRATEGISTA") != NULL) {
-        return territoriosComMais5Tropas >= 3;
-    }
-    else if (strstr(missao, "IMPERADOR") != NULL) {
-        return territoriosControlados > (tamanho / 2);
-    }
-    else if (strstr(missao, "EXPANSIONISTA") != NULL) {
-        return territoriosControlados >= 4;
+    // Verificação baseada no tipo identificado no texto da missão
+    return avaliarMissao(regras, identificarMissao(missao), territoriosControlados, tropasTotais,
+                         territoriosComMais5Tropas, tamanho) ? 1 : 0;
+}
+
+/**
+ * Decide se os números de um jogador cumprem uma missão
+ * 
+ * Lógica comum a verificarMissao (mapa de territórios) e a
+ * verificarMissaoEstado (estado compacto), que só diferem na contagem.
+ * Missões mais complexas retornam false por enquanto (lógica simplificada).
+ * 
+ * @param regras Regras com os limites das missões
+ * @param tipo Tipo da missão
+ * @param territoriosControlados Territórios do jogador
+ * @param tropasTotais Tropas somadas nos territórios do jogador
+ * @param territoriosFortes Territórios do jogador com mais de estrategistaTropas tropas
+ * @param numTerritorios Territórios do mapa
+ * @return true se a missão foi cumprida
+ */
+bool avaliarMissao(const Regras* regras, TipoMissao tipo, int territoriosControlados, int tropasTotais,
+                   int territoriosFortes, int numTerritorios) {
+    switch (tipo) {
+        case MISSAO_CONQUISTADOR:  return territoriosControlados >= regras->conquistadorTerritorios;
+        case MISSAO_GENERAL:       return tropasTotais > regras->generalTropas;
+        case MISSAO_ESTRATEGISTA:  return territoriosFortes >= regras->estrategistaTerritorios;
+        case MISSAO_IMPERADOR:     return territoriosControlados > (numTerritorios / 2);
+        case MISSAO_EXPANSIONISTA: return territoriosControlados >= regras->expansionistaTerritorios;
+        default:                   return false;
     }
-    
-    // Missões mais complexas retornam false por enquanto (lógica simplificada)
-    return 0;
 }
 
 /**
@@ -1110,11 +2311,12 @@ Jogador* alocarJogadores(int quantidade) {
 /**
  * Cadastra todos os jogadores e atribui missões
  * 
- * @param jogadores Array de jogadores
- * @param numJogadores Número de jogadores
+ * @param contexto Contexto da partida (jogadores e gerador dos sorteios)
  * @param missoes Array de missões disponíveis
  */
-void cadastrarJogadores(Jogador* jogadores, int numJogadores, char missoes[][MAX_MISSAO]) {
+void cadastrarJogadores(ContextoJogo* contexto, char missoes[][MAX_MISSAO]) {
+    Jogador* jogadores = contexto->jogadores;
+    int numJogadores = contexto->numJogadores;
     const char* cores[] = {"Vermelho", "Azul", "Verde", "Amarelo", "Roxo", "Laranja"};
     
     printf("\n👤 ═══════════════════════════════════════════════════════════\n");
@@ -1139,10 +2341,29 @@ void cadastrarJogadores(Jogador* jogadores, int numJogadores, char missoes[][MAX
         jogadores[i].ativo = true;
         jogadores[i].territoriosControlados = 0;
         
+        // Escolhe quem controla o jogador (Enter = humano)
+        char tipo[BUFFER_SIZE];
+        printf("🤖 Controle (1=humano, 2=bot aleatório, 3=bot estrategista) [1]: ");
+        if (fgets(tipo, sizeof(tipo), stdin) == NULL) {
+            tipo[0] = '\0';
+        }
+        const char* tipos[] = {"humano", "aleatorio", "estrategista"};
+        int escolha = atoi(tipo);
+        if (escolha < 1 || escolha > 3) escolha = 1;
+        jogadores[i].controlador = criarControlador(tipos[escolha - 1], proximoAleatorio(&contexto->gerador));
+        if (jogadores[i].controlador == NULL) {
+            printf("❌ Erro: Falha na alocação do controlador!\n");
+            jogadores[i].controlador = criarControlador("humano", 0);
+        }
+        if (jogadores[i].controlador != NULL) {
+            definirRegrasControlador(jogadores[i].controlador, contexto->regras);
+            printf("🎮 Controlador: %s\n", jogadores[i].controlador->nome);
+        }
+        
         // Aloca e atribui missão
         jogadores[i].missao = (char*)malloc(MAX_MISSAO * sizeof(char));
         if (jogadores[i].missao != NULL) {
-            int indiceMissao = rand() % TOTAL_MISSOES;
+            int indiceMissao = sortearIntervalo(&contexto->gerador, TOTAL_MISSOES);
             strcpy(jogadores[i].missao, missoes[indiceMissao]);
             printf("🎯 Missão atribuída: %s\n", jogadores[i].missao);
         }
@@ -1153,30 +2374,41 @@ void cadastrarJogadores(Jogador* jogadores, int numJogadores, char missoes[][MAX
 }
 
 /**
- * Valida se um ataque é permitido (apenas contra territórios inimigos)
+ * Valida se um ataque é permitido (de território próprio contra inimigo)
  * 
+ * @param contexto Contexto da partida (saída de eventos)
+ * @param jogador Jogador da vez
  * @param atacante Território atacante
  * @param defensor Território defensor  
  * @return true se ataque é válido, false caso contrário
  */
-bool validarAtaque(const Territorio* atacante, const Territorio* defensor) {
-    if (atacante == NULL || defensor == NULL) {
-        printf("❌ Erro: Territórios inválidos!\n");
+bool validarAtaque(ContextoJogo* contexto, const Jogador* jogador, const Territorio* atacante,
+                   const Territorio* defensor) {
+    if (jogador == NULL || atacante == NULL || defensor == NULL) {
+        emitirEvento(contexto, "❌ Erro: Territórios inválidos!\n");
+        return false;
+    }
+    
+    // Verificar se o atacante pertence ao jogador da vez
+    if (strcmp(atacante->cor, jogador->cor) != 0) {
+        emitirEvento(contexto, "❌ Ataque inválido: O território atacante não é seu!\n");
+        emitirEvento(contexto, "   🏴 %s pertence a %s (%s), não a %s (%s)\n",
+               atacante->nome, atacante->dono, atacante->cor, jogador->nome, jogador->cor);
         return false;
     }
     
     // Verificar se são territórios de cores diferentes (inimigos)
     if (strcmp(atacante->cor, defensor->cor) == 0) {
-        printf("❌ Ataque inválido: Não pode atacar território da mesma cor!\n");
-        printf("   🏴 %s (%s) não pode atacar %s (%s)\n", 
+        emitirEvento(contexto, "❌ Ataque inválido: Não pode atacar território da mesma cor!\n");
+        emitirEvento(contexto, "   🏴 %s (%s) não pode atacar %s (%s)\n", 
                atacante->nome, atacante->cor, defensor->nome, defensor->cor);
         return false;
     }
     
     // Verificar se atacante tem tropas suficientes
     if (atacante->tropas <= 1) {
-        printf("❌ Ataque inválido: Tropas insuficientes!\n");
-        printf("   🏴 %s tem apenas %d tropa(s) - mínimo necessário: 2\n", 
+        emitirEvento(contexto, "❌ Ataque inválido: Tropas insuficientes!\n");
+        emitirEvento(contexto, "   🏴 %s tem apenas %d tropa(s) - mínimo necessário: 2\n", 
                atacante->nome, atacante->tropas);
         return false;
     }
@@ -1187,53 +2419,56 @@ bool validarAtaque(const Territorio* atacante, const Territorio* defensor) {
 /**
  * Distribui territórios entre os jogadores no início do jogo
  * 
- * @param mapa Array de territórios
- * @param numTerritorios Número de territórios
- * @param jogadores Array de jogadores
- * @param numJogadores Número de jogadores
+ * @param contexto Contexto da partida (mapa, jogadores, gerador e regras)
  */
-void distribuirTerritorios(Territorio* mapa, int numTerritorios, Jogador* jogadores, int numJogadores) {
-    printf("\n🗺️ ═══════════════════════════════════════════════════════════\n");
-    printf("              DISTRIBUIÇÃO AUTOMÁTICA DE TERRITÓRIOS\n");
-    printf("═══════════════════════════════════════════════════════════🗺️\n");
+void distribuirTerritorios(ContextoJogo* contexto) {
+    Territorio* mapa = contexto->mapa;
+    Jogador* jogadores = contexto->jogadores;
+    int numJogadores = contexto->numJogadores;
+    
+    emitirEvento(contexto, "\n🗺️ ═══════════════════════════════════════════════════════════\n");
+    emitirEvento(contexto, "              DISTRIBUIÇÃO AUTOMÁTICA DE TERRITÓRIOS\n");
+    emitirEvento(contexto, "═══════════════════════════════════════════════════════════🗺️\n");
     
     // Distribui territórios de forma alternada entre jogadores
-    for (int i = 0; i < numTerritorios; i++) {
+    for (int i = 0; i < contexto->numTerritorios; i++) {
         int jogadorAtual = i % numJogadores;
         
         // Atualizar cor e dono do território
         strcpy(mapa[i].cor, jogadores[jogadorAtual].cor);
         strcpy(mapa[i].dono, jogadores[jogadorAtual].nome);
         
-        // Tropas iniciais aleatórias (2-6)
-        mapa[i].tropas = (rand() % 5) + 2;
+        // Tropas iniciais aleatórias (2-6 nas regras oficiais)
+        mapa[i].tropas = sortearIntervalo(&contexto->gerador,
+                                          contexto->regras->tropasIniciaisMax - contexto->regras->tropasIniciaisMin + 1)
+                         + contexto->regras->tropasIniciaisMin;
         
-        printf("🏰 %s → %s (%s) - %d tropas\n", 
+        emitirEvento(contexto, "🏰 %s → %s (%s) - %d tropas\n", 
                mapa[i].nome, jogadores[jogadorAtual].nome, 
                jogadores[jogadorAtual].cor, mapa[i].tropas);
     }
     
-    printf("✅ Distribuição concluída!\n");
+    emitirEvento(contexto, "✅ Distribuição concluída!\n");
 }
 
 /**
  * Atualiza estatísticas dos jogadores baseado no mapa atual
  * 
- * @param jogadores Array de jogadores
- * @param numJogadores Número de jogadores
- * @param mapa Array de territórios
- * @param numTerritorios Número de territórios
+ * @param contexto Contexto da partida (mapa, jogadores e saída de eventos)
  */
-void atualizarEstatisticasJogadores(Jogador* jogadores, int numJogadores, Territorio* mapa, int numTerritorios) {
+void atualizarEstatisticasJogadores(ContextoJogo* contexto) {
+    Jogador* jogadores = contexto->jogadores;
+    int numJogadores = contexto->numJogadores;
+    
     // Zera contadores
     for (int i = 0; i < numJogadores; i++) {
         jogadores[i].territoriosControlados = 0;
     }
     
     // Conta territórios por jogador
-    for (int i = 0; i < numTerritorios; i++) {
+    for (int i = 0; i < contexto->numTerritorios; i++) {
         for (int j = 0; j < numJogadores; j++) {
-            if (strcmp(mapa[i].cor, jogadores[j].cor) == 0) {
+            if (strcmp(contexto->mapa[i].cor, jogadores[j].cor) == 0) {
                 jogadores[j].territoriosControlados++;
                 break;
             }
@@ -1244,7 +2479,7 @@ void atualizarEstatisticasJogadores(Jogador* jogadores, int numJogadores, Territ
     for (int i = 0; i < numJogadores; i++) {
         if (jogadores[i].territoriosControlados == 0 && jogadores[i].ativo) {
             jogadores[i].ativo = false;
-            printf("💀 %s foi eliminado do jogo!\n", jogadores[i].nome);
+            emitirEvento(contexto, "💀 %s foi eliminado do jogo!\n", jogadores[i].nome);
         }
     }
 }
@@ -1252,16 +2487,15 @@ void atualizarEstatisticasJogadores(Jogador* jogadores, int numJogadores, Territ
 /**
  * Verifica se algum jogador cumpriu sua missão e venceu
  * 
- * @param jogadores Array de jogadores
- * @param numJogadores Número de jogadores
- * @param mapa Array de territórios
- * @param numTerritorios Número de territórios
+ * @param contexto Contexto da partida (mapa, jogadores e regras)
  * @return Índice do jogador vencedor, ou -1 se ninguém venceu
  */
-int verificarVencedor(Jogador* jogadores, int numJogadores, Territorio* mapa, int numTerritorios) {
-    for (int i = 0; i < numJogadores; i++) {
-        if (jogadores[i].ativo && jogadores[i].missao != NULL) {
-            if (verificarMissao(jogadores[i].missao, mapa, numTerritorios, jogadores[i].cor)) {
+int verificarVencedor(const ContextoJogo* contexto) {
+    for (int i = 0; i < contexto->numJogadores; i++) {
+        const Jogador* jogador = &contexto->jogadores[i];
+        if (jogador->ativo && jogador->missao != NULL) {
+            if (verificarMissao(contexto->regras, jogador->missao, contexto->mapa,
+                                contexto->numTerritorios, jogador->cor)) {
                 return i; // Retorna índice do vencedor
             }
         }
@@ -1301,6 +2535,10 @@ void liberarMemoriaCompleta(Territorio* mapa, Jogador* jogadores, int numJogador
                 free(jogadores[i].missao);
                 jogadores[i].missao = NULL;
             }
+            if (jogadores[i].controlador != NULL) {
+                jogadores[i].controlador->liberar(jogadores[i].controlador);
+                jogadores[i].controlador = NULL;
+            }
         }
         
         free(jogadores);
@@ -1313,62 +2551,11363 @@ void liberarMemoriaCompleta(Territorio* mapa, Jogador* jogadores, int numJogador
 /**
  * Executa uma rodada de batalha no modo multiplayer
  * 
+ * O controlador do jogador da vez escolhe o ataque: humanos digitam os
+ * territórios (o analisador continua simulando enquanto isso) e bots
+ * decidem a partir de uma visão compacta do mapa. Tudo o que aparece
+ * na tela e as pausas passam pela saída e pela entrada do contexto.
+ * 
+ * @param contexto Contexto da partida
+ * @param jogadorDaVez Jogador que escolhe o ataque
+ * @param analisador Analisador em segundo plano (pode ser NULL)
+ */
+void executarBatalhaMultiplayer(ContextoJogo* contexto, int jogadorDaVez, AnalisadorFundo* analisador) {
+    Territorio* mapa = contexto->mapa;
+    int numTerritorios = contexto->numTerritorios;
+    Jogador* jogadores = contexto->jogadores;
+    int numJogadores = contexto->numJogadores;
+    int indiceAtacante, indiceDefensor;
+    ControladorJogador* controlador = jogadores[jogadorDaVez].controlador;
+    
+    emitirEvento(contexto, "\n⚔️ ═══════════════════════════════════════════════════════════\n");
+    emitirEvento(contexto, "                    RODADA DE BATALHA\n");
+    emitirEvento(contexto, "═══════════════════════════════════════════════════════════⚔️\n");
+    
+    // Mostrar territórios disponíveis com cores (sem saída, o motor
+    // pula a listagem, que custaria uma chamada por território a cada vez)
+    if (contexto->saida.escrever != NULL) {
+        emitirEvento(contexto, "\n🗺️ TERRITÓRIOS DISPONÍVEIS:\n");
+        for (int i = 0; i < numTerritorios; i++) {
+            emitirEvento(contexto, "   [%d] %s - %s (%s) - %d tropas\n", 
+                         i + 1, mapa[i].nome, mapa[i].dono, mapa[i].cor, mapa[i].tropas);
+        }
+    }
+    
+    emitirEvento(contexto, "\n🎯 Vez de %s (%s)\n", jogadores[jogadorDaVez].nome, controlador->nome);
+    
+    // Decisão do controlador a partir de uma visão somente leitura; humanos
+    // escolhem de novo até o ataque ser válido, bots inválidos passam a vez
+    EstadoSimulacao visao;
+    montarEstadoSimulacao(&visao, mapa, numTerritorios, jogadores, numJogadores, jogadorDaVez);
+    bool humano = controladorEhHumano(controlador);
+    while (true) {
+        if (!controlador->decidirAtaque(controlador, &visao, &indiceAtacante, &indiceDefensor)) {
+            emitirEvento(contexto, "⏭️  %s passa a vez (nenhum ataque possível).\n", jogadores[jogadorDaVez].nome);
+            pausarContexto(contexto);
+            return;
+        }
+        
+        // Verificar se os territórios existem e são diferentes e validar o
+        // ataque (atacante do jogador da vez, só contra inimigos)
+        bool valido;
+        if (indiceAtacante < 0 || indiceAtacante >= numTerritorios ||
+            indiceDefensor < 0 || indiceDefensor >= numTerritorios) {
+            emitirEvento(contexto, "❌ Território inexistente! Escolha entre 1 e %d.\n", numTerritorios);
+            valido = false;
+        } else {
+            if (!humano) {
+                emitirEvento(contexto, "🤖 %s ataca [%d] %s → [%d] %s\n", jogadores[jogadorDaVez].nome,
+                             indiceAtacante + 1, mapa[indiceAtacante].nome,
+                             indiceDefensor + 1, mapa[indiceDefensor].nome);
+            }
+            if (indiceAtacante == indiceDefensor) {
+                emitirEvento(contexto, "❌ Um território não pode atacar a si mesmo!\n");
+                valido = false;
+            } else {
+                valido = validarAtaque(contexto, &jogadores[jogadorDaVez], &mapa[indiceAtacante],
+                                       &mapa[indiceDefensor]);
+            }
+        }
+        if (valido) {
+            break;
+        }
+        if (!humano) {
+            pausarContexto(contexto);
+            return;
+        }
+        emitirEvento(contexto, "🔁 Escolha outro ataque.\n");
+    }
+    
+    // Executar batalha
+    bool sucesso = atacar(contexto, &mapa[indiceAtacante], &mapa[indiceDefensor]);
+    
+    if (sucesso) {
+        emitirEvento(contexto, "🎊 Território conquistado com sucesso!\n");
+    }
+    
+    // O mapa mudou: descartar simulações do estado anterior imediatamente
+    if (analisador != NULL) {
+        // Registra as eliminações desta batalha para simular a vez de quem
+        // de fato joga a seguir (o atacante segue ativo, então o laço para)
+        atualizarEstatisticasJogadores(contexto);
+        int proximo = (jogadorDaVez + 1) % numJogadores;
+        while (!jogadores[proximo].ativo) {
+            proximo = (proximo + 1) % numJogadores;
+        }
+        EstadoSimulacao estado;
+        montarEstadoSimulacao(&estado, mapa, numTerritorios, jogadores, numJogadores, proximo);
+        publicarEstadoAnalise(analisador, &estado);
+    }
+    
+    pausarContexto(contexto);
+}
+
+// ============================================================================
+// IMPLEMENTAÇÃO DAS FUNÇÕES - SIMULAÇÃO RÁPIDA
+// ============================================================================
+
+/**
+ * Inicializa um gerador aleatório independente
+ * 
+ * Espalha a semente com splitmix64 para que sementes próximas
+ * (ex.: índices de threads) produzam sequências sem correlação.
+ * 
+ * @param gerador Gerador a ser inicializado
+ * @param semente Semente de 64 bits
+ */
+void inicializarGerador(GeradorAleatorio* gerador, uint64_t semente) {
+    uint64_t z = semente + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    gerador->estado = (z != 0) ? z : 0x9E3779B97F4A7C15ULL; // xorshift não aceita zero
+    gerador->antitetico = false;
+}
+
+/**
+ * Gera o próximo número de 64 bits (xorshift64*)
+ * 
+ * @param gerador Gerador com estado próprio
+ * @return Número pseudoaleatório de 64 bits
+ */
+uint64_t proximoAleatorio(GeradorAleatorio* gerador) {
+    uint64_t x = gerador->estado;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    gerador->estado = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+/**
+ * Sorteia um inteiro uniforme em [0, limite)
+ * 
+ * @param gerador Gerador com estado próprio
+ * @param limite Quantidade de valores possíveis (> 0)
+ * @return Valor sorteado
+ */
+int sortearIntervalo(GeradorAleatorio* gerador, int limite) {
+    return (int)(((proximoAleatorio(gerador) >> 32) * (uint64_t)limite) >> 32);
+}
+
+/**
+ * Versão de simularDado com gerador próprio (segura entre threads)
+ * 
+ * @param gerador Gerador com estado próprio
+ * @return Valor do dado (DADO_MIN-DADO_MAX)
+ */
+int rolarDado(GeradorAleatorio* gerador) {
+    int dado = sortearIntervalo(gerador, DADO_MAX - DADO_MIN + 1) + DADO_MIN;
+    return gerador->antitetico ? (DADO_MIN + DADO_MAX - dado) : dado;
+}
+
+/**
+ * Identifica o tipo de uma missão a partir do seu texto
+ * 
+ * @param missao Texto da missão (como em inicializarMissoes)
+ * @return Tipo da missão, ou MISSAO_DESCONHECIDA
+ */
+TipoMissao identificarMissao(const char* missao) {
+    if (missao == NULL) {
+        return MISSAO_DESCONHECIDA;
+    }
+    
+    for (int i = 0; i < TOTAL_MISSOES; i++) {
+        if (strstr(missao, chavesMissoes[i]) != NULL) {
+            return (TipoMissao)i;
+        }
+    }
+    return MISSAO_DESCONHECIDA;
+}
+
+/**
+ * Sorteia uma partida inicial no estado compacto
+ * 
+ * Segue distribuirTerritorios (rodízio entre jogadores, tropas sorteadas
+ * entre os limites das regras) e cadastrarJogadores (missão sorteada
+ * entre as TOTAL_MISSOES).
+ * 
+ * @param estado Estado compacto a ser preenchido
+ * @param regras Regras com os limites de tropas iniciais
+ * @param numJogadores Número de jogadores
+ * @param numTerritorios Número de territórios
+ * @param gerador Gerador do sorteio
+ */
+void gerarPartidaAleatoria(EstadoSimulacao* estado, const Regras* regras, int numJogadores,
+                           int numTerritorios, GeradorAleatorio* gerador) {
+    memset(estado, 0, sizeof(*estado));
+    estado->numJogadores = numJogadores;
+    estado->numTerritorios = numTerritorios;
+    
+    for (int j = 0; j < numJogadores; j++) {
+        estado->missao[j] = (int8_t)sortearIntervalo(gerador, TOTAL_MISSOES);
+        estado->ativo[j] = true;
+    }
+    
+    for (int i = 0; i < numTerritorios; i++) {
+        estado->dono[i] = (int8_t)(i % numJogadores);
+        estado->tropas[i] = sortearIntervalo(gerador, regras->tropasIniciaisMax - regras->tropasIniciaisMin + 1)
+                            + regras->tropasIniciaisMin;
+    }
+    estado->hash = calcularHashEstado(estado);
+}
+
+/**
+ * Copia o estado do jogo para a representação compacta da simulação
+ * 
+ * Os donos são identificados pela cor, como em atualizarEstatisticasJogadores.
+ * 
+ * @param estado Estado compacto a ser preenchido
  * @param mapa Array de territórios
  * @param numTerritorios Número de territórios
  * @param jogadores Array de jogadores
  * @param numJogadores Número de jogadores
+ * @param jogadorDaVez Jogador que realiza o próximo ataque
  */
-void executarBatalhaMultiplayer(Territorio *mapa, int numTerritorios, Jogador* jogadores, int numJogadores) {
-    int indiceAtacante, indiceDefensor;
+void montarEstadoSimulacao(EstadoSimulacao* estado, const Territorio* mapa, int numTerritorios,
+                           const Jogador* jogadores, int numJogadores, int jogadorDaVez) {
+    memset(estado, 0, sizeof(*estado));
+    estado->numTerritorios = numTerritorios;
+    estado->numJogadores = numJogadores;
     
-    printf("\n⚔️ ═══════════════════════════════════════════════════════════\n");
-    printf("                    RODADA DE BATALHA\n");
-    printf("═══════════════════════════════════════════════════════════⚔️\n");
+    for (int j = 0; j < numJogadores; j++) {
+        estado->missao[j] = (int8_t)identificarMissao(jogadores[j].missao);
+    }
     
-    // Mostrar territórios disponíveis com cores
-    printf("\n🗺️ TERRITÓRIOS DISPONÍVEIS:\n");
     for (int i = 0; i < numTerritorios; i++) {
-        printf("   [%d] %s - %s (%s) - %d tropas\n", 
-               i + 1, mapa[i].nome, mapa[i].dono, mapa[i].cor, mapa[i].tropas);
+        estado->dono[i] = -1;
+        estado->tropas[i] = mapa[i].tropas;
+        for (int j = 0; j < numJogadores; j++) {
+            if (strcmp(mapa[i].cor, jogadores[j].cor) == 0) {
+                estado->dono[i] = (int8_t)j;
+                estado->ativo[j] = true;
+                break;
+            }
+        }
     }
     
-    // Escolher atacante
-    printf("\n🏴 Escolha o território ATACANTE (1-%d): ", numTerritorios);
-    while (scanf("%d", &indiceAtacante) != 1 || 
-           indiceAtacante < 1 || indiceAtacante > numTerritorios) {
-        printf("❌ Índice inválido! Escolha entre 1 e %d: ", numTerritorios);
-        while (getchar() != '\n');
+    estado->jogadorDaVez = jogadorDaVez % numJogadores;
+    estado->hash = calcularHashEstado(estado);
+    if (!estado->ativo[estado->jogadorDaVez]) {
+        avancarJogadorDaVez(estado);
     }
-    indiceAtacante--; // Converter para índice 0-based
+}
+
+/**
+ * Lista os ataques válidos de um jogador
+ * 
+ * Mesmas regras de validarAtaque: atacante próprio com mais de 1 tropa
+ * contra qualquer território inimigo.
+ * 
+ * @param estado Estado compacto
+ * @param jogador Jogador atacante
+ * @param ataques Saída com pares (atacante, defensor)
+ * @return Quantidade de ataques listados
+ */
+int listarAtaques(const EstadoSimulacao* estado, int jogador, int ataques[][2]) {
+    int total = 0;
     
-    // Escolher defensor
-    printf("🏰 Escolha o território DEFENSOR (1-%d): ", numTerritorios);
-    while (scanf("%d", &indiceDefensor) != 1 || 
-           indiceDefensor < 1 || indiceDefensor > numTerritorios) {
-        printf("❌ Índice inválido! Escolha entre 1 e %d: ", numTerritorios);
-        while (getchar() != '\n');
+    for (int a = 0; a < estado->numTerritorios; a++) {
+        if (estado->dono[a] != jogador || estado->tropas[a] <= 1) {
+            continue;
+        }
+        for (int d = 0; d < estado->numTerritorios; d++) {
+            if (estado->dono[d] != jogador) {
+                ataques[total][0] = a;
+                ataques[total][1] = d;
+                total++;
+            }
+        }
+    }
+    return total;
+}
+
+/**
+ * Rola os dados de uma batalha: maior dado vence, igualdade empata
+ * 
+ * Cada batalha consome exatamente dois dados (atacante e defensor),
+ * o que mantém sequências de dados sincronizadas entre variantes de
+ * regras e entre os modos que resolvem batalhas no estado compacto.
+ * 
+ * @param gerador Gerador dos dados
+ * @return BATALHA_CONQUISTA, BATALHA_DEFESA ou BATALHA_EMPATE
+ */
+int rolarBatalha(GeradorAleatorio* gerador) {
+    int dadoAtacante = rolarDado(gerador);
+    int dadoDefensor = rolarDado(gerador);
+    return (dadoAtacante > dadoDefensor) ? BATALHA_CONQUISTA :
+           (dadoDefensor > dadoAtacante) ? BATALHA_DEFESA : BATALHA_EMPATE;
+}
+
+/**
+ * Calcula as tropas do atacante e do defensor após uma batalha
+ * 
+ * Regras de atacar(): conquista transfere parte das tropas (metade nas
+ * regras oficiais, ao menos 1) e derrota custa tropas ao atacante
+ * (1 nas regras oficiais), que mantém pelo menos 1.
+ * 
+ * @param regras Variante das regras
+ * @param resultado BATALHA_CONQUISTA, BATALHA_DEFESA ou BATALHA_EMPATE
+ * @param tropasAtacante Tropas do atacante antes da batalha
+ * @param tropasDefensor Saída: tropas que ocupam o defensor (só na conquista)
+ * @return Tropas que ficam no atacante
+ */
+int tropasAposBatalha(const Regras* regras, int resultado, int tropasAtacante, int* tropasDefensor) {
+    if (resultado == BATALHA_CONQUISTA) {
+        int tropasTransferidas = tropasAtacante / regras->divisorTransferencia;
+        if (tropasTransferidas == 0) tropasTransferidas = 1;
+        *tropasDefensor = tropasTransferidas;
+        return tropasAtacante - tropasTransferidas;
+    }
+    if (resultado == BATALHA_DEFESA) {
+        int perdas = regras->penalidadeDerrota;
+        if (perdas > tropasAtacante - 1) perdas = tropasAtacante - 1;
+        return tropasAtacante - perdas;
+    }
+    return tropasAtacante;
+}
+
+/**
+ * Resolve uma batalha no estado compacto, sem entrada/saída
+ * 
+ * Rola os dados com rolarBatalha e aplica as consequências com
+ * aplicarResultadoBatalha.
+ * 
+ * @param estado Estado compacto
+ * @param regras Variante das regras
+ * @param atacante Índice do território atacante
+ * @param defensor Índice do território defensor
+ * @param gerador Gerador dos dados
+ * @return BATALHA_CONQUISTA, BATALHA_DEFESA, BATALHA_EMPATE ou BATALHA_INVALIDA
+ */
+int resolverBatalhaEstado(EstadoSimulacao* estado, const Regras* regras, int atacante, int defensor,
+                          GeradorAleatorio* gerador) {
+    if (estado->tropas[atacante] <= 1) {
+        return BATALHA_INVALIDA;
     }
-    indiceDefensor--; // Converter para índice 0-based
     
-    // Verificar se são territórios diferentes
-    if (indiceAtacante == indiceDefensor) {
-        printf("❌ Um território não pode atacar a si mesmo!\n");
-        aguardarEnter();
-        return;
+    int resultado = rolarBatalha(gerador);
+    aplicarResultadoBatalha(estado, regras, atacante, defensor, resultado);
+    return resultado;
+}
+
+/**
+ * Aplica ao estado compacto o resultado já conhecido de uma batalha
+ * 
+ * Usada pelas simulações (após rolar os dados) e pelas buscas que
+ * percorrem os três resultados possíveis de cada ataque.
+ * 
+ * @param estado Estado compacto
+ * @param regras Variante das regras
+ * @param atacante Índice do território atacante
+ * @param defensor Índice do território defensor
+ * @param resultado BATALHA_CONQUISTA, BATALHA_DEFESA ou BATALHA_EMPATE
+ */
+void aplicarResultadoBatalha(EstadoSimulacao* estado, const Regras* regras, int atacante, int defensor,
+                             int resultado) {
+    int tropasDefensor = 0;
+    int tropasAtacante = tropasAposBatalha(regras, resultado, estado->tropas[atacante], &tropasDefensor);
+    
+    if (resultado == BATALHA_CONQUISTA) {
+        definirDonoEstado(estado, defensor, estado->dono[atacante]);
+        definirTropasEstado(estado, defensor, tropasDefensor);
+    }
+    if (resultado != BATALHA_EMPATE) {
+        definirTropasEstado(estado, atacante, tropasAtacante);
+    }
+}
+
+/**
+ * Calcula a chance de cada resultado de uma batalha
+ * 
+ * Enumera todos os pares de dados entre DADO_MIN e DADO_MAX
+ * (15/36 conquista, 15/36 defesa e 6/36 empate com dados de 6 faces).
+ * 
+ * @param chances Saída indexada por BATALHA_EMPATE, BATALHA_CONQUISTA e BATALHA_DEFESA
+ */
+void calcularChancesBatalha(double chances[3]) {
+    int faces = DADO_MAX - DADO_MIN + 1;
+    int contagem[3] = {0, 0, 0};
+    
+    for (int a = DADO_MIN; a <= DADO_MAX; a++) {
+        for (int d = DADO_MIN; d <= DADO_MAX; d++) {
+            contagem[(a > d) ? BATALHA_CONQUISTA : (d > a) ? BATALHA_DEFESA : BATALHA_EMPATE]++;
+        }
+    }
+    for (int r = 0; r < 3; r++) {
+        chances[r] = (double)contagem[r] / (faces * faces);
     }
+}
+
+/**
+ * Verifica a missão de um jogador no estado compacto
+ * 
+ * Equivalente a verificarMissao, usando o tipo da missão em vez do texto
+ * (a decisão é a mesma: avaliarMissao).
+ * 
+ * @param estado Estado compacto
+ * @param regras Regras com os limites das missões
+ * @param jogador Índice do jogador
+ * @return true se a missão foi cumprida
+ */
+bool verificarMissaoEstado(const EstadoSimulacao* estado, const Regras* regras, int jogador) {
+    int territoriosControlados = 0;
+    int tropasTotais = 0;
+    int territoriosComMais5Tropas = 0;
     
-    // Validar ataque (só contra inimigos)
-    if (!validarAtaque(&mapa[indiceAtacante], &mapa[indiceDefensor])) {
-        aguardarEnter();
-        return;
+    for (int i = 0; i < estado->numTerritorios; i++) {
+        if (estado->dono[i] == jogador) {
+            territoriosControlados++;
+            tropasTotais += estado->tropas[i];
+            if (estado->tropas[i] > regras->estrategistaTropas) {
+                territoriosComMais5Tropas++;
+            }
+        }
     }
     
-    // Executar batalha
-    bool sucesso = atacar(&mapa[indiceAtacante], &mapa[indiceDefensor]);
+    return avaliarMissao(regras, (TipoMissao)estado->missao[jogador], territoriosControlados, tropasTotais,
+                         territoriosComMais5Tropas, estado->numTerritorios);
+}
+
+/**
+ * Atualiza os jogadores ativos e verifica se a partida terminou
+ * 
+ * Vence o primeiro jogador ativo com a missão cumprida (como em
+ * verificarVencedor) ou o último jogador que ainda tiver territórios.
+ * 
+ * @param estado Estado compacto (campo ativo é atualizado)
+ * @param regras Regras com os limites das missões
+ * @return Índice do vencedor, ou -1 se a partida continua
+ */
+int verificarVencedorEstado(EstadoSimulacao* estado, const Regras* regras) {
+    int contagem[MAX_JOGADORES] = {0};
+    int ativos = 0;
+    int ultimoAtivo = -1;
     
-    if (sucesso) {
-        printf("🎊 Território conquistado com sucesso!\n");
+    for (int i = 0; i < estado->numTerritorios; i++) {
+        if (estado->dono[i] >= 0) {
+            contagem[estado->dono[i]]++;
+        }
     }
     
-    aguardarEnter();
-}
\ No newline at end of file
+    for (int j = 0; j < estado->numJogadores; j++) {
+        if (estado->ativo[j] != (contagem[j] > 0)) {
+            definirAtivoEstado(estado, j, contagem[j] > 0);
+        }
+        if (estado->ativo[j]) {
+            ativos++;
+            ultimoAtivo = j;
+        }
+    }
+    
+    for (int j = 0; j < estado->numJogadores; j++) {
+        if (estado->ativo[j] && verificarMissaoEstado(estado, regras, j)) {
+            return j;
+        }
+    }
+    
+    return (ativos <= 1) ? ultimoAtivo : -1;
+}
+
+/**
+ * Passa a vez para o próximo jogador ativo
+ * 
+ * @param estado Estado compacto
+ */
+void avancarJogadorDaVez(EstadoSimulacao* estado) {
+    for (int passo = 1; passo <= estado->numJogadores; passo++) {
+        int candidato = (estado->jogadorDaVez + passo) % estado->numJogadores;
+        if (estado->ativo[candidato]) {
+            definirJogadorDaVez(estado, candidato);
+            return;
+        }
+    }
+}
+
+/**
+ * Simula uma partida até o fim com ataques aleatórios
+ * 
+ * Cada jogador, em sua vez, escolhe um ataque válido ao acaso
+ * (ou passa a vez se não tiver nenhum). Dados e escolhas usam
+ * geradores separados para que duas variantes com a mesma semente
+ * recebam os mesmos dados batalha a batalha (números aleatórios comuns).
+ * 
+ * @param estado Estado compacto (modificado durante a simulação)
+ * @param regras Variante das regras
+ * @param dados Gerador dos dados de batalha
+ * @param politica Gerador das escolhas de ataque (pode ser o mesmo)
+ * @param maxTurnos Limite de turnos antes de declarar empate
+ * @param turnosJogados Saída com a duração da partida (pode ser NULL)
+ * @return Índice do vencedor, ou -1 se o limite foi atingido
+ */
+int simularPartidaAleatoria(EstadoSimulacao* estado, const Regras* regras, GeradorAleatorio* dados,
+                            GeradorAleatorio* politica, int maxTurnos, int* turnosJogados) {
+    int ataques[MAX_ATAQUES][2];
+    int vencedor = -1;
+    int turno;
+    
+    for (turno = 0; turno < maxTurnos; turno++) {
+        vencedor = verificarVencedorEstado(estado, regras);
+        if (vencedor != -1) {
+            break;
+        }
+        
+        int numAtaques = listarAtaques(estado, estado->jogadorDaVez, ataques);
+        if (numAtaques > 0) {
+            int escolhido = sortearIntervalo(politica, numAtaques);
+            resolverBatalhaEstado(estado, regras, ataques[escolhido][0], ataques[escolhido][1], dados);
+        }
+        avancarJogadorDaVez(estado);
+    }
+    
+    if (turno == maxTurnos) {
+        vencedor = verificarVencedorEstado(estado, regras);
+    }
+    if (turnosJogados != NULL) {
+        *turnosJogados = turno;
+    }
+    return vencedor;
+}
+
+// ============================================================================
+// IMPLEMENTAÇÃO DAS FUNÇÕES - HASH ZOBRIST
+// ============================================================================
+
+/*
+ * Struct: ChavesZobrist
+ *
+ * Chaves aleatórias fixas de cada componente do estado. O hash de um
+ * estado é o XOR das chaves dos componentes presentes, então trocar um
+ * componente custa dois XORs (remove a chave antiga, insere a nova).
+ * Dono -1 (território sem dono) usa a última coluna de dono; missão
+ * desconhecida, a última coluna de missão.
+ */
+typedef struct {
+    uint64_t dono[MAX_TERRITORIOS][MAX_JOGADORES + 1];
+    uint64_t tropas[MAX_TERRITORIOS][ZOBRIST_MAX_TROPAS];
+    uint64_t vez[MAX_JOGADORES];
+    uint64_t missao[MAX_JOGADORES][TOTAL_MISSOES + 1];
+    uint64_t ativo[MAX_JOGADORES];
+} ChavesZobrist;
+
+static ChavesZobrist chavesZobrist;
+static pthread_once_t chavesZobristIniciadas = PTHREAD_ONCE_INIT;
+
+/**
+ * Sorteia as chaves com semente fixa (hashes iguais entre execuções)
+ */
+static void inicializarChavesZobrist(void) {
+    GeradorAleatorio gerador;
+    inicializarGerador(&gerador, 0x5A0B215751A7ULL);
+    
+    uint64_t* chaves = (uint64_t*)&chavesZobrist;
+    for (size_t k = 0; k < sizeof(chavesZobrist) / sizeof(uint64_t); k++) {
+        chaves[k] = proximoAleatorio(&gerador);
+    }
+}
+
+/**
+ * Chave de um território com certa quantidade de tropas
+ * 
+ * Contagens acima de ZOBRIST_MAX_TROPAS recebem uma chave calculada
+ * na hora (splitmix64), para não colidirem entre si.
+ * 
+ * @param territorio Índice do território
+ * @param tropas Quantidade de tropas
+ * @return Chave Zobrist
+ */
+static uint64_t chaveTropas(int territorio, int tropas) {
+    if (tropas >= 0 && tropas < ZOBRIST_MAX_TROPAS) {
+        return chavesZobrist.tropas[territorio][tropas];
+    }
+    uint64_t z = chavesZobrist.tropas[territorio][0] + (uint64_t)(uint32_t)tropas * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Calcula do zero o hash Zobrist de um estado
+ * 
+ * Usada só ao montar um estado; daí em diante o hash é mantido pelas
+ * funções definir*, que também alteram o campo correspondente.
+ * 
+ * @param estado Estado compacto
+ * @return Hash de 64 bits (dono e tropas dos territórios, jogador da vez,
+ *         missões e jogadores ativos)
+ */
+uint64_t calcularHashEstado(const EstadoSimulacao* estado) {
+    pthread_once(&chavesZobristIniciadas, inicializarChavesZobrist);
+    uint64_t hash = chavesZobrist.vez[estado->jogadorDaVez];
+    
+    for (int i = 0; i < estado->numTerritorios; i++) {
+        int dono = (estado->dono[i] >= 0) ? estado->dono[i] : MAX_JOGADORES;
+        hash ^= chavesZobrist.dono[i][dono] ^ chaveTropas(i, estado->tropas[i]);
+    }
+    for (int j = 0; j < estado->numJogadores; j++) {
+        int missao = (estado->missao[j] >= 0) ? estado->missao[j] : TOTAL_MISSOES;
+        hash ^= chavesZobrist.missao[j][missao];
+        if (estado->ativo[j]) {
+            hash ^= chavesZobrist.ativo[j];
+        }
+    }
+    return hash;
+}
+
+/**
+ * Troca o dono de um território, atualizando o hash
+ * 
+ * @param estado Estado compacto
+ * @param territorio Índice do território
+ * @param dono Novo dono (-1 para nenhum)
+ */
+void definirDonoEstado(EstadoSimulacao* estado, int territorio, int dono) {
+    int antigo = (estado->dono[territorio] >= 0) ? estado->dono[territorio] : MAX_JOGADORES;
+    int novo = (dono >= 0) ? dono : MAX_JOGADORES;
+    estado->hash ^= chavesZobrist.dono[territorio][antigo] ^ chavesZobrist.dono[territorio][novo];
+    estado->dono[territorio] = (int8_t)dono;
+}
+
+/**
+ * Troca as tropas de um território, atualizando o hash
+ * 
+ * @param estado Estado compacto
+ * @param territorio Índice do território
+ * @param tropas Nova quantidade de tropas
+ */
+void definirTropasEstado(EstadoSimulacao* estado, int territorio, int tropas) {
+    estado->hash ^= chaveTropas(territorio, estado->tropas[territorio]) ^ chaveTropas(territorio, tropas);
+    estado->tropas[territorio] = tropas;
+}
+
+/**
+ * Troca o jogador da vez, atualizando o hash
+ * 
+ * @param estado Estado compacto
+ * @param jogador Novo jogador da vez
+ */
+void definirJogadorDaVez(EstadoSimulacao* estado, int jogador) {
+    estado->hash ^= chavesZobrist.vez[estado->jogadorDaVez] ^ chavesZobrist.vez[jogador];
+    estado->jogadorDaVez = jogador;
+}
+
+/**
+ * Marca um jogador como ativo ou eliminado, atualizando o hash
+ * 
+ * @param estado Estado compacto
+ * @param jogador Índice do jogador
+ * @param ativo Nova situação
+ */
+void definirAtivoEstado(EstadoSimulacao* estado, int jogador, bool ativo) {
+    if (estado->ativo[jogador] != ativo) {
+        estado->hash ^= chavesZobrist.ativo[jogador];
+        estado->ativo[jogador] = ativo;
+    }
+}
+
+// ============================================================================
+// IMPLEMENTAÇÃO DAS FUNÇÕES - ANÁLISE EM SEGUNDO PLANO
+// ============================================================================
+
+/**
+ * Copia o estado publicado pela thread principal (leitura de seqlock)
+ * 
+ * @param analisador Analisador com o estado publicado
+ * @param destino Cópia do estado
+ * @return true se a cópia é consistente
+ */
+static bool copiarEstadoPublicado(AnalisadorFundo* analisador, EstadoSimulacao* destino) {
+    unsigned int antes = atomic_load_explicit(&analisador->seqEstado, memory_order_acquire);
+    if (antes & 1u) {
+        return false; // Escrita em andamento
+    }
+    memcpy(destino, &analisador->estado, sizeof(*destino));
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&analisador->seqEstado, memory_order_relaxed) == antes;
+}
+
+/**
+ * Publica o resultado parcial da análise (escrita de seqlock)
+ * 
+ * @param analisador Analisador
+ * @param resultado Resultado a ser publicado
+ */
+static void publicarResultado(AnalisadorFundo* analisador, const ResultadoAnalise* resultado) {
+    unsigned int seq = atomic_load_explicit(&analisador->seqResultado, memory_order_relaxed);
+    atomic_store_explicit(&analisador->seqResultado, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    memcpy(&analisador->resultado, resultado, sizeof(*resultado));
+    atomic_store_explicit(&analisador->seqResultado, seq + 2, memory_order_release);
+}
+
+/**
+ * Corpo da thread de análise
+ * 
+ * Alterna simulações a partir do estado atual (chance de cada jogador)
+ * com simulações após cada ataque possível do jogador da vez (sugestão).
+ * Uma nova geração descarta o trabalho em andamento após no máximo
+ * uma partida simulada.
+ * 
+ * @param argumento Ponteiro para o AnalisadorFundo
+ * @return NULL
+ */
+static void* executarAnalisador(void* argumento) {
+    AnalisadorFundo* analisador = (AnalisadorFundo*)argumento;
+    GeradorAleatorio gerador;
+    EstadoSimulacao base, simulado;
+    ResultadoAnalise parcial;
+    int (*ataques)[2] = analisador->ataques;
+    int* vitoriasAtaque = analisador->vitoriasAtaque;
+    int* tentativasAtaque = analisador->tentativasAtaque;
+    int numAtaques = 0;
+    unsigned int geracaoAtual = 0;
+    const struct timespec pausa = {0, ANALISE_PAUSA_NS};
+    
+    inicializarGerador(&gerador, (uint64_t)time(NULL) ^ (uint64_t)(uintptr_t)analisador);
+    memset(&parcial, 0, sizeof(parcial));
+    
+    while (!atomic_load_explicit(&analisador->encerrar, memory_order_relaxed)) {
+        unsigned int geracao = atomic_load_explicit(&analisador->geracao, memory_order_acquire);
+        
+        // Nada publicado ainda, ou estado atual já foi suficientemente analisado
+        if (geracao == 0 || (geracao == geracaoAtual && parcial.rollouts >= ANALISE_MAX_ROLLOUTS)) {
+            nanosleep(&pausa, NULL);
+            continue;
+        }
+        
+        // Novo estado: recomeçar do zero
+        if (geracao != geracaoAtual) {
+            if (!copiarEstadoPublicado(analisador, &base) ||
+                atomic_load_explicit(&analisador->geracao, memory_order_acquire) != geracao) {
+                continue;
+            }
+            geracaoAtual = geracao;
+            memset(&parcial, 0, sizeof(parcial));
+            parcial.geracao = geracao;
+            parcial.melhorAtacante = -1;
+            parcial.melhorDefensor = -1;
+            numAtaques = listarAtaques(&base, base.jogadorDaVez, ataques);
+            memset(analisador->vitoriasAtaque, 0, sizeof(analisador->vitoriasAtaque));
+            memset(analisador->tentativasAtaque, 0, sizeof(analisador->tentativasAtaque));
+        }
+        
+        // Uma partida simulada (a partir do estado ou após um ataque candidato)
+        simulado = base;
+        if (numAtaques > 0 && (parcial.rollouts & 1)) {
+            int candidato = (parcial.rollouts / 2) % numAtaques;
+            resolverBatalhaEstado(&simulado, &regrasPadrao, ataques[candidato][0], ataques[candidato][1], &gerador);
+            avancarJogadorDaVez(&simulado);
+            int vencedor = simularPartidaAleatoria(&simulado, &regrasPadrao, &gerador, &gerador,
+                                                   ROLLOUT_MAX_TURNOS, NULL);
+            tentativasAtaque[candidato]++;
+            if (vencedor == base.jogadorDaVez) {
+                vitoriasAtaque[candidato]++;
+            }
+        } else {
+            int vencedor = simularPartidaAleatoria(&simulado, &regrasPadrao, &gerador, &gerador,
+                                                   ROLLOUT_MAX_TURNOS, NULL);
+            if (vencedor >= 0) {
+                parcial.vitorias[vencedor]++;
+            }
+            parcial.rolloutsEstado++;
+        }
+        parcial.rollouts++;
+        
+        // Publicar periodicamente, se o estado ainda for o mesmo
+        if ((parcial.rollouts % 64) == 0 &&
+            atomic_load_explicit(&analisador->geracao, memory_order_relaxed) == geracaoAtual) {
+            double melhor = -1.0;
+            for (int i = 0; i < numAtaques; i++) {
+                if (tentativasAtaque[i] == 0) continue;
+                double chance = (vitoriasAtaque[i] + 1.0) / (tentativasAtaque[i] + 2.0);
+                if (chance > melhor) {
+                    melhor = chance;
+                    parcial.melhorAtacante = ataques[i][0];
+                    parcial.melhorDefensor = ataques[i][1];
+                    parcial.chanceMelhorAtaque = chance;
+                }
+            }
+            publicarResultado(analisador, &parcial);
+        }
+    }
+    
+    return NULL;
+}
+
+/**
+ * Inicia a thread de análise em segundo plano
+ * 
+ * Se a thread não puder ser criada o jogo continua normalmente,
+ * apenas sem as estimativas.
+ * 
+ * @param analisador Analisador a ser iniciado
+ */
+void iniciarAnalisador(AnalisadorFundo* analisador) {
+    memset(analisador, 0, sizeof(*analisador));
+    atomic_init(&analisador->encerrar, false);
+    atomic_init(&analisador->geracao, 0);
+    atomic_init(&analisador->seqEstado, 0);
+    atomic_init(&analisador->seqResultado, 0);
+    
+    analisador->iniciado =
+        pthread_create(&analisador->thread, NULL, executarAnalisador, analisador) == 0;
+    if (!analisador->iniciado) {
+        printf("⚠️  Aviso: Análise em segundo plano indisponível.\n");
+    }
+}
+
+/**
+ * Publica um novo estado para análise (escrita de seqlock)
+ * 
+ * Chamado apenas pela thread principal. Não bloqueia: o analisador
+ * percebe a nova geração e abandona as simulações antigas.
+ * 
+ * @param analisador Analisador
+ * @param estado Estado atual do jogo
+ */
+void publicarEstadoAnalise(AnalisadorFundo* analisador, const EstadoSimulacao* estado) {
+    unsigned int seq = atomic_load_explicit(&analisador->seqEstado, memory_order_relaxed);
+    atomic_store_explicit(&analisador->seqEstado, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    memcpy(&analisador->estado, estado, sizeof(*estado));
+    atomic_store_explicit(&analisador->seqEstado, seq + 2, memory_order_release);
+    reiniciarAnalise(analisador);
+}
+
+/**
+ * Cancela a análise em andamento e recomeça a partir do estado publicado
+ * 
+ * @param analisador Analisador
+ */
+void reiniciarAnalise(AnalisadorFundo* analisador) {
+    atomic_fetch_add_explicit(&analisador->geracao, 1, memory_order_release);
+}
+
+/**
+ * Lê o resultado mais recente sem esperar o analisador
+ * 
+ * @param analisador Analisador
+ * @param resultado Cópia do resultado
+ * @return true se há resultado consistente para o estado atual
+ */
+bool lerResultadoAnalise(AnalisadorFundo* analisador, ResultadoAnalise* resultado) {
+    if (!analisador->iniciado) {
+        return false;
+    }
+    
+    // Poucas tentativas: se o analisador estiver escrevendo, desiste
+    for (int tentativa = 0; tentativa < 4; tentativa++) {
+        unsigned int antes = atomic_load_explicit(&analisador->seqResultado, memory_order_acquire);
+        if (antes & 1u) continue;
+        memcpy(resultado, &analisador->resultado, sizeof(*resultado));
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&analisador->seqResultado, memory_order_relaxed) == antes) {
+            return resultado->rolloutsEstado > 0 &&
+                   resultado->geracao == atomic_load_explicit(&analisador->geracao, memory_order_relaxed);
+        }
+    }
+    return false;
+}
+
+/**
+ * Exibe a estimativa de vitória e a sugestão de ataque
+ * 
+ * @param analisador Analisador
+ * @param mapa Array de territórios (para os nomes)
+ * @param jogadores Array de jogadores
+ */
+void exibirAnalise(AnalisadorFundo* analisador, const Territorio* mapa, const Jogador* jogadores) {
+    ResultadoAnalise resultado;
+    
+    if (!lerResultadoAnalise(analisador, &resultado)) {
+        printf("\n🔮 Análise em andamento... (digite 0 para atualizar)\n");
+        return;
+    }
+    
+    int numJogadores = analisador->estado.numJogadores;
+    int jogadorDaVez = analisador->estado.jogadorDaVez;
+    
+    printf("\n🔮 Chances de vitória (%d simulações):", resultado.rollouts);
+    for (int j = 0; j < numJogadores; j++) {
+        if (analisador->estado.ativo[j]) {
+            printf(" %s %.0f%%", jogadores[j].nome, 100.0 * resultado.vitorias[j] / resultado.rolloutsEstado);
+        }
+    }
+    printf("\n");
+    
+    if (resultado.melhorAtacante >= 0) {
+        printf("💡 Sugestão para %s: [%d] %s → [%d] %s (vitória em %.0f%%)\n",
+               jogadores[jogadorDaVez].nome,
+               resultado.melhorAtacante + 1, mapa[resultado.melhorAtacante].nome,
+               resultado.melhorDefensor + 1, mapa[resultado.melhorDefensor].nome,
+               100.0 * resultado.chanceMelhorAtaque);
+    }
+}
+
+/**
+ * Encerra a thread de análise
+ * 
+ * @param analisador Analisador
+ */
+void encerrarAnalisador(AnalisadorFundo* analisador) {
+    if (analisador->iniciado) {
+        atomic_store(&analisador->encerrar, true);
+        pthread_join(analisador->thread, NULL);
+        analisador->iniciado = false;
+    }
+}
+
+// ============================================================================
+// IMPLEMENTAÇÃO DAS FUNÇÕES - COMPARAÇÃO DE VARIANTES DE REGRAS
+// ============================================================================
+
+/**
+ * Acumula uma amostra na estatística (Welford)
+ * 
+ * @param estatistica Estatística acumulada
+ * @param valor Nova amostra
+ */
+void acumularAmostra(EstatisticaAmostral* estatistica, double valor) {
+    estatistica->n++;
+    double delta = valor - estatistica->media;
+    estatistica->media += delta / estatistica->n;
+    estatistica->m2 += delta * (valor - estatistica->media);
+}
+
+/**
+ * Variância amostral acumulada
+ * 
+ * @param estatistica Estatística acumulada
+ * @return Variância (0 se houver menos de 2 amostras)
+ */
+double varianciaAmostral(const EstatisticaAmostral* estatistica) {
+    return (estatistica->n > 1) ? estatistica->m2 / (estatistica->n - 1) : 0.0;
+}
+
+/**
+ * Joga uma partida simulada completa a partir de uma semente
+ * 
+ * A semente define três fluxos independentes: sorteio inicial, dados
+ * e escolhas de ataque. Assim a mesma semente reproduz a mesma partida
+ * inicial e a mesma sequência de dados em qualquer variante de regras.
+ * 
+ * @param regras Variante das regras
+ * @param opcoes Tamanho da partida
+ * @param semente Semente da partida
+ * @param antitetico true para usar a sequência de dados espelhada
+ * @param duracao Saída com o número de turnos jogados
+ * @return Índice do vencedor, ou -1 se o limite foi atingido
+ */
+int jogarPartidaComSemente(const Regras* regras, const OpcoesSimulacao* opcoes, uint64_t semente,
+                                  bool antitetico, int* duracao) {
+    GeradorAleatorio sorteio, dados, politica;
+    EstadoSimulacao estado;
+    
+    inicializarGerador(&sorteio, semente * 3);
+    inicializarGerador(&dados, semente * 3 + 1);
+    inicializarGerador(&politica, semente * 3 + 2);
+    dados.antitetico = antitetico;
+    
+    gerarPartidaAleatoria(&estado, regras, opcoes->numJogadores, opcoes->numTerritorios, &sorteio);
+    return simularPartidaAleatoria(&estado, regras, &dados, &politica, ROLLOUT_MAX_TURNOS, duracao);
+}
+
+/**
+ * Exibe o resultado de um método de estimativa da diferença A - B
+ * 
+ * @param nome Nome do método
+ * @param diferenca Diferenças por replicação
+ * @param partidasPorReplicacao Partidas simuladas em cada replicação
+ * @param varianciaReferencia Variância por partida do método independente
+ */
+static void exibirMetodoComparacao(const char* nome, const EstatisticaAmostral* diferenca,
+                                   int partidasPorReplicacao, double varianciaReferencia) {
+    double variancia = varianciaAmostral(diferenca);
+    double erroPadrao = sqrt(variancia / diferenca->n);
+    // Custo de precisão: variância de uma replicação vezes partidas gastas nela
+    double varianciaPorPartida = variancia * partidasPorReplicacao;
+    double eficiencia = (varianciaPorPartida > 0.0) ? varianciaReferencia / varianciaPorPartida : 0.0;
+    
+    printf("   %-26s %+9.4f ± %.4f   (%ld partidas, eficiência %.1fx)\n",
+           nome, diferenca->media, 1.96 * erroPadrao,
+           diferenca->n * partidasPorReplicacao, eficiencia);
+}
+
+/**
+ * Junta a estatística de um bloco de amostras à acumulada (Chan et al.)
+ * 
+ * @param estatistica Estatística acumulada
+ * @param parte Estatística do bloco
+ */
+static void combinarAmostras(EstatisticaAmostral* estatistica, const EstatisticaAmostral* parte) {
+    if (parte->n == 0) {
+        return;
+    }
+    long n = estatistica->n + parte->n;
+    double delta = parte->media - estatistica->media;
+    estatistica->m2 += parte->m2 + delta * delta * ((double)estatistica->n * parte->n / n);
+    estatistica->media += delta * parte->n / n;
+    estatistica->n = n;
+}
+
+/*
+ * Struct: BlocoComparacao
+ *
+ * Tarefa do pool com as replicações [inicio, fim) da comparação de
+ * variantes e as estatísticas só delas. Os blocos são combinados em
+ * ordem no final, então o resultado não depende das threads.
+ */
+typedef struct {
+    TarefaPool tarefa;
+    const Regras* regrasA;
+    const Regras* regrasB;
+    const OpcoesSimulacao* opcoes;
+    long inicio;
+    long fim;
+    EstatisticaAmostral vitoria[3];
+    EstatisticaAmostral duracao[3];
+} BlocoComparacao;
+
+/*
+ * Struct: TrabalhoComparacao
+ *
+ * Blocos da comparação, bifurcados pela raiz.
+ */
+typedef struct {
+    BlocoComparacao* blocos;
+    long numBlocos;
+} TrabalhoComparacao;
+
+/**
+ * Tarefa de um bloco de replicações da comparação de variantes
+ * 
+ * @param trabalhador Trabalhador do pool (não usado: o bloco é folha)
+ * @param argumento Ponteiro para o BlocoComparacao
+ */
+static void jogarBlocoComparacao(TrabalhadorPool* trabalhador, void* argumento) {
+    (void)trabalhador;
+    BlocoComparacao* bloco = (BlocoComparacao*)argumento;
+    const Regras* regrasA = bloco->regrasA;
+    const Regras* regrasB = bloco->regrasB;
+    const OpcoesSimulacao* opcoes = bloco->opcoes;
+    EstatisticaAmostral* vitoria = bloco->vitoria;
+    EstatisticaAmostral* duracao = bloco->duracao;
+    
+    for (long r = bloco->inicio; r < bloco->fim; r++) {
+        uint64_t semente = opcoes->semente + (uint64_t)r * 2;
+        int duracaoA, duracaoB, duracaoA2, duracaoB2;
+        int vencedorA, vencedorB, vencedorA2, vencedorB2;
+        
+        // Independente: cada variante com sua própria semente
+        vencedorA = jogarPartidaComSemente(regrasA, opcoes, semente, false, &duracaoA);
+        vencedorB = jogarPartidaComSemente(regrasB, opcoes, semente + 1, false, &duracaoB);
+        acumularAmostra(&vitoria[0], (vencedorA == 0) - (vencedorB == 0));
+        acumularAmostra(&duracao[0], duracaoA - duracaoB);
+        
+        // Números aleatórios comuns: B reutiliza a semente de A
+        vencedorB = jogarPartidaComSemente(regrasB, opcoes, semente, false, &duracaoB);
+        acumularAmostra(&vitoria[1], (vencedorA == 0) - (vencedorB == 0));
+        acumularAmostra(&duracao[1], duracaoA - duracaoB);
+        
+        // Comuns + antitéticos: par espelhado da mesma semente, metade das
+        // replicações para gastar o mesmo número de partidas
+        if ((r & 1) == 0) {
+            vencedorA2 = jogarPartidaComSemente(regrasA, opcoes, semente, true, &duracaoA2);
+            vencedorB2 = jogarPartidaComSemente(regrasB, opcoes, semente, true, &duracaoB2);
+            acumularAmostra(&vitoria[2], 0.5 * (((vencedorA == 0) - (vencedorB == 0)) +
+                                                ((vencedorA2 == 0) - (vencedorB2 == 0))));
+            acumularAmostra(&duracao[2], 0.5 * ((duracaoA - duracaoB) + (duracaoA2 - duracaoB2)));
+        }
+    }
+}
+
+/**
+ * Raiz da comparação: bifurca os blocos de replicações
+ * 
+ * @param trabalhador Trabalhador 0 do pool
+ * @param argumento Ponteiro para o TrabalhoComparacao
+ */
+static void executarRaizComparacao(TrabalhadorPool* trabalhador, void* argumento) {
+    TrabalhoComparacao* trabalho = (TrabalhoComparacao*)argumento;
+    GrupoTarefas grupo;
+    atomic_init(&grupo.pendentes, 0);
+    
+    for (long b = 0; b < trabalho->numBlocos; b++) {
+        bifurcarTarefa(trabalhador, &grupo, &trabalho->blocos[b].tarefa);
+    }
+    aguardarGrupo(trabalhador, &grupo);
+}
+
+/**
+ * Compara duas variantes de regras por simulação
+ * 
+ * Estima a diferença A - B na chance de vitória do primeiro jogador e
+ * na duração média das partidas com três métodos:
+ * - independente: sementes diferentes para A e B
+ * - números aleatórios comuns: mesma semente (mesmos dados) para A e B
+ * - comuns + antitéticos: cada semente também é jogada com os dados
+ *   espelhados, e as duas diferenças são promediadas
+ * A eficiência indica quantas vezes menos partidas o método precisa
+ * para a mesma precisão do método independente. As replicações são
+ * jogadas em blocos de COMPARACAO_BLOCO no pool de roubo de tarefas.
+ * 
+ * @param regrasA Primeira variante
+ * @param regrasB Segunda variante
+ * @param opcoes Número de partidas e tamanho do mapa
+ * @param numThreads Trabalhadores paralelos
+ */
+void compararVariantes(const Regras* regrasA, const Regras* regrasB, const OpcoesSimulacao* opcoes,
+                       int numThreads) {
+    EstatisticaAmostral vitoria[3], duracao[3];
+    long replicacoes = opcoes->numJogos / 2;
+    TrabalhoComparacao trabalho;
+    
+    memset(vitoria, 0, sizeof(vitoria));
+    memset(duracao, 0, sizeof(duracao));
+    trabalho.numBlocos = (replicacoes + COMPARACAO_BLOCO - 1) / COMPARACAO_BLOCO;
+    trabalho.blocos = (BlocoComparacao*)calloc(trabalho.numBlocos > 0 ? trabalho.numBlocos : 1,
+                                               sizeof(BlocoComparacao));
+    PoolTrabalho* pool = criarPoolTrabalho(numThreads, opcoes->semente, 0, opcoes->numaIngenuo);
+    if (trabalho.blocos == NULL || pool == NULL) {
+        printf("❌ Erro: Falha na alocação de memória para a comparação!\n");
+        free(trabalho.blocos);
+        liberarPoolTrabalho(pool);
+        return;
+    }
+    for (long b = 0; b < trabalho.numBlocos; b++) {
+        BlocoComparacao* bloco = &trabalho.blocos[b];
+        bloco->tarefa.executar = jogarBlocoComparacao;
+        bloco->tarefa.argumento = bloco;
+        bloco->regrasA = regrasA;
+        bloco->regrasB = regrasB;
+        bloco->opcoes = opcoes;
+        bloco->inicio = b * COMPARACAO_BLOCO;
+        bloco->fim = (bloco->inicio + COMPARACAO_BLOCO < replicacoes) ? bloco->inicio + COMPARACAO_BLOCO
+                                                                      : replicacoes;
+    }
+    
+    printf("\n🧪 ═══════════════════════════════════════════════════════════\n");
+    printf("              COMPARAÇÃO DE VARIANTES DE REGRAS\n");
+    printf("═══════════════════════════════════════════════════════════🧪\n");
+    printf("🅰️  Transferência: tropas / %d\n", regrasA->divisorTransferencia);
+    printf("🅱️  Transferência: tropas / %d\n", regrasB->divisorTransferencia);
+    printf("🗺️  %d jogadores, %d territórios, %ld partidas por método, %d threads\n",
+           opcoes->numJogadores, opcoes->numTerritorios, replicacoes * 2, pool->iniciados + 1);
+    
+    executarRaizPool(pool, executarRaizComparacao, &trabalho);
+    liberarPoolTrabalho(pool);
+    for (long b = 0; b < trabalho.numBlocos; b++) {
+        for (int m = 0; m < 3; m++) {
+            combinarAmostras(&vitoria[m], &trabalho.blocos[b].vitoria[m]);
+            combinarAmostras(&duracao[m], &trabalho.blocos[b].duracao[m]);
+        }
+    }
+    free(trabalho.blocos);
+    
+    double referenciaVitoria = varianciaAmostral(&vitoria[0]) * 2;
+    double referenciaDuracao = varianciaAmostral(&duracao[0]) * 2;
+    
+    printf("\n🏆 Diferença na chance de vitória do jogador 1 (A - B, IC 95%%):\n");
+    exibirMetodoComparacao("Independente", &vitoria[0], 2, referenciaVitoria);
+    exibirMetodoComparacao("Números comuns", &vitoria[1], 2, referenciaVitoria);
+    exibirMetodoComparacao("Comuns + antitéticos", &vitoria[2], 4, referenciaVitoria);
+    
+    printf("\n⏱️  Diferença na duração em turnos (A - B, IC 95%%):\n");
+    exibirMetodoComparacao("Independente", &duracao[0], 2, referenciaDuracao);
+    exibirMetodoComparacao("Números comuns", &duracao[1], 2, referenciaDuracao);
+    exibirMetodoComparacao("Comuns + antitéticos", &duracao[2], 4, referenciaDuracao);
+}
+
+// ============================================================================
+// IMPLEMENTAÇÃO DAS FUNÇÕES - MODOS DE LINHA DE COMANDO
+// ============================================================================
+
+/**
+ * Exibe as opções aceitas na linha de comando
+ * 
+ * @param programa Nome do executável
+ */
+static void exibirUsoLinhaComando(const char* programa) {
+    printf("Uso: %s [modo] [opções]\n", programa);
+    printf("Sem argumentos inicia o jogo interativo.\n\n");
+    printf("Modos:\n");
+    printf("  --comparar D     Compara transferência tropas/2 com tropas/D\n");
+    printf("  --varredura grade|K  Avalia a grade de regras ou K conjuntos sorteados\n");
+    printf("  --sprt grade|K   Compara as regras oficiais com cada conjunto, parando\n");
+    printf("                   cada comparação assim que o teste sequencial decidir\n");
+    printf("                   (--jogos passa a ser o limite de pares por comparação)\n");
+    printf("  --resolver ARQ   Resolve mapas de 2 jogadores e grava a tabela final\n");
+    printf("  --consultar ARQ  Consulta a tabela final em partidas sorteadas\n");
+    printf("  --bots A,B,...   Partidas só entre bots (aleatorio, estrategista,\n");
+    printf("                   tabela:ARQ, mcts[:THREADS:MS:MB],\n");
+    printf("                   expectimax[:NOS:PROFUNDIDADE[:PESOS]], rede[:PESOS],\n");
+    printf("                   heuristico[:P1:P2:P3:P4]),\n");
+    printf("                   um bot por jogador\n");
+    printf("  --autojogo DIR   Gera amostras (estado, ataque, vencedor) em arquivos\n");
+    printf("                   binários DIR/amostras-TT-NNNN.bin, uma partida por vez\n");
+    printf("                   em cada thread\n");
+    printf("  --rede ARQ|padrao  Mede e confere o avaliador neural com os pesos do\n");
+    printf("                   arquivo ou com pesos sorteados\n");
+    printf("  --lote-rede ARQ|padrao  Partidas do bot rede avaliadas uma a uma e\n");
+    printf("                   em lotes de %d posições, comparando a vazão\n", LOTE_TAMANHO);
+    printf("  --torneio A,B,...  Torneio todos contra todos (2 jogadores) com ratings\n");
+    printf("                   Glicko-2 atualizados a cada partida e placar ao vivo\n");
+    printf("  --motor TIPO     Partidas do motor completo (um contexto por partida) com\n");
+    printf("                   o bot TIPO em todos os jogadores, medindo a vazão com\n");
+    printf("                   1, 2, 4... threads até --threads\n");
+    printf("  --fibras TIPO    Hospeda --jogos partidas simultâneas em fibras sobre\n");
+    printf("                   --threads threads; cada decisão espera até --pensar-ms\n");
+    printf("                   e é tomada pelo bot TIPO (aleatorio, estrategista,\n");
+    printf("                   heuristico)\n");
+    printf("  --simultaneo TIPO Rodadas em que todos os jogadores (bot TIPO) enviam\n");
+    printf("                   até %d ordens; batalhas sem territórios em comum são\n", ORDENS_POR_JOGADOR);
+    printf("                   resolvidas em paralelo, com o mesmo resultado para\n");
+    printf("                   qualquer --threads\n");
+    printf("  --mapa-massivo N Mapa em grade com N territórios dividido em faixas, uma\n");
+    printf("                   por thread; só as bordas que mudam passam entre vizinhos\n");
+    printf("                   (--turnos turnos), medido com 1, 2, 4... threads até\n");
+    printf("                   --threads, com o mesmo resultado em todas\n");
+    printf("  --bancada-numa N Mapa massivo de N territórios e partidas simultâneas\n");
+    printf("                   com posicionamento ingênuo e local, comparando tempo\n");
+    printf("                   e páginas fora do nó NUMA de cada thread\n");
+    printf("  --servidor SOCK  Servidor de partidas no socket Unix SOCK (protocolo\n");
+    printf("                   binário, --backend + --threads trabalhadores; Ctrl+C encerra)\n");
+    printf("  --carga SOCK     Gerador de carga: --jogos partidas contra o servidor em\n");
+    printf("                   --conexoes conexões, bot --politica, medindo a latência\n");
+    printf("  --ajuste ARQ     Ajusta os pesos do bot heurístico (SPSA) contra a\n");
+    printf("                   política, --jogos partidas por candidato; o progresso\n");
+    printf("                   fica em ARQ e uma nova execução continua de onde parou\n");
+    printf("\nOpções:\n");
+    printf("  --jogos N        Partidas simuladas (padrão: %d)\n", SIM_JOGOS_PADRAO);
+    printf("  --jogadores N    Jogadores por partida (%d-%d, padrão: %d)\n",
+           MIN_JOGADORES, MAX_JOGADORES, SIM_JOGADORES_PADRAO);
+    printf("  --territorios N  Territórios por partida (%d-%d, padrão: %d)\n",
+           MIN_TERRITORIOS, MAX_TERRITORIOS, SIM_TERRITORIOS_PADRAO);
+    printf("  --semente N      Semente das simulações (padrão: relógio)\n");
+    printf("  --threads N      Threads de simulação (padrão: núcleos disponíveis)\n");
+    printf("  --missoes A,B    Missões dos 2 jogadores na tabela final (1-%d, padrão: 2,2)\n", TOTAL_MISSOES);
+    printf("  --politica TIPO  Bot de todos os jogadores no autojogo e na carga e\n");
+    printf("                   adversário no ajuste (padrão: estrategista)\n");
+    printf("  --geracoes N     Gerações do ajuste (padrão: %d)\n", AJUSTE_GERACOES_PADRAO);
+    printf("  --shard-mb N     Tamanho máximo de cada arquivo do autojogo (padrão: %d)\n",
+           AUTOJOGO_SHARD_PADRAO_MB);
+    printf("  --prazo-ms N     Prazo por jogada dos bots de busca em --bots (padrão: sem prazo)\n");
+    printf("  --pensar-ms N    Espera máxima por decisão em --fibras (padrão: %d)\n", FIBRA_PENSAR_PADRAO_MS);
+    printf("  --conexoes N     Conexões simultâneas do gerador de carga (padrão: %d)\n", CARGA_CONEXOES_PADRAO);
+    printf("  --backend TIPO   Laço do servidor: auto, epoll ou io_uring (padrão: auto)\n");
+    printf("  --diario ARQ     Diário binário dos comandos do servidor (padrão: sem diário)\n");
+    printf("  --turnos N       Turnos do mapa massivo (padrão: %d)\n", MASSIVO_TURNOS_PADRAO);
+    printf("  --numa TIPO      local (threads fixadas, memória no próprio nó) ou\n");
+    printf("                   ingenuo (threads soltas, como antes) nos trabalhadores de\n");
+    printf("                   simulação (padrão: local)\n");
+}
+
+/**
+ * Interpreta os argumentos e executa o modo de simulação pedido
+ * 
+ * @param argc Número de argumentos
+ * @param argv Argumentos da linha de comando
+ * @return 0 se execução foi bem-sucedida, 1 em caso de erro
+ */
+int executarModoLinhaComando(int argc, char* argv[]) {
+    OpcoesSimulacao opcoes = {
+        .numJogos = SIM_JOGOS_PADRAO,
+        .numJogadores = SIM_JOGADORES_PADRAO,
+        .numTerritorios = SIM_TERRITORIOS_PADRAO,
+        .semente = (uint64_t)time(NULL)
+    };
+    const char* modo = NULL;
+    const char* argumentoModo = NULL;
+    long parametroModo = 0;
+    int numThreads = contarNucleos();
+    int missoes[2] = {MISSAO_DOMINACAO, MISSAO_DOMINACAO};
+    bool territoriosInformados = false;
+    const char* politica = "estrategista";
+    long limiteShardMB = AUTOJOGO_SHARD_PADRAO_MB;
+    long prazoMs = 0;
+    long geracoes = AJUSTE_GERACOES_PADRAO;
+    long pensarMs = FIBRA_PENSAR_PADRAO_MS;
+    long conexoes = CARGA_CONEXOES_PADRAO;
+    const char* backend = "auto";
+    const char* arquivoDiario = NULL;
+    long turnos = MASSIVO_TURNOS_PADRAO;
+    const char* numa = "local";
+    
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool temValor = (i + 1 < argc);
+        
+        if ((strcmp(arg, "--comparar") == 0 || strcmp(arg, "--mapa-massivo") == 0 ||
+             strcmp(arg, "--bancada-numa") == 0) && temValor) {
+            modo = arg;
+            parametroModo = strtol(argv[++i], NULL, 10);
+        } else if ((strcmp(arg, "--varredura") == 0 || strcmp(arg, "--sprt") == 0) && temValor) {
+            modo = arg;
+            argumentoModo = argv[++i];
+        } else if ((strcmp(arg, "--resolver") == 0 || strcmp(arg, "--consultar") == 0 ||
+                    strcmp(arg, "--bots") == 0 || strcmp(arg, "--autojogo") == 0 ||
+                    strcmp(arg, "--rede") == 0 || strcmp(arg, "--lote-rede") == 0 ||
+                    strcmp(arg, "--ajuste") == 0 || strcmp(arg, "--torneio") == 0 ||
+                    strcmp(arg, "--motor") == 0 || strcmp(arg, "--fibras") == 0 ||
+                    strcmp(arg, "--servidor") == 0 || strcmp(arg, "--carga") == 0 ||
+                    strcmp(arg, "--simultaneo") == 0) && temValor) {
+            modo = arg;
+            argumentoModo = argv[++i];
+        } else if (strcmp(arg, "--missoes") == 0 && temValor) {
+            if (sscanf(argv[++i], "%d,%d", &missoes[0], &missoes[1]) != 2 ||
+                missoes[0] < 1 || missoes[0] > TOTAL_MISSOES || missoes[1] < 1 || missoes[1] > TOTAL_MISSOES) {
+                printf("❌ Missões inválidas: %s\n", argv[i]);
+                return 1;
+            }
+            missoes[0]--; // Converter para índice 0-based
+            missoes[1]--;
+        } else if (strcmp(arg, "--politica") == 0 && temValor) {
+            politica = argv[++i];
+        } else if (strcmp(arg, "--geracoes") == 0 && temValor) {
+            geracoes = strtol(argv[++i], NULL, 10);
+        } else if (strcmp(arg, "--prazo-ms") == 0 && temValor) {
+            prazoMs = strtol(argv[++i], NULL, 10);
+        } else if (strcmp(arg, "--pensar-ms") == 0 && temValor) {
+            pensarMs = strtol(argv[++i], NULL, 10);
+        } else if (strcmp(arg, "--conexoes") == 0 && temValor) {
+            conexoes = strtol(argv[++i], NULL, 10);
+        } else if (strcmp(arg, "--backend") == 0 && temValor) {
+            backend = argv[++i];
+        } else if (strcmp(arg, "--diario") == 0 && temValor) {
+            arquivoDiario = argv[++i];
+        } else if (strcmp(arg, "--turnos") == 0 && temValor) {
+            turnos = strtol(argv[++i], NULL, 10);
+        } else if (strcmp(arg, "--numa") == 0 && temValor) {
+            numa = argv[++i];
+        } else if (strcmp(arg, "--shard-mb") == 0 && temValor) {
+            limiteShardMB = strtol(argv[++i], NULL, 10);
+        } else if (strcmp(arg, "--threads") == 0 && temValor) {
+            numThreads = (int)strtol(argv[++i], NULL, 10);
+        } else if (strcmp(arg, "--jogos") == 0 && temValor) {
+            opcoes.numJogos = strtol(argv[++i], NULL, 10);
+        } else if (strcmp(arg, "--jogadores") == 0 && temValor) {
+            opcoes.numJogadores = (int)strtol(argv[++i], NULL, 10);
+        } else if (strcmp(arg, "--territorios") == 0 && temValor) {
+            opcoes.numTerritorios = (int)strtol(argv[++i], NULL, 10);
+            territoriosInformados = true;
+        } else if (strcmp(arg, "--semente") == 0 && temValor) {
+            opcoes.semente = strtoull(argv[++i], NULL, 10);
+        } else {
+            exibirUsoLinhaComando(argv[0]);
+            return 1;
+        }
+    }
+    
+    // Validar configurações (mesmos limites do jogo interativo)
+    if (opcoes.numJogadores < MIN_JOGADORES || opcoes.numJogadores > MAX_JOGADORES ||
+        opcoes.numTerritorios < MIN_TERRITORIOS || opcoes.numTerritorios > MAX_TERRITORIOS ||
+        opcoes.numTerritorios < opcoes.numJogadores || opcoes.numJogos < 2 || numThreads < 1 ||
+        limiteShardMB < 1 || prazoMs < 0 || geracoes < 1 || pensarMs < 0 ||
+        conexoes < 1 || turnos < 1 || turnos > INT32_MAX ||
+        (strcmp(numa, "local") != 0 && strcmp(numa, "ingenuo") != 0) ||
+        (strcmp(backend, "auto") != 0 && strcmp(backend, "epoll") != 0 && strcmp(backend, "io_uring") != 0)) {
+        printf("❌ Configuração inválida!\n");
+        exibirUsoLinhaComando(argv[0]);
+        return 1;
+    }
+    opcoes.numaIngenuo = strcmp(numa, "ingenuo") == 0;
+    
+    if (modo != NULL && strcmp(modo, "--comparar") == 0) {
+        if (parametroModo < 1) {
+            printf("❌ Divisor de transferência inválido: %ld\n", parametroModo);
+            return 1;
+        }
+        Regras variante = regrasPadrao;
+        variante.divisorTransferencia = (int)parametroModo;
+        compararVariantes(&regrasPadrao, &variante, &opcoes, numThreads);
+        return 0;
+    }
+    
+    if (modo != NULL && strcmp(modo, "--resolver") == 0) {
+        int numTerritorios = territoriosInformados ? opcoes.numTerritorios : MIN_TERRITORIOS;
+        return resolverTabelaFinal(argumentoModo, numTerritorios, missoes, &regrasPadrao, numThreads) ? 0 : 1;
+    }
+    
+    if (modo != NULL && strcmp(modo, "--bots") == 0) {
+        executarPartidasBots((char*)argumentoModo, &opcoes, prazoMs);
+        return 0;
+    }
+    
+    if (modo != NULL && strcmp(modo, "--rede") == 0) {
+        executarTesteRede(strcmp(argumentoModo, "padrao") == 0 ? NULL : argumentoModo, &opcoes);
+        return 0;
+    }
+    
+    if (modo != NULL && strcmp(modo, "--lote-rede") == 0) {
+        executarPartidasLoteRede(strcmp(argumentoModo, "padrao") == 0 ? NULL : argumentoModo, &opcoes);
+        return 0;
+    }
+    
+    if (modo != NULL && strcmp(modo, "--motor") == 0) {
+        executarEscalaMotor(argumentoModo, &opcoes, numThreads);
+        return 0;
+    }
+    
+    if (modo != NULL && strcmp(modo, "--fibras") == 0) {
+        executarFibras(argumentoModo, &opcoes, pensarMs, numThreads);
+        return 0;
+    }
+    
+    if (modo != NULL && strcmp(modo, "--simultaneo") == 0) {
+        executarSimultaneo(argumentoModo, &opcoes, numThreads, NULL);
+        return 0;
+    }
+    
+    if (modo != NULL && strcmp(modo, "--mapa-massivo") == 0) {
+        if (parametroModo < 1) {
+            printf("❌ Número de territórios inválido: %ld\n", parametroModo);
+            return 1;
+        }
+        executarMapaMassivo(parametroModo, (int)turnos, &opcoes, numThreads, NULL);
+        return 0;
+    }
+    
+    if (modo != NULL && strcmp(modo, "--bancada-numa") == 0) {
+        if (parametroModo < 1) {
+            printf("❌ Número de territórios inválido: %ld\n", parametroModo);
+            return 1;
+        }
+        executarBancadaNuma(parametroModo, (int)turnos, &opcoes, numThreads);
+        return 0;
+    }
+    
+    if (modo != NULL && strcmp(modo, "--servidor") == 0) {
+        return executarServidor(argumentoModo, numThreads, backend, arquivoDiario);
+    }
+    
+    if (modo != NULL && strcmp(modo, "--carga") == 0) {
+        executarCargaServidor(argumentoModo, politica, &opcoes, (int)conexoes, numThreads);
+        return 0;
+    }
+    
+    if (modo != NULL && strcmp(modo, "--torneio") == 0) {
+        executarTorneio((char*)argumentoModo, &opcoes, numThreads);
+        return 0;
+    }
+    
+    if (modo != NULL && strcmp(modo, "--ajuste") == 0) {
+        executarAjuste(argumentoModo, politica, (int)geracoes, &opcoes, numThreads);
+        return 0;
+    }
+    
+    if (modo != NULL && strcmp(modo, "--autojogo") == 0) {
+        executarAutojogo(argumentoModo, politica, (size_t)limiteShardMB, &opcoes, numThreads);
+        return 0;
+    }
+    
+    if (modo != NULL && strcmp(modo, "--consultar") == 0) {
+        TabelaFinal tabela;
+        if (!abrirTabelaFinal(&tabela, argumentoModo)) {
+            return 1;
+        }
+        exibirConsultasTabela(&tabela, &opcoes);
+        fecharTabelaFinal(&tabela);
+        return 0;
+    }
+    
+    if (modo != NULL && (strcmp(modo, "--varredura") == 0 || strcmp(modo, "--sprt") == 0)) {
+        static Regras conjuntos[VARREDURA_MAX_CONJUNTOS];
+        int numConjuntos;
+        
+        if (strcmp(argumentoModo, "grade") == 0) {
+            numConjuntos = montarGradeRegras(conjuntos, VARREDURA_MAX_CONJUNTOS);
+        } else {
+            char* fim;
+            long quantidade = strtol(argumentoModo, &fim, 10);
+            if (fim == argumentoModo || *fim != '\0' || quantidade < 1 || quantidade > VARREDURA_MAX_CONJUNTOS) {
+                printf("❌ Quantidade de conjuntos inválida: %s (use grade ou 1 a %d)\n",
+                       argumentoModo, VARREDURA_MAX_CONJUNTOS);
+                return 1;
+            }
+            GeradorAleatorio gerador;
+            inicializarGerador(&gerador, opcoes.semente ^ 0x5EEDULL);
+            numConjuntos = sortearConjuntosRegras(conjuntos, (int)quantidade, &gerador);
+        }
+        
+        if (numConjuntos <= 0) {
+            printf("❌ Nenhum conjunto de regras para avaliar!\n");
+            return 1;
+        }
+        if (strcmp(modo, "--sprt") == 0) {
+            executarComparacoesSequenciais(&regrasPadrao, conjuntos, numConjuntos, &opcoes, numThreads);
+        } else {
+            executarVarredura(conjuntos, numConjuntos, &opcoes, numThreads);
+        }
+        return 0;
+    }
+    
+    exibirUsoLinhaComando(argv[0]);
+    return 1;
+}
+
+// ============================================================================
+// IMPLEMENTAÇÃO DAS FUNÇÕES - POOL DE TRABALHO (ROUBO DE TAREFAS)
+// ============================================================================
+
+/**
+ * Empilha uma tarefa na base da deque (apenas o dono)
+ * 
+ * @param deque Deque do trabalhador atual
+ * @param tarefa Tarefa a empilhar
+ * @return false se a deque estiver cheia
+ */
+static bool empilharDeque(DequeTrabalho* deque, TarefaPool* tarefa) {
+    long base = atomic_load_explicit(&deque->base, memory_order_relaxed);
+    long topo = atomic_load_explicit(&deque->topo, memory_order_acquire);
+    if (base - topo >= POOL_CAPACIDADE_DEQUE) {
+        return false;
+    }
+    atomic_store_explicit(&deque->itens[base & (POOL_CAPACIDADE_DEQUE - 1)], tarefa, memory_order_relaxed);
+    atomic_store_explicit(&deque->base, base + 1, memory_order_release); // Publica a tarefa aos ladrões
+    return true;
+}
+
+/**
+ * Desempilha a tarefa mais recente da base (apenas o dono)
+ * 
+ * Só disputa com ladrões quando resta uma única tarefa.
+ * 
+ * @param deque Deque do trabalhador atual
+ * @return Tarefa retirada ou NULL se vazia
+ */
+static TarefaPool* desempilharDeque(DequeTrabalho* deque) {
+    long base = atomic_load_explicit(&deque->base, memory_order_relaxed) - 1;
+    atomic_store_explicit(&deque->base, base, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long topo = atomic_load_explicit(&deque->topo, memory_order_relaxed);
+    
+    if (topo > base) {
+        atomic_store_explicit(&deque->base, base + 1, memory_order_relaxed);
+        return NULL;
+    }
+    
+    TarefaPool* tarefa = atomic_load_explicit(&deque->itens[base & (POOL_CAPACIDADE_DEQUE - 1)],
+                                              memory_order_relaxed);
+    if (topo == base) {
+        if (!atomic_compare_exchange_strong_explicit(&deque->topo, &topo, topo + 1,
+                                                     memory_order_seq_cst, memory_order_relaxed)) {
+            tarefa = NULL; // Um ladrão levou a última tarefa
+        }
+        atomic_store_explicit(&deque->base, base + 1, memory_order_relaxed);
+    }
+    return tarefa;
+}
+
+/**
+ * Rouba a tarefa mais antiga do topo de outra deque
+ * 
+ * @param deque Deque da vítima
+ * @return Tarefa roubada ou NULL se vazia ou perdida para outro ladrão
+ */
+static TarefaPool* roubarDeque(DequeTrabalho* deque) {
+    long topo = atomic_load_explicit(&deque->topo, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long base = atomic_load_explicit(&deque->base, memory_order_acquire);
+    
+    if (topo >= base) {
+        return NULL;
+    }
+    TarefaPool* tarefa = atomic_load_explicit(&deque->itens[topo & (POOL_CAPACIDADE_DEQUE - 1)],
+                                              memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&deque->topo, &topo, topo + 1,
+                                                 memory_order_seq_cst, memory_order_relaxed)) {
+        return NULL;
+    }
+    return tarefa;
+}
+
+/**
+ * Executa uma tarefa e avisa o grupo dela
+ * 
+ * @param trabalhador Trabalhador que executa
+ * @param tarefa Tarefa a executar
+ */
+static void executarTarefaPool(TrabalhadorPool* trabalhador, TarefaPool* tarefa) {
+    GrupoTarefas* grupo = tarefa->grupo;
+    tarefa->executar(trabalhador, tarefa->argumento);
+    trabalhador->executadas++;
+    trabalhador->no = noDaThreadAtual();
+    atomic_fetch_sub_explicit(&grupo->pendentes, 1, memory_order_release);
+}
+
+/**
+ * Procura trabalho: primeiro na própria deque, depois roubando
+ * 
+ * As vítimas são percorridas a partir de uma posição sorteada, o que
+ * espalha os ladrões e evita que todos disputem o mesmo topo.
+ * 
+ * @param trabalhador Trabalhador atual
+ * @return Tarefa encontrada ou NULL
+ */
+static TarefaPool* procurarTarefaPool(TrabalhadorPool* trabalhador) {
+    PoolTrabalho* pool = trabalhador->pool;
+    TarefaPool* tarefa = desempilharDeque(&trabalhador->deque);
+    if (tarefa != NULL || pool->numTrabalhadores < 2) {
+        return tarefa;
+    }
+    
+    int inicio = sortearIntervalo(&trabalhador->gerador, pool->numTrabalhadores);
+    for (int i = 0; i < pool->numTrabalhadores; i++) {
+        int vitima = (inicio + i) % pool->numTrabalhadores;
+        if (vitima == trabalhador->indice) continue;
+        tarefa = roubarDeque(&pool->trabalhadores[vitima].deque);
+        if (tarefa != NULL) {
+            trabalhador->roubadas++;
+            return tarefa;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Prepara a memória de um trabalhador (deque, gerador e estatísticas)
+ * 
+ * Com posicionamento local roda na thread do trabalhador, depois de
+ * fixá-la num núcleo: as páginas são tocadas primeiro ali e o kernel as
+ * coloca no nó desse núcleo.
+ * 
+ * @param pool Pool do trabalhador
+ * @param indice Índice do trabalhador (local fica NULL se faltar memória)
+ */
+static void prepararTrabalhadorPool(PoolTrabalho* pool, int indice) {
+    TrabalhadorPool* trabalhador = &pool->trabalhadores[indice];
+    
+    memset(&trabalhador->deque, 0, sizeof(trabalhador->deque));
+    atomic_init(&trabalhador->deque.topo, 0);
+    atomic_init(&trabalhador->deque.base, 0);
+    trabalhador->pool = pool;
+    trabalhador->indice = indice;
+    trabalhador->executadas = 0;
+    trabalhador->roubadas = 0;
+    trabalhador->no = noDaThreadAtual();
+    inicializarGerador(&trabalhador->gerador, pool->semente + (uint64_t)indice);
+    if (pool->tamanhoLocal == 0) {
+        trabalhador->local = NULL;
+    } else if (pool->ingenuo) {
+        trabalhador->local = (char*)pool->locaisIngenuos + pool->tamanhoLocal * indice;
+    } else {
+        size_t tamanho = (pool->tamanhoLocal + TT_LINHA_CACHE - 1) / TT_LINHA_CACHE * TT_LINHA_CACHE;
+        trabalhador->local = aligned_alloc(TT_LINHA_CACHE, tamanho);
+        if (trabalhador->local != NULL) {
+            memset(trabalhador->local, 0, tamanho);
+        }
+    }
+}
+
+/**
+ * Registra no trabalhador a pilha da thread chamadora
+ * 
+ * @param trabalhador Trabalhador que a thread executa
+ */
+static void registrarPilhaTrabalhador(TrabalhadorPool* trabalhador) {
+    pthread_attr_t atributos;
+    trabalhador->pilha = NULL;
+    trabalhador->tamanhoPilha = 0;
+    if (pthread_getattr_np(pthread_self(), &atributos) == 0) {
+        pthread_attr_getstack(&atributos, &trabalhador->pilha, &trabalhador->tamanhoPilha);
+        pthread_attr_destroy(&atributos);
+    }
+}
+
+/**
+ * Corpo dos trabalhadores em segundo plano
+ * 
+ * Rouba tarefas enquanto houver uma raiz ativa; sem raiz, dorme em
+ * pausas curtas para não ocupar núcleos entre simulações.
+ * 
+ * @param argumento Ponteiro para o PoolTrabalho
+ * @return NULL
+ */
+static void* executarTrabalhadorPool(void* argumento) {
+    PoolTrabalho* pool = (PoolTrabalho*)argumento;
+    int indice = atomic_fetch_add_explicit(&pool->proximoIndice, 1, memory_order_relaxed);
+    TrabalhadorPool* trabalhador = &pool->trabalhadores[indice];
+    struct timespec pausa = {0, POOL_PAUSA_NS};
+    
+    // Com posicionamento local ninguém tocou as páginas deste trabalhador até aqui
+    if (!pool->ingenuo) {
+        fixarThreadNucleo(indice, pool->numTrabalhadores, NULL);
+        prepararTrabalhadorPool(pool, indice);
+    }
+    registrarPilhaTrabalhador(trabalhador);
+    atomic_fetch_add_explicit(&pool->prontos, 1, memory_order_release);
+    while (!atomic_load_explicit(&pool->liberados, memory_order_acquire)) {
+        sched_yield();
+    }
+    
+    while (!atomic_load_explicit(&pool->encerrar, memory_order_acquire)) {
+        TarefaPool* tarefa = procurarTarefaPool(trabalhador);
+        if (tarefa != NULL) {
+            executarTarefaPool(trabalhador, tarefa);
+        } else if (atomic_load_explicit(&pool->raizesAtivas, memory_order_relaxed) > 0) {
+            sched_yield();
+        } else {
+            nanosleep(&pausa, NULL);
+        }
+    }
+    trabalhador->no = noDaThreadAtual();
+    return NULL;
+}
+
+/**
+ * Cria o pool e inicia os trabalhadores em segundo plano
+ * 
+ * Os trabalhadores ficam num mapeamento anônimo, uma faixa de páginas
+ * para cada. Com posicionamento local cada um se fixa num núcleo
+ * (trabalhadores vizinhos no mesmo nó) e prepara a própria faixa; a
+ * criação só retorna quando todos estiverem prontos. No modo ingênuo a
+ * thread criadora prepara tudo, como antes, e ninguém é fixado.
+ * 
+ * @param numTrabalhadores Trabalhadores incluindo a thread chamadora
+ * @param semente Semente dos sorteios de vítimas (não afeta resultados)
+ * @param tamanhoLocal Bytes de estatísticas por trabalhador (0 sem estatísticas)
+ * @param ingenuo Sem fixar núcleos nem preparar a memória no nó do trabalhador
+ * @return Pool criado ou NULL em falha de alocação
+ */
+PoolTrabalho* criarPoolTrabalho(int numTrabalhadores, uint64_t semente, size_t tamanhoLocal, bool ingenuo) {
+    if (numTrabalhadores < 1) numTrabalhadores = 1;
+    if (numTrabalhadores > MAX_THREADS) numTrabalhadores = MAX_THREADS;
+    
+    PoolTrabalho* pool = (PoolTrabalho*)calloc(1, sizeof(PoolTrabalho));
+    if (pool == NULL) {
+        return NULL;
+    }
+    pool->tamanhoMapeado = sizeof(TrabalhadorPool) * numTrabalhadores;
+    void* mapeamento = mmap(NULL, pool->tamanhoMapeado, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ingenuo && tamanhoLocal > 0) {
+        pool->locaisIngenuos = calloc(numTrabalhadores, tamanhoLocal);
+    }
+    if (mapeamento == MAP_FAILED || (ingenuo && tamanhoLocal > 0 && pool->locaisIngenuos == NULL)) {
+        if (mapeamento != MAP_FAILED) munmap(mapeamento, pool->tamanhoMapeado);
+        free(pool->locaisIngenuos);
+        free(pool);
+        return NULL;
+    }
+    
+    pool->trabalhadores = (TrabalhadorPool*)mapeamento;
+    pool->numTrabalhadores = numTrabalhadores;
+    pool->tamanhoLocal = tamanhoLocal;
+    pool->ingenuo = ingenuo;
+    pool->semente = semente;
+    atomic_init(&pool->encerrar, false);
+    atomic_init(&pool->raizesAtivas, 0);
+    atomic_init(&pool->proximoIndice, 1);
+    atomic_init(&pool->prontos, 0);
+    atomic_init(&pool->liberados, ingenuo);
+    
+    if (ingenuo) {
+        for (int i = 0; i < numTrabalhadores; i++) {
+            prepararTrabalhadorPool(pool, i);
+        }
+    } else {
+        // A thread chamadora é o trabalhador 0; a afinidade dela volta ao liberar o pool
+        pool->fixouPrincipal = fixarThreadNucleo(0, numTrabalhadores, &pool->afinidadePrincipal) >= 0;
+        prepararTrabalhadorPool(pool, 0);
+    }
+    registrarPilhaTrabalhador(&pool->trabalhadores[0]);
+    
+    // Trabalhadores que não iniciarem ficam com a deque sempre vazia (páginas zeradas)
+    for (int i = 1; i < numTrabalhadores; i++) {
+        if (pthread_create(&pool->threads[i], NULL, executarTrabalhadorPool, pool) != 0) {
+            break;
+        }
+        pool->iniciados++;
+    }
+    // No modo ingênuo já estão liberados; a espera só garante as pilhas registradas
+    while (atomic_load_explicit(&pool->prontos, memory_order_acquire) < pool->iniciados) {
+        sched_yield();
+    }
+    atomic_store_explicit(&pool->liberados, true, memory_order_release);
+    for (int i = 0; i <= pool->iniciados; i++) {
+        if (tamanhoLocal > 0 && pool->trabalhadores[i].local == NULL) {
+            liberarPoolTrabalho(pool);
+            return NULL;
+        }
+    }
+    return pool;
+}
+
+/**
+ * Executa uma tarefa raiz na thread chamadora (trabalhador 0)
+ * 
+ * A raiz bifurca subtarefas e as aguarda; os demais trabalhadores
+ * roubam o que ela e as subtarefas empilharem. Apenas uma raiz por
+ * vez, sempre a partir da mesma thread que criou o pool.
+ * 
+ * @param pool Pool de trabalho
+ * @param executar Corpo da raiz
+ * @param argumento Dados da raiz
+ */
+void executarRaizPool(PoolTrabalho* pool, void (*executar)(TrabalhadorPool*, void*), void* argumento) {
+    atomic_store_explicit(&pool->raizesAtivas, 1, memory_order_relaxed);
+    executar(&pool->trabalhadores[0], argumento);
+    atomic_store_explicit(&pool->raizesAtivas, 0, memory_order_relaxed);
+    pool->trabalhadores[0].no = noDaThreadAtual();
+}
+
+/**
+ * Bifurca uma tarefa (fork)
+ * 
+ * A tarefa vai para a deque do trabalhador atual, de onde ele mesmo a
+ * retoma ou outro trabalhador a rouba. Com a deque cheia, executa na
+ * hora, o que mantém a memória limitada em recursões profundas.
+ * 
+ * @param trabalhador Trabalhador que está executando o pai
+ * @param grupo Grupo que o pai vai aguardar
+ * @param tarefa Tarefa preenchida com executar e argumento
+ */
+void bifurcarTarefa(TrabalhadorPool* trabalhador, GrupoTarefas* grupo, TarefaPool* tarefa) {
+    tarefa->grupo = grupo;
+    atomic_fetch_add_explicit(&grupo->pendentes, 1, memory_order_relaxed);
+    if (!empilharDeque(&trabalhador->deque, tarefa)) {
+        executarTarefaPool(trabalhador, tarefa);
+    }
+}
+
+/**
+ * Aguarda todas as tarefas do grupo (join)
+ * 
+ * Em vez de bloquear, o trabalhador executa tarefas da própria deque e
+ * rouba das outras até o grupo terminar: é isso que equilibra
+ * paralelismo aninhado sem trava central.
+ * 
+ * @param trabalhador Trabalhador que está executando o pai
+ * @param grupo Grupo a aguardar
+ */
+void aguardarGrupo(TrabalhadorPool* trabalhador, GrupoTarefas* grupo) {
+    while (atomic_load_explicit(&grupo->pendentes, memory_order_acquire) > 0) {
+        TarefaPool* tarefa = procurarTarefaPool(trabalhador);
+        if (tarefa != NULL) {
+            executarTarefaPool(trabalhador, tarefa);
+        } else {
+            sched_yield();
+        }
+    }
+}
+
+/**
+ * Encerra os trabalhadores e libera o pool
+ * 
+ * @param pool Pool sem raiz ativa (NULL é ignorado)
+ */
+void liberarPoolTrabalho(PoolTrabalho* pool) {
+    if (pool == NULL) return;
+    atomic_store_explicit(&pool->encerrar, true, memory_order_release);
+    for (int i = 1; i <= pool->iniciados; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    if (!pool->ingenuo) {
+        for (int i = 0; i <= pool->iniciados; i++) {
+            free(pool->trabalhadores[i].local);
+        }
+    }
+    if (pool->fixouPrincipal) {
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &pool->afinidadePrincipal);
+    }
+    munmap(pool->trabalhadores, pool->tamanhoMapeado);
+    free(pool->locaisIngenuos);
+    free(pool);
+}
+
+/**
+ * Conta as páginas dos trabalhadores que estão fora do nó deles
+ * 
+ * Considera a pilha de cada trabalhador, onde ficam as partidas e as
+ * cópias do mapa das tarefas que ele executou (só páginas tocadas
+ * entram na conta), além da sua faixa no pool (deque e gerador) e das
+ * estatísticas locais, comparadas com o nó da última tarefa dele.
+ * 
+ * @param pool Pool depois de executar alguma raiz
+ * @param paginas Saída: páginas consultadas
+ * @return Páginas em outro nó, ou -1 se o kernel não informa o nó das páginas
+ */
+long contarPaginasRemotasPool(const PoolTrabalho* pool, long* paginas) {
+    long remotas = 0;
+    *paginas = 0;
+    for (int i = 0; i <= pool->iniciados; i++) {
+        const TrabalhadorPool* trabalhador = &pool->trabalhadores[i];
+        long total;
+        long fora = contarPaginasRemotas(trabalhador, sizeof(TrabalhadorPool), trabalhador->no, &total);
+        if (fora < 0) {
+            return -1;
+        }
+        remotas += fora;
+        *paginas += total;
+        if (trabalhador->local != NULL) {
+            fora = contarPaginasRemotas(trabalhador->local, pool->tamanhoLocal, trabalhador->no, &total);
+            remotas += (fora > 0) ? fora : 0;
+            *paginas += total;
+        }
+        if (trabalhador->pilha != NULL) {
+            fora = contarPaginasRemotas(trabalhador->pilha, trabalhador->tamanhoPilha, trabalhador->no, &total);
+            remotas += (fora > 0) ? fora : 0;
+            *paginas += total;
+        }
+    }
+    return remotas;
+}
+
+// ============================================================================
+// IMPLEMENTAÇÃO DAS FUNÇÕES - VARREDURA PARALELA DE PARÂMETROS
+// ============================================================================
+
+/*
+ * Struct: TrabalhoVarredura
+ *
+ * Dados compartilhados da varredura. A raiz bifurca uma tarefa por
+ * conjunto de regras e cada conjunto bifurca seus blocos de
+ * VARREDURA_BLOCO partidas no pool de roubo de tarefas.
+ */
+typedef struct {
+    ResultadoVarredura* resultados;
+    int numConjuntos;
+    int blocosPorConjunto;
+    const OpcoesSimulacao* opcoes;
+    struct ItemVarredura* itens;    // Um item por conjunto seguido dos blocos
+    pthread_mutex_t saida;      // Serializa apenas a impressão dos resultados
+} TrabalhoVarredura;
+
+/*
+ * Struct: ItemVarredura
+ *
+ * Tarefa do pool para um conjunto inteiro (bloco < 0) ou para um bloco.
+ */
+typedef struct ItemVarredura {
+    TarefaPool tarefa;
+    TrabalhoVarredura* trabalho;
+    int conjunto;
+    long bloco;
+} ItemVarredura;
+
+/**
+ * Número de núcleos disponíveis para as simulações
+ * 
+ * @return Núcleos online (mínimo 1)
+ */
+int contarNucleos(void) {
+    long nucleos = sysconf(_SC_NPROCESSORS_ONLN);
+    return (nucleos > 0) ? (int)nucleos : 1;
+}
+
+/**
+ * Monta a grade padrão de conjuntos de regras
+ * 
+ * Varia transferência, penalidade, tropas iniciais máximas e o limite
+ * da missão GENERAL SUPREMO em torno das regras oficiais.
+ * 
+ * @param conjuntos Saída com os conjuntos
+ * @param maxConjuntos Capacidade do array de saída
+ * @return Quantidade de conjuntos montados
+ */
+int montarGradeRegras(Regras* conjuntos, int maxConjuntos) {
+    const int divisores[] = {2, 3, 4};
+    const int penalidades[] = {0, 1, 2};
+    const int tropasMaximas[] = {4, 6, 8};
+    const int limitesGeneral[] = {20, 30, 40};
+    int total = 0;
+    
+    for (int a = 0; a < 3; a++)
+        for (int b = 0; b < 3; b++)
+            for (int c = 0; c < 3; c++)
+                for (int d = 0; d < 3 && total < maxConjuntos; d++) {
+                    Regras r = regrasPadrao;
+                    r.divisorTransferencia = divisores[a];
+                    r.penalidadeDerrota = penalidades[b];
+                    r.tropasIniciaisMax = tropasMaximas[c];
+                    r.generalTropas = limitesGeneral[d];
+                    conjuntos[total++] = r;
+                }
+    
+    return total;
+}
+
+/**
+ * Sorteia conjuntos de regras dentro de faixas plausíveis
+ * 
+ * @param conjuntos Saída com os conjuntos
+ * @param quantidade Conjuntos desejados (limitado a VARREDURA_MAX_CONJUNTOS)
+ * @param gerador Gerador do sorteio
+ * @return Quantidade de conjuntos sorteados
+ */
+int sortearConjuntosRegras(Regras* conjuntos, int quantidade, GeradorAleatorio* gerador) {
+    if (quantidade > VARREDURA_MAX_CONJUNTOS) {
+        quantidade = VARREDURA_MAX_CONJUNTOS;
+    }
+    
+    for (int i = 0; i < quantidade; i++) {
+        Regras r = regrasPadrao;
+        r.tropasIniciaisMin = 1 + sortearIntervalo(gerador, 3);
+        r.tropasIniciaisMax = r.tropasIniciaisMin + sortearIntervalo(gerador, 7);
+        r.divisorTransferencia = 2 + sortearIntervalo(gerador, 3);
+        r.penalidadeDerrota = sortearIntervalo(gerador, 3);
+        r.conquistadorTerritorios = 4 + sortearIntervalo(gerador, 4);
+        r.estrategistaTerritorios = 2 + sortearIntervalo(gerador, 3);
+        r.estrategistaTropas = 3 + sortearIntervalo(gerador, 5);
+        r.expansionistaTerritorios = 3 + sortearIntervalo(gerador, 4);
+        r.generalTropas = 15 + sortearIntervalo(gerador, 31);
+        conjuntos[i] = r;
+    }
+    return quantidade;
+}
+
+/**
+ * Imprime as métricas agregadas de um conjunto concluído
+ * 
+ * @param indice Índice do conjunto
+ * @param resultado Métricas agregadas
+ * @param numJogos Partidas jogadas no conjunto
+ * @param numJogadores Jogadores por partida
+ */
+static void exibirResultadoVarredura(int indice, ResultadoVarredura* resultado, long numJogos, int numJogadores) {
+    const Regras* r = &resultado->regras;
+    double somaTurnos = (double)atomic_load(&resultado->somaTurnos);
+    double somaQuadrados = (double)atomic_load(&resultado->somaTurnosQuadrado);
+    double media = somaTurnos / numJogos;
+    double desvio = sqrt(fmax(0.0, somaQuadrados / numJogos - media * media));
+    
+    printf("%4d | %d-%d | /%d | -%d | %d %d>%d %d >%-3d | %6.1f ± %-5.1f | %5.1f%% |",
+           indice + 1, r->tropasIniciaisMin, r->tropasIniciaisMax, r->divisorTransferencia,
+           r->penalidadeDerrota, r->conquistadorTerritorios, r->estrategistaTerritorios,
+           r->estrategistaTropas, r->expansionistaTerritorios, r->generalTropas,
+           media, desvio, 100.0 * atomic_load(&resultado->empates) / numJogos);
+    for (int j = 0; j < numJogadores; j++) {
+        printf(" %5.1f%%", 100.0 * atomic_load(&resultado->vitorias[j]) / numJogos);
+    }
+    printf("\n");
+    fflush(stdout);
+}
+
+/**
+ * Tarefa de um bloco da varredura
+ * 
+ * Joga as partidas do bloco e soma as métricas no conjunto.
+ * 
+ * @param trabalhador Trabalhador do pool (não usado: o bloco é folha)
+ * @param argumento Ponteiro para o ItemVarredura
+ */
+static void jogarBlocoVarredura(TrabalhadorPool* trabalhador, void* argumento) {
+    (void)trabalhador;
+    ItemVarredura* item = (ItemVarredura*)argumento;
+    const OpcoesSimulacao* opcoes = item->trabalho->opcoes;
+    ResultadoVarredura* resultado = &item->trabalho->resultados[item->conjunto];
+    long inicio = item->bloco * VARREDURA_BLOCO;
+    long fim = inicio + VARREDURA_BLOCO;
+    if (fim > opcoes->numJogos) fim = opcoes->numJogos;
+    
+    long vitorias[MAX_JOGADORES] = {0};
+    long empates = 0, somaTurnos = 0, somaQuadrados = 0;
+    
+    // Mesmas sementes em todos os conjuntos (números aleatórios comuns)
+    for (long jogo = inicio; jogo < fim; jogo++) {
+        int duracao;
+        int vencedor = jogarPartidaComSemente(&resultado->regras, opcoes,
+                                              opcoes->semente + (uint64_t)jogo, false, &duracao);
+        if (vencedor >= 0) vitorias[vencedor]++;
+        else empates++;
+        somaTurnos += duracao;
+        somaQuadrados += (long)duracao * duracao;
+    }
+    
+    for (int j = 0; j < opcoes->numJogadores; j++) {
+        atomic_fetch_add_explicit(&resultado->vitorias[j], vitorias[j], memory_order_relaxed);
+    }
+    atomic_fetch_add_explicit(&resultado->empates, empates, memory_order_relaxed);
+    atomic_fetch_add_explicit(&resultado->somaTurnos, somaTurnos, memory_order_relaxed);
+    atomic_fetch_add_explicit(&resultado->somaTurnosQuadrado, somaQuadrados, memory_order_relaxed);
+}
+
+/**
+ * Tarefa de um conjunto de regras da varredura
+ * 
+ * Bifurca os blocos do conjunto, aguarda (ajudando a executá-los) e
+ * imprime o resultado assim que o conjunto fica pronto.
+ * 
+ * @param trabalhador Trabalhador do pool
+ * @param argumento Ponteiro para o ItemVarredura do conjunto
+ */
+static void avaliarConjuntoVarredura(TrabalhadorPool* trabalhador, void* argumento) {
+    ItemVarredura* item = (ItemVarredura*)argumento;
+    TrabalhoVarredura* trabalho = item->trabalho;
+    ItemVarredura* blocos = trabalho->itens + trabalho->numConjuntos +
+                            (long)item->conjunto * trabalho->blocosPorConjunto;
+    GrupoTarefas grupo;
+    atomic_init(&grupo.pendentes, 0);
+    
+    for (int b = 0; b < trabalho->blocosPorConjunto; b++) {
+        bifurcarTarefa(trabalhador, &grupo, &blocos[b].tarefa);
+    }
+    aguardarGrupo(trabalhador, &grupo);
+    
+    pthread_mutex_lock(&trabalho->saida);
+    exibirResultadoVarredura(item->conjunto, &trabalho->resultados[item->conjunto],
+                             trabalho->opcoes->numJogos, trabalho->opcoes->numJogadores);
+    pthread_mutex_unlock(&trabalho->saida);
+}
+
+/**
+ * Raiz da varredura: bifurca um conjunto de regras por tarefa
+ * 
+ * @param trabalhador Trabalhador 0 do pool
+ * @param argumento Ponteiro para o TrabalhoVarredura
+ */
+static void executarRaizVarredura(TrabalhadorPool* trabalhador, void* argumento) {
+    TrabalhoVarredura* trabalho = (TrabalhoVarredura*)argumento;
+    GrupoTarefas grupo;
+    atomic_init(&grupo.pendentes, 0);
+    
+    for (int i = 0; i < trabalho->numConjuntos; i++) {
+        bifurcarTarefa(trabalhador, &grupo, &trabalho->itens[i].tarefa);
+    }
+    aguardarGrupo(trabalhador, &grupo);
+}
+
+/**
+ * Avalia vários conjuntos de regras em paralelo
+ * 
+ * Cada conjunto joga opcoes->numJogos partidas com ataques aleatórios;
+ * as linhas de resultado (duração média, empates por limite de turnos e
+ * vitórias por posição) são impressas à medida que os conjuntos terminam.
+ * Conjuntos e blocos são tarefas aninhadas no pool de roubo de tarefas.
+ * 
+ * @param conjuntos Conjuntos de regras a avaliar
+ * @param numConjuntos Quantidade de conjuntos
+ * @param opcoes Partidas por conjunto e tamanho do mapa
+ * @param numThreads Trabalhadores paralelos
+ */
+void executarVarredura(const Regras* conjuntos, int numConjuntos, const OpcoesSimulacao* opcoes, int numThreads) {
+    TrabalhoVarredura trabalho;
+    int blocosPorConjunto = (int)((opcoes->numJogos + VARREDURA_BLOCO - 1) / VARREDURA_BLOCO);
+    long numItens = numConjuntos + (long)numConjuntos * blocosPorConjunto;
+    ResultadoVarredura* resultados = (ResultadoVarredura*)calloc(numConjuntos, sizeof(ResultadoVarredura));
+    ItemVarredura* itens = (ItemVarredura*)calloc(numItens, sizeof(ItemVarredura));
+    PoolTrabalho* pool = criarPoolTrabalho(numThreads, opcoes->semente, 0, opcoes->numaIngenuo);
+    
+    if (resultados == NULL || itens == NULL || pool == NULL) {
+        printf("❌ Erro: Falha na alocação de memória para a varredura!\n");
+        free(resultados);
+        free(itens);
+        liberarPoolTrabalho(pool);
+        return;
+    }
+    
+    trabalho.resultados = resultados;
+    trabalho.numConjuntos = numConjuntos;
+    trabalho.blocosPorConjunto = blocosPorConjunto;
+    trabalho.opcoes = opcoes;
+    trabalho.itens = itens;
+    pthread_mutex_init(&trabalho.saida, NULL);
+    
+    for (int i = 0; i < numConjuntos; i++) {
+        resultados[i].regras = conjuntos[i];
+    }
+    for (long i = 0; i < numItens; i++) {
+        ItemVarredura* item = &itens[i];
+        item->trabalho = &trabalho;
+        item->tarefa.argumento = item;
+        if (i < numConjuntos) {
+            item->conjunto = (int)i;
+            item->bloco = -1;
+            item->tarefa.executar = avaliarConjuntoVarredura;
+        } else {
+            item->conjunto = (int)((i - numConjuntos) / blocosPorConjunto);
+            item->bloco = (i - numConjuntos) % blocosPorConjunto;
+            item->tarefa.executar = jogarBlocoVarredura;
+        }
+    }
+    
+    printf("\n📐 ═══════════════════════════════════════════════════════════\n");
+    printf("              VARREDURA DE PARÂMETROS DE REGRAS\n");
+    printf("═══════════════════════════════════════════════════════════📐\n");
+    printf("🗺️  %d conjuntos × %ld partidas, %d jogadores, %d territórios, %d threads\n\n",
+           numConjuntos, opcoes->numJogos, opcoes->numJogadores, opcoes->numTerritorios, pool->iniciados + 1);
+    printf("   # | trop| transf| pen | missões C E>T X >G | turnos      | limite | vitórias por posição\n");
+    
+    executarRaizPool(pool, executarRaizVarredura, &trabalho);
+    
+    long executadas = 0, roubadas = 0;
+    for (int i = 0; i <= pool->iniciados; i++) {
+        executadas += pool->trabalhadores[i].executadas;
+        roubadas += pool->trabalhadores[i].roubadas;
+    }
+    
+    liberarPoolTrabalho(pool);
+    pthread_mutex_destroy(&trabalho.saida);
+    free(itens);
+    free(resultados);
+    printf("\n🔀 Tarefas: %ld executadas, %ld roubadas entre trabalhadores\n", executadas, roubadas);
+    printf("✅ Varredura concluída!\n");
+}
+
+// ============================================================================
+// IMPLEMENTAÇÃO DAS FUNÇÕES - TESTE SEQUENCIAL (SPRT)
+// ============================================================================
+
+/*
+ * Struct: ComparacaoSequencial
+ *
+ * Uma comparação da fila: regras base (A) contra uma variante (B).
+ * - proximoLote: lotes já reservados pelos trabalhadores
+ * - decidida: lida sem trava para que trabalhadores pulem comparações
+ *   encerradas e passem às que ainda estão pendentes
+ * - lotes: pares discordantes (A, B) de cada lote, guardados até que
+ *   todos os anteriores terminem; o teste consome os lotes na ordem do
+ *   índice, então a decisão não depende de --threads
+ * - trava: protege os lotes guardados e a atualização do teste
+ */
+typedef struct {
+    const Regras* variante;
+    TesteSequencial teste;
+    atomic_long proximoLote;
+    atomic_bool decidida;
+    atomic_long partidas;
+    long (*lotes)[2];
+    bool* concluidos;
+    long proximoAplicado;
+    pthread_mutex_t trava;
+} ComparacaoSequencial;
+
+/*
+ * Struct: FilaComparacoes
+ *
+ * Estado compartilhado pelos trabalhadores do modo --sprt.
+ */
+typedef struct {
+    const Regras* base;
+    ComparacaoSequencial* comparacoes;
+    int numComparacoes;
+    long maxLotes;
+    const OpcoesSimulacao* opcoes;
+    atomic_int pendentes;
+    atomic_uint cursor;
+    atomic_int proximoIndice;   // Núcleo de cada trabalhador (fixarThreadNucleo)
+    int numThreads;
+    pthread_mutex_t saida;
+} FilaComparacoes;
+
+/**
+ * Inicializa um teste sequencial simétrico
+ * 
+ * Hipóteses sobre a chance p de um par discordante favorecer A:
+ * "B melhor" (p = 0.5 - delta) contra "A melhor" (p = 0.5 + delta).
+ * 
+ * @param teste Teste a ser inicializado
+ * @param delta Vantagem mínima que interessa detectar
+ * @param alfa Erro tipo I
+ * @param beta Erro tipo II
+ */
+void inicializarTesteSequencial(TesteSequencial* teste, double delta, double alfa, double beta) {
+    memset(teste, 0, sizeof(*teste));
+    teste->p0 = 0.5 - delta;
+    teste->p1 = 0.5 + delta;
+    teste->limiteSuperior = log((1.0 - beta) / alfa);
+    teste->limiteInferior = log(beta / (1.0 - alfa));
+    teste->decisao = SPRT_PENDENTE;
+}
+
+/**
+ * Acrescenta pares discordantes ao teste e verifica as fronteiras
+ * 
+ * @param teste Teste sequencial
+ * @param favoraveisA Pares em que só a variante A produziu o evento
+ * @param favoraveisB Pares em que só a variante B produziu o evento
+ * @return Decisão atual (SPRT_PENDENTE enquanto não cruzar uma fronteira)
+ */
+int atualizarTesteSequencial(TesteSequencial* teste, long favoraveisA, long favoraveisB) {
+    teste->favoraveisA += favoraveisA;
+    teste->favoraveisB += favoraveisB;
+    teste->llr += favoraveisA * log(teste->p1 / teste->p0) +
+                  favoraveisB * log((1.0 - teste->p1) / (1.0 - teste->p0));
+    
+    if (teste->decisao == SPRT_PENDENTE) {
+        if (teste->llr >= teste->limiteSuperior) {
+            teste->decisao = SPRT_A_MELHOR;
+        } else if (teste->llr <= teste->limiteInferior) {
+            teste->decisao = SPRT_B_MELHOR;
+        }
+    }
+    return teste->decisao;
+}
+
+/**
+ * Imprime a conclusão de uma comparação (partidas consumidas pelo teste)
+ * 
+ * @param indice Índice da comparação
+ * @param comparacao Comparação encerrada
+ */
+static void exibirDecisaoSequencial(int indice, ComparacaoSequencial* comparacao) {
+    static const char* nomes[] = {"pendente", "A melhor", "B melhor", "inconclusivo"};
+    const Regras* r = comparacao->variante;
+    const TesteSequencial* t = &comparacao->teste;
+    
+    printf("%4d | %d-%d /%d -%d %d %d>%d %d >%-3d | %-12s | LLR %+6.2f | %5ld x %-5ld | %7ld partidas\n",
+           indice + 1, r->tropasIniciaisMin, r->tropasIniciaisMax, r->divisorTransferencia,
+           r->penalidadeDerrota, r->conquistadorTerritorios, r->estrategistaTerritorios,
+           r->estrategistaTropas, r->expansionistaTerritorios, r->generalTropas,
+           nomes[t->decisao], t->llr, t->favoraveisA, t->favoraveisB, 2 * t->pares);
+    fflush(stdout);
+}
+
+/**
+ * Reserva o próximo lote de alguma comparação ainda pendente
+ * 
+ * Percorre a fila a partir de um cursor compartilhado, de modo que os
+ * trabalhadores se espalham pelas comparações abertas e migram para as
+ * restantes assim que uma delas é decidida.
+ * 
+ * @param fila Fila de comparações
+ * @param lote Saída com o índice do lote reservado
+ * @return Índice da comparação, ou -1 se todas terminaram
+ */
+static int reservarLoteSequencial(FilaComparacoes* fila, long* lote) {
+    while (atomic_load(&fila->pendentes) > 0) {
+        for (int passo = 0; passo < fila->numComparacoes; passo++) {
+            int i = (int)(atomic_fetch_add(&fila->cursor, 1) % (unsigned int)fila->numComparacoes);
+            ComparacaoSequencial* c = &fila->comparacoes[i];
+            if (atomic_load_explicit(&c->decidida, memory_order_acquire)) {
+                continue;
+            }
+            long reservado = atomic_fetch_add(&c->proximoLote, 1);
+            if (reservado < fila->maxLotes) {
+                *lote = reservado;
+                return i;
+            }
+        }
+        // Só restam lotes em andamento em outros trabalhadores
+        sched_yield();
+    }
+    return -1;
+}
+
+/**
+ * Corpo de um trabalhador do modo --sprt
+ * 
+ * @param argumento Ponteiro para a FilaComparacoes
+ * @return NULL
+ */
+static void* executarTrabalhadorSequencial(void* argumento) {
+    FilaComparacoes* fila = (FilaComparacoes*)argumento;
+    const OpcoesSimulacao* opcoes = fila->opcoes;
+    long lote;
+    int indice;
+    
+    if (!opcoes->numaIngenuo) {
+        fixarThreadNucleo(atomic_fetch_add(&fila->proximoIndice, 1), fila->numThreads, NULL);
+    }
+    while ((indice = reservarLoteSequencial(fila, &lote)) >= 0) {
+        ComparacaoSequencial* c = &fila->comparacoes[indice];
+        long favoraveisA = 0, favoraveisB = 0;
+        
+        // Pares com a mesma semente: evento = vitória do primeiro jogador
+        for (long k = 0; k < SPRT_LOTE; k++) {
+            uint64_t semente = opcoes->semente + (uint64_t)(lote * SPRT_LOTE + k);
+            int duracao;
+            bool eventoA = jogarPartidaComSemente(fila->base, opcoes, semente, false, &duracao) == 0;
+            bool eventoB = jogarPartidaComSemente(c->variante, opcoes, semente, false, &duracao) == 0;
+            if (eventoA && !eventoB) favoraveisA++;
+            if (eventoB && !eventoA) favoraveisB++;
+        }
+        atomic_fetch_add(&c->partidas, 2 * SPRT_LOTE);
+        
+        // Aplica em ordem todos os lotes contíguos já concluídos; os que
+        // seguem a decisão são descartados
+        pthread_mutex_lock(&c->trava);
+        bool encerrar = false;
+        c->lotes[lote][0] = favoraveisA;
+        c->lotes[lote][1] = favoraveisB;
+        c->concluidos[lote] = true;
+        while (!atomic_load(&c->decidida) && !encerrar && c->proximoAplicado < fila->maxLotes &&
+               c->concluidos[c->proximoAplicado]) {
+            const long* pares = c->lotes[c->proximoAplicado++];
+            int decisao = atualizarTesteSequencial(&c->teste, pares[0], pares[1]);
+            c->teste.pares += SPRT_LOTE;
+            encerrar = decisao != SPRT_PENDENTE || c->teste.pares >= fila->maxLotes * SPRT_LOTE;
+        }
+        if (encerrar) {
+            int decisao = c->teste.decisao;
+            if (decisao == SPRT_PENDENTE) {
+                c->teste.decisao = SPRT_INCONCLUSIVO;
+            }
+            atomic_store_explicit(&c->decidida, true, memory_order_release);
+        }
+        pthread_mutex_unlock(&c->trava);
+        
+        if (encerrar) {
+            atomic_fetch_sub(&fila->pendentes, 1);
+            pthread_mutex_lock(&fila->saida);
+            exibirDecisaoSequencial(indice, c);
+            pthread_mutex_unlock(&fila->saida);
+        }
+    }
+    
+    return NULL;
+}
+
+/**
+ * Executa uma fila de comparações A/B com parada antecipada
+ * 
+ * Cada comparação joga pares de partidas com a mesma semente até o
+ * teste sequencial decidir ou o limite de opcoes->numJogos pares ser
+ * atingido. Trabalhadores liberados por comparações decididas passam
+ * imediatamente às que continuam pendentes.
+ * 
+ * @param base Regras A (comuns a todas as comparações)
+ * @param variantes Regras B de cada comparação
+ * @param numVariantes Quantidade de comparações
+ * @param opcoes Limite de pares e tamanho do mapa
+ * @param numThreads Trabalhadores paralelos
+ */
+void executarComparacoesSequenciais(const Regras* base, const Regras* variantes, int numVariantes,
+                                    const OpcoesSimulacao* opcoes, int numThreads) {
+    FilaComparacoes fila;
+    long maxLotes = (opcoes->numJogos + SPRT_LOTE - 1) / SPRT_LOTE;
+    pthread_t* threads = (pthread_t*)calloc(numThreads, sizeof(pthread_t));
+    ComparacaoSequencial* comparacoes = (ComparacaoSequencial*)calloc(numVariantes, sizeof(ComparacaoSequencial));
+    long (*lotes)[2] = (long (*)[2])calloc((size_t)numVariantes * maxLotes, sizeof(*lotes));
+    bool* concluidos = (bool*)calloc((size_t)numVariantes * maxLotes, sizeof(bool));
+    
+    if (threads == NULL || comparacoes == NULL || lotes == NULL || concluidos == NULL) {
+        printf("❌ Erro: Falha na alocação de memória para as comparações!\n");
+        free(threads);
+        free(comparacoes);
+        free(lotes);
+        free(concluidos);
+        return;
+    }
+    
+    fila.base = base;
+    fila.comparacoes = comparacoes;
+    fila.numComparacoes = numVariantes;
+    fila.maxLotes = maxLotes;
+    fila.opcoes = opcoes;
+    atomic_init(&fila.pendentes, numVariantes);
+    atomic_init(&fila.cursor, 0);
+    atomic_init(&fila.proximoIndice, 0);
+    fila.numThreads = numThreads;
+    pthread_mutex_init(&fila.saida, NULL);
+    
+    for (int i = 0; i < numVariantes; i++) {
+        comparacoes[i].variante = &variantes[i];
+        inicializarTesteSequencial(&comparacoes[i].teste, SPRT_DELTA, SPRT_ALFA, SPRT_BETA);
+        atomic_init(&comparacoes[i].proximoLote, 0);
+        atomic_init(&comparacoes[i].decidida, false);
+        atomic_init(&comparacoes[i].partidas, 0);
+        comparacoes[i].lotes = lotes + (size_t)i * maxLotes;
+        comparacoes[i].concluidos = concluidos + (size_t)i * maxLotes;
+        comparacoes[i].proximoAplicado = 0;
+        pthread_mutex_init(&comparacoes[i].trava, NULL);
+    }
+    
+    // A saída fica travada até o cabeçalho, que mostra as threads de fato criadas
+    pthread_mutex_lock(&fila.saida);
+    int iniciadas = 0;
+    for (int i = 0; i < numThreads; i++) {
+        if (pthread_create(&threads[i], NULL, executarTrabalhadorSequencial, &fila) != 0) {
+            break;
+        }
+        iniciadas++;
+    }
+    
+    printf("\n🚦 ═══════════════════════════════════════════════════════════\n");
+    printf("              COMPARAÇÕES COM TESTE SEQUENCIAL\n");
+    printf("═══════════════════════════════════════════════════════════🚦\n");
+    printf("🅰️  Regras oficiais contra %d variantes (B), até %ld pares cada, %d threads\n",
+           numVariantes, fila.maxLotes * SPRT_LOTE, iniciadas > 0 ? iniciadas : 1);
+    printf("📏 Evento: vitória do jogador 1 | δ = %.2f, α = %.2f, β = %.2f\n\n",
+           SPRT_DELTA, SPRT_ALFA, SPRT_BETA);
+    pthread_mutex_unlock(&fila.saida);
+    
+    if (iniciadas == 0) {
+        fila.numThreads = 0;    // Na thread principal, sem fixar (nada a restaurar depois)
+        executarTrabalhadorSequencial(&fila);
+    }
+    for (int i = 0; i < iniciadas; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    
+    long totalPartidas = 0;
+    for (int i = 0; i < numVariantes; i++) {
+        totalPartidas += atomic_load(&comparacoes[i].partidas);
+        pthread_mutex_destroy(&comparacoes[i].trava);
+    }
+    long orcamentoFixo = (long)numVariantes * fila.maxLotes * SPRT_LOTE * 2;
+    
+    printf("\n✅ %ld partidas jogadas de %ld do orçamento fixo (%.1f%% economizado)\n",
+           totalPartidas, orcamentoFixo, 100.0 * (1.0 - (double)totalPartidas / orcamentoFixo));
+    
+    pthread_mutex_destroy(&fila.saida);
+    free(concluidos);
+    free(lotes);
+    free(comparacoes);
+    free(threads);
+}
+
+// ============================================================================
+// IMPLEMENTAÇÃO DAS FUNÇÕES - RESOLVEDOR EXATO E TABELA FINAL
+// ============================================================================
+
+// Situação de um estado da tabela (pré-calculada antes da iteração)
+#define TABELA_EM_JOGO 0
+#define TABELA_VITORIA_J1 1
+#define TABELA_VITORIA_J2 2
+
+/*
+ * Struct: Resolvedor
+ *
+ * Estado compartilhado da iteração de valor paralela. Cada thread
+ * calcula uma faixa de 'novos' a partir de 'atuais'; depois da barreira
+ * a thread 0 troca os vetores e decide se houve convergência. As faixas
+ * e a barreira só são montadas depois que se sabe quantas threads de
+ * fato foram criadas ('liberado' passa a true).
+ */
+typedef struct {
+    CabecalhoTabela cabecalho;
+    uint8_t* situacao;
+    float* atuais;
+    float* novos;
+    double chances[3];
+    int numThreads;
+    double residuos[MAX_THREADS];
+    bool convergiu;
+    atomic_bool liberado;
+    pthread_barrier_t barreira;
+} Resolvedor;
+
+/*
+ * Struct: TarefaResolvedor
+ *
+ * Faixa de estados de uma thread do resolvedor.
+ */
+typedef struct {
+    Resolvedor* resolvedor;
+    int indice;
+    int64_t inicio;
+    int64_t fim;
+} TarefaResolvedor;
+
+/**
+ * Quantidade de estados da tabela
+ * 
+ * Cada estado guarda o dono de cada território (1 bit), suas tropas
+ * (1..maxTropas) e o jogador da vez.
+ * 
+ * @param numTerritorios Territórios do mapa
+ * @param maxTropas Maior contagem de tropas
+ * @return Número de estados
+ */
+int64_t contarEstadosTabela(int numTerritorios, int maxTropas) {
+    int64_t combinacoesTropas = 1;
+    for (int i = 0; i < numTerritorios; i++) {
+        combinacoesTropas *= maxTropas;
+    }
+    return 2 * ((int64_t)1 << numTerritorios) * combinacoesTropas;
+}
+
+/**
+ * Calcula a posição de um estado na tabela
+ * 
+ * @param cabecalho Parâmetros da tabela
+ * @param estado Estado compacto
+ * @return Índice do estado, ou -1 se o estado não pertence à tabela
+ */
+int64_t indexarEstadoTabela(const CabecalhoTabela* cabecalho, const EstadoSimulacao* estado) {
+    if (estado->numJogadores != 2 || estado->numTerritorios != cabecalho->numTerritorios ||
+        estado->missao[0] != cabecalho->missao[0] || estado->missao[1] != cabecalho->missao[1]) {
+        return -1;
+    }
+    
+    int64_t indiceTropas = 0;
+    int64_t mascara = 0;
+    for (int i = estado->numTerritorios - 1; i >= 0; i--) {
+        if (estado->tropas[i] < 1 || estado->tropas[i] > cabecalho->maxTropas || estado->dono[i] < 0) {
+            return -1;
+        }
+        indiceTropas = indiceTropas * cabecalho->maxTropas + (estado->tropas[i] - 1);
+        mascara = (mascara << 1) | estado->dono[i];
+    }
+    
+    int64_t combinacoesTropas = cabecalho->numEstados / (2 * ((int64_t)1 << cabecalho->numTerritorios));
+    return (((int64_t)estado->jogadorDaVez << cabecalho->numTerritorios) | mascara) * combinacoesTropas
+           + indiceTropas;
+}
+
+/**
+ * Reconstrói o estado compacto correspondente a um índice da tabela
+ * 
+ * @param cabecalho Parâmetros da tabela
+ * @param indice Índice do estado
+ * @param estado Saída com o estado
+ */
+static void decodificarEstadoTabela(const CabecalhoTabela* cabecalho, int64_t indice, EstadoSimulacao* estado) {
+    int64_t combinacoesTropas = cabecalho->numEstados / (2 * ((int64_t)1 << cabecalho->numTerritorios));
+    int64_t indiceTropas = indice % combinacoesTropas;
+    int64_t chave = indice / combinacoesTropas;
+    
+    memset(estado, 0, sizeof(*estado));
+    estado->numJogadores = 2;
+    estado->numTerritorios = cabecalho->numTerritorios;
+    estado->missao[0] = (int8_t)cabecalho->missao[0];
+    estado->missao[1] = (int8_t)cabecalho->missao[1];
+    estado->jogadorDaVez = (int)(chave >> cabecalho->numTerritorios);
+    
+    for (int i = 0; i < cabecalho->numTerritorios; i++) {
+        estado->dono[i] = (int8_t)((chave >> i) & 1);
+        estado->tropas[i] = (int)(indiceTropas % cabecalho->maxTropas) + 1;
+        indiceTropas /= cabecalho->maxTropas;
+        estado->ativo[estado->dono[i]] = true;
+    }
+    estado->hash = calcularHashEstado(estado);
+}
+
+/**
+ * Valor de um estado sucessor na iteração atual
+ * 
+ * @param resolvedor Resolvedor
+ * @param estado Estado após a batalha (antes de passar a vez)
+ * @return Chance de vitória do jogador 1
+ */
+static double valorSucessor(Resolvedor* resolvedor, EstadoSimulacao* estado) {
+    // O fim de partida não depende da vez, então a situação pré-calculada
+    // do estado com a vez já passada responde pelos dois
+    definirJogadorDaVez(estado, 1 - estado->jogadorDaVez);
+    int64_t indice = indexarEstadoTabela(&resolvedor->cabecalho, estado);
+    switch (resolvedor->situacao[indice]) {
+        case TABELA_VITORIA_J1: return 1.0;
+        case TABELA_VITORIA_J2: return 0.0;
+        default: return resolvedor->atuais[indice];
+    }
+}
+
+/**
+ * Uma atualização de Bellman: o jogador 1 maximiza e o jogador 2
+ * minimiza a chance de vitória do jogador 1, ponderando os três
+ * resultados de cada ataque pelas chances dos dados.
+ * 
+ * @param resolvedor Resolvedor
+ * @param indice Estado a atualizar
+ * @return Novo valor do estado
+ */
+static float atualizarEstadoTabela(Resolvedor* resolvedor, int64_t indice) {
+    const Regras* regras = &resolvedor->cabecalho.regras;
+    EstadoSimulacao estado, sucessor;
+    int ataques[MAX_ATAQUES][2];
+    
+    switch (resolvedor->situacao[indice]) {
+        case TABELA_VITORIA_J1: return 1.0f;
+        case TABELA_VITORIA_J2: return 0.0f;
+        default: break;
+    }
+    
+    decodificarEstadoTabela(&resolvedor->cabecalho, indice, &estado);
+    int jogador = estado.jogadorDaVez;
+    int numAtaques = listarAtaques(&estado, jogador, ataques);
+    
+    // Sem ataques possíveis: passa a vez
+    if (numAtaques == 0) {
+        definirJogadorDaVez(&estado, 1 - jogador);
+        return resolvedor->atuais[indexarEstadoTabela(&resolvedor->cabecalho, &estado)];
+    }
+    
+    double melhor = (jogador == 0) ? -1.0 : 2.0;
+    for (int k = 0; k < numAtaques; k++) {
+        double valor = 0.0;
+        for (int resultado = 0; resultado < 3; resultado++) {
+            sucessor = estado;
+            aplicarResultadoBatalha(&sucessor, regras, ataques[k][0], ataques[k][1], resultado);
+            valor += resolvedor->chances[resultado] * valorSucessor(resolvedor, &sucessor);
+        }
+        if ((jogador == 0) ? (valor > melhor) : (valor < melhor)) {
+            melhor = valor;
+        }
+    }
+    return (float)melhor;
+}
+
+/**
+ * Corpo de uma thread do resolvedor (iteração de valor de Jacobi)
+ * 
+ * @param argumento Ponteiro para a TarefaResolvedor
+ * @return NULL
+ */
+static void* executarTrabalhadorResolvedor(void* argumento) {
+    TarefaResolvedor* tarefa = (TarefaResolvedor*)argumento;
+    Resolvedor* resolvedor = tarefa->resolvedor;
+    
+    while (!atomic_load_explicit(&resolvedor->liberado, memory_order_acquire)) {
+        sched_yield();
+    }
+    
+    for (int iteracao = 0; iteracao < SOLVER_MAX_ITERACOES; iteracao++) {
+        double residuo = 0.0;
+        for (int64_t i = tarefa->inicio; i < tarefa->fim; i++) {
+            float valor = atualizarEstadoTabela(resolvedor, i);
+            double diferenca = fabs((double)valor - resolvedor->atuais[i]);
+            if (diferenca > residuo) residuo = diferenca;
+            resolvedor->novos[i] = valor;
+        }
+        resolvedor->residuos[tarefa->indice] = residuo;
+        
+        pthread_barrier_wait(&resolvedor->barreira);
+        if (tarefa->indice == 0) {
+            double maximo = 0.0;
+            for (int t = 0; t < resolvedor->numThreads; t++) {
+                if (resolvedor->residuos[t] > maximo) maximo = resolvedor->residuos[t];
+            }
+            float* troca = resolvedor->atuais;
+            resolvedor->atuais = resolvedor->novos;
+            resolvedor->novos = troca;
+            resolvedor->cabecalho.iteracoes = iteracao + 1;
+            resolvedor->cabecalho.residuo = (float)maximo;
+            resolvedor->convergiu = maximo < SOLVER_TOLERANCIA;
+        }
+        pthread_barrier_wait(&resolvedor->barreira);
+        
+        if (resolvedor->convergiu) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Resolve exatamente partidas de 2 jogadores e grava a tabela final
+ * 
+ * Como nenhuma regra cria tropas, nenhum território passa das tropas
+ * iniciais máximas, então o espaço de estados é finito. A iteração de
+ * valor parte de zero e converge para a chance de vitória do jogador 1
+ * sob jogo ótimo de ambos (partidas que nunca terminam valem 0).
+ * 
+ * @param caminho Arquivo de saída
+ * @param numTerritorios Territórios do mapa (até SOLVER_MAX_TERRITORIOS)
+ * @param missoes Missões dos dois jogadores
+ * @param regras Regras da partida
+ * @param numThreads Threads da iteração de valor
+ * @return true se a tabela foi gravada
+ */
+bool resolverTabelaFinal(const char* caminho, int numTerritorios, const int missoes[2],
+                         const Regras* regras, int numThreads) {
+    Resolvedor resolvedor;
+    
+    if (numTerritorios < 2 || numTerritorios > SOLVER_MAX_TERRITORIOS) {
+        printf("❌ Erro: O resolvedor aceita de 2 a %d territórios (pedido: %d).\n",
+               SOLVER_MAX_TERRITORIOS, numTerritorios);
+        return false;
+    }
+    if (regras->tropasIniciaisMax > SOLVER_MAX_TROPAS || regras->tropasIniciaisMin < 1 ||
+        regras->divisorTransferencia < 2) {
+        printf("❌ Erro: Regras fora do alcance do resolvedor.\n");
+        return false;
+    }
+    if (numThreads > MAX_THREADS) {
+        numThreads = MAX_THREADS;
+    }
+    
+    memset(&resolvedor, 0, sizeof(resolvedor));
+    memcpy(resolvedor.cabecalho.assinatura, TABELA_ASSINATURA, sizeof(resolvedor.cabecalho.assinatura));
+    resolvedor.cabecalho.numTerritorios = numTerritorios;
+    resolvedor.cabecalho.maxTropas = regras->tropasIniciaisMax;
+    resolvedor.cabecalho.missao[0] = missoes[0];
+    resolvedor.cabecalho.missao[1] = missoes[1];
+    resolvedor.cabecalho.regras = *regras;
+    resolvedor.cabecalho.numEstados = contarEstadosTabela(numTerritorios, regras->tropasIniciaisMax);
+    resolvedor.numThreads = numThreads;
+    calcularChancesBatalha(resolvedor.chances);
+    
+    int64_t numEstados = resolvedor.cabecalho.numEstados;
+    resolvedor.situacao = (uint8_t*)calloc(numEstados, sizeof(uint8_t));
+    resolvedor.atuais = (float*)calloc(numEstados, sizeof(float));
+    resolvedor.novos = (float*)calloc(numEstados, sizeof(float));
+    if (resolvedor.situacao == NULL || resolvedor.atuais == NULL || resolvedor.novos == NULL) {
+        printf("❌ Erro: Falha na alocação de %lld estados!\n", (long long)numEstados);
+        free(resolvedor.situacao);
+        free(resolvedor.atuais);
+        free(resolvedor.novos);
+        return false;
+    }
+    
+    printf("\n🧮 ═══════════════════════════════════════════════════════════\n");
+    printf("              RESOLUÇÃO EXATA (ITERAÇÃO DE VALOR)\n");
+    printf("═══════════════════════════════════════════════════════════🧮\n");
+    printf("🗺️  %d territórios, tropas 1-%d, %lld estados (%.1f MB), %d threads\n",
+           numTerritorios, regras->tropasIniciaisMax, (long long)numEstados,
+           numEstados * sizeof(float) / 1048576.0, numThreads);
+    
+    // Estados finais têm valor fixo durante toda a iteração
+    for (int64_t i = 0; i < numEstados; i++) {
+        EstadoSimulacao estado;
+        decodificarEstadoTabela(&resolvedor.cabecalho, i, &estado);
+        int vencedor = verificarVencedorEstado(&estado, regras);
+        resolvedor.situacao[i] = (vencedor == 0) ? TABELA_VITORIA_J1 :
+                                 (vencedor == 1) ? TABELA_VITORIA_J2 : TABELA_EM_JOGO;
+        resolvedor.atuais[i] = (vencedor == 0) ? 1.0f : 0.0f;
+    }
+    
+    pthread_t threads[MAX_THREADS];
+    TarefaResolvedor tarefas[MAX_THREADS];
+    atomic_init(&resolvedor.liberado, false);
+    
+    // A barreira conta só as threads que de fato foram criadas
+    int iniciadas = 1;
+    tarefas[0].resolvedor = &resolvedor;
+    for (int t = 1; t < numThreads; t++) {
+        tarefas[t].resolvedor = &resolvedor;
+        if (pthread_create(&threads[t], NULL, executarTrabalhadorResolvedor, &tarefas[t]) != 0) {
+            printf("⚠️  Apenas %d de %d threads foram criadas; seguindo com elas.\n", iniciadas, numThreads);
+            break;
+        }
+        iniciadas++;
+    }
+    resolvedor.numThreads = iniciadas;
+    for (int t = 0; t < iniciadas; t++) {
+        tarefas[t].indice = t;
+        tarefas[t].inicio = numEstados * t / iniciadas;
+        tarefas[t].fim = numEstados * (t + 1) / iniciadas;
+    }
+    pthread_barrier_init(&resolvedor.barreira, NULL, (unsigned int)iniciadas);
+    atomic_store_explicit(&resolvedor.liberado, true, memory_order_release);
+    
+    executarTrabalhadorResolvedor(&tarefas[0]);
+    for (int t = 1; t < iniciadas; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    pthread_barrier_destroy(&resolvedor.barreira);
+    
+    printf("🔁 %d iterações, resíduo final %.2e%s\n", resolvedor.cabecalho.iteracoes,
+           resolvedor.cabecalho.residuo, resolvedor.convergiu ? "" : " (limite de iterações!)");
+    
+    // Gravação: cabeçalho seguido dos valores
+    bool gravado = false;
+    FILE* arquivo = fopen(caminho, "wb");
+    if (arquivo != NULL) {
+        gravado = fwrite(&resolvedor.cabecalho, sizeof(CabecalhoTabela), 1, arquivo) == 1 &&
+                  fwrite(resolvedor.atuais, sizeof(float), (size_t)numEstados, arquivo) == (size_t)numEstados;
+        gravado = (fclose(arquivo) == 0) && gravado;
+    }
+    if (gravado) {
+        printf("💾 Tabela final gravada em %s\n", caminho);
+    } else {
+        printf("❌ Erro: Não foi possível gravar %s\n", caminho);
+    }
+    
+    free(resolvedor.situacao);
+    free(resolvedor.atuais);
+    free(resolvedor.novos);
+    return gravado;
+}
+
+/**
+ * Confere se os campos do cabeçalho cabem nos limites do resolvedor
+ * 
+ * Feito antes de qualquer conta ou consulta: um arquivo corrompido não
+ * pode levar a índices fora das tabelas nem a divisões por zero.
+ * 
+ * @param cabecalho Cabeçalho lido do arquivo
+ * @return true se todos os campos estão no alcance
+ */
+static bool cabecalhoTabelaValido(const CabecalhoTabela* cabecalho) {
+    const Regras* regras = &cabecalho->regras;
+    
+    if (memcmp(cabecalho->assinatura, TABELA_ASSINATURA, sizeof(cabecalho->assinatura)) != 0 ||
+        cabecalho->numTerritorios < 2 || cabecalho->numTerritorios > SOLVER_MAX_TERRITORIOS ||
+        cabecalho->numTerritorios > MAX_TERRITORIOS ||
+        cabecalho->maxTropas < 1 || cabecalho->maxTropas > SOLVER_MAX_TROPAS) {
+        return false;
+    }
+    for (int j = 0; j < 2; j++) {
+        if (cabecalho->missao[j] < 0 || cabecalho->missao[j] >= TOTAL_MISSOES) {
+            return false;
+        }
+    }
+    return regras->tropasIniciaisMin >= 1 && regras->tropasIniciaisMax == cabecalho->maxTropas &&
+           regras->divisorTransferencia >= 2 && regras->penalidadeDerrota >= 0;
+}
+
+/**
+ * Mapeia uma tabela final em memória (somente leitura)
+ * 
+ * @param tabela Saída com a tabela aberta
+ * @param caminho Arquivo da tabela
+ * @return true se a tabela é válida
+ */
+bool abrirTabelaFinal(TabelaFinal* tabela, const char* caminho) {
+    struct stat informacoes;
+    int descritor = open(caminho, O_RDONLY);
+    
+    memset(tabela, 0, sizeof(*tabela));
+    if (descritor < 0 || fstat(descritor, &informacoes) != 0 ||
+        (size_t)informacoes.st_size < sizeof(CabecalhoTabela)) {
+        printf("❌ Erro: Não foi possível abrir a tabela %s\n", caminho);
+        if (descritor >= 0) close(descritor);
+        return false;
+    }
+    
+    void* mapeamento = mmap(NULL, (size_t)informacoes.st_size, PROT_READ, MAP_SHARED, descritor, 0);
+    close(descritor); // O mapeamento continua válido
+    if (mapeamento == MAP_FAILED) {
+        printf("❌ Erro: Falha ao mapear a tabela %s\n", caminho);
+        return false;
+    }
+    
+    const CabecalhoTabela* cabecalho = (const CabecalhoTabela*)mapeamento;
+    if (!cabecalhoTabelaValido(cabecalho) ||
+        cabecalho->numEstados != contarEstadosTabela(cabecalho->numTerritorios, cabecalho->maxTropas) ||
+        (size_t)informacoes.st_size != sizeof(CabecalhoTabela) + (size_t)cabecalho->numEstados * sizeof(float)) {
+        printf("❌ Erro: %s não é uma tabela final válida\n", caminho);
+        munmap(mapeamento, (size_t)informacoes.st_size);
+        return false;
+    }
+    
+    tabela->mapeamento = mapeamento;
+    tabela->tamanho = (size_t)informacoes.st_size;
+    tabela->cabecalho = cabecalho;
+    tabela->valores = (const float*)((const char*)mapeamento + sizeof(CabecalhoTabela));
+    return true;
+}
+
+/**
+ * Consulta a chance de vitória do jogador 1 em O(1)
+ * 
+ * @param tabela Tabela aberta
+ * @param estado Estado compacto (2 jogadores, mesmas missões da tabela)
+ * @return Chance de vitória do jogador 1, ou -1 se o estado não está na tabela
+ */
+float consultarTabelaFinal(const TabelaFinal* tabela, const EstadoSimulacao* estado) {
+    int64_t indice = indexarEstadoTabela(tabela->cabecalho, estado);
+    return (indice >= 0) ? tabela->valores[indice] : -1.0f;
+}
+
+/**
+ * Escolhe o ataque ótimo do jogador da vez com uma consulta por resultado
+ * 
+ * @param tabela Tabela aberta
+ * @param estado Estado compacto
+ * @param atacante Saída com o território atacante
+ * @param defensor Saída com o território defensor
+ * @return false se não há ataques ou o estado não está na tabela
+ */
+bool melhorAtaqueTabela(const TabelaFinal* tabela, const EstadoSimulacao* estado, int* atacante, int* defensor) {
+    const Regras* regras = &tabela->cabecalho->regras;
+    int ataques[MAX_ATAQUES][2];
+    double chances[3];
+    int jogador = estado->jogadorDaVez;
+    int numAtaques = listarAtaques(estado, jogador, ataques);
+    double melhor = -1.0;
+    
+    if (numAtaques == 0 || indexarEstadoTabela(tabela->cabecalho, estado) < 0) {
+        return false;
+    }
+    calcularChancesBatalha(chances);
+    
+    for (int k = 0; k < numAtaques; k++) {
+        double valor = 0.0;
+        for (int resultado = 0; resultado < 3; resultado++) {
+            EstadoSimulacao sucessor = *estado;
+            aplicarResultadoBatalha(&sucessor, regras, ataques[k][0], ataques[k][1], resultado);
+            int vencedor = verificarVencedorEstado(&sucessor, regras);
+            double chanceJ1;
+            if (vencedor >= 0) {
+                chanceJ1 = (vencedor == 0) ? 1.0 : 0.0;
+            } else {
+                definirJogadorDaVez(&sucessor, 1 - jogador);
+                chanceJ1 = consultarTabelaFinal(tabela, &sucessor);
+            }
+            valor += chances[resultado] * ((jogador == 0) ? chanceJ1 : 1.0 - chanceJ1);
+        }
+        if (valor > melhor) {
+            melhor = valor;
+            *atacante = ataques[k][0];
+            *defensor = ataques[k][1];
+        }
+    }
+    return true;
+}
+
+/**
+ * Libera o mapeamento da tabela final
+ * 
+ * @param tabela Tabela aberta
+ */
+void fecharTabelaFinal(TabelaFinal* tabela) {
+    if (tabela->mapeamento != NULL) {
+        munmap(tabela->mapeamento, tabela->tamanho);
+        memset(tabela, 0, sizeof(*tabela));
+    }
+}
+
+/**
+ * Exibe a chance exata e o ataque ótimo em partidas iniciais sorteadas
+ * 
+ * @param tabela Tabela aberta
+ * @param opcoes Semente e quantidade de partidas (limitada a 10)
+ */
+void exibirConsultasTabela(const TabelaFinal* tabela, const OpcoesSimulacao* opcoes) {
+    const CabecalhoTabela* c = tabela->cabecalho;
+    GeradorAleatorio gerador;
+    long consultas = (opcoes->numJogos < 10) ? opcoes->numJogos : 10;
+    
+    inicializarGerador(&gerador, opcoes->semente);
+    printf("\n📖 Tabela: %d territórios, tropas 1-%d, missões %d e %d, %lld estados\n",
+           c->numTerritorios, c->maxTropas, c->missao[0] + 1, c->missao[1] + 1, (long long)c->numEstados);
+    
+    for (long k = 0; k < consultas; k++) {
+        EstadoSimulacao estado;
+        int atacante, defensor;
+        
+        gerarPartidaAleatoria(&estado, &c->regras, 2, c->numTerritorios, &gerador);
+        estado.missao[0] = (int8_t)c->missao[0];
+        estado.missao[1] = (int8_t)c->missao[1];
+        
+        printf("   Tropas:");
+        for (int i = 0; i < estado.numTerritorios; i++) {
+            printf(" J%d:%d", estado.dono[i] + 1, estado.tropas[i]);
+        }
+        printf(" → vitória J1 %.1f%%", 100.0 * consultarTabelaFinal(tabela, &estado));
+        if (melhorAtaqueTabela(tabela, &estado, &atacante, &defensor)) {
+            printf(", ótimo: [%d] → [%d]", atacante + 1, defensor + 1);
+        }
+        printf("\n");
+    }
+}
+
+// ============================================================================
+// IMPLEMENTAÇÃO DAS FUNÇÕES - CONTROLADORES DE JOGADORES
+// ============================================================================
+
+/*
+ * Struct: DadosHumano
+ *
+ * Contexto do controlador humano, usado apenas para exibir a análise
+ * em segundo plano enquanto o jogador digita.
+ */
+typedef struct {
+    AnalisadorFundo* analisador;
+    const Territorio* mapa;
+    const Jogador* jogadores;
+} DadosHumano;
+
+/*
+ * Struct: DadosBot
+ *
+ * Contexto dos bots: gerador próprio, regras da partida e, para os
+ * bots de tabela, MCTS, expectimax, rede e heurístico, a tabela final,
+ * a árvore, a busca, a rede e os pesos de cada um.
+ */
+typedef struct {
+    GeradorAleatorio gerador;
+    const Regras* regras;
+    TabelaFinal tabela;
+    void* arvore;
+    void* busca;
+    RedeAvaliacao* rede;
+    PesosHeuristica pesos;
+} DadosBot;
+
+/**
+ * Lê o ataque pelo terminal (controlador humano)
+ * 
+ * Digitar 0 no lugar do atacante exibe a estimativa mais recente do
+ * analisador em segundo plano.
+ */
+static bool decidirAtaqueHumano(ControladorJogador* controlador, const EstadoSimulacao* visao,
+                                int* atacante, int* defensor) {
+    DadosHumano* dados = (DadosHumano*)controlador->dados;
+    int numTerritorios = visao->numTerritorios;
+    int lidos;
+    
+    // Estimativa disponível até agora (nunca espera o analisador)
+    if (dados->analisador != NULL) {
+        exibirAnalise(dados->analisador, dados->mapa, dados->jogadores);
+    }
+    
+    // Escolher atacante (0 atualiza a estimativa)
+    printf("\n🏴 Escolha o território ATACANTE (1-%d, 0 = atualizar análise): ", numTerritorios);
+    while ((lidos = scanf("%d", atacante)) != 1 || 
+           *atacante < 1 || *atacante > numTerritorios) {
+        if (lidos == 1 && *atacante == 0 && dados->analisador != NULL) {
+            exibirAnalise(dados->analisador, dados->mapa, dados->jogadores);
+            printf("🏴 Escolha o território ATACANTE (1-%d): ", numTerritorios);
+            continue;
+        }
+        printf("❌ Índice inválido! Escolha entre 1 e %d: ", numTerritorios);
+        while (getchar() != '\n');
+    }
+    (*atacante)--; // Converter para índice 0-based
+    
+    // Escolher defensor
+    printf("🏰 Escolha o território DEFENSOR (1-%d): ", numTerritorios);
+    while (scanf("%d", defensor) != 1 || 
+           *defensor < 1 || *defensor > numTerritorios) {
+        printf("❌ Índice inválido! Escolha entre 1 e %d: ", numTerritorios);
+        while (getchar() != '\n');
+    }
+    (*defensor)--; // Converter para índice 0-based
+    
+    return true;
+}
+
+/**
+ * Bot aleatório: qualquer ataque válido com a mesma chance
+ */
+static bool decidirAtaqueAleatorio(ControladorJogador* controlador, const EstadoSimulacao* visao,
+                                   int* atacante, int* defensor) {
+    DadosBot* dados = (DadosBot*)controlador->dados;
+    int ataques[MAX_ATAQUES][2];
+    int numAtaques = listarAtaques(visao, visao->jogadorDaVez, ataques);
+    
+    if (numAtaques == 0) {
+        return false;
+    }
+    int escolhido = sortearIntervalo(&dados->gerador, numAtaques);
+    *atacante = ataques[escolhido][0];
+    *defensor = ataques[escolhido][1];
+    return true;
+}
+
+/**
+ * Bot estrategista (script): como os dados não dependem das tropas,
+ * prefere conquistas que destroem mais tropas inimigas e que partem
+ * do território mais forte (transfere mais tropas ao conquistar).
+ * Empates são desfeitos ao acaso.
+ */
+static bool decidirAtaqueEstrategista(ControladorJogador* controlador, const EstadoSimulacao* visao,
+                                      int* atacante, int* defensor) {
+    DadosBot* dados = (DadosBot*)controlador->dados;
+    int ataques[MAX_ATAQUES][2];
+    int numAtaques = listarAtaques(visao, visao->jogadorDaVez, ataques);
+    int melhorPontuacao = -1;
+    int empatados = 0;
+    
+    for (int k = 0; k < numAtaques; k++) {
+        int pontuacao = 2 * visao->tropas[ataques[k][1]] + visao->tropas[ataques[k][0]];
+        if (pontuacao > melhorPontuacao) {
+            melhorPontuacao = pontuacao;
+            empatados = 0;
+        }
+        // Amostragem de reservatório entre as melhores opções
+        if (pontuacao == melhorPontuacao && sortearIntervalo(&dados->gerador, ++empatados) == 0) {
+            *atacante = ataques[k][0];
+            *defensor = ataques[k][1];
+        }
+    }
+    return numAtaques > 0;
+}
+
+/**
+ * Progresso (0 a 1) de um jogador na própria missão
+ * 
+ * @param estado Estado compacto
+ * @param regras Regras com os limites das missões
+ * @param jogador Jogador avaliado
+ * @param territorios Territórios de cada jogador
+ * @param tropas Tropas de cada jogador
+ * @param fortes Territórios de cada jogador acima do limite do estrategista
+ * @param tropasTotais Tropas no mapa
+ * @return Progresso limitado a 1
+ */
+static double progressoMissaoEstado(const EstadoSimulacao* estado, const Regras* regras, int jogador,
+                                    const int* territorios, const int* tropas, const int* fortes,
+                                    int tropasTotais) {
+    double progresso;
+    switch (estado->missao[jogador]) {
+        case MISSAO_CONQUISTADOR:  progresso = (double)territorios[jogador] / regras->conquistadorTerritorios; break;
+        case MISSAO_GENERAL:       progresso = (double)tropas[jogador] / (regras->generalTropas + 1); break;
+        case MISSAO_ESTRATEGISTA:  progresso = (double)fortes[jogador] / regras->estrategistaTerritorios; break;
+        case MISSAO_IMPERADOR:     progresso = (double)territorios[jogador] / (estado->numTerritorios / 2 + 1); break;
+        case MISSAO_EXPANSIONISTA: progresso = (double)territorios[jogador] / regras->expansionistaTerritorios; break;
+        default:
+            progresso = 0.5 * territorios[jogador] / estado->numTerritorios +
+                        0.5 * ((tropasTotais > 0) ? (double)tropas[jogador] / tropasTotais : 0.0);
+            break;
+    }
+    return (progresso > 1.0) ? 1.0 : progresso;
+}
+
+/**
+ * Avaliação heurística ponderada de um estado não terminal
+ * 
+ * Média ponderada das características de PesosHeuristica, levada para
+ * (0,05; 0,95), longe dos valores de vitória e derrota.
+ * 
+ * @param estado Estado compacto
+ * @param regras Regras com os limites das missões
+ * @param jogador Jogador avaliado
+ * @param pesos Pesos das características
+ * @return Avaliação entre 0.05 e 0.95
+ */
+double avaliarHeuristica(const EstadoSimulacao* estado, const Regras* regras, int jogador,
+                         const PesosHeuristica* pesos) {
+    int territorios[MAX_JOGADORES] = {0}, tropas[MAX_JOGADORES] = {0}, fortes[MAX_JOGADORES] = {0};
+    int tropasTotais = 0;
+    
+    for (int i = 0; i < estado->numTerritorios; i++) {
+        int dono = estado->dono[i];
+        tropasTotais += estado->tropas[i];
+        if (dono >= 0) {
+            territorios[dono]++;
+            tropas[dono] += estado->tropas[i];
+            if (estado->tropas[i] > regras->estrategistaTropas) fortes[dono]++;
+        }
+    }
+    
+    double maiorAdversario = 0.0;
+    for (int j = 0; j < estado->numJogadores; j++) {
+        if (j != jogador && territorios[j] > 0) {
+            double p = progressoMissaoEstado(estado, regras, j, territorios, tropas, fortes, tropasTotais);
+            if (p > maiorAdversario) maiorAdversario = p;
+        }
+    }
+    double caracteristicas[HEURISTICA_NUM_PESOS] = {
+        (double)territorios[jogador] / estado->numTerritorios,
+        (tropasTotais > 0) ? (double)tropas[jogador] / tropasTotais : 0.0,
+        progressoMissaoEstado(estado, regras, jogador, territorios, tropas, fortes, tropasTotais),
+        1.0 - maiorAdversario
+    };
+    
+    double soma = 0.0, norma = 0.0;
+    for (int k = 0; k < HEURISTICA_NUM_PESOS; k++) {
+        soma += pesos->peso[k] * caracteristicas[k];
+        norma += fabs(pesos->peso[k]);
+    }
+    double valor = (norma > 0.0) ? soma / norma : 0.5;
+    if (valor < 0.0) valor = 0.0;
+    if (valor > 1.0) valor = 1.0;
+    return 0.05 + 0.9 * valor;
+}
+
+/**
+ * Bot heurístico: um lance à frente, maximiza a avaliação ponderada
+ * esperada sobre os três resultados dos dados. Empates ao acaso.
+ */
+static bool decidirAtaqueHeuristico(ControladorJogador* controlador, const EstadoSimulacao* visao,
+                                    int* atacante, int* defensor) {
+    DadosBot* dados = (DadosBot*)controlador->dados;
+    int ataques[MAX_ATAQUES][2];
+    int jogador = visao->jogadorDaVez;
+    int numAtaques = listarAtaques(visao, jogador, ataques);
+    double chances[3];
+    double melhor = -1.0;
+    int empatados = 0;
+    
+    calcularChancesBatalha(chances);
+    for (int k = 0; k < numAtaques; k++) {
+        double valor = 0.0;
+        for (int resultado = 0; resultado < 3; resultado++) {
+            EstadoSimulacao sucessor = *visao;
+            aplicarResultadoBatalha(&sucessor, dados->regras, ataques[k][0], ataques[k][1], resultado);
+            int vencedor = verificarVencedorEstado(&sucessor, dados->regras);
+            valor += chances[resultado] *
+                     ((vencedor >= 0) ? (vencedor == jogador ? 1.0 : 0.0)
+                                      : avaliarHeuristica(&sucessor, dados->regras, jogador, &dados->pesos));
+        }
+        if (valor > melhor) {
+            melhor = valor;
+            empatados = 0;
+        }
+        if (valor == melhor && sortearIntervalo(&dados->gerador, ++empatados) == 0) {
+            *atacante = ataques[k][0];
+            *defensor = ataques[k][1];
+        }
+    }
+    return numAtaques > 0;
+}
+
+/**
+ * Bot de tabela: jogo ótimo quando o estado está na tabela final,
+ * aleatório nos demais casos
+ */
+static bool decidirAtaqueTabela(ControladorJogador* controlador, const EstadoSimulacao* visao,
+                                int* atacante, int* defensor) {
+    DadosBot* dados = (DadosBot*)controlador->dados;
+    
+    if (melhorAtaqueTabela(&dados->tabela, visao, atacante, defensor)) {
+        return true;
+    }
+    return decidirAtaqueAleatorio(controlador, visao, atacante, defensor);
+}
+
+/**
+ * Bot MCTS: busca paralela com orçamento de tempo por jogada
+ */
+static bool decidirAtaqueMcts(ControladorJogador* controlador, const EstadoSimulacao* visao,
+                              int* atacante, int* defensor) {
+    DadosBot* dados = (DadosBot*)controlador->dados;
+    
+    if (buscarAtaqueMcts(dados->arvore, visao, atacante, defensor)) {
+        return true;
+    }
+    return decidirAtaqueAleatorio(controlador, visao, atacante, defensor);
+}
+
+/**
+ * Bot expectimax: decisão determinística dentro do orçamento de nós
+ */
+static bool decidirAtaqueExpectimax(ControladorJogador* controlador, const EstadoSimulacao* visao,
+                                    int* atacante, int* defensor) {
+    DadosBot* dados = (DadosBot*)controlador->dados;
+    return buscarAtaqueExpectimax(dados->busca, visao, atacante, defensor);
+}
+
+/**
+ * Bot rede: um lance de profundidade avaliado pela rede neural
+ */
+static bool decidirAtaqueRede(ControladorJogador* controlador, const EstadoSimulacao* visao,
+                              int* atacante, int* defensor) {
+    DadosBot* dados = (DadosBot*)controlador->dados;
+    return escolherAtaqueRede(dados->rede, visao, atacante, defensor);
+}
+
+/**
+ * Libera um controlador e seus dados
+ */
+static void liberarControlador(ControladorJogador* controlador) {
+    if (controlador == NULL) {
+        return;
+    }
+    if (controlador->decidirAtaque == decidirAtaqueTabela) {
+        fecharTabelaFinal(&((DadosBot*)controlador->dados)->tabela);
+    }
+    if (controlador->decidirAtaque == decidirAtaqueMcts) {
+        liberarArvoreMcts(((DadosBot*)controlador->dados)->arvore);
+    }
+    if (controlador->decidirAtaque == decidirAtaqueExpectimax) {
+        liberarBuscaExpectimax(((DadosBot*)controlador->dados)->busca);
+    }
+    if (controlador->decidirAtaque == decidirAtaqueRede) {
+        liberarRede(((DadosBot*)controlador->dados)->rede);
+    }
+    free(controlador->latencias);
+    free(controlador->dados);
+    free(controlador);
+}
+
+/**
+ * Cria um controlador pelo nome do tipo
+ * 
+ * Tipos: "humano", "aleatorio", "estrategista", "tabela:ARQUIVO",
+ * "mcts[:THREADS:MILISSEGUNDOS:MEGABYTES]" (MEGABYTES é o tamanho da
+ * tabela de transposição) e "expectimax[:NOS:PROFUNDIDADE[:PESOS]]"
+ * (PESOS é um arquivo da rede de avaliação; sem ele, avaliação heurística)
+ * e "rede[:PESOS]" (sem PESOS, rede com pesos sorteados) e
+ * "heuristico[:P1:P2:P3:P4]" (pesos de PesosHeuristica; sem eles, os
+ * pesos do expectimax).
+ * 
+ * @param tipo Nome do tipo
+ * @param semente Semente do gerador do bot
+ * @return Controlador alocado, ou NULL se o tipo é desconhecido ou falhou
+ */
+ControladorJogador* criarControlador(const char* tipo, uint64_t semente) {
+    ControladorJogador* controlador = (ControladorJogador*)calloc(1, sizeof(ControladorJogador));
+    if (controlador == NULL) {
+        return NULL;
+    }
+    controlador->liberar = liberarControlador;
+    
+    if (strcmp(tipo, "humano") == 0) {
+        controlador->nome = "humano";
+        controlador->decidirAtaque = decidirAtaqueHumano;
+        controlador->dados = calloc(1, sizeof(DadosHumano));
+    } else {
+        DadosBot* dados = (DadosBot*)calloc(1, sizeof(DadosBot));
+        controlador->dados = dados;
+        if (dados != NULL) {
+            inicializarGerador(&dados->gerador, semente);
+            dados->regras = &regrasPadrao;
+        }
+        
+        if (strcmp(tipo, "aleatorio") == 0) {
+            controlador->nome = "bot aleatório";
+            controlador->decidirAtaque = decidirAtaqueAleatorio;
+        } else if (strcmp(tipo, "estrategista") == 0) {
+            controlador->nome = "bot estrategista";
+            controlador->decidirAtaque = decidirAtaqueEstrategista;
+        } else if (strncmp(tipo, "mcts", 4) == 0 && (tipo[4] == '\0' || tipo[4] == ':') && dados != NULL) {
+            int threads = contarNucleos();
+            int milissegundos = MCTS_TEMPO_PADRAO_MS;
+            int megabytes = TT_MEMORIA_PADRAO_MB;
+            if (tipo[4] == ':' && sscanf(tipo + 5, "%d:%d:%d", &threads, &milissegundos, &megabytes) < 1) {
+                printf("❌ Erro: Parâmetros inválidos em %s (use mcts[:THREADS:MS:MB])\n", tipo);
+                free(dados);
+                free(controlador);
+                return NULL;
+            }
+            controlador->nome = "bot MCTS";
+            controlador->decidirAtaque = decidirAtaqueMcts;
+            dados->arvore = criarArvoreMcts(threads, milissegundos, megabytes, semente);
+            if (dados->arvore == NULL) {
+                free(dados);
+                controlador->dados = NULL;
+            }
+        } else if (strncmp(tipo, "expectimax", 10) == 0 && (tipo[10] == '\0' || tipo[10] == ':') &&
+                   dados != NULL) {
+            long nos = EXPECTIMAX_NOS_PADRAO;
+            int profundidade = EXPECTIMAX_MAX_PROFUNDIDADE;
+            int consumidos = 0;
+            if (tipo[10] == ':' &&
+                (sscanf(tipo + 11, "%ld:%d:%n", &nos, &profundidade, &consumidos) < 1 ||
+                 nos < 1 || profundidade < 1 || profundidade > EXPECTIMAX_MAX_PROFUNDIDADE)) {
+                printf("❌ Erro: Parâmetros inválidos em %s (use expectimax[:NOS:PROFUNDIDADE[:PESOS]],"
+                       " NOS >= 1, PROFUNDIDADE de 1 a %d)\n", tipo, EXPECTIMAX_MAX_PROFUNDIDADE);
+                free(dados);
+                free(controlador);
+                return NULL;
+            }
+            controlador->nome = "bot expectimax";
+            controlador->decidirAtaque = decidirAtaqueExpectimax;
+            dados->busca = criarBuscaExpectimax(nos, profundidade, TT_MEMORIA_PADRAO_MB,
+                                                consumidos > 0 ? tipo + 11 + consumidos : NULL);
+            if (dados->busca == NULL) {
+                free(dados);
+                controlador->dados = NULL;
+            }
+        } else if (strncmp(tipo, "rede", 4) == 0 && (tipo[4] == '\0' || tipo[4] == ':') && dados != NULL) {
+            controlador->nome = "bot rede";
+            controlador->decidirAtaque = decidirAtaqueRede;
+            dados->rede = (tipo[4] == ':') ? carregarRede(tipo + 5) : criarRedePadrao(REDE_SEMENTE_PADRAO);
+            if (dados->rede == NULL) {
+                free(dados);
+                controlador->dados = NULL;
+            }
+        } else if (strncmp(tipo, "heuristico", 10) == 0 && (tipo[10] == '\0' || tipo[10] == ':') &&
+                   dados != NULL) {
+            controlador->nome = "bot heurístico";
+            controlador->decidirAtaque = decidirAtaqueHeuristico;
+            dados->pesos = pesosHeuristicaPadrao;
+            if (tipo[10] == ':' &&
+                sscanf(tipo + 11, "%lf:%lf:%lf:%lf", &dados->pesos.peso[0], &dados->pesos.peso[1],
+                       &dados->pesos.peso[2], &dados->pesos.peso[3]) < 1) {
+                printf("❌ Erro: Parâmetros inválidos em %s (use heuristico[:P1:P2:P3:P4])\n", tipo);
+                free(dados);
+                free(controlador);
+                return NULL;
+            }
+        } else if (strncmp(tipo, "tabela:", 7) == 0 && dados != NULL) {
+            controlador->nome = "bot de tabela final";
+            controlador->decidirAtaque = decidirAtaqueTabela;
+            if (!abrirTabelaFinal(&dados->tabela, tipo + 7)) {
+                free(dados);
+                free(controlador);
+                return NULL;
+            }
+        } else {
+            printf("❌ Erro: Tipo de controlador desconhecido: %s\n", tipo);
+            free(dados);
+            free(controlador);
+            return NULL;
+        }
+    }
+    
+    if (controlador->dados == NULL) {
+        free(controlador);
+        return NULL;
+    }
+    return controlador;
+}
+
+/**
+ * Define o prazo por jogada de um bot de busca (MCTS ou expectimax)
+ * 
+ * Sem efeito para os demais controladores, que decidem de imediato.
+ * 
+ * @param controlador Controlador do jogador
+ * @param prazoMs Limite por jogada em milissegundos (0 = sem limite)
+ */
+void definirPrazoControlador(ControladorJogador* controlador, long prazoMs) {
+    if (controlador->decidirAtaque == decidirAtaqueMcts) {
+        definirPrazoMcts(((DadosBot*)controlador->dados)->arvore, prazoMs);
+    } else if (controlador->decidirAtaque == decidirAtaqueExpectimax) {
+        definirPrazoExpectimax(((DadosBot*)controlador->dados)->busca, prazoMs);
+    }
+}
+
+/**
+ * Define as regras com que um bot avalia as jogadas
+ * 
+ * Os bots nascem com as regras oficiais; quem os liga a uma partida com
+ * outras regras as repassa aqui. Sem efeito para o controlador humano.
+ * 
+ * @param controlador Controlador do jogador
+ * @param regras Regras da partida (devem durar enquanto o bot jogar)
+ */
+void definirRegrasControlador(ControladorJogador* controlador, const Regras* regras) {
+    if (controladorEhHumano(controlador)) {
+        return;
+    }
+    DadosBot* dados = (DadosBot*)controlador->dados;
+    dados->regras = regras;
+    if (controlador->decidirAtaque == decidirAtaqueMcts) {
+        definirRegrasMcts(dados->arvore, regras);
+    } else if (controlador->decidirAtaque == decidirAtaqueExpectimax) {
+        definirRegrasExpectimax(dados->busca, regras);
+    }
+}
+
+/**
+ * Prepara um bot para uma nova partida, como se acabasse de ser criado
+ * 
+ * Volta o gerador à semente dada e esquece o estado das buscas (tabelas
+ * de transposição), para que a partida não dependa das que o mesmo
+ * controlador jogou antes. Sem efeito para o controlador humano.
+ * 
+ * @param controlador Controlador do jogador
+ * @param semente Semente da partida para este jogador
+ */
+void reiniciarControlador(ControladorJogador* controlador, uint64_t semente) {
+    if (controladorEhHumano(controlador)) {
+        return;
+    }
+    DadosBot* dados = (DadosBot*)controlador->dados;
+    inicializarGerador(&dados->gerador, semente);
+    if (controlador->decidirAtaque == decidirAtaqueMcts) {
+        reiniciarArvoreMcts(dados->arvore, semente);
+    } else if (controlador->decidirAtaque == decidirAtaqueExpectimax) {
+        reiniciarBuscaExpectimax(dados->busca);
+    }
+}
+
+/**
+ * Liga o controlador humano à análise em segundo plano
+ * 
+ * Sem efeito para bots.
+ * 
+ * @param controlador Controlador do jogador
+ * @param analisador Analisador em segundo plano
+ * @param mapa Array de territórios (para os nomes)
+ * @param jogadores Array de jogadores
+ */
+void conectarControladorHumano(ControladorJogador* controlador, AnalisadorFundo* analisador,
+                               const Territorio* mapa, const Jogador* jogadores) {
+    if (controladorEhHumano(controlador)) {
+        DadosHumano* dados = (DadosHumano*)controlador->dados;
+        dados->analisador = analisador;
+        dados->mapa = mapa;
+        dados->jogadores = jogadores;
+    }
+}
+
+/**
+ * Indica se o controlador lê as decisões do terminal
+ * 
+ * @param controlador Controlador do jogador
+ * @return true para o controlador humano
+ */
+bool controladorEhHumano(const ControladorJogador* controlador) {
+    return controlador != NULL && controlador->decidirAtaque == decidirAtaqueHumano;
+}
+
+/**
+ * Joga uma partida completa entre controladores, sem entrada/saída
+ * 
+ * Mesmo fluxo do jogo interativo: o jogador da vez escolhe um ataque,
+ * ataques inválidos são ignorados e a vez passa ao próximo ativo.
+ * 
+ * @param estado Estado compacto inicial (modificado)
+ * @param regras Regras da partida
+ * @param controladores Um controlador por jogador
+ * @param dados Gerador dos dados de batalha
+ * @param maxTurnos Limite de turnos antes de declarar empate
+ * @param turnosJogados Saída com a duração da partida (pode ser NULL)
+ * @return Índice do vencedor, ou -1 se o limite foi atingido
+ */
+int jogarPartidaControladores(EstadoSimulacao* estado, const Regras* regras, ControladorJogador** controladores,
+                              GeradorAleatorio* dados, int maxTurnos, int* turnosJogados) {
+    int vencedor = -1;
+    int turno;
+    
+    for (turno = 0; turno < maxTurnos; turno++) {
+        vencedor = verificarVencedorEstado(estado, regras);
+        if (vencedor != -1) {
+            break;
+        }
+        
+        ControladorJogador* controlador = controladores[estado->jogadorDaVez];
+        int atacante, defensor;
+        struct timespec inicio, fim;
+        if (controlador->latencias != NULL) {
+            clock_gettime(CLOCK_MONOTONIC, &inicio);
+        }
+        bool decidiu = controlador->decidirAtaque(controlador, estado, &atacante, &defensor);
+        if (controlador->latencias != NULL) {
+            clock_gettime(CLOCK_MONOTONIC, &fim);
+            registrarLatencia(controlador->latencias,
+                              (fim.tv_sec - inicio.tv_sec) * 1000000000L + (fim.tv_nsec - inicio.tv_nsec));
+        }
+        if (decidiu &&
+            atacante >= 0 && atacante < estado->numTerritorios &&
+            defensor >= 0 && defensor < estado->numTerritorios &&
+            estado->dono[atacante] == estado->jogadorDaVez &&
+            estado->dono[defensor] != estado->jogadorDaVez) {
+            resolverBatalhaEstado(estado, regras, atacante, defensor, dados);
+        }
+        avancarJogadorDaVez(estado);
+    }
+    
+    if (turno == maxTurnos) {
+        vencedor = verificarVencedorEstado(estado, regras);
+    }
+    if (turnosJogados != NULL) {
+        *turnosJogados = turno;
+    }
+    return vencedor;
+}
+
+/**
+ * Executa partidas só entre bots e mede a velocidade do motor
+ * 
+ * @param lista Tipos dos bots separados por vírgula (um por jogador)
+ * @param opcoes Número de partidas, territórios e semente
+ * @param prazoMs Prazo por jogada dos bots de busca (0 = sem prazo)
+ */
+void executarPartidasBots(char* lista, const OpcoesSimulacao* opcoes, long prazoMs) {
+    ControladorJogador* controladores[MAX_JOGADORES];
+    long vitorias[MAX_JOGADORES] = {0};
+    long empates = 0, somaTurnos = 0;
+    int numJogadores = 0;
+    
+    for (char* tipo = strtok(lista, ","); tipo != NULL; tipo = strtok(NULL, ",")) {
+        if (numJogadores == MAX_JOGADORES) {
+            printf("❌ Erro: No máximo %d bots por partida.\n", MAX_JOGADORES);
+            numJogadores = -1;
+            break;
+        }
+        controladores[numJogadores] = criarControlador(tipo, opcoes->semente * 31 + numJogadores);
+        if (controladores[numJogadores] == NULL || controladorEhHumano(controladores[numJogadores])) {
+            if (controladores[numJogadores] != NULL) {
+                printf("❌ Erro: O modo --bots não aceita jogadores humanos.\n");
+                controladores[numJogadores]->liberar(controladores[numJogadores]);
+            }
+            numJogadores = -1;
+            break;
+        }
+        definirPrazoControlador(controladores[numJogadores], prazoMs);
+        controladores[numJogadores]->latencias = (HistogramaLatencia*)calloc(1, sizeof(HistogramaLatencia));
+        numJogadores++;
+    }
+    if (numJogadores < MIN_JOGADORES || numJogadores > opcoes->numTerritorios) {
+        if (numJogadores >= 0) {
+            printf("❌ Erro: Informe de %d a %d bots.\n", MIN_JOGADORES, MAX_JOGADORES);
+        }
+        for (int j = 0; j < numJogadores; j++) {
+            controladores[j]->liberar(controladores[j]);
+        }
+        return;
+    }
+    
+    printf("\n🤖 ═══════════════════════════════════════════════════════════\n");
+    printf("                   PARTIDAS ENTRE BOTS\n");
+    printf("═══════════════════════════════════════════════════════════🤖\n");
+    
+    struct timespec inicio, fim;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    
+    for (long jogo = 0; jogo < opcoes->numJogos; jogo++) {
+        GeradorAleatorio sorteio, dados;
+        EstadoSimulacao estado;
+        int duracao;
+        
+        inicializarGerador(&sorteio, (opcoes->semente + (uint64_t)jogo) * 3);
+        inicializarGerador(&dados, (opcoes->semente + (uint64_t)jogo) * 3 + 1);
+        gerarPartidaAleatoria(&estado, &regrasPadrao, numJogadores, opcoes->numTerritorios, &sorteio);
+        
+        int vencedor = jogarPartidaControladores(&estado, &regrasPadrao, controladores, &dados,
+                                                 ROLLOUT_MAX_TURNOS, &duracao);
+        if (vencedor >= 0) vitorias[vencedor]++;
+        else empates++;
+        somaTurnos += duracao;
+    }
+    
+    clock_gettime(CLOCK_MONOTONIC, &fim);
+    double segundos = (fim.tv_sec - inicio.tv_sec) + (fim.tv_nsec - inicio.tv_nsec) / 1e9;
+    
+    for (int j = 0; j < numJogadores; j++) {
+        HistogramaLatencia* latencias = controladores[j]->latencias;
+        printf("👤 Jogador %d (%s): %5.1f%% de vitórias\n", j + 1, controladores[j]->nome,
+               100.0 * vitorias[j] / opcoes->numJogos);
+        if (latencias != NULL && latencias->total > 0) {
+            long acimaDoPrazo = 0;
+            if (prazoMs > 0) {
+                for (int k = 0; k < LATENCIA_FAIXAS * LATENCIA_SUBFAIXAS; k++) {
+                    if (latencias->contagem[k] > 0 && percentilFaixaLatencia(k) > prazoMs * 1000000L) {
+                        acimaDoPrazo += latencias->contagem[k];
+                    }
+                }
+            }
+            printf("   ⏱️  p50 %.3f ms | p99 %.3f ms | p99,9 %.3f ms | máx %.3f ms",
+                   percentilLatencia(latencias, 0.5) / 1e6, percentilLatencia(latencias, 0.99) / 1e6,
+                   percentilLatencia(latencias, 0.999) / 1e6, latencias->maximoNs / 1e6);
+            if (prazoMs > 0) {
+                printf(" | acima de %ld ms: %ld", prazoMs, acimaDoPrazo);
+            }
+            printf("\n");
+        }
+        controladores[j]->liberar(controladores[j]);
+    }
+    printf("🤝 Limite de turnos: %.1f%% | ⏱️  duração média: %.1f turnos\n",
+           100.0 * empates / opcoes->numJogos, (double)somaTurnos / opcoes->numJogos);
+    printf("🚀 %ld partidas em %.2f s (%.0f partidas/s)\n", opcoes->numJogos, segundos,
+           opcoes->numJogos / (segundos > 0 ? segundos : 1e-9));
+}
+
+// ============================================================================
+// IMPLEMENTAÇÃO DAS FUNÇÕES - BOT MCTS PARALELO
+// ============================================================================
+
+/*
+ * Struct: ArvoreMcts
+ *
+ * Árvore compartilhada por todas as threads da busca (paralelismo na
+ * árvore). Nós e arestas vêm de arenas pré-alocadas com contadores
+ * atômicos, então nenhuma thread trava para crescer a árvore. A tabela
+ * de transposição liga estados repetidos (ex.: após empates) ao mesmo nó.
+ * As threads auxiliares são criadas com a árvore e esperam em 'inicio'
+ * pela próxima busca; 'trava' protege buscaAtual, emBusca e encerrar.
+ */
+typedef struct {
+    NoMcts* nos;
+    ArestaMcts* arestas;
+    atomic_int totalNos;
+    atomic_int totalArestas;
+    EstadoSimulacao raiz;
+    const Regras* regras;
+    GerenciadorTempo tempo;
+    atomic_bool parar;
+    atomic_long iteracoes;
+    TabelaTransposicao transposicao;
+    int numThreads;
+    int milissegundos;
+    uint64_t semente;
+    uint64_t jogada;
+    pthread_t threads[MCTS_MAX_THREADS];
+    int threadsCriadas;
+    atomic_int proximoIndice;
+    pthread_mutex_t trava;
+    pthread_cond_t inicio;      // Nova busca ou encerramento
+    pthread_cond_t fim;         // A última thread auxiliar terminou a busca
+    uint64_t buscaAtual;
+    int emBusca;
+    bool encerrar;
+} ArvoreMcts;
+
+static void* executarTrabalhadorMcts(void* argumento);
+
+/**
+ * Cria a árvore (arenas de nós e arestas) de um bot MCTS
+ * 
+ * As threads auxiliares da busca nascem aqui e são reaproveitadas em
+ * todas as jogadas do bot.
+ * 
+ * @param numThreads Threads por decisão (1 a MCTS_MAX_THREADS)
+ * @param milissegundos Orçamento de tempo por jogada
+ * @param megabytes Memória da tabela de transposição (0 desativa)
+ * @param semente Semente dos geradores das threads
+ * @return Árvore alocada, ou NULL se faltou memória
+ */
+void* criarArvoreMcts(int numThreads, int milissegundos, int megabytes, uint64_t semente) {
+    ArvoreMcts* arvore = (ArvoreMcts*)calloc(1, sizeof(ArvoreMcts));
+    if (arvore == NULL) {
+        return NULL;
+    }
+    pthread_mutex_init(&arvore->trava, NULL);
+    pthread_cond_init(&arvore->inicio, NULL);
+    pthread_cond_init(&arvore->fim, NULL);
+    
+    arvore->nos = (NoMcts*)calloc(MCTS_MAX_NOS, sizeof(NoMcts));
+    arvore->arestas = (ArestaMcts*)calloc(MCTS_MAX_ARESTAS, sizeof(ArestaMcts));
+    if (arvore->nos == NULL || arvore->arestas == NULL ||
+        (megabytes > 0 && !criarTabelaTransposicao(&arvore->transposicao, (size_t)megabytes))) {
+        liberarArvoreMcts(arvore);
+        return NULL;
+    }
+    // Pré-carrega as arenas (mesmo motivo da tabela de transposição)
+    memset(arvore->nos, 0, MCTS_MAX_NOS * sizeof(NoMcts));
+    memset(arvore->arestas, 0, MCTS_MAX_ARESTAS * sizeof(ArestaMcts));
+    
+    arvore->numThreads = (numThreads < 1) ? 1 : (numThreads > MCTS_MAX_THREADS) ? MCTS_MAX_THREADS : numThreads;
+    arvore->milissegundos = (milissegundos < 1) ? 1 : milissegundos;
+    arvore->semente = semente;
+    arvore->regras = &regrasPadrao;
+    
+    // Sem alguma das auxiliares, a busca segue com as que foram criadas
+    atomic_init(&arvore->proximoIndice, 1);
+    for (int t = 1; t < arvore->numThreads; t++) {
+        if (pthread_create(&arvore->threads[arvore->threadsCriadas], NULL, executarTrabalhadorMcts, arvore) != 0) {
+            break;
+        }
+        arvore->threadsCriadas++;
+    }
+    return arvore;
+}
+
+/**
+ * Libera a árvore de um bot MCTS
+ * 
+ * @param arvore Árvore (pode ser NULL)
+ */
+void liberarArvoreMcts(void* arvore) {
+    ArvoreMcts* a = (ArvoreMcts*)arvore;
+    if (a != NULL) {
+        pthread_mutex_lock(&a->trava);
+        a->encerrar = true;
+        pthread_cond_broadcast(&a->inicio);
+        pthread_mutex_unlock(&a->trava);
+        for (int t = 0; t < a->threadsCriadas; t++) {
+            pthread_join(a->threads[t], NULL);
+        }
+        pthread_cond_destroy(&a->fim);
+        pthread_cond_destroy(&a->inicio);
+        pthread_mutex_destroy(&a->trava);
+        free(a->nos);
+        free(a->arestas);
+        liberarTabelaTransposicao(&a->transposicao);
+        free(a);
+    }
+}
+
+/**
+ * Inicializa um nó de decisão já reservado na arena
+ * 
+ * @param arvore Árvore
+ * @param indice Nó a inicializar
+ * @param jogador Jogador da vez no nó
+ */
+static void inicializarNoMcts(ArvoreMcts* arvore, int indice, int jogador) {
+    NoMcts* no = &arvore->nos[indice];
+    atomic_store_explicit(&no->expansao, 0, memory_order_relaxed);
+    atomic_store_explicit(&no->visitas, 0, memory_order_relaxed);
+    atomic_store_explicit(&no->jogador, jogador, memory_order_relaxed);
+    no->numArestas = 0;
+}
+
+/**
+ * Reserva e inicializa um nó de decisão
+ * 
+ * @param arvore Árvore
+ * @param jogador Jogador da vez no nó
+ * @return Índice do nó, ou 0 se a arena acabou
+ */
+static int criarNoMcts(ArvoreMcts* arvore, int jogador) {
+    int indice = atomic_fetch_add_explicit(&arvore->totalNos, 1, memory_order_relaxed);
+    if (indice >= MCTS_MAX_NOS) {
+        return 0;
+    }
+    inicializarNoMcts(arvore, indice, jogador);
+    return indice;
+}
+
+/**
+ * Procura o nó de um estado já presente na árvore
+ * 
+ * Estados repetidos por caminhos diferentes compartilham o nó e suas
+ * estatísticas. Entradas de jogadas anteriores (outra idade) apontam
+ * para nós já reciclados e são ignoradas.
+ * 
+ * @param arvore Árvore
+ * @param estado Estado do nó procurado
+ * @return Índice do nó, ou 0 se o estado ainda não tem nó
+ */
+static int consultarNoTransposicao(ArvoreMcts* arvore, const EstadoSimulacao* estado) {
+    TabelaTransposicao* tabela = &arvore->transposicao;
+    RegistroTransposicao registro;
+    
+    if (tabela->baldes == NULL) {
+        return 0;
+    }
+    
+    int idade = (int)(atomic_load_explicit(&tabela->idade, memory_order_relaxed) & 0xFF);
+    if (consultarTransposicao(tabela, estado->hash, &registro) && registro.idade == idade &&
+        registro.valor > 0 && registro.valor < (uint32_t)MCTS_MAX_NOS &&
+        atomic_load_explicit(&arvore->nos[registro.valor].jogador, memory_order_relaxed) == estado->jogadorDaVez) {
+        return (int)registro.valor;
+    }
+    return 0;
+}
+
+/**
+ * Registra na tabela de transposição o nó recém-ligado à árvore
+ * 
+ * @param arvore Árvore
+ * @param estado Estado do nó
+ * @param profundidade Distância até a raiz
+ * @param indice Nó do estado
+ */
+static void registrarNoTransposicao(ArvoreMcts* arvore, const EstadoSimulacao* estado, int profundidade,
+                                    int indice) {
+    RegistroTransposicao registro;
+    
+    if (arvore->transposicao.baldes == NULL) {
+        return;
+    }
+    // Nós rasos valem mais (mais visitas): guardados com maior profundidade restante
+    registro.valor = (uint32_t)indice;
+    registro.profundidade = ROLLOUT_MAX_TURNOS - profundidade;
+    registro.tipo = TT_EXATO;
+    registro.atacante = -1;
+    registro.defensor = -1;
+    gravarTransposicao(&arvore->transposicao, estado->hash, &registro);
+}
+
+/**
+ * Expande um nó com todos os ataques do jogador da vez
+ * 
+ * Apenas a thread que vencer o CAS expande; as demais seguem com uma
+ * simulação a partir do nó, sem esperar.
+ * 
+ * @param arvore Árvore
+ * @param no Nó a expandir
+ * @param estado Estado correspondente ao nó
+ */
+static void expandirNoMcts(ArvoreMcts* arvore, NoMcts* no, const EstadoSimulacao* estado) {
+    int esperado = 0;
+    if (!atomic_compare_exchange_strong(&no->expansao, &esperado, 1)) {
+        return;
+    }
+    
+    int ataques[MAX_ATAQUES][2];
+    int numAtaques = listarAtaques(estado, estado->jogadorDaVez, ataques);
+    int numArestas = (numAtaques > 0) ? numAtaques : 1; // Sem ataques: aresta de passar a vez
+    int primeira = atomic_fetch_add_explicit(&arvore->totalArestas, numArestas, memory_order_relaxed);
+    
+    if (primeira + numArestas > MCTS_MAX_ARESTAS) {
+        atomic_store_explicit(&no->expansao, 0, memory_order_release); // Arena cheia: continua folha
+        return;
+    }
+    
+    for (int k = 0; k < numArestas; k++) {
+        ArestaMcts* aresta = &arvore->arestas[primeira + k];
+        aresta->atacante = (int8_t)((numAtaques > 0) ? ataques[k][0] : -1);
+        aresta->defensor = (int8_t)((numAtaques > 0) ? ataques[k][1] : -1);
+        atomic_store_explicit(&aresta->visitas, 0, memory_order_relaxed);
+        atomic_store_explicit(&aresta->recompensa, 0, memory_order_relaxed);
+        for (int r = 0; r < 3; r++) {
+            atomic_store_explicit(&aresta->filhos[r], 0, memory_order_relaxed);
+        }
+    }
+    no->primeiraAresta = primeira;
+    no->numArestas = numArestas;
+    atomic_store_explicit(&no->expansao, 2, memory_order_release);
+}
+
+/**
+ * Escolhe a aresta com maior UCT
+ * 
+ * A perda virtual já somada às visitas de arestas em uso por outras
+ * threads reduz sua média e afasta as demais threads do mesmo caminho.
+ * 
+ * @param arvore Árvore
+ * @param no Nó expandido
+ * @return Índice da aresta escolhida
+ */
+static int selecionarArestaMcts(ArvoreMcts* arvore, NoMcts* no) {
+    int visitasNo = atomic_load_explicit(&no->visitas, memory_order_relaxed);
+    double logPai = log((double)visitasNo + 1.0);
+    double melhor = -1.0;
+    int escolhida = no->primeiraAresta;
+    
+    for (int k = 0; k < no->numArestas; k++) {
+        ArestaMcts* aresta = &arvore->arestas[no->primeiraAresta + k];
+        int visitas = atomic_load_explicit(&aresta->visitas, memory_order_relaxed);
+        if (visitas == 0) {
+            return no->primeiraAresta + k; // Ataques nunca tentados primeiro
+        }
+        double media = (double)atomic_load_explicit(&aresta->recompensa, memory_order_relaxed) /
+                       (MCTS_ESCALA * (double)visitas);
+        double valor = media + MCTS_EXPLORACAO * sqrt(logPai / visitas);
+        if (valor > melhor) {
+            melhor = valor;
+            escolhida = no->primeiraAresta + k;
+        }
+    }
+    return escolhida;
+}
+
+/**
+ * Uma iteração da busca: seleção, expansão, simulação e retropropagação
+ * 
+ * @param arvore Árvore
+ * @param gerador Gerador da thread (dados e simulação)
+ * @param reserva Nó reservado pela thread e ainda não ligado à árvore
+ *                (0 se nenhum); reaproveitado quando outra thread vence o CAS
+ */
+static void iterarMcts(ArvoreMcts* arvore, GeradorAleatorio* gerador, int* reserva) {
+    EstadoSimulacao estado = arvore->raiz;
+    int caminhoNos[ROLLOUT_MAX_TURNOS];
+    int caminhoArestas[ROLLOUT_MAX_TURNOS];
+    int profundidade = 0;
+    int indiceNo = 0;
+    int vencedor = verificarVencedorEstado(&estado, arvore->regras);
+    
+    // Seleção descendo pela árvore até uma folha ou fim de partida
+    while (vencedor == -1 && profundidade < ROLLOUT_MAX_TURNOS) {
+        NoMcts* no = &arvore->nos[indiceNo];
+        int expansao = atomic_load_explicit(&no->expansao, memory_order_acquire);
+        if (expansao != 2) {
+            if (expansao == 0) {
+                expandirNoMcts(arvore, no, &estado);
+            }
+            break;
+        }
+        
+        int indiceAresta = selecionarArestaMcts(arvore, no);
+        ArestaMcts* aresta = &arvore->arestas[indiceAresta];
+        atomic_fetch_add_explicit(&aresta->visitas, MCTS_PERDA_VIRTUAL, memory_order_relaxed);
+        caminhoNos[profundidade] = indiceNo;
+        caminhoArestas[profundidade] = indiceAresta;
+        profundidade++;
+        
+        // Nó de acaso: os dados decidem qual filho segue
+        int resultado = BATALHA_EMPATE;
+        if (aresta->atacante >= 0) {
+            resultado = resolverBatalhaEstado(&estado, arvore->regras, aresta->atacante, aresta->defensor, gerador);
+            if (resultado == BATALHA_INVALIDA) resultado = BATALHA_EMPATE;
+        }
+        vencedor = verificarVencedorEstado(&estado, arvore->regras);
+        avancarJogadorDaVez(&estado);
+        if (vencedor != -1) {
+            break;
+        }
+        
+        int filho = atomic_load_explicit(&aresta->filhos[resultado], memory_order_acquire);
+        if (filho == 0) {
+            int novo = consultarNoTransposicao(arvore, &estado);
+            bool reservado = (novo == 0);
+            if (reservado) {
+                if (*reserva != 0) {
+                    novo = *reserva;
+                    *reserva = 0;
+                    inicializarNoMcts(arvore, novo, estado.jogadorDaVez);
+                } else {
+                    novo = criarNoMcts(arvore, estado.jogadorDaVez);
+                }
+                if (novo == 0) {
+                    break; // Arena cheia: simula a partir daqui
+                }
+            }
+            int esperado = 0;
+            if (atomic_compare_exchange_strong(&aresta->filhos[resultado], &esperado, novo)) {
+                filho = novo;
+                if (reservado) {
+                    registrarNoTransposicao(arvore, &estado, profundidade, novo);
+                }
+            } else {
+                filho = esperado; // Outra thread criou antes
+                if (reservado) {
+                    *reserva = novo; // Guardado para o próximo nó desta thread
+                }
+            }
+        }
+        indiceNo = filho;
+    }
+    
+    // Simulação aleatória até o fim
+    if (vencedor == -1) {
+        vencedor = simularPartidaAleatoria(&estado, arvore->regras, gerador, gerador,
+                                           ROLLOUT_MAX_TURNOS - profundidade, NULL);
+    }
+    
+    // Retropropagação: cada aresta recebe a recompensa de quem a escolheu
+    long empate = MCTS_ESCALA / arvore->raiz.numJogadores;
+    for (int p = 0; p < profundidade; p++) {
+        NoMcts* no = &arvore->nos[caminhoNos[p]];
+        ArestaMcts* aresta = &arvore->arestas[caminhoArestas[p]];
+        int jogador = atomic_load_explicit(&no->jogador, memory_order_relaxed);
+        long recompensa = (vencedor == jogador) ? MCTS_ESCALA : (vencedor < 0) ? empate : 0;
+        atomic_fetch_add_explicit(&aresta->recompensa, recompensa, memory_order_relaxed);
+        atomic_fetch_sub_explicit(&aresta->visitas, MCTS_PERDA_VIRTUAL - 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&no->visitas, 1, memory_order_relaxed);
+    }
+}
+
+/**
+ * Define o prazo por jogada do bot MCTS (substitui o orçamento fixo)
+ * 
+ * @param arvore Árvore do bot
+ * @param prazoMs Limite por jogada em milissegundos (0 = orçamento fixo)
+ */
+void definirPrazoMcts(void* arvore, long prazoMs) {
+    ((ArvoreMcts*)arvore)->tempo.prazoMs = prazoMs;
+}
+
+/**
+ * Define as regras usadas pelas simulações do bot MCTS
+ * 
+ * @param arvore Árvore do bot (sem busca em andamento)
+ * @param regras Regras da partida
+ */
+void definirRegrasMcts(void* arvore, const Regras* regras) {
+    ((ArvoreMcts*)arvore)->regras = regras;
+}
+
+/**
+ * Recomeça o bot MCTS como recém-criado, com outra semente
+ * 
+ * @param arvore Árvore do bot (sem busca em andamento)
+ * @param semente Nova semente dos geradores das threads
+ */
+void reiniciarArvoreMcts(void* arvore, uint64_t semente) {
+    ArvoreMcts* a = (ArvoreMcts*)arvore;
+    a->semente = semente;
+    a->jogada = 0;
+    limparTabelaTransposicao(&a->transposicao);
+}
+
+/**
+ * Participação de uma thread em uma busca, até alguém decidir parar
+ * 
+ * @param arvore Árvore (raiz e prazo já preparados)
+ * @param indice Índice da thread (0 é a que chamou buscarAtaqueMcts)
+ */
+static void buscarComThreadMcts(ArvoreMcts* arvore, int indice) {
+    GeradorAleatorio gerador;
+    long iteracoes = 0;
+    int reserva = 0;
+    
+    inicializarGerador(&gerador, arvore->semente ^ (arvore->jogada * 0x9E3779B97F4A7C15ULL) ^
+                                 ((uint64_t)indice << 48));
+    
+    while (!atomic_load_explicit(&arvore->parar, memory_order_relaxed)) {
+        iterarMcts(arvore, &gerador, &reserva);
+        iteracoes++;
+        
+        // Consulta o relógio a cada 16 iterações; arenas quase cheias também encerram
+        if ((iteracoes & 15) == 0 &&
+            (tempoEsgotado(&arvore->tempo) ||
+             atomic_load_explicit(&arvore->totalNos, memory_order_relaxed) >= MCTS_MAX_NOS - MCTS_MAX_THREADS ||
+             atomic_load_explicit(&arvore->totalArestas, memory_order_relaxed) >= MCTS_MAX_ARESTAS - MAX_ATAQUES)) {
+            atomic_store_explicit(&arvore->parar, true, memory_order_relaxed);
+        }
+    }
+    
+    atomic_fetch_add(&arvore->iteracoes, iteracoes);
+}
+
+/**
+ * Corpo de uma thread auxiliar da busca (vive enquanto a árvore existir)
+ * 
+ * @param argumento Ponteiro para a ArvoreMcts
+ * @return NULL
+ */
+static void* executarTrabalhadorMcts(void* argumento) {
+    ArvoreMcts* arvore = (ArvoreMcts*)argumento;
+    int indice = atomic_fetch_add(&arvore->proximoIndice, 1);
+    uint64_t vista = 0;
+    
+    pthread_mutex_lock(&arvore->trava);
+    while (true) {
+        while (!arvore->encerrar && arvore->buscaAtual == vista) {
+            pthread_cond_wait(&arvore->inicio, &arvore->trava);
+        }
+        if (arvore->encerrar) {
+            break;
+        }
+        vista = arvore->buscaAtual;
+        pthread_mutex_unlock(&arvore->trava);
+        
+        buscarComThreadMcts(arvore, indice);
+        
+        pthread_mutex_lock(&arvore->trava);
+        if (--arvore->emBusca == 0) {
+            pthread_cond_signal(&arvore->fim);
+        }
+    }
+    pthread_mutex_unlock(&arvore->trava);
+    return NULL;
+}
+
+/**
+ * Escolhe um ataque por busca em árvore Monte Carlo
+ * 
+ * Todas as threads compartilham a mesma árvore, reconstruída a cada
+ * jogada; as auxiliares são as mesmas em todas as jogadas. O ataque
+ * devolvido é o mais visitado da raiz.
+ * 
+ * @param arvore Árvore do bot
+ * @param estado Visão do mapa (jogadorDaVez é o bot)
+ * @param atacante Saída com o território atacante
+ * @param defensor Saída com o território defensor
+ * @return false se não há ataque a fazer
+ */
+bool buscarAtaqueMcts(void* arvore, const EstadoSimulacao* estado, int* atacante, int* defensor) {
+    ArvoreMcts* a = (ArvoreMcts*)arvore;
+    int ataques[MAX_ATAQUES][2];
+    
+    int numAtaques = listarAtaques(estado, estado->jogadorDaVez, ataques);
+    if (numAtaques <= 1) {
+        if (numAtaques == 1) {
+            *atacante = ataques[0][0];
+            *defensor = ataques[0][1];
+        }
+        return numAtaques == 1;
+    }
+    
+    // Nova árvore a partir do estado atual
+    a->raiz = *estado;
+    a->jogada++;
+    atomic_store(&a->totalNos, 0);
+    atomic_store(&a->totalArestas, 0);
+    atomic_store(&a->parar, false);
+    atomic_store(&a->iteracoes, 0);
+    if (a->transposicao.baldes != NULL) {
+        novaBuscaTransposicao(&a->transposicao);
+    }
+    criarNoMcts(a, estado->jogadorDaVez);
+    
+    iniciarJogadaTempo(&a->tempo, estado, a->milissegundos);
+    
+    // Acorda as auxiliares, busca junto e espera todas saírem da árvore
+    pthread_mutex_lock(&a->trava);
+    a->buscaAtual++;
+    a->emBusca = a->threadsCriadas;
+    pthread_cond_broadcast(&a->inicio);
+    pthread_mutex_unlock(&a->trava);
+    
+    buscarComThreadMcts(a, 0);
+    
+    pthread_mutex_lock(&a->trava);
+    while (a->emBusca > 0) {
+        pthread_cond_wait(&a->fim, &a->trava);
+    }
+    pthread_mutex_unlock(&a->trava);
+    
+    // Ataque mais visitado da raiz
+    NoMcts* raiz = &a->nos[0];
+    if (atomic_load(&raiz->expansao) != 2) {
+        return false;
+    }
+    int maisVisitas = -1;
+    for (int k = 0; k < raiz->numArestas; k++) {
+        ArestaMcts* aresta = &a->arestas[raiz->primeiraAresta + k];
+        int visitas = atomic_load(&aresta->visitas);
+        if (aresta->atacante >= 0 && visitas > maisVisitas) {
+            maisVisitas = visitas;
+            *atacante = aresta->atacante;
+            *defensor = aresta->defensor;
+        }
+    }
+    return maisVisitas >= 0;
+}
+
+// ============================================================================
+// IMPLEMENTAÇÃO DAS FUNÇÕES - TABELA DE TRANSPOSIÇÃO
+// ============================================================================
+
+/**
+ * Cria a tabela de transposição dentro de um orçamento de memória
+ * 
+ * O número de baldes é a maior potência de 2 que cabe no orçamento.
+ * Tenta páginas grandes reservadas (MAP_HUGETLB); sem elas, usa páginas
+ * comuns e pede páginas grandes transparentes ao kernel (madvise).
+ * 
+ * @param tabela Tabela a ser preenchida
+ * @param megabytes Orçamento de memória
+ * @return true se a memória foi obtida
+ */
+bool criarTabelaTransposicao(TabelaTransposicao* tabela, size_t megabytes) {
+    size_t numBaldes = 1;
+    while (numBaldes * 2 * sizeof(BaldeTransposicao) <= megabytes * 1024 * 1024) {
+        numBaldes *= 2;
+    }
+    
+    memset(tabela, 0, sizeof(*tabela));
+    tabela->bytes = numBaldes * sizeof(BaldeTransposicao);
+    tabela->mascara = numBaldes - 1;
+    
+    size_t bytesPaginas = (tabela->bytes + TT_PAGINA_GRANDE - 1) / TT_PAGINA_GRANDE * TT_PAGINA_GRANDE;
+    void* memoria = mmap(NULL, bytesPaginas, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (memoria != MAP_FAILED) {
+        tabela->bytes = bytesPaginas;
+        tabela->paginasGrandes = true;
+    } else {
+        memoria = mmap(NULL, tabela->bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memoria == MAP_FAILED) {
+            tabela->bytes = 0;
+            return false;
+        }
+        madvise(memoria, tabela->bytes, MADV_HUGEPAGE);
+    }
+    
+    // mmap entrega memória zerada (entradas vazias), mas só a mapeia no
+    // primeiro acesso: tocar tudo agora tira as faltas de página das
+    // primeiras jogadas, que estourariam o prazo por jogada
+    memset(memoria, 0, tabela->bytes);
+    tabela->baldes = (BaldeTransposicao*)memoria;
+    return true;
+}
+
+/**
+ * Inicia uma nova geração de busca
+ * 
+ * Entradas de gerações anteriores continuam legíveis, mas passam a ser
+ * as primeiras candidatas à substituição.
+ * 
+ * @param tabela Tabela de transposição
+ */
+void novaBuscaTransposicao(TabelaTransposicao* tabela) {
+    atomic_fetch_add_explicit(&tabela->idade, 1, memory_order_relaxed);
+}
+
+/**
+ * Decodifica os dados de uma entrada
+ * 
+ * @param dados Campo dados da entrada
+ * @param registro Saída com os campos
+ */
+static void decodificarTransposicao(uint64_t dados, RegistroTransposicao* registro) {
+    registro->valor = (uint32_t)dados;
+    registro->profundidade = (int)((dados >> 32) & 0xFF);
+    registro->idade = (int)((dados >> 40) & 0xFF);
+    registro->tipo = (int)((dados >> 48) & 0x3);
+    registro->atacante = (int)((dados >> 50) & 0x1F);
+    registro->defensor = (int)((dados >> 55) & 0x1F);
+    if (registro->atacante == TT_SEM_TERRITORIO) registro->atacante = -1;
+    if (registro->defensor == TT_SEM_TERRITORIO) registro->defensor = -1;
+}
+
+/**
+ * Procura um estado na tabela
+ * 
+ * @param tabela Tabela de transposição
+ * @param hash Hash Zobrist do estado
+ * @param registro Saída com a entrada encontrada
+ * @return true se o estado estava na tabela
+ */
+bool consultarTransposicao(TabelaTransposicao* tabela, uint64_t hash, RegistroTransposicao* registro) {
+    BaldeTransposicao* balde = &tabela->baldes[hash & tabela->mascara];
+    
+    for (int k = 0; k < TT_ENTRADAS_BALDE; k++) {
+        uint64_t dados = atomic_load_explicit(&balde->entradas[k].dados, memory_order_relaxed);
+        uint64_t chave = atomic_load_explicit(&balde->entradas[k].chave, memory_order_relaxed);
+        if (dados != 0 && (chave ^ dados) == hash) {
+            decodificarTransposicao(dados, registro);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Grava um estado na tabela
+ * 
+ * Substitui, em ordem: a entrada do mesmo estado, uma entrada vazia ou
+ * a de menor prioridade, em que cada geração de atraso pesa como 8 de
+ * profundidade. A idade gravada é sempre a da busca atual.
+ * 
+ * @param tabela Tabela de transposição
+ * @param hash Hash Zobrist do estado
+ * @param registro Dados a gravar (campo idade é ignorado)
+ */
+void gravarTransposicao(TabelaTransposicao* tabela, uint64_t hash, const RegistroTransposicao* registro) {
+    BaldeTransposicao* balde = &tabela->baldes[hash & tabela->mascara];
+    unsigned int idade = atomic_load_explicit(&tabela->idade, memory_order_relaxed) & 0xFF;
+    int escolhida = 0;
+    int menorPrioridade = 1 << 30;
+    
+    for (int k = 0; k < TT_ENTRADAS_BALDE; k++) {
+        uint64_t dados = atomic_load_explicit(&balde->entradas[k].dados, memory_order_relaxed);
+        uint64_t chave = atomic_load_explicit(&balde->entradas[k].chave, memory_order_relaxed);
+        if (dados == 0 || (chave ^ dados) == hash) {
+            escolhida = k;
+            break;
+        }
+        int atraso = (int)((idade - ((dados >> 40) & 0xFF)) & 0xFF);
+        int prioridade = (int)((dados >> 32) & 0xFF) - 8 * atraso;
+        if (prioridade < menorPrioridade) {
+            menorPrioridade = prioridade;
+            escolhida = k;
+        }
+    }
+    
+    int profundidade = registro->profundidade < 0 ? 0 : registro->profundidade > 255 ? 255 : registro->profundidade;
+    uint64_t atacante = (registro->atacante >= 0) ? (uint64_t)registro->atacante : TT_SEM_TERRITORIO;
+    uint64_t defensor = (registro->defensor >= 0) ? (uint64_t)registro->defensor : TT_SEM_TERRITORIO;
+    uint64_t dados = (uint64_t)registro->valor |
+                     ((uint64_t)profundidade << 32) |
+                     ((uint64_t)idade << 40) |
+                     ((uint64_t)(registro->tipo & 0x3) << 48) |
+                     (atacante << 50) |
+                     (defensor << 55) |
+                     (1ULL << 60);
+    
+    atomic_store_explicit(&balde->entradas[escolhida].chave, hash ^ dados, memory_order_relaxed);
+    atomic_store_explicit(&balde->entradas[escolhida].dados, dados, memory_order_relaxed);
+}
+
+/**
+ * Esvazia a tabela de transposição (como recém-criada)
+ * 
+ * @param tabela Tabela (pode estar vazia)
+ */
+void limparTabelaTransposicao(TabelaTransposicao* tabela) {
+    if (tabela->baldes != NULL) {
+        memset(tabela->baldes, 0, tabela->bytes);
+        atomic_store_explicit(&tabela->idade, 0, memory_order_relaxed);
+    }
+}
+
+/**
+ * Libera a memória da tabela de transposição
+ * 
+ * @param tabela Tabela (pode estar vazia)
+ */
+void liberarTabelaTransposicao(TabelaTransposicao* tabela) {
+    if (tabela->baldes != NULL) {
+        munmap(tabela->baldes, tabela->bytes);
+        tabela->baldes = NULL;
+    }
+}
+
+// ============================================================================
+// IMPLEMENTAÇÃO DAS FUNÇÕES - BOT EXPECTIMAX
+// ============================================================================
+
+/*
+ * Struct: BuscaExpectimax
+ *
+ * Busca *-minimax paranoica: o jogador da raiz maximiza a própria
+ * avaliação (entre 0 e 1), os demais minimizam, e cada ataque passa por
+ * um nó de acaso com os três resultados dos dados. Tudo é
+ * determinístico (sem sorteios nem threads), então a mesma sequência de
+ * estados sempre leva às mesmas decisões. Com rede, as folhas são
+ * avaliadas por ela e o acumulador desce a árvore por diferença.
+ */
+typedef struct {
+    TabelaTransposicao transposicao;
+    GerenciadorTempo tempo;
+    RedeAvaliacao* rede;
+    const Regras* regras;
+    double chances[3];
+    long orcamentoNos;
+    long nos;
+    int maxProfundidade;
+    int jogadorRaiz;
+    bool abortada;
+} BuscaExpectimax;
+
+/**
+ * Cria o contexto de busca de um bot expectimax
+ * 
+ * @param orcamentoNos Nós visitados por jogada, somando todas as iterações
+ * @param maxProfundidade Profundidade máxima do aprofundamento iterativo
+ * @param megabytes Memória da tabela de transposição
+ * @param arquivoRede Pesos da rede de avaliação (NULL para a heurística)
+ * @return Busca alocada, ou NULL se faltou memória ou a rede não carregou
+ */
+void* criarBuscaExpectimax(long orcamentoNos, int maxProfundidade, int megabytes, const char* arquivoRede) {
+    BuscaExpectimax* busca = (BuscaExpectimax*)calloc(1, sizeof(BuscaExpectimax));
+    if (busca == NULL) {
+        return NULL;
+    }
+    if (!criarTabelaTransposicao(&busca->transposicao, (size_t)((megabytes > 0) ? megabytes : 1))) {
+        free(busca);
+        return NULL;
+    }
+    if (arquivoRede != NULL && (busca->rede = carregarRede(arquivoRede)) == NULL) {
+        liberarBuscaExpectimax(busca);
+        return NULL;
+    }
+    
+    busca->regras = &regrasPadrao;
+    busca->orcamentoNos = (orcamentoNos < 1) ? 1 : orcamentoNos;
+    busca->maxProfundidade = (maxProfundidade < 1) ? 1 :
+                             (maxProfundidade > EXPECTIMAX_MAX_PROFUNDIDADE) ? EXPECTIMAX_MAX_PROFUNDIDADE : maxProfundidade;
+    calcularChancesBatalha(busca->chances);
+    return busca;
+}
+
+/**
+ * Libera o contexto de busca de um bot expectimax
+ * 
+ * @param busca Busca (pode ser NULL)
+ */
+void liberarBuscaExpectimax(void* busca) {
+    BuscaExpectimax* b = (BuscaExpectimax*)busca;
+    if (b != NULL) {
+        liberarTabelaTransposicao(&b->transposicao);
+        liberarRede(b->rede);
+        free(b);
+    }
+}
+
+/**
+ * Define o prazo por jogada do bot expectimax (além do orçamento de nós)
+ * 
+ * @param busca Busca do bot
+ * @param prazoMs Limite por jogada em milissegundos (0 = sem limite)
+ */
+void definirPrazoExpectimax(void* busca, long prazoMs) {
+    ((BuscaExpectimax*)busca)->tempo.prazoMs = prazoMs;
+}
+
+/**
+ * Define as regras usadas pela busca do bot expectimax
+ * 
+ * @param busca Busca do bot
+ * @param regras Regras da partida
+ */
+void definirRegrasExpectimax(void* busca, const Regras* regras) {
+    ((BuscaExpectimax*)busca)->regras = regras;
+}
+
+/**
+ * Esquece o que o bot expectimax aprendeu em partidas anteriores
+ * 
+ * @param busca Busca do bot
+ */
+void reiniciarBuscaExpectimax(void* busca) {
+    limparTabelaTransposicao(&((BuscaExpectimax*)busca)->transposicao);
+}
+
+/**
+ * Avaliação heurística de um estado não terminal para um jogador
+ * 
+ * Metade pela fatia de territórios e tropas do jogador, metade pelo
+ * progresso da própria missão (pesosHeuristicaPadrao).
+ * 
+ * @param estado Estado compacto
+ * @param regras Regras com os limites das missões
+ * @param jogador Jogador avaliado
+ * @return Avaliação entre 0.05 e 0.95
+ */
+static double avaliarEstadoExpectimax(const EstadoSimulacao* estado, const Regras* regras, int jogador) {
+    return avaliarHeuristica(estado, regras, jogador, &pesosHeuristicaPadrao);
+}
+
+/**
+ * Ordena os ataques: primeiro o melhor da tabela de transposição, depois
+ * pelo ganho esperado segundo as chances dos dados (tropas inimigas
+ * tomadas na conquista menos a perda esperada na derrota). Empates
+ * mantêm a ordem de listarAtaques, o que preserva a reprodutibilidade.
+ * 
+ * @param busca Busca
+ * @param estado Estado compacto
+ * @param ataques Ataques a ordenar (no lugar)
+ * @param numAtaques Quantidade de ataques
+ * @param primeiroAtacante Atacante sugerido pela tabela (-1 se nenhum)
+ * @param primeiroDefensor Defensor sugerido pela tabela
+ */
+static void ordenarAtaquesExpectimax(const BuscaExpectimax* busca, const EstadoSimulacao* estado,
+                                     int ataques[][2], int numAtaques, int primeiroAtacante, int primeiroDefensor) {
+    double ganho[MAX_ATAQUES];
+    
+    for (int k = 0; k < numAtaques; k++) {
+        int a = ataques[k][0], d = ataques[k][1];
+        if (a == primeiroAtacante && d == primeiroDefensor) {
+            ganho[k] = 1e9;
+            continue;
+        }
+        int transferidas = estado->tropas[a] / busca->regras->divisorTransferencia;
+        ganho[k] = busca->chances[BATALHA_CONQUISTA] * (2.0 * estado->tropas[d] + (transferidas > 0 ? transferidas : 1)) -
+                   busca->chances[BATALHA_DEFESA] * busca->regras->penalidadeDerrota;
+    }
+    
+    // Inserção estável: poucos ataques por estado
+    for (int k = 1; k < numAtaques; k++) {
+        double g = ganho[k];
+        int a = ataques[k][0], d = ataques[k][1];
+        int m = k - 1;
+        while (m >= 0 && ganho[m] < g) {
+            ganho[m + 1] = ganho[m];
+            ataques[m + 1][0] = ataques[m][0];
+            ataques[m + 1][1] = ataques[m][1];
+            m--;
+        }
+        ganho[m + 1] = g;
+        ataques[m + 1][0] = a;
+        ataques[m + 1][1] = d;
+    }
+}
+
+static double buscarNoExpectimax(BuscaExpectimax* busca, const EstadoSimulacao* estado,
+                                 const AcumuladorRede* acumulador, int profundidade,
+                                 double alfa, double beta, bool sonda);
+
+/**
+ * Nó de acaso de um ataque com poda Star1/Star2
+ * 
+ * Cada resultado i tem limites [inferior_i, superior_i], inicialmente
+ * [0, 1]. Star2: uma sonda (só o primeiro ataque ordenado) em cada
+ * filho dá um limite inferior se o filho é do jogador da raiz, ou
+ * superior se é de um adversário; se os limites já decidem a janela,
+ * o nó retorna sem busca completa. Star1: cada filho é buscado com a
+ * janela mais estreita que ainda pode mudar o resultado, e o nó corta
+ * assim que a média ponderada sai de (alfa, beta).
+ * 
+ * @param busca Busca
+ * @param estado Estado antes do ataque
+ * @param acumulador Acumulador da rede no estado (NULL sem rede)
+ * @param atacante Território atacante
+ * @param defensor Território defensor
+ * @param profundidade Profundidade restante (já descontado este ataque)
+ * @param alfa Limite inferior da janela
+ * @param beta Limite superior da janela
+ * @return Valor esperado (ou limite, se houve corte) para o jogador da raiz
+ */
+static double avaliarAcasoExpectimax(BuscaExpectimax* busca, const EstadoSimulacao* estado,
+                                     const AcumuladorRede* acumulador, int atacante,
+                                     int defensor, int profundidade, double alfa, double beta) {
+    static const int ordemResultados[3] = {BATALHA_CONQUISTA, BATALHA_DEFESA, BATALHA_EMPATE};
+    EstadoSimulacao filhos[3];
+    AcumuladorRede acumuladores[3];
+    double probabilidade[3], inferior[3], superior[3];
+    bool terminal[3];
+    
+    for (int i = 0; i < 3; i++) {
+        int resultado = ordemResultados[i];
+        probabilidade[i] = busca->chances[resultado];
+        filhos[i] = *estado;
+        aplicarResultadoBatalha(&filhos[i], busca->regras, atacante, defensor, resultado);
+        int vencedor = verificarVencedorEstado(&filhos[i], busca->regras);
+        terminal[i] = (vencedor != -1);
+        inferior[i] = 0.0;
+        superior[i] = 1.0;
+        if (terminal[i]) {
+            inferior[i] = superior[i] = (vencedor == busca->jogadorRaiz) ? 1.0 : 0.0;
+        } else {
+            avancarJogadorDaVez(&filhos[i]);
+            if (acumulador != NULL) {
+                acumuladores[i] = *acumulador;
+                atualizarAcumulador(busca->rede, &acumuladores[i], estado, &filhos[i]);
+            }
+        }
+    }
+    
+    // Star2: sondagem dos filhos
+    if (profundidade >= 2) {
+        double somaInferior = 0.0, somaSuperior = 0.0;
+        for (int i = 0; i < 3; i++) {
+            if (!terminal[i]) {
+                double v = buscarNoExpectimax(busca, &filhos[i], acumulador ? &acumuladores[i] : NULL,
+                                              profundidade, 0.0, 1.0, true);
+                if (busca->abortada) return 0.5;
+                if (filhos[i].jogadorDaVez == busca->jogadorRaiz) {
+                    inferior[i] = v;
+                } else {
+                    superior[i] = v;
+                }
+            }
+            somaInferior += probabilidade[i] * inferior[i];
+            somaSuperior += probabilidade[i] * superior[i];
+        }
+        if (somaInferior >= beta) return somaInferior;
+        if (somaSuperior <= alfa) return somaSuperior;
+    }
+    
+    // Star1: busca completa com janelas derivadas
+    double soma = 0.0;
+    for (int i = 0; i < 3; i++) {
+        double restanteInferior = 0.0, restanteSuperior = 0.0;
+        for (int j = i + 1; j < 3; j++) {
+            restanteInferior += probabilidade[j] * inferior[j];
+            restanteSuperior += probabilidade[j] * superior[j];
+        }
+        
+        double v;
+        double limiteA = (alfa - soma - restanteSuperior) / probabilidade[i];
+        double limiteB = (beta - soma - restanteInferior) / probabilidade[i];
+        if (terminal[i] || inferior[i] == superior[i]) {
+            v = inferior[i];
+        } else {
+            double a = (limiteA > inferior[i]) ? limiteA : inferior[i];
+            double b = (limiteB < superior[i]) ? limiteB : superior[i];
+            v = buscarNoExpectimax(busca, &filhos[i], acumulador ? &acumuladores[i] : NULL,
+                                   profundidade, a, b, false);
+            if (busca->abortada) return 0.5;
+        }
+        
+        soma += probabilidade[i] * v;
+        if (v <= limiteA) return soma + restanteSuperior;
+        if (v >= limiteB) return soma + restanteInferior;
+    }
+    return soma;
+}
+
+/**
+ * Nó de decisão: o jogador da vez escolhe o ataque
+ * 
+ * @param busca Busca
+ * @param estado Estado (não terminal, com o jogador da vez definido)
+ * @param acumulador Acumulador da rede no estado (NULL sem rede)
+ * @param profundidade Ataques restantes até a avaliação heurística
+ * @param alfa Limite inferior da janela
+ * @param beta Limite superior da janela
+ * @param sonda true para avaliar só o primeiro ataque (sondagem Star2)
+ * @return Valor (ou limite) para o jogador da raiz
+ */
+static double buscarNoExpectimax(BuscaExpectimax* busca, const EstadoSimulacao* estado,
+                                 const AcumuladorRede* acumulador, int profundidade,
+                                 double alfa, double beta, bool sonda) {
+    if (++busca->nos > busca->orcamentoNos ||
+        ((busca->nos % TEMPO_VERIFICACAO_NOS) == 0 && tempoEsgotado(&busca->tempo))) {
+        busca->abortada = true;
+        return 0.5;
+    }
+    if (profundidade == 0) {
+        if (acumulador != NULL) {
+            return avaliarRede(busca->rede, acumulador);
+        }
+        return avaliarEstadoExpectimax(estado, busca->regras, busca->jogadorRaiz);
+    }
+    
+    // Tabela de transposição: valores com a mesma profundidade ou maior
+    RegistroTransposicao registro;
+    int sugeridoAtacante = -1, sugeridoDefensor = -1;
+    if (consultarTransposicao(&busca->transposicao, estado->hash, &registro)) {
+        float valor;
+        memcpy(&valor, &registro.valor, sizeof(valor));
+        if (!sonda && registro.profundidade >= profundidade &&
+            (registro.tipo == TT_EXATO ||
+             (registro.tipo == TT_LIMITE_INFERIOR && valor >= beta) ||
+             (registro.tipo == TT_LIMITE_SUPERIOR && valor <= alfa))) {
+            return valor;
+        }
+        sugeridoAtacante = registro.atacante;
+        sugeridoDefensor = registro.defensor;
+    }
+    
+    int ataques[MAX_ATAQUES][2];
+    int numAtaques = listarAtaques(estado, estado->jogadorDaVez, ataques);
+    if (numAtaques == 0) {
+        // Sem ataques: passa a vez
+        EstadoSimulacao sucessor = *estado;
+        AcumuladorRede acumuladorSucessor;
+        avancarJogadorDaVez(&sucessor);
+        if (acumulador != NULL) {
+            acumuladorSucessor = *acumulador;
+            atualizarAcumulador(busca->rede, &acumuladorSucessor, estado, &sucessor);
+        }
+        return buscarNoExpectimax(busca, &sucessor, acumulador ? &acumuladorSucessor : NULL,
+                                  profundidade - 1, alfa, beta, sonda);
+    }
+    ordenarAtaquesExpectimax(busca, estado, ataques, numAtaques, sugeridoAtacante, sugeridoDefensor);
+    
+    bool maximiza = (estado->jogadorDaVez == busca->jogadorRaiz);
+    double alfaOriginal = alfa, betaOriginal = beta;
+    double melhor = maximiza ? -1.0 : 2.0;
+    int melhorAtaque = 0;
+    
+    for (int k = 0; k < (sonda ? 1 : numAtaques); k++) {
+        double v = avaliarAcasoExpectimax(busca, estado, acumulador, ataques[k][0], ataques[k][1],
+                                          profundidade - 1, alfa, beta);
+        if (busca->abortada) return 0.5;
+        
+        if (maximiza ? (v > melhor) : (v < melhor)) {
+            melhor = v;
+            melhorAtaque = k;
+        }
+        if (maximiza && melhor > alfa) alfa = melhor;
+        if (!maximiza && melhor < beta) beta = melhor;
+        if (alfa >= beta) break;
+    }
+    
+    if (!sonda) {
+        float valor = (float)melhor;
+        memcpy(&registro.valor, &valor, sizeof(valor));
+        registro.profundidade = profundidade;
+        registro.tipo = (melhor <= alfaOriginal) ? TT_LIMITE_SUPERIOR :
+                        (melhor >= betaOriginal) ? TT_LIMITE_INFERIOR : TT_EXATO;
+        registro.atacante = ataques[melhorAtaque][0];
+        registro.defensor = ataques[melhorAtaque][1];
+        gravarTransposicao(&busca->transposicao, estado->hash, &registro);
+    }
+    return melhor;
+}
+
+/**
+ * Escolhe um ataque por aprofundamento iterativo
+ * 
+ * Cada iteração busca um ataque a mais de profundidade, começando pelo
+ * melhor ataque da iteração anterior, então sempre há uma jogada
+ * pronta. Se o orçamento de nós ou o prazo acabar no meio de uma
+ * iteração, vale o melhor entre os ataques da raiz já concluídos nela
+ * (o primeiro é o melhor da iteração anterior) ou, se nenhum terminou,
+ * o resultado da iteração anterior.
+ * 
+ * @param busca Busca do bot
+ * @param estado Visão do mapa (jogadorDaVez é o bot)
+ * @param atacante Saída com o território atacante
+ * @param defensor Saída com o território defensor
+ * @return false se não há ataque a fazer
+ */
+bool buscarAtaqueExpectimax(void* busca, const EstadoSimulacao* estado, int* atacante, int* defensor) {
+    BuscaExpectimax* b = (BuscaExpectimax*)busca;
+    int ataques[MAX_ATAQUES][2];
+    int numAtaques = listarAtaques(estado, estado->jogadorDaVez, ataques);
+    if (numAtaques == 0) {
+        return false;
+    }
+    
+    *atacante = ataques[0][0];
+    *defensor = ataques[0][1];
+    AcumuladorRede acumulador;
+    b->jogadorRaiz = estado->jogadorDaVez;
+    if (b->rede != NULL) {
+        inicializarAcumulador(b->rede, &acumulador, estado, b->jogadorRaiz);
+    }
+    b->nos = 0;
+    b->abortada = false;
+    iniciarJogadaTempo(&b->tempo, estado, 0);
+    novaBuscaTransposicao(&b->transposicao);
+    
+    int sugeridoAtacante = -1, sugeridoDefensor = -1;
+    for (int profundidade = 1; profundidade <= b->maxProfundidade; profundidade++) {
+        ordenarAtaquesExpectimax(b, estado, ataques, numAtaques, sugeridoAtacante, sugeridoDefensor);
+        
+        double melhor = -1.0;
+        int melhorAtaque = 0;
+        for (int k = 0; k < numAtaques && !b->abortada; k++) {
+            double v = avaliarAcasoExpectimax(b, estado, b->rede ? &acumulador : NULL,
+                                              ataques[k][0], ataques[k][1], profundidade - 1,
+                                              melhor > 0.0 ? melhor : 0.0, 1.0);
+            if (!b->abortada && v > melhor) {
+                melhor = v;
+                melhorAtaque = k;
+            }
+        }
+        if (b->abortada) {
+            if (melhor >= 0.0) {
+                // Iteração parcial: ataques concluídos valem (janela a partir do melhor)
+                *atacante = ataques[melhorAtaque][0];
+                *defensor = ataques[melhorAtaque][1];
+            }
+            break;
+        }
+        
+        sugeridoAtacante = *atacante = ataques[melhorAtaque][0];
+        sugeridoDefensor = *defensor = ataques[melhorAtaque][1];
+        if (melhor >= 1.0) {
+            break; // Vitória garantida: não há o que aprofundar
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// IMPLEMENTAÇÃO DAS FUNÇÕES - AUTOJOGO PARA DADOS DE TREINO
+// ============================================================================
+
+/*
+ * Struct: EscritorShard
+ *
+ * Escritor exclusivo de uma thread: acumula registros em memória e
+ * grava em arquivos próprios, trocando de arquivo ao atingir o limite.
+ * Nenhuma thread compartilha arquivo ou buffer, então gravar não trava.
+ */
+typedef struct {
+    const char* diretorio;
+    FILE* arquivo;
+    int thread;
+    int numeroShard;
+    size_t bytesShard;
+    size_t limiteBytes;
+    RegistroAutojogo buffer[AUTOJOGO_BUFFER];
+    int noBuffer;
+    long registros;
+    bool falhou;
+} EscritorShard;
+
+/*
+ * Struct: TarefaAutojogo
+ *
+ * Contexto compartilhado pelas threads do autojogo. As partidas são
+ * distribuídas por um contador atômico.
+ * - assinatura: XOR dos estados finais e durações das partidas (não
+ *   depende de qual thread jogou cada uma)
+ */
+typedef struct {
+    const char* diretorio;
+    const char* politica;
+    const OpcoesSimulacao* opcoes;
+    size_t limiteBytes;
+    int numThreads;
+    atomic_long proximaPartida;
+    atomic_long posicoes;
+    atomic_long partidasConcluidas;
+    atomic_int shards;
+    _Atomic uint64_t assinatura;
+    atomic_bool erro;
+} TarefaAutojogo;
+
+/*
+ * Struct: TrabalhadorAutojogo
+ *
+ * Parâmetros de uma thread do autojogo.
+ */
+typedef struct {
+    TarefaAutojogo* tarefa;
+    int indice;
+} TrabalhadorAutojogo;
+
+/**
+ * Fecha o arquivo atual e abre o próximo arquivo de amostras da thread
+ * 
+ * @param escritor Escritor da thread
+ * @return true se o novo arquivo foi aberto
+ */
+static bool abrirProximoShard(EscritorShard* escritor) {
+    char caminho[512];
+    CabecalhoShard cabecalho;
+    
+    if (escritor->arquivo != NULL) {
+        fclose(escritor->arquivo);
+    }
+    snprintf(caminho, sizeof(caminho), "%s/amostras-%02d-%04d.bin", escritor->diretorio,
+             escritor->thread, escritor->numeroShard++);
+    escritor->arquivo = fopen(caminho, "wb");
+    if (escritor->arquivo == NULL) {
+        printf("❌ Erro: Não foi possível criar %s\n", caminho);
+        escritor->falhou = true;
+        return false;
+    }
+    
+    memset(&cabecalho, 0, sizeof(cabecalho));
+    memcpy(cabecalho.assinatura, AUTOJOGO_ASSINATURA, sizeof(AUTOJOGO_ASSINATURA));
+    cabecalho.tamanhoRegistro = sizeof(RegistroAutojogo);
+    cabecalho.thread = (uint32_t)escritor->thread;
+    fwrite(&cabecalho, sizeof(cabecalho), 1, escritor->arquivo);
+    escritor->bytesShard = sizeof(cabecalho);
+    return true;
+}
+
+/**
+ * Grava o buffer da thread, dividindo entre arquivos quando o limite
+ * de tamanho é atingido
+ * 
+ * @param escritor Escritor da thread
+ */
+static void esvaziarEscritor(EscritorShard* escritor) {
+    int gravados = 0;
+    
+    while (gravados < escritor->noBuffer && !escritor->falhou) {
+        if (escritor->arquivo == NULL ||
+            escritor->bytesShard + sizeof(RegistroAutojogo) > escritor->limiteBytes) {
+            if (!abrirProximoShard(escritor)) break;
+        }
+        size_t cabem = (escritor->limiteBytes - escritor->bytesShard) / sizeof(RegistroAutojogo);
+        size_t quantidade = (size_t)(escritor->noBuffer - gravados);
+        if (quantidade > cabem) quantidade = cabem;
+        
+        if (fwrite(&escritor->buffer[gravados], sizeof(RegistroAutojogo), quantidade, escritor->arquivo) != quantidade) {
+            printf("❌ Erro: Falha ao gravar amostras da thread %d\n", escritor->thread);
+            escritor->falhou = true;
+            break;
+        }
+        escritor->bytesShard += quantidade * sizeof(RegistroAutojogo);
+        gravados += (int)quantidade;
+    }
+    escritor->registros += gravados;
+    escritor->noBuffer = 0;
+}
+
+/**
+ * Copia o estado da decisão para um registro de amostra
+ * 
+ * @param registro Registro a preencher
+ * @param estado Estado antes da decisão
+ * @param atacante Ataque escolhido (-1 se passou a vez)
+ * @param defensor Defensor escolhido
+ * @param turno Turno da partida
+ */
+static void preencherRegistroAutojogo(RegistroAutojogo* registro, const EstadoSimulacao* estado,
+                                      int atacante, int defensor, int turno) {
+    memset(registro, 0, sizeof(*registro));
+    registro->numTerritorios = (uint8_t)estado->numTerritorios;
+    registro->numJogadores = (uint8_t)estado->numJogadores;
+    registro->jogadorDaVez = (uint8_t)estado->jogadorDaVez;
+    for (int i = 0; i < estado->numTerritorios; i++) {
+        registro->dono[i] = estado->dono[i];
+        registro->tropas[i] = (uint8_t)((estado->tropas[i] > 255) ? 255 : estado->tropas[i]);
+    }
+    memcpy(registro->missao, estado->missao, sizeof(registro->missao));
+    registro->atacante = (int8_t)atacante;
+    registro->defensor = (int8_t)defensor;
+    registro->turno = (uint16_t)turno;
+}
+
+/**
+ * Joga uma partida entre controladores gravando cada decisão
+ * 
+ * Os registros ficam em partida[] até o fim, quando o vencedor é
+ * conhecido e preenchido em todos.
+ * 
+ * @param estado Estado inicial (alterado durante a partida)
+ * @param controladores Controlador de cada jogador
+ * @param dados Gerador dos dados
+ * @param partida Saída com um registro por turno (ROLLOUT_MAX_TURNOS)
+ * @return Quantidade de registros
+ */
+static int jogarPartidaGravando(EstadoSimulacao* estado, ControladorJogador** controladores,
+                                GeradorAleatorio* dados, RegistroAutojogo* partida) {
+    int vencedor = -1;
+    int turno;
+    
+    for (turno = 0; turno < ROLLOUT_MAX_TURNOS; turno++) {
+        vencedor = verificarVencedorEstado(estado, &regrasPadrao);
+        if (vencedor != -1) {
+            break;
+        }
+        
+        ControladorJogador* controlador = controladores[estado->jogadorDaVez];
+        int atacante = -1, defensor = -1;
+        bool valido = controlador->decidirAtaque(controlador, estado, &atacante, &defensor) &&
+                      atacante >= 0 && atacante < estado->numTerritorios &&
+                      defensor >= 0 && defensor < estado->numTerritorios &&
+                      estado->dono[atacante] == estado->jogadorDaVez &&
+                      estado->dono[defensor] != estado->jogadorDaVez;
+        if (!valido) {
+            atacante = defensor = -1;
+        }
+        
+        preencherRegistroAutojogo(&partida[turno], estado, atacante, defensor, turno);
+        if (valido) {
+            resolverBatalhaEstado(estado, &regrasPadrao, atacante, defensor, dados);
+        }
+        avancarJogadorDaVez(estado);
+    }
+    if (turno == ROLLOUT_MAX_TURNOS) {
+        vencedor = verificarVencedorEstado(estado, &regrasPadrao);
+    }
+    
+    for (int k = 0; k < turno; k++) {
+        partida[k].vencedor = (uint8_t)((vencedor >= 0) ? vencedor : AUTOJOGO_SEM_VENCEDOR);
+    }
+    return turno;
+}
+
+/**
+ * Corpo de uma thread do autojogo
+ * 
+ * Cada thread tem seus controladores, seu escritor e seus arquivos;
+ * a única comunicação com as outras é o contador atômico de partidas.
+ * 
+ * @param argumento Ponteiro para o TrabalhadorAutojogo
+ * @return NULL
+ */
+static void* executarTrabalhadorAutojogo(void* argumento) {
+    TrabalhadorAutojogo* trabalhador = (TrabalhadorAutojogo*)argumento;
+    TarefaAutojogo* tarefa = trabalhador->tarefa;
+    const OpcoesSimulacao* opcoes = tarefa->opcoes;
+    ControladorJogador* controladores[MAX_JOGADORES];
+    RegistroAutojogo partida[ROLLOUT_MAX_TURNOS];
+    long partidas = 0;
+    uint64_t assinatura = 0;
+    int criados = 0;
+    
+    // Fixada antes de alocar: escritor, controladores e partidas ficam no nó da thread
+    if (!opcoes->numaIngenuo) {
+        fixarThreadNucleo(trabalhador->indice, tarefa->numThreads, NULL);
+    }
+    EscritorShard* escritor = (EscritorShard*)calloc(1, sizeof(EscritorShard));
+    while (escritor != NULL && criados < opcoes->numJogadores) {
+        controladores[criados] = criarControlador(tarefa->politica, opcoes->semente * 31 + (uint64_t)criados);
+        if (controladores[criados] == NULL || controladorEhHumano(controladores[criados])) {
+            if (controladores[criados] != NULL) {
+                controladores[criados]->liberar(controladores[criados]);
+            }
+            break;
+        }
+        criados++;
+    }
+    
+    if (escritor != NULL && criados == opcoes->numJogadores) {
+        escritor->diretorio = tarefa->diretorio;
+        escritor->thread = trabalhador->indice;
+        escritor->limiteBytes = tarefa->limiteBytes;
+        
+        for (;;) {
+            long jogo = atomic_fetch_add_explicit(&tarefa->proximaPartida, 1, memory_order_relaxed);
+            if (jogo >= opcoes->numJogos || escritor->falhou) {
+                break;
+            }
+            
+            GeradorAleatorio sorteio, dados;
+            EstadoSimulacao estado;
+            inicializarGerador(&sorteio, (opcoes->semente + (uint64_t)jogo) * 3);
+            inicializarGerador(&dados, (opcoes->semente + (uint64_t)jogo) * 3 + 1);
+            gerarPartidaAleatoria(&estado, &regrasPadrao, opcoes->numJogadores, opcoes->numTerritorios, &sorteio);
+            for (int j = 0; j < criados; j++) {
+                reiniciarControlador(controladores[j], (opcoes->semente + (uint64_t)jogo) * 31 + (uint64_t)j);
+            }
+            
+            int numRegistros = jogarPartidaGravando(&estado, controladores, &dados, partida);
+            if (escritor->noBuffer + numRegistros > AUTOJOGO_BUFFER) {
+                esvaziarEscritor(escritor);
+            }
+            memcpy(&escritor->buffer[escritor->noBuffer], partida, (size_t)numRegistros * sizeof(RegistroAutojogo));
+            escritor->noBuffer += numRegistros;
+            assinatura ^= (estado.hash ^ (uint64_t)numRegistros) * (2 * (uint64_t)jogo + 1);
+            partidas++;
+        }
+        esvaziarEscritor(escritor);
+        if (escritor->arquivo != NULL) {
+            fclose(escritor->arquivo);
+        }
+        
+        atomic_fetch_add(&tarefa->posicoes, escritor->registros);
+        atomic_fetch_add(&tarefa->partidasConcluidas, partidas);
+        atomic_fetch_add(&tarefa->shards, escritor->numeroShard);
+        atomic_fetch_xor(&tarefa->assinatura, assinatura);
+    }
+    if (escritor == NULL || criados < opcoes->numJogadores || escritor->falhou) {
+        atomic_store(&tarefa->erro, true);
+    }
+    
+    for (int j = 0; j < criados; j++) {
+        controladores[j]->liberar(controladores[j]);
+    }
+    free(escritor);
+    return NULL;
+}
+
+/**
+ * Gera amostras de treino por autojogo em todas as threads
+ * 
+ * Paralelismo na raiz: cada thread joga partidas inteiras e
+ * independentes com a mesma política para todos os jogadores. A
+ * partida N usa sempre as mesmas sementes de sorteio, de dados e dos
+ * bots (reiniciados antes de cada partida), qualquer que seja a thread
+ * que a jogue.
+ * 
+ * @param diretorio Diretório dos arquivos (criado se não existir)
+ * @param politica Tipo de controlador usado por todos os jogadores
+ * @param limiteShardMB Tamanho máximo de cada arquivo
+ * @param opcoes Partidas, jogadores, territórios e semente
+ * @param numThreads Threads de autojogo
+ */
+void executarAutojogo(const char* diretorio, const char* politica, size_t limiteShardMB,
+                      const OpcoesSimulacao* opcoes, int numThreads) {
+    TarefaAutojogo tarefa;
+    pthread_t threads[MAX_THREADS];
+    TrabalhadorAutojogo trabalhadores[MAX_THREADS];
+    
+    if (mkdir(diretorio, 0755) != 0 && errno != EEXIST) {
+        printf("❌ Erro: Não foi possível criar o diretório %s\n", diretorio);
+        return;
+    }
+    if (numThreads > MAX_THREADS) numThreads = MAX_THREADS;
+    
+    memset(&tarefa, 0, sizeof(tarefa));
+    tarefa.diretorio = diretorio;
+    tarefa.politica = politica;
+    tarefa.opcoes = opcoes;
+    tarefa.limiteBytes = limiteShardMB * 1024 * 1024;
+    tarefa.numThreads = numThreads;
+    
+    printf("\n🧠 ═══════════════════════════════════════════════════════════\n");
+    printf("                   AUTOJOGO - DADOS DE TREINO\n");
+    printf("═══════════════════════════════════════════════════════════🧠\n");
+    printf("🤖 Política: %s | %d jogadores, %d territórios | %d threads\n",
+           politica, opcoes->numJogadores, opcoes->numTerritorios, numThreads);
+    
+    struct timespec inicio, fim;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    
+    int iniciadas = 0;
+    for (int t = 0; t < numThreads; t++) {
+        trabalhadores[t].tarefa = &tarefa;
+        trabalhadores[t].indice = t;
+        if (pthread_create(&threads[t], NULL, executarTrabalhadorAutojogo, &trabalhadores[t]) != 0) {
+            break;
+        }
+        iniciadas++;
+    }
+    for (int t = 0; t < iniciadas; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    
+    clock_gettime(CLOCK_MONOTONIC, &fim);
+    double segundos = (fim.tv_sec - inicio.tv_sec) + (fim.tv_nsec - inicio.tv_nsec) / 1e9;
+    long posicoes = atomic_load(&tarefa.posicoes);
+    
+    if (iniciadas == 0 || atomic_load(&tarefa.erro)) {
+        printf("⚠️  Autojogo interrompido por erro (política inválida ou falha de gravação)\n");
+    }
+    printf("💾 %ld posições de %ld partidas em %d arquivos (%.1f MB) em %s\n",
+           posicoes, atomic_load(&tarefa.partidasConcluidas), atomic_load(&tarefa.shards),
+           posicoes * (double)sizeof(RegistroAutojogo) / (1024.0 * 1024.0), diretorio);
+    printf("🔏 Assinatura das partidas: %016llx\n", (unsigned long long)atomic_load(&tarefa.assinatura));
+    printf("🚀 %.2f s (%.0f posições/minuto)\n", segundos, 60.0 * posicoes / (segundos > 0 ? segundos : 1e-9));
+}
+
+// ============================================================================
+// IMPLEMENTAÇÃO DAS FUNÇÕES - AVALIADOR NEURAL QUANTIZADO
+// ============================================================================
+
+/**
+ * Produto escalar de ativações (0 a 127) por pesos int8 - versão escalar
+ * 
+ * @param ativacoes Ativações quantizadas
+ * @param pesos Pesos int8
+ * @param n Tamanho (múltiplo de 32)
+ * @return Soma dos produtos
+ */
+static int32_t produtoEscalarEscalar(const uint8_t* ativacoes, const int8_t* pesos, int n) {
+    int32_t soma = 0;
+    for (int k = 0; k < n; k++) {
+        soma += (int32_t)ativacoes[k] * pesos[k];
+    }
+    return soma;
+}
+
+#ifdef NN_SUPORTE_AVX2
+/**
+ * Produto escalar com AVX2: 32 pares por instrução (maddubs), somados
+ * em int32 (madd). Ativações até 127 não saturam os pares int16.
+ */
+__attribute__((target("avx2")))
+static int32_t produtoEscalarAvx2(const uint8_t* ativacoes, const int8_t* pesos, int n) {
+    __m256i soma = _mm256_setzero_si256();
+    const __m256i uns = _mm256_set1_epi16(1);
+    
+    for (int k = 0; k < n; k += 32) {
+        __m256i x = _mm256_load_si256((const __m256i*)(ativacoes + k));
+        __m256i w = _mm256_load_si256((const __m256i*)(pesos + k));
+        soma = _mm256_add_epi32(soma, _mm256_madd_epi16(_mm256_maddubs_epi16(x, w), uns));
+    }
+    __m128i parcial = _mm_add_epi32(_mm256_castsi256_si128(soma), _mm256_extracti128_si256(soma, 1));
+    parcial = _mm_add_epi32(parcial, _mm_shuffle_epi32(parcial, 0x4E));
+    parcial = _mm_add_epi32(parcial, _mm_shuffle_epi32(parcial, 0xB1));
+    return _mm_cvtsi128_si32(parcial);
+}
+#endif
+
+#ifdef NN_SUPORTE_AVX2
+/**
+ * Soma ou subtrai uma coluna de w1 no acumulador com AVX2 (16 por
+ * instrução). O acumulador pode estar em memória de malloc, sem o
+ * alinhamento de 32 bytes, por isso os acessos a ele não são alinhados.
+ */
+__attribute__((target("avx2")))
+static void aplicarColunaAvx2(int16_t* valores, const int16_t* coluna, int sinal) {
+    for (int k = 0; k < NN_OCULTA1; k += 16) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(valores + k));
+        __m256i c = _mm256_load_si256((const __m256i*)(coluna + k));
+        v = (sinal > 0) ? _mm256_add_epi16(v, c) : _mm256_sub_epi16(v, c);
+        _mm256_storeu_si256((__m256i*)(valores + k), v);
+    }
+}
+
+/**
+ * ReLU limitada do acumulador com AVX2: satura int16 em 0..127 e
+ * empacota em bytes (packus intercala as metades de 128 bits, o que o
+ * permute final desfaz)
+ */
+__attribute__((target("avx2")))
+static void limitarAcumuladorAvx2(const int16_t* valores, uint8_t* saida) {
+    const __m256i maximo = _mm256_set1_epi16(NN_ESCALA_ATIVACAO);
+    for (int k = 0; k < NN_OCULTA1; k += 32) {
+        __m256i a = _mm256_min_epi16(_mm256_loadu_si256((const __m256i*)(valores + k)), maximo);
+        __m256i b = _mm256_min_epi16(_mm256_loadu_si256((const __m256i*)(valores + k + 16)), maximo);
+        __m256i empacotado = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+        _mm256_store_si256((__m256i*)(saida + k), empacotado);
+    }
+}
+#endif
+
+static int32_t (*produtoEscalarRede)(const uint8_t*, const int8_t*, int) = produtoEscalarEscalar;
+static pthread_once_t produtoEscalarEscolhido = PTHREAD_ONCE_INIT;
+
+/**
+ * Escolhe a versão do produto escalar suportada pelo processador
+ */
+static void escolherProdutoEscalar(void) {
+#ifdef NN_SUPORTE_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        produtoEscalarRede = produtoEscalarAvx2;
+    }
+#endif
+}
+
+/**
+ * Aloca uma rede vazia (alinhada para AVX2)
+ * 
+ * @return Rede zerada, ou NULL se faltou memória
+ */
+static RedeAvaliacao* alocarRede(void) {
+    pthread_once(&produtoEscalarEscolhido, escolherProdutoEscalar);
+    RedeAvaliacao* rede = (RedeAvaliacao*)aligned_alloc(_Alignof(RedeAvaliacao), sizeof(RedeAvaliacao));
+    if (rede != NULL) {
+        memset(rede, 0, sizeof(*rede));
+    }
+    return rede;
+}
+
+/**
+ * Cria uma rede com pesos sorteados (para medir velocidade e testar a
+ * atualização incremental; pesos úteis vêm de treino sobre o autojogo)
+ * 
+ * @param semente Semente do sorteio
+ * @return Rede alocada, ou NULL se faltou memória
+ */
+RedeAvaliacao* criarRedePadrao(uint64_t semente) {
+    RedeAvaliacao* rede = alocarRede();
+    if (rede == NULL) {
+        return NULL;
+    }
+    
+    GeradorAleatorio gerador;
+    inicializarGerador(&gerador, semente);
+    for (int f = 0; f < NN_ENTRADAS; f++) {
+        for (int k = 0; k < NN_OCULTA1; k++) {
+            rede->w1[f][k] = (int16_t)(sortearIntervalo(&gerador, 65) - 32);
+        }
+    }
+    for (int k = 0; k < NN_OCULTA1; k++) {
+        rede->b1[k] = (int16_t)sortearIntervalo(&gerador, 65);
+    }
+    for (int o = 0; o < NN_OCULTA2; o++) {
+        for (int k = 0; k < NN_OCULTA1; k++) {
+            rede->w2[o][k] = (int8_t)(sortearIntervalo(&gerador, 65) - 32);
+        }
+        rede->w3[o] = (int8_t)(sortearIntervalo(&gerador, 65) - 32);
+    }
+    return rede;
+}
+
+/**
+ * Carrega os pesos de uma rede
+ * 
+ * Formato: assinatura NN_ASSINATURA (8 bytes), três uint32 com
+ * NN_ENTRADAS, NN_OCULTA1 e NN_OCULTA2, seguidos de w1, b1, w2, b2, w3
+ * e b3 na ordem e nos tipos de RedeAvaliacao.
+ * 
+ * @param arquivo Caminho do arquivo de pesos
+ * @return Rede carregada, ou NULL em caso de erro
+ */
+RedeAvaliacao* carregarRede(const char* arquivo) {
+    char assinatura[8];
+    uint32_t dimensoes[3];
+    FILE* entrada = fopen(arquivo, "rb");
+    
+    if (entrada == NULL) {
+        printf("❌ Erro: Não foi possível abrir os pesos %s\n", arquivo);
+        return NULL;
+    }
+    
+    RedeAvaliacao* rede = alocarRede();
+    bool valido = rede != NULL &&
+                  fread(assinatura, sizeof(assinatura), 1, entrada) == 1 &&
+                  memcmp(assinatura, NN_ASSINATURA, sizeof(NN_ASSINATURA)) == 0 &&
+                  fread(dimensoes, sizeof(dimensoes), 1, entrada) == 1 &&
+                  dimensoes[0] == NN_ENTRADAS && dimensoes[1] == NN_OCULTA1 && dimensoes[2] == NN_OCULTA2 &&
+                  fread(rede->w1, sizeof(rede->w1), 1, entrada) == 1 &&
+                  fread(rede->b1, sizeof(rede->b1), 1, entrada) == 1 &&
+                  fread(rede->w2, sizeof(rede->w2), 1, entrada) == 1 &&
+                  fread(rede->b2, sizeof(rede->b2), 1, entrada) == 1 &&
+                  fread(rede->w3, sizeof(rede->w3), 1, entrada) == 1 &&
+                  fread(&rede->b3, sizeof(rede->b3), 1, entrada) == 1;
+    fclose(entrada);
+    
+    if (!valido) {
+        printf("❌ Erro: %s não é um arquivo de pesos compatível\n", arquivo);
+        free(rede);
+        return NULL;
+    }
+    return rede;
+}
+
+/**
+ * Libera uma rede
+ * 
+ * @param rede Rede (pode ser NULL)
+ */
+void liberarRede(RedeAvaliacao* rede) {
+    free(rede);
+}
+
+/**
+ * Faixa de uma quantidade de tropas (1, 2, 3, 4-5, 6-8, 9-12, 13-20, 21+)
+ * 
+ * @param tropas Quantidade de tropas
+ * @return Faixa entre 0 e NN_FAIXAS_TROPAS - 1
+ */
+static int faixaTropas(int tropas) {
+    if (tropas <= 3) return (tropas > 0) ? tropas - 1 : 0;
+    if (tropas <= 5) return 3;
+    if (tropas <= 8) return 4;
+    if (tropas <= 12) return 5;
+    if (tropas <= 20) return 6;
+    return 7;
+}
+
+/**
+ * Característica ativa de um território: dono relativo ao jogador
+ * avaliado (0 = ele mesmo, 1 = o próximo na ordem de jogo...) combinado
+ * com a faixa de tropas
+ * 
+ * @param estado Estado compacto
+ * @param territorio Índice do território
+ * @param jogador Jogador avaliado
+ * @return Índice da característica, ou -1 se o território não tem dono
+ */
+static int caracteristicaTerritorio(const EstadoSimulacao* estado, int territorio, int jogador) {
+    if (estado->dono[territorio] < 0) {
+        return -1;
+    }
+    int relativo = (estado->dono[territorio] - jogador + estado->numJogadores) % estado->numJogadores;
+    return (territorio * MAX_JOGADORES + relativo) * NN_FAIXAS_TROPAS + faixaTropas(estado->tropas[territorio]);
+}
+
+/**
+ * Lista as características ativas de uma posição
+ * 
+ * Um índice por território com dono, a missão do jogador e se é a vez dele.
+ * 
+ * @param estado Estado compacto
+ * @param jogador Jogador avaliado
+ * @param indices Saída (até NN_MAX_ATIVAS índices)
+ * @return Quantidade de características ativas
+ */
+int extrairCaracteristicas(const EstadoSimulacao* estado, int jogador, int* indices) {
+    int total = 0;
+    
+    for (int i = 0; i < estado->numTerritorios; i++) {
+        int caracteristica = caracteristicaTerritorio(estado, i, jogador);
+        if (caracteristica >= 0) {
+            indices[total++] = caracteristica;
+        }
+    }
+    if (estado->missao[jogador] >= 0 && estado->missao[jogador] < TOTAL_MISSOES) {
+        indices[total++] = NN_BASE_MISSAO + estado->missao[jogador];
+    }
+    if (estado->jogadorDaVez == jogador) {
+        indices[total++] = NN_CARACTERISTICA_VEZ;
+    }
+    return total;
+}
+
+/**
+ * Soma (sinal 1) ou subtrai (sinal -1) a coluna de uma característica
+ * 
+ * A aritmética int16 é modular, então somar e depois subtrair a mesma
+ * coluna sempre volta exatamente ao valor anterior.
+ */
+static void aplicarColunaRede(const RedeAvaliacao* rede, AcumuladorRede* acumulador, int caracteristica, int sinal) {
+    const int16_t* coluna = rede->w1[caracteristica];
+#ifdef NN_SUPORTE_AVX2
+    if (produtoEscalarRede == produtoEscalarAvx2) {
+        aplicarColunaAvx2(acumulador->valores, coluna, sinal);
+        return;
+    }
+#endif
+    for (int k = 0; k < NN_OCULTA1; k++) {
+        acumulador->valores[k] = (int16_t)(acumulador->valores[k] + sinal * coluna[k]);
+    }
+}
+
+/**
+ * Calcula o acumulador de uma posição do zero
+ * 
+ * @param rede Rede
+ * @param acumulador Acumulador a preencher
+ * @param estado Estado compacto
+ * @param jogador Jogador avaliado
+ */
+void inicializarAcumulador(const RedeAvaliacao* rede, AcumuladorRede* acumulador,
+                           const EstadoSimulacao* estado, int jogador) {
+    int indices[NN_MAX_ATIVAS];
+    int total = extrairCaracteristicas(estado, jogador, indices);
+    
+    memcpy(acumulador->valores, rede->b1, sizeof(acumulador->valores));
+    acumulador->jogador = jogador;
+    for (int f = 0; f < total; f++) {
+        aplicarColunaRede(rede, acumulador, indices[f], 1);
+    }
+}
+
+/**
+ * Atualiza o acumulador por diferença entre duas posições
+ * 
+ * Uma batalha muda no máximo dois territórios e a vez, então a
+ * atualização custa poucas colunas em vez de todas.
+ * 
+ * @param rede Rede
+ * @param acumulador Acumulador válido para a posição antes
+ * @param antes Posição anterior
+ * @param depois Nova posição (mesmos jogadores e missões)
+ */
+void atualizarAcumulador(const RedeAvaliacao* rede, AcumuladorRede* acumulador,
+                         const EstadoSimulacao* antes, const EstadoSimulacao* depois) {
+    int jogador = acumulador->jogador;
+    
+    for (int i = 0; i < depois->numTerritorios; i++) {
+        if (antes->dono[i] == depois->dono[i] && antes->tropas[i] == depois->tropas[i]) {
+            continue;
+        }
+        int antiga = caracteristicaTerritorio(antes, i, jogador);
+        int nova = caracteristicaTerritorio(depois, i, jogador);
+        if (antiga != nova) {
+            if (antiga >= 0) aplicarColunaRede(rede, acumulador, antiga, -1);
+            if (nova >= 0) aplicarColunaRede(rede, acumulador, nova, 1);
+        }
+    }
+    
+    bool vezAntes = (antes->jogadorDaVez == jogador);
+    bool vezDepois = (depois->jogadorDaVez == jogador);
+    if (vezAntes != vezDepois) {
+        aplicarColunaRede(rede, acumulador, NN_CARACTERISTICA_VEZ, vezDepois ? 1 : -1);
+    }
+}
+
+/**
+ * Parte inteira da avaliação: ReLU limitada (0 a 127) sobre o
+ * acumulador, camada densa int8 com deslocamento de
+ * NN_DESLOCAMENTO_PESOS bits e saída linear
+ * 
+ * @param rede Rede
+ * @param acumulador Acumulador da posição
+ * @return Saída quantizada da rede
+ */
+static int32_t calcularSaidaRede(const RedeAvaliacao* rede, const AcumuladorRede* acumulador) {
+    _Alignas(32) uint8_t oculta1[NN_OCULTA1];
+    _Alignas(32) uint8_t oculta2[NN_OCULTA2];
+    
+#ifdef NN_SUPORTE_AVX2
+    if (produtoEscalarRede == produtoEscalarAvx2) {
+        limitarAcumuladorAvx2(acumulador->valores, oculta1);
+    } else
+#endif
+    for (int k = 0; k < NN_OCULTA1; k++) {
+        int16_t v = acumulador->valores[k];
+        oculta1[k] = (uint8_t)((v < 0) ? 0 : (v > NN_ESCALA_ATIVACAO) ? NN_ESCALA_ATIVACAO : v);
+    }
+    for (int o = 0; o < NN_OCULTA2; o++) {
+        int32_t v = (produtoEscalarRede(oculta1, rede->w2[o], NN_OCULTA1) + rede->b2[o]) >> NN_DESLOCAMENTO_PESOS;
+        oculta2[o] = (uint8_t)((v < 0) ? 0 : (v > NN_ESCALA_ATIVACAO) ? NN_ESCALA_ATIVACAO : v);
+    }
+    
+    return produtoEscalarRede(oculta2, rede->w3, NN_OCULTA2) + rede->b3;
+}
+
+/**
+ * Converte a saída quantizada em chance de vitória (logística)
+ */
+static double logisticaRede(int32_t saida) {
+    double x = saida / (double)(NN_ESCALA_ATIVACAO << NN_DESLOCAMENTO_PESOS);
+    return 1.0 / (1.0 + exp(-x));
+}
+
+/**
+ * Avalia uma posição a partir do acumulador
+ * 
+ * @param rede Rede
+ * @param acumulador Acumulador da posição
+ * @return Chance estimada de vitória do jogador do acumulador (0 a 1)
+ */
+double avaliarRede(const RedeAvaliacao* rede, const AcumuladorRede* acumulador) {
+    return logisticaRede(calcularSaidaRede(rede, acumulador));
+}
+
+#ifdef NN_SUPORTE_AVX2
+/**
+ * Camadas densas de um lote com AVX2
+ * 
+ * Para cada posição, calcula 8 saídas da segunda camada de uma vez:
+ * os 8 vetores de somas parciais são reduzidos juntos por hadd, em vez
+ * de uma redução horizontal por saída como em avaliarRede.
+ * 
+ * @param rede Rede
+ * @param acumuladores Acumuladores contíguos
+ * @param quantidade Posições no lote
+ * @param saidas Saída quantizada de cada posição
+ */
+__attribute__((target("avx2")))
+static void calcularSaidasLoteAvx2(const RedeAvaliacao* rede, const AcumuladorRede* acumuladores,
+                                   int quantidade, int32_t* saidas) {
+    const __m256i uns = _mm256_set1_epi16(1);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i maximo = _mm256_set1_epi32(NN_ESCALA_ATIVACAO);
+    _Alignas(32) uint8_t oculta1[NN_OCULTA1];
+    _Alignas(32) uint8_t oculta2[NN_OCULTA2];
+    _Alignas(32) int32_t grupo[8];
+    
+    for (int p = 0; p < quantidade; p++) {
+        limitarAcumuladorAvx2(acumuladores[p].valores, oculta1);
+        __m256i x0 = _mm256_load_si256((const __m256i*)oculta1);
+        __m256i x1 = _mm256_load_si256((const __m256i*)(oculta1 + 32));
+        
+        for (int o = 0; o < NN_OCULTA2; o += 8) {
+            __m256i parciais[8];
+            for (int j = 0; j < 8; j++) {
+                __m256i w0 = _mm256_load_si256((const __m256i*)rede->w2[o + j]);
+                __m256i w1 = _mm256_load_si256((const __m256i*)(rede->w2[o + j] + 32));
+                parciais[j] = _mm256_add_epi32(_mm256_madd_epi16(_mm256_maddubs_epi16(x0, w0), uns),
+                                               _mm256_madd_epi16(_mm256_maddubs_epi16(x1, w1), uns));
+            }
+            __m256i t0 = _mm256_hadd_epi32(parciais[0], parciais[1]);
+            __m256i t1 = _mm256_hadd_epi32(parciais[2], parciais[3]);
+            __m256i t2 = _mm256_hadd_epi32(parciais[4], parciais[5]);
+            __m256i t3 = _mm256_hadd_epi32(parciais[6], parciais[7]);
+            __m256i u0 = _mm256_hadd_epi32(t0, t1);
+            __m256i u1 = _mm256_hadd_epi32(t2, t3);
+            __m256i soma = _mm256_add_epi32(_mm256_permute2x128_si256(u0, u1, 0x20),
+                                            _mm256_permute2x128_si256(u0, u1, 0x31));
+            soma = _mm256_add_epi32(soma, _mm256_load_si256((const __m256i*)(rede->b2 + o)));
+            soma = _mm256_srai_epi32(soma, NN_DESLOCAMENTO_PESOS);
+            soma = _mm256_min_epi32(_mm256_max_epi32(soma, zero), maximo);
+            _mm256_store_si256((__m256i*)grupo, soma);
+            for (int j = 0; j < 8; j++) {
+                oculta2[o + j] = (uint8_t)grupo[j];
+            }
+        }
+        saidas[p] = produtoEscalarAvx2(oculta2, rede->w3, NN_OCULTA2) + rede->b3;
+    }
+}
+#endif
+
+/**
+ * Avalia um lote de posições de uma vez
+ * 
+ * Dá exatamente os mesmos valores de avaliarRede posição a posição.
+ * 
+ * @param rede Rede
+ * @param acumuladores Acumuladores contíguos
+ * @param quantidade Posições no lote
+ * @param valores Saída com a chance de vitória de cada posição
+ */
+void avaliarLoteRede(const RedeAvaliacao* rede, const AcumuladorRede* acumuladores, int quantidade, double* valores) {
+    int32_t saidas[LOTE_TAMANHO];
+    
+    for (int inicio = 0; inicio < quantidade; inicio += LOTE_TAMANHO) {
+        int parte = (quantidade - inicio < LOTE_TAMANHO) ? quantidade - inicio : LOTE_TAMANHO;
+#ifdef NN_SUPORTE_AVX2
+        if (produtoEscalarRede == produtoEscalarAvx2) {
+            calcularSaidasLoteAvx2(rede, acumuladores + inicio, parte, saidas);
+        } else
+#endif
+        for (int p = 0; p < parte; p++) {
+            saidas[p] = calcularSaidaRede(rede, &acumuladores[inicio + p]);
+        }
+        for (int p = 0; p < parte; p++) {
+            valores[inicio + p] = logisticaRede(saidas[p]);
+        }
+    }
+}
+
+/**
+ * Mede e confere o avaliador neural em posições de partidas aleatórias
+ * 
+ * Confere que a atualização incremental reproduz exatamente o cálculo
+ * do zero (e, com AVX2, que a versão escalar dá o mesmo valor) e mede
+ * o tempo por posição nos dois caminhos.
+ * 
+ * @param arquivo Pesos da rede (NULL para pesos sorteados)
+ * @param opcoes Número de posições (numJogos), jogadores, territórios e semente
+ */
+void executarTesteRede(const char* arquivo, const OpcoesSimulacao* opcoes) {
+    RedeAvaliacao* rede = (arquivo != NULL) ? carregarRede(arquivo) : criarRedePadrao(opcoes->semente);
+    long numPosicoes = opcoes->numJogos;
+    EstadoSimulacao* antes = (EstadoSimulacao*)malloc((size_t)numPosicoes * sizeof(EstadoSimulacao));
+    EstadoSimulacao* depois = (EstadoSimulacao*)malloc((size_t)numPosicoes * sizeof(EstadoSimulacao));
+    AcumuladorRede* acumuladores = (AcumuladorRede*)malloc((size_t)numPosicoes * sizeof(AcumuladorRede));
+    
+    if (rede == NULL || antes == NULL || depois == NULL || acumuladores == NULL) {
+        printf("❌ Erro: Não foi possível preparar o teste da rede!\n");
+        liberarRede(rede);
+        free(antes);
+        free(depois);
+        free(acumuladores);
+        return;
+    }
+    
+    // Pares de posições consecutivas tirados de partidas aleatórias
+    GeradorAleatorio gerador;
+    inicializarGerador(&gerador, opcoes->semente);
+    long total = 0;
+    while (total < numPosicoes) {
+        EstadoSimulacao estado;
+        int ataques[MAX_ATAQUES][2];
+        gerarPartidaAleatoria(&estado, &regrasPadrao, opcoes->numJogadores, opcoes->numTerritorios, &gerador);
+        
+        for (int turno = 0; turno < ROLLOUT_MAX_TURNOS && total < numPosicoes; turno++) {
+            if (verificarVencedorEstado(&estado, &regrasPadrao) != -1) {
+                break;
+            }
+            antes[total] = estado;
+            int numAtaques = listarAtaques(&estado, estado.jogadorDaVez, ataques);
+            if (numAtaques > 0) {
+                int k = sortearIntervalo(&gerador, numAtaques);
+                resolverBatalhaEstado(&estado, &regrasPadrao, ataques[k][0], ataques[k][1], &gerador);
+            }
+            avancarJogadorDaVez(&estado);
+            depois[total++] = estado;
+        }
+    }
+    
+    // Conferência: incremental x do zero, AVX2 x escalar
+    long divergencias = 0, divergenciasSimd = 0;
+    for (long p = 0; p < numPosicoes; p++) {
+        AcumuladorRede incremental, completo;
+        int jogador = antes[p].jogadorDaVez;
+        inicializarAcumulador(rede, &incremental, &antes[p], jogador);
+        atualizarAcumulador(rede, &incremental, &antes[p], &depois[p]);
+        inicializarAcumulador(rede, &completo, &depois[p], jogador);
+        if (memcmp(incremental.valores, completo.valores, sizeof(completo.valores)) != 0) {
+            divergencias++;
+        }
+        
+        double vetorial = avaliarRede(rede, &completo);
+        int32_t (*escolhido)(const uint8_t*, const int8_t*, int) = produtoEscalarRede;
+        produtoEscalarRede = produtoEscalarEscalar;
+        if (avaliarRede(rede, &completo) != vetorial) {
+            divergenciasSimd++;
+        }
+        produtoEscalarRede = escolhido;
+    }
+    
+    struct timespec inicio, meio, fim;
+    volatile double soma = 0.0;
+    double parcial = 0.0;
+    
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    for (long p = 0; p < numPosicoes; p++) {
+        inicializarAcumulador(rede, &acumuladores[p], &antes[p], antes[p].jogadorDaVez);
+        parcial += avaliarRede(rede, &acumuladores[p]);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &meio);
+    for (long p = 0; p < numPosicoes; p++) {
+        atualizarAcumulador(rede, &acumuladores[p], &antes[p], &depois[p]);
+        parcial += avaliarRede(rede, &acumuladores[p]);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &fim);
+    soma = parcial;
+    (void)soma;
+    
+    double nsCompleto = ((meio.tv_sec - inicio.tv_sec) * 1e9 + (meio.tv_nsec - inicio.tv_nsec)) / numPosicoes;
+    double nsIncremental = ((fim.tv_sec - meio.tv_sec) * 1e9 + (fim.tv_nsec - meio.tv_nsec)) / numPosicoes;
+    
+    printf("\n🧠 ═══════════════════════════════════════════════════════════\n");
+    printf("                   AVALIADOR NEURAL\n");
+    printf("═══════════════════════════════════════════════════════════🧠\n");
+    printf("📐 %d entradas → %d (int16) → %d (int8) → 1 | pesos: %s\n",
+           NN_ENTRADAS, NN_OCULTA1, NN_OCULTA2, arquivo != NULL ? arquivo : "sorteados");
+    printf("⚙️  Produto escalar: %s\n", produtoEscalarRede == produtoEscalarEscalar ? "escalar" : "AVX2");
+    printf("🔍 %ld posições | divergências incremental: %ld | AVX2 x escalar: %ld\n",
+           numPosicoes, divergencias, divergenciasSimd);
+    printf("⏱️  Do zero: %.0f ns/posição | incremental: %.0f ns/posição\n", nsCompleto, nsIncremental);
+    
+    liberarRede(rede);
+    free(antes);
+    free(depois);
+    free(acumuladores);
+}
+
+// ============================================================================
+// IMPLEMENTAÇÃO DAS FUNÇÕES - BOT REDE E FILA DE AVALIAÇÃO EM LOTE
+// ============================================================================
+
+/**
+ * Prepara os três resultados de um ataque para avaliação pela rede
+ * 
+ * Resultados que encerram a partida recebem valor fixo (1 vitória, 0
+ * derrota); os demais recebem o acumulador atualizado por diferença a
+ * partir do acumulador do estado atual.
+ * 
+ * @param rede Rede
+ * @param estado Estado antes do ataque
+ * @param acumulador Acumulador do estado, do ponto de vista do jogador da vez
+ * @param atacante Território atacante
+ * @param defensor Território defensor
+ * @param acumuladores Saída com o acumulador de cada resultado
+ * @param valores Saída com o valor dos resultados terminais
+ * @return Máscara (bit = resultado) dos resultados que precisam da rede
+ */
+static int prepararResultadosRede(const RedeAvaliacao* rede, const EstadoSimulacao* estado,
+                                  const AcumuladorRede* acumulador, int atacante, int defensor,
+                                  AcumuladorRede* acumuladores, double* valores) {
+    int pendentes = 0;
+    
+    for (int resultado = 0; resultado < 3; resultado++) {
+        EstadoSimulacao sucessor = *estado;
+        aplicarResultadoBatalha(&sucessor, &regrasPadrao, atacante, defensor, resultado);
+        int vencedor = verificarVencedorEstado(&sucessor, &regrasPadrao);
+        if (vencedor != -1) {
+            valores[resultado] = (vencedor == acumulador->jogador) ? 1.0 : 0.0;
+            continue;
+        }
+        avancarJogadorDaVez(&sucessor);
+        acumuladores[resultado] = *acumulador;
+        atualizarAcumulador(rede, &acumuladores[resultado], estado, &sucessor);
+        pendentes |= 1 << resultado;
+    }
+    return pendentes;
+}
+
+/**
+ * Escolhe o primeiro ataque de maior valor esperado
+ * 
+ * @param valores Valor de cada resultado de cada ataque
+ * @param numAtaques Quantidade de ataques
+ * @return Índice do ataque escolhido
+ */
+static int escolherMelhorValorRede(double valores[][3], int numAtaques) {
+    double chances[3];
+    double melhor = -1.0;
+    int escolhido = 0;
+    
+    calcularChancesBatalha(chances);
+    for (int k = 0; k < numAtaques; k++) {
+        double esperado = chances[0] * valores[k][0] + chances[1] * valores[k][1] + chances[2] * valores[k][2];
+        if (esperado > melhor) {
+            melhor = esperado;
+            escolhido = k;
+        }
+    }
+    return escolhido;
+}
+
+/**
+ * Bot rede: avalia os três resultados de cada ataque, uma posição por vez
+ * 
+ * @param rede Rede
+ * @param estado Visão do mapa (jogadorDaVez é o bot)
+ * @param atacante Saída com o território atacante
+ * @param defensor Saída com o território defensor
+ * @return false se não há ataque a fazer
+ */
+bool escolherAtaqueRede(const RedeAvaliacao* rede, const EstadoSimulacao* estado, int* atacante, int* defensor) {
+    int ataques[MAX_ATAQUES][2];
+    double valores[MAX_ATAQUES][3];
+    AcumuladorRede acumulador, resultados[3];
+    
+    int numAtaques = listarAtaques(estado, estado->jogadorDaVez, ataques);
+    if (numAtaques == 0) {
+        return false;
+    }
+    
+    inicializarAcumulador(rede, &acumulador, estado, estado->jogadorDaVez);
+    for (int k = 0; k < numAtaques; k++) {
+        int pendentes = prepararResultadosRede(rede, estado, &acumulador, ataques[k][0], ataques[k][1],
+                                               resultados, valores[k]);
+        for (int resultado = 0; resultado < 3; resultado++) {
+            if (pendentes & (1 << resultado)) {
+                valores[k][resultado] = avaliarRede(rede, &resultados[resultado]);
+            }
+        }
+    }
+    
+    int escolhido = escolherMelhorValorRede(valores, numAtaques);
+    *atacante = ataques[escolhido][0];
+    *defensor = ataques[escolhido][1];
+    return true;
+}
+
+/*
+ * Struct: PartidaLote
+ *
+ * Uma partida em andamento no modo de avaliação em lote. Enquanto
+ * espera a fila, guarda os ataques do turno e os valores já recebidos.
+ */
+typedef struct {
+    EstadoSimulacao estado;
+    GeradorAleatorio dados;
+    int ataques[MAX_ATAQUES][2];
+    double valores[MAX_ATAQUES][3];
+    int numAtaques;
+    int turno;
+    long indice;
+    bool ativa;
+} PartidaLote;
+
+/*
+ * Struct: FilaAvaliacao
+ *
+ * Pedidos de avaliação de várias partidas. Cada pedido lembra onde o
+ * resultado deve ser entregue (partida, ataque e resultado dos dados).
+ */
+typedef struct {
+    AcumuladorRede acumuladores[LOTE_TAMANHO];
+    double valores[LOTE_TAMANHO];
+    double* destino[LOTE_TAMANHO];
+    int total;
+    long lotes;
+    long posicoes;
+} FilaAvaliacao;
+
+/**
+ * Avalia os pedidos acumulados e entrega cada valor à sua partida
+ * 
+ * @param fila Fila de avaliação
+ * @param rede Rede
+ */
+static void esvaziarFilaAvaliacao(FilaAvaliacao* fila, const RedeAvaliacao* rede) {
+    if (fila->total == 0) {
+        return;
+    }
+    avaliarLoteRede(rede, fila->acumuladores, fila->total, fila->valores);
+    for (int p = 0; p < fila->total; p++) {
+        *fila->destino[p] = fila->valores[p];
+    }
+    fila->lotes++;
+    fila->posicoes += fila->total;
+    fila->total = 0;
+}
+
+/**
+ * Ocupa uma vaga do modo em lote com a próxima partida, com as mesmas
+ * sementes usadas por executarPartidasBots
+ * 
+ * Partidas já decididas no sorteio inicial (ex.: missão cumprida de
+ * saída) são contabilizadas na hora, como em jogarPartidaControladores.
+ * 
+ * @param partida Vaga a ocupar
+ * @param proxima Índice da próxima partida (avançado)
+ * @param opcoes Partidas, jogadores, territórios e semente
+ * @param vitorias Vitórias por jogador
+ * @return true se a vaga ficou com uma partida em andamento
+ */
+static bool iniciarPartidaLote(PartidaLote* partida, long* proxima, const OpcoesSimulacao* opcoes, long* vitorias) {
+    while (*proxima < opcoes->numJogos) {
+        GeradorAleatorio sorteio;
+        long indice = (*proxima)++;
+        inicializarGerador(&sorteio, (opcoes->semente + (uint64_t)indice) * 3);
+        inicializarGerador(&partida->dados, (opcoes->semente + (uint64_t)indice) * 3 + 1);
+        gerarPartidaAleatoria(&partida->estado, &regrasPadrao, opcoes->numJogadores, opcoes->numTerritorios, &sorteio);
+        partida->turno = 0;
+        partida->indice = indice;
+        
+        int vencedor = verificarVencedorEstado(&partida->estado, &regrasPadrao);
+        if (vencedor == -1) {
+            partida->ativa = true;
+            return true;
+        }
+        vitorias[vencedor]++;
+    }
+    partida->ativa = false;
+    return false;
+}
+
+/**
+ * Joga as partidas do bot rede com a fila de avaliação em lote
+ * 
+ * Até LOTE_PARTIDAS_PADRAO partidas avançam juntas, um turno por
+ * rodada: cada partida enfileira as posições que precisa avaliar, a
+ * fila é avaliada em lotes de LOTE_TAMANHO e, com todos os valores
+ * entregues, cada partida escolhe e joga seu ataque.
+ * 
+ * @param rede Rede
+ * @param opcoes Partidas, jogadores, territórios e semente
+ * @param vitorias Saída com vitórias por jogador
+ * @param somaTurnos Saída com a soma das durações
+ * @param posicoes Saída com as posições avaliadas
+ */
+static void jogarPartidasEmLote(const RedeAvaliacao* rede, const OpcoesSimulacao* opcoes,
+                                long* vitorias, long* somaTurnos, long* posicoes) {
+    int numVagas = (opcoes->numJogos < LOTE_PARTIDAS_PADRAO) ? (int)opcoes->numJogos : LOTE_PARTIDAS_PADRAO;
+    PartidaLote* partidas = (PartidaLote*)calloc((size_t)numVagas, sizeof(PartidaLote));
+    FilaAvaliacao* fila = (FilaAvaliacao*)aligned_alloc(_Alignof(FilaAvaliacao),
+                                                        (sizeof(FilaAvaliacao) + 63) / 64 * 64);
+    if (partidas == NULL || fila == NULL) {
+        printf("❌ Erro: Memória insuficiente para as partidas em lote!\n");
+        free(partidas);
+        free(fila);
+        return;
+    }
+    memset(fila, 0, sizeof(*fila));
+    
+    long proxima = 0;
+    int ativas = 0;
+    for (int v = 0; v < numVagas; v++) {
+        ativas += iniciarPartidaLote(&partidas[v], &proxima, opcoes, vitorias) ? 1 : 0;
+    }
+
+    while (ativas > 0) {
+        // Fase 1: cada partida enfileira as posições do seu turno
+        for (int v = 0; v < numVagas; v++) {
+            PartidaLote* partida = &partidas[v];
+            if (!partida->ativa) continue;
+            
+            AcumuladorRede acumulador, resultados[3];
+            partida->numAtaques = listarAtaques(&partida->estado, partida->estado.jogadorDaVez, partida->ataques);
+            if (partida->numAtaques == 0) continue;
+            
+            inicializarAcumulador(rede, &acumulador, &partida->estado, partida->estado.jogadorDaVez);
+            for (int k = 0; k < partida->numAtaques; k++) {
+                int pendentes = prepararResultadosRede(rede, &partida->estado, &acumulador,
+                                                       partida->ataques[k][0], partida->ataques[k][1],
+                                                       resultados, partida->valores[k]);
+                for (int resultado = 0; resultado < 3; resultado++) {
+                    if (pendentes & (1 << resultado)) {
+                        if (fila->total == LOTE_TAMANHO) {
+                            esvaziarFilaAvaliacao(fila, rede);
+                        }
+                        fila->acumuladores[fila->total] = resultados[resultado];
+                        fila->destino[fila->total] = &partida->valores[k][resultado];
+                        fila->total++;
+                    }
+                }
+            }
+        }
+        esvaziarFilaAvaliacao(fila, rede);
+        
+        // Fase 2: com os valores entregues, cada partida joga seu turno
+        for (int v = 0; v < numVagas; v++) {
+            PartidaLote* partida = &partidas[v];
+            if (!partida->ativa) continue;
+            
+            if (partida->numAtaques > 0) {
+                int k = escolherMelhorValorRede(partida->valores, partida->numAtaques);
+                resolverBatalhaEstado(&partida->estado, &regrasPadrao, partida->ataques[k][0],
+                                      partida->ataques[k][1], &partida->dados);
+            }
+            avancarJogadorDaVez(&partida->estado);
+            partida->turno++;
+            
+            int vencedor = verificarVencedorEstado(&partida->estado, &regrasPadrao);
+            if (vencedor != -1 || partida->turno == ROLLOUT_MAX_TURNOS) {
+                if (vencedor >= 0) vitorias[vencedor]++;
+                *somaTurnos += partida->turno;
+                if (!iniciarPartidaLote(partida, &proxima, opcoes, vitorias)) {
+                    ativas--;
+                }
+            }
+        }
+    }
+    
+    *posicoes = fila->posicoes;
+    printf("📦 Lotes: %ld (média de %.1f posições por lote)\n", fila->lotes,
+           fila->lotes > 0 ? (double)fila->posicoes / fila->lotes : 0.0);
+    free(partidas);
+    free(fila);
+}
+
+/**
+ * Compara o bot rede avaliando uma posição por vez e em lotes
+ * 
+ * As duas execuções jogam as mesmas partidas (mesmas sementes) e
+ * precisam chegar aos mesmos resultados; muda só a vazão.
+ * 
+ * @param arquivo Pesos da rede (NULL para pesos sorteados)
+ * @param opcoes Partidas, jogadores, territórios e semente
+ */
+void executarPartidasLoteRede(const char* arquivo, const OpcoesSimulacao* opcoes) {
+    RedeAvaliacao* rede = (arquivo != NULL) ? carregarRede(arquivo) : criarRedePadrao(REDE_SEMENTE_PADRAO);
+    ControladorJogador controlador;
+    DadosBot dados;
+    ControladorJogador* controladores[MAX_JOGADORES];
+    long vitoriasUm[MAX_JOGADORES] = {0}, vitoriasLote[MAX_JOGADORES] = {0};
+    long turnosUm = 0, turnosLote = 0, posicoesLote = 0;
+    struct timespec inicio, meio, fim;
+    
+    if (rede == NULL) {
+        return;
+    }
+    
+    // Um controlador rede compartilhado por todos os jogadores (sem estado próprio)
+    memset(&dados, 0, sizeof(dados));
+    dados.rede = rede;
+    memset(&controlador, 0, sizeof(controlador));
+    controlador.nome = "bot rede";
+    controlador.decidirAtaque = decidirAtaqueRede;
+    controlador.dados = &dados;
+    for (int j = 0; j < opcoes->numJogadores; j++) {
+        controladores[j] = &controlador;
+    }
+    
+    printf("\n📦 ═══════════════════════════════════════════════════════════\n");
+    printf("                   AVALIAÇÃO EM LOTE\n");
+    printf("═══════════════════════════════════════════════════════════📦\n");
+    
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    for (long jogo = 0; jogo < opcoes->numJogos; jogo++) {
+        GeradorAleatorio sorteio, geradorDados;
+        EstadoSimulacao estado;
+        int duracao;
+        inicializarGerador(&sorteio, (opcoes->semente + (uint64_t)jogo) * 3);
+        inicializarGerador(&geradorDados, (opcoes->semente + (uint64_t)jogo) * 3 + 1);
+        gerarPartidaAleatoria(&estado, &regrasPadrao, opcoes->numJogadores, opcoes->numTerritorios, &sorteio);
+        int vencedor = jogarPartidaControladores(&estado, &regrasPadrao, controladores, &geradorDados,
+                                                 ROLLOUT_MAX_TURNOS, &duracao);
+        if (vencedor >= 0) vitoriasUm[vencedor]++;
+        turnosUm += duracao;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &meio);
+    jogarPartidasEmLote(rede, opcoes, vitoriasLote, &turnosLote, &posicoesLote);
+    clock_gettime(CLOCK_MONOTONIC, &fim);
+    
+    double segundosUm = (meio.tv_sec - inicio.tv_sec) + (meio.tv_nsec - inicio.tv_nsec) / 1e9;
+    double segundosLote = (fim.tv_sec - meio.tv_sec) + (fim.tv_nsec - meio.tv_nsec) / 1e9;
+    bool iguais = (turnosUm == turnosLote) &&
+                  memcmp(vitoriasUm, vitoriasLote, sizeof(vitoriasUm)) == 0;
+    
+    printf("🐢 Uma a uma: %.2f s (%.0f posições/s)\n", segundosUm, posicoesLote / (segundosUm > 0 ? segundosUm : 1e-9));
+    printf("🚀 Em lote:   %.2f s (%.0f posições/s) | %.2fx\n", segundosLote,
+           posicoesLote / (segundosLote > 0 ? segundosLote : 1e-9),
+           segundosUm / (segundosLote > 0 ? segundosLote : 1e-9));
+    printf("%s Mesmos resultados nas duas execuções: %s\n", iguais ? "✅" : "❌", iguais ? "sim" : "não");
+    
+    liberarRede(rede);
+}
+
+// ============================================================================
+// IMPLEMENTAÇÃO DAS FUNÇÕES - GERENCIAMENTO DE TEMPO E LATÊNCIA
+// ============================================================================
+
+/**
+ * Classifica a fase da partida pela fatia de territórios do líder
+ * 
+ * @param estado Estado compacto
+ * @return 0 abertura (líder com menos de 45%), 1 meio de jogo,
+ *         2 final (líder com 70% ou mais, ou só dois jogadores ativos)
+ */
+int faseJogo(const EstadoSimulacao* estado) {
+    int contagem[MAX_JOGADORES] = {0};
+    int maior = 0, ativos = 0;
+    
+    for (int i = 0; i < estado->numTerritorios; i++) {
+        if (estado->dono[i] >= 0 && ++contagem[estado->dono[i]] > maior) {
+            maior = contagem[estado->dono[i]];
+        }
+    }
+    for (int j = 0; j < estado->numJogadores; j++) {
+        if (contagem[j] > 0) ativos++;
+    }
+    
+    double fatia = (double)maior / estado->numTerritorios;
+    if (fatia >= 0.7 || (ativos <= 2 && estado->numJogadores > 2)) return 2;
+    if (fatia < 0.45) return 0;
+    return 1;
+}
+
+/**
+ * Calcula o instante de parada da jogada atual
+ * 
+ * Com prazo definido, o orçamento é TEMPO_MARGEM do prazo ponderado
+ * pela fase (mais tempo no meio de jogo, onde as escolhas pesam mais);
+ * a folga restante cobre a parada das threads e a volta ao laço de
+ * turnos. Sem prazo, usa o orçamento padrão do bot (0 = sem limite).
+ * 
+ * @param tempo Gerenciador de tempo do bot
+ * @param estado Estado no início da jogada
+ * @param padraoMs Orçamento usado quando não há prazo
+ */
+void iniciarJogadaTempo(GerenciadorTempo* tempo, const EstadoSimulacao* estado, long padraoMs) {
+    static const double fatores[3] = {TEMPO_FATOR_ABERTURA, TEMPO_FATOR_MEIO, TEMPO_FATOR_FINAL};
+    long orcamentoNs;
+    
+    if (tempo->prazoMs > 0) {
+        orcamentoNs = (long)(tempo->prazoMs * 1e6 * TEMPO_MARGEM * fatores[faseJogo(estado)]);
+    } else if (padraoMs > 0) {
+        orcamentoNs = padraoMs * 1000000L;
+    } else {
+        tempo->ativo = false;
+        return;
+    }
+    
+    clock_gettime(CLOCK_MONOTONIC, &tempo->limite);
+    tempo->limite.tv_sec += orcamentoNs / 1000000000L;
+    tempo->limite.tv_nsec += orcamentoNs % 1000000000L;
+    if (tempo->limite.tv_nsec >= 1000000000L) {
+        tempo->limite.tv_sec++;
+        tempo->limite.tv_nsec -= 1000000000L;
+    }
+    tempo->ativo = true;
+}
+
+/**
+ * Verifica se o orçamento da jogada acabou (relógio monotônico)
+ * 
+ * @param tempo Gerenciador de tempo do bot
+ * @return true se a busca deve parar
+ */
+bool tempoEsgotado(const GerenciadorTempo* tempo) {
+    if (!tempo->ativo) {
+        return false;
+    }
+    struct timespec agora;
+    clock_gettime(CLOCK_MONOTONIC, &agora);
+    return agora.tv_sec > tempo->limite.tv_sec ||
+           (agora.tv_sec == tempo->limite.tv_sec && agora.tv_nsec >= tempo->limite.tv_nsec);
+}
+
+/**
+ * Faixa do histograma de uma latência
+ * 
+ * @param nanossegundos Latência
+ * @return Índice da faixa
+ */
+static int faixaLatencia(long nanossegundos) {
+    uint64_t v = (nanossegundos > 0) ? (uint64_t)nanossegundos : 0;
+    if (v < LATENCIA_SUBFAIXAS) {
+        return (int)v;
+    }
+    int bit = 63 - __builtin_clzll(v);                 // Bit mais alto (>= 6)
+    int potencia = bit - 5;                             // 1, 2, ...
+    int sub = (int)((v >> (bit - 6)) - LATENCIA_SUBFAIXAS);  // 0..63
+    if (potencia >= LATENCIA_FAIXAS) {
+        return LATENCIA_FAIXAS * LATENCIA_SUBFAIXAS - 1;
+    }
+    return potencia * LATENCIA_SUBFAIXAS + sub;
+}
+
+/**
+ * Maior latência representada por uma faixa do histograma
+ * 
+ * @param faixa Índice da faixa
+ * @return Limite superior da faixa em nanossegundos
+ */
+long percentilFaixaLatencia(int faixa) {
+    int potencia = faixa / LATENCIA_SUBFAIXAS;
+    int sub = faixa % LATENCIA_SUBFAIXAS;
+    if (potencia == 0) {
+        return sub;
+    }
+    return ((long)(LATENCIA_SUBFAIXAS + sub + 1) << (potencia - 1)) - 1;
+}
+
+/**
+ * Registra uma latência no histograma
+ * 
+ * @param histograma Histograma
+ * @param nanossegundos Latência medida
+ */
+void registrarLatencia(HistogramaLatencia* histograma, long nanossegundos) {
+    histograma->contagem[faixaLatencia(nanossegundos)]++;
+    histograma->total++;
+    if (nanossegundos > histograma->maximoNs) {
+        histograma->maximoNs = nanossegundos;
+    }
+}
+
+/**
+ * Percentil das latências registradas
+ * 
+ * Devolve o limite superior da faixa (erro de no máximo ~1,6% para
+ * cima), limitado ao máximo observado.
+ * 
+ * @param histograma Histograma
+ * @param fracao Percentil entre 0 e 1 (ex.: 0.999)
+ * @return Latência em nanossegundos
+ */
+long percentilLatencia(const HistogramaLatencia* histograma, double fracao) {
+    long alvo = (long)ceil(fracao * histograma->total);
+    long acumulado = 0;
+    
+    if (alvo < 1) alvo = 1;
+    for (int k = 0; k < LATENCIA_FAIXAS * LATENCIA_SUBFAIXAS; k++) {
+        acumulado += histograma->contagem[k];
+        if (acumulado >= alvo) {
+            long limite = percentilFaixaLatencia(k);
+            return (limite < histograma->maximoNs) ? limite : histograma->maximoNs;
+        }
+    }
+    return histograma->maximoNs;
+}
+
+// ============================================================================
+// IMPLEMENTAÇÃO DAS FUNÇÕES - AJUSTE DE PESOS (SPSA)
+// ============================================================================
+
+/*
+ * Struct: ProgressoAjuste
+ *
+ * Conteúdo do checkpoint: gerações concluídas, semente do ajuste e
+ * pesos atuais. Basta para continuar exatamente de onde parou.
+ */
+typedef struct {
+    int geracao;
+    uint64_t semente;
+    PesosHeuristica pesos;
+} ProgressoAjuste;
+
+/*
+ * Struct: TarefaAjuste
+ *
+ * Geração em avaliação, compartilhada pelas threads. A cada geração a
+ * thread principal preenche os candidatos e libera as threads pela
+ * barreira de início; elas repartem as partidas pelo contador atômico
+ * e se encontram na barreira de fim. As barreiras só são montadas
+ * depois que se sabe quantas threads foram criadas ('liberado').
+ */
+typedef struct {
+    const char* politica;
+    const OpcoesSimulacao* opcoes;
+    int numThreads;
+    PesosHeuristica candidatos[2];
+    uint64_t sementeGeracao;
+    atomic_long proximaPartida;
+    atomic_bool liberado;
+    pthread_barrier_t inicio;
+    pthread_barrier_t fim;
+    bool encerrar;
+    atomic_bool erro;
+} TarefaAjuste;
+
+/*
+ * Struct: TrabalhadorAjuste
+ *
+ * Thread do ajuste: pontos de cada candidato na geração atual.
+ */
+typedef struct {
+    TarefaAjuste* tarefa;
+    int indice;
+    double pontos[2];
+} TrabalhadorAjuste;
+
+/**
+ * Lê o checkpoint do ajuste
+ * 
+ * @param caminho Arquivo de checkpoint
+ * @param progresso Saída com o progresso salvo
+ * @return true se o arquivo existe e é válido
+ */
+static bool carregarCheckpointAjuste(const char* caminho, ProgressoAjuste* progresso) {
+    FILE* arquivo = fopen(caminho, "r");
+    char assinatura[16];
+    unsigned long long semente;
+    bool valido;
+    
+    if (arquivo == NULL) {
+        return false;
+    }
+    valido = fscanf(arquivo, "%15s", assinatura) == 1 && strcmp(assinatura, AJUSTE_ASSINATURA) == 0 &&
+             fscanf(arquivo, " geracao %d semente %llu pesos", &progresso->geracao, &semente) == 2 &&
+             progresso->geracao >= 0;
+    progresso->semente = semente;
+    for (int k = 0; valido && k < HEURISTICA_NUM_PESOS; k++) {
+        valido = fscanf(arquivo, "%lf", &progresso->pesos.peso[k]) == 1;
+    }
+    fclose(arquivo);
+    return valido;
+}
+
+/**
+ * Garante em disco a entrada de diretório de um arquivo recém-renomeado
+ * 
+ * @param caminho Arquivo cujo diretório será sincronizado
+ * @return true se o diretório foi sincronizado
+ */
+static bool sincronizarDiretorio(const char* caminho) {
+    char diretorio[1024];
+    const char* barra = strrchr(caminho, '/');
+    
+    if (barra == NULL) {
+        strcpy(diretorio, ".");
+    } else if (barra == caminho) {
+        strcpy(diretorio, "/");
+    } else {
+        snprintf(diretorio, sizeof(diretorio), "%.*s", (int)(barra - caminho), caminho);
+    }
+    
+    int descritor = open(diretorio, O_RDONLY | O_DIRECTORY);
+    if (descritor < 0) {
+        return false;
+    }
+    bool sincronizado = fsync(descritor) == 0;
+    close(descritor);
+    return sincronizado;
+}
+
+/**
+ * Grava o checkpoint do ajuste de forma atômica (arquivo temporário
+ * renomeado e diretório sincronizado), para que uma interrupção nunca
+ * deixe um arquivo parcial nem perca a renomeação
+ * 
+ * @param caminho Arquivo de checkpoint
+ * @param progresso Progresso atual
+ * @return true se gravou
+ */
+static bool gravarCheckpointAjuste(const char* caminho, const ProgressoAjuste* progresso) {
+    char temporario[1024];
+    snprintf(temporario, sizeof(temporario), "%s.tmp", caminho);
+    
+    FILE* arquivo = fopen(temporario, "w");
+    if (arquivo == NULL) {
+        return false;
+    }
+    fprintf(arquivo, "%s\ngeracao %d\nsemente %llu\npesos", AJUSTE_ASSINATURA,
+            progresso->geracao, (unsigned long long)progresso->semente);
+    for (int k = 0; k < HEURISTICA_NUM_PESOS; k++) {
+        fprintf(arquivo, " %.17g", progresso->pesos.peso[k]);
+    }
+    fprintf(arquivo, "\n");
+    
+    bool gravado = (fflush(arquivo) == 0) & (fsync(fileno(arquivo)) == 0);
+    gravado &= (fclose(arquivo) == 0);
+    return gravado && rename(temporario, caminho) == 0 && sincronizarDiretorio(caminho);
+}
+
+/**
+ * Corpo de uma thread do ajuste
+ * 
+ * Os controladores são criados uma vez e reaproveitados em todas as
+ * gerações; antes de cada partida são reiniciados (reiniciarControlador),
+ * então o resultado não depende das partidas que a thread jogou antes
+ * nem de a execução ter sido retomada. A partida N da geração usa as
+ * mesmas sementes para os dois candidatos (números aleatórios comuns),
+ * o que reduz muito o ruído da diferença.
+ * 
+ * @param argumento Ponteiro para o TrabalhadorAjuste
+ * @return NULL
+ */
+static void* executarTrabalhadorAjuste(void* argumento) {
+    TrabalhadorAjuste* trabalhador = (TrabalhadorAjuste*)argumento;
+    TarefaAjuste* tarefa = trabalhador->tarefa;
+    const OpcoesSimulacao* opcoes = tarefa->opcoes;
+    if (!opcoes->numaIngenuo) {
+        fixarThreadNucleo(trabalhador->indice, tarefa->numThreads, NULL);
+    }
+    ControladorJogador* candidato = criarControlador("heuristico", 0);
+    ControladorJogador* adversarios[MAX_JOGADORES];
+    int criados = 0;
+    
+    while (candidato != NULL && criados < opcoes->numJogadores - 1) {
+        adversarios[criados] = criarControlador(tarefa->politica, 0);
+        if (adversarios[criados] == NULL || controladorEhHumano(adversarios[criados])) {
+            if (adversarios[criados] != NULL) {
+                adversarios[criados]->liberar(adversarios[criados]);
+            }
+            break;
+        }
+        criados++;
+    }
+    bool pronto = (candidato != NULL && criados == opcoes->numJogadores - 1);
+    if (!pronto) {
+        atomic_store(&tarefa->erro, true);
+    }
+    
+    while (!atomic_load_explicit(&tarefa->liberado, memory_order_acquire)) {
+        sched_yield();
+    }
+    for (;;) {
+        pthread_barrier_wait(&tarefa->inicio);
+        if (tarefa->encerrar) {
+            break;
+        }
+        trabalhador->pontos[0] = trabalhador->pontos[1] = 0.0;
+        
+        while (pronto) {
+            long jogo = atomic_fetch_add_explicit(&tarefa->proximaPartida, 1, memory_order_relaxed);
+            if (jogo >= opcoes->numJogos) {
+                break;
+            }
+            uint64_t semente = (tarefa->sementeGeracao + (uint64_t)jogo) * 3;
+            int assento = (int)(jogo % opcoes->numJogadores);
+            ControladorJogador* controladores[MAX_JOGADORES];
+            for (int j = 0, a = 0; j < opcoes->numJogadores; j++) {
+                controladores[j] = (j == assento) ? candidato : adversarios[a++];
+            }
+            
+            for (int lado = 0; lado < 2; lado++) {
+                GeradorAleatorio sorteio, dados;
+                EstadoSimulacao estado;
+                ((DadosBot*)candidato->dados)->pesos = tarefa->candidatos[lado];
+                for (int j = 0; j < opcoes->numJogadores; j++) {
+                    reiniciarControlador(controladores[j], semente + 2 + (uint64_t)j);
+                }
+                inicializarGerador(&sorteio, semente);
+                inicializarGerador(&dados, semente + 1);
+                gerarPartidaAleatoria(&estado, &regrasPadrao, opcoes->numJogadores, opcoes->numTerritorios, &sorteio);
+                
+                int vencedor = jogarPartidaControladores(&estado, &regrasPadrao, controladores, &dados,
+                                                         ROLLOUT_MAX_TURNOS, NULL);
+                trabalhador->pontos[lado] += (vencedor == assento) ? 1.0 :
+                                             (vencedor < 0) ? 1.0 / opcoes->numJogadores : 0.0;
+            }
+        }
+        pthread_barrier_wait(&tarefa->fim);
+    }
+    
+    for (int j = 0; j < criados; j++) {
+        adversarios[j]->liberar(adversarios[j]);
+    }
+    if (candidato != NULL) {
+        candidato->liberar(candidato);
+    }
+    return NULL;
+}
+
+/**
+ * Ajusta os pesos do bot heurístico por SPSA
+ * 
+ * A cada geração sorteia uma direção de perturbação (±1 por peso),
+ * mede a taxa de vitórias dos pesos deslocados para os dois lados
+ * contra a política em partidas paralelas e anda na direção da
+ * diferença, com passo e perturbação decrescentes. O checkpoint é
+ * regravado ao fim de cada geração; uma nova execução com o mesmo
+ * arquivo continua da geração salva com os mesmos sorteios. Por isso
+ * adversários que dependem do relógio (MCTS) são recusados.
+ * 
+ * @param caminho Arquivo de checkpoint
+ * @param politica Tipo de controlador dos adversários
+ * @param geracoes Total de gerações do ajuste
+ * @param opcoes Partidas por candidato, jogadores, territórios e semente
+ * @param numThreads Threads de simulação
+ */
+void executarAjuste(const char* caminho, const char* politica, int geracoes,
+                    const OpcoesSimulacao* opcoes, int numThreads) {
+    ProgressoAjuste progresso;
+    TarefaAjuste tarefa;
+    pthread_t threads[MAX_THREADS];
+    TrabalhadorAjuste trabalhadores[MAX_THREADS];
+    
+    if (strncmp(politica, "mcts", 4) == 0) {
+        printf("❌ Erro: O ajuste precisa de adversários reprodutíveis; MCTS depende do relógio.\n");
+        return;
+    }
+    
+    bool retomado = carregarCheckpointAjuste(caminho, &progresso);
+    if (!retomado) {
+        progresso.geracao = 0;
+        progresso.semente = opcoes->semente;
+        progresso.pesos = pesosHeuristicaPadrao;
+    }
+    if (numThreads > MAX_THREADS) numThreads = MAX_THREADS;
+    
+    printf("\n🧬 ═══════════════════════════════════════════════════════════\n");
+    printf("                   AJUSTE DE PESOS (SPSA)\n");
+    printf("═══════════════════════════════════════════════════════════🧬\n");
+    printf("🤖 Bot heurístico contra %s | %d jogadores, %d territórios | %ld partidas por candidato | %d threads\n",
+           politica, opcoes->numJogadores, opcoes->numTerritorios, opcoes->numJogos, numThreads);
+    if (retomado) {
+        printf("💾 Retomando %s a partir da geração %d\n", caminho, progresso.geracao);
+    }
+    
+    memset(&tarefa, 0, sizeof(tarefa));
+    tarefa.politica = politica;
+    tarefa.opcoes = opcoes;
+    tarefa.numThreads = numThreads;
+    atomic_init(&tarefa.liberado, false);
+    
+    // As barreiras contam só as threads que de fato foram criadas
+    int iniciadas = 0;
+    for (int t = 0; t < numThreads; t++) {
+        trabalhadores[t].tarefa = &tarefa;
+        trabalhadores[t].indice = t;
+        if (pthread_create(&threads[t], NULL, executarTrabalhadorAjuste, &trabalhadores[t]) != 0) {
+            break;
+        }
+        iniciadas++;
+    }
+    if (iniciadas == 0) {
+        printf("❌ Erro: Não foi possível criar as threads do ajuste\n");
+        return;
+    }
+    if (iniciadas < numThreads) {
+        printf("⚠️  Apenas %d de %d threads foram criadas; seguindo com elas.\n", iniciadas, numThreads);
+        numThreads = iniciadas;
+    }
+    pthread_barrier_init(&tarefa.inicio, NULL, (unsigned int)numThreads + 1);
+    pthread_barrier_init(&tarefa.fim, NULL, (unsigned int)numThreads + 1);
+    atomic_store_explicit(&tarefa.liberado, true, memory_order_release);
+    
+    struct timespec inicio, fim;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    
+    while (progresso.geracao < geracoes) {
+        int k = progresso.geracao;
+        double passo = AJUSTE_PASSO / pow(k + 1 + AJUSTE_ESTABILIDADE, AJUSTE_ALFA);
+        double perturbacao = AJUSTE_PERTURBACAO / pow(k + 1, AJUSTE_GAMA);
+        double direcao[HEURISTICA_NUM_PESOS];
+        GeradorAleatorio gerador;
+        
+        inicializarGerador(&gerador, progresso.semente * 7919 + (uint64_t)k);
+        for (int p = 0; p < HEURISTICA_NUM_PESOS; p++) {
+            direcao[p] = sortearIntervalo(&gerador, 2) ? 1.0 : -1.0;
+            tarefa.candidatos[0].peso[p] = progresso.pesos.peso[p] + perturbacao * direcao[p];
+            tarefa.candidatos[1].peso[p] = progresso.pesos.peso[p] - perturbacao * direcao[p];
+        }
+        tarefa.sementeGeracao = progresso.semente + (uint64_t)k * (uint64_t)opcoes->numJogos;
+        atomic_store(&tarefa.proximaPartida, 0);
+        
+        pthread_barrier_wait(&tarefa.inicio);
+        pthread_barrier_wait(&tarefa.fim);
+        if (atomic_load(&tarefa.erro)) {
+            printf("❌ Erro: Não foi possível criar os bots (política %s)\n", politica);
+            break;
+        }
+        
+        double pontos[2] = {0.0, 0.0};
+        for (int t = 0; t < numThreads; t++) {
+            pontos[0] += trabalhadores[t].pontos[0];
+            pontos[1] += trabalhadores[t].pontos[1];
+        }
+        double taxaMais = pontos[0] / opcoes->numJogos;
+        double taxaMenos = pontos[1] / opcoes->numJogos;
+        for (int p = 0; p < HEURISTICA_NUM_PESOS; p++) {
+            double peso = progresso.pesos.peso[p] + passo * (taxaMais - taxaMenos) / (2.0 * perturbacao * direcao[p]);
+            progresso.pesos.peso[p] = (peso > 1.0) ? 1.0 : (peso < -1.0) ? -1.0 : peso;
+        }
+        progresso.geracao++;
+        
+        if (!gravarCheckpointAjuste(caminho, &progresso)) {
+            printf("⚠️  Não foi possível gravar o checkpoint %s\n", caminho);
+        }
+        printf("🧬 Geração %3d | +: %5.1f%% | -: %5.1f%% | pesos: %.4f %.4f %.4f %.4f\n",
+               progresso.geracao, 100.0 * taxaMais, 100.0 * taxaMenos, progresso.pesos.peso[0],
+               progresso.pesos.peso[1], progresso.pesos.peso[2], progresso.pesos.peso[3]);
+    }
+    
+    tarefa.encerrar = true;
+    pthread_barrier_wait(&tarefa.inicio);
+    for (int t = 0; t < numThreads; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    pthread_barrier_destroy(&tarefa.inicio);
+    pthread_barrier_destroy(&tarefa.fim);
+    
+    clock_gettime(CLOCK_MONOTONIC, &fim);
+    double segundos = (fim.tv_sec - inicio.tv_sec) + (fim.tv_nsec - inicio.tv_nsec) / 1e9;
+    printf("✅ Pesos após %d gerações: heuristico:%.4f:%.4f:%.4f:%.4f (%.2f s)\n", progresso.geracao,
+           progresso.pesos.peso[0], progresso.pesos.peso[1], progresso.pesos.peso[2],
+           progresso.pesos.peso[3], segundos);
+}
+
+// ============================================================================
+// IMPLEMENTAÇÃO DAS FUNÇÕES - RATINGS E TORNEIO
+// ============================================================================
+
+/**
+ * Nova volatilidade de um bot ao fim de um período (passo 5 do
+ * Glicko-2): raiz de f(x) pelo método de Illinois
+ * 
+ * @param volatilidade Volatilidade atual
+ * @param phi Desvio no início do período (escala Glicko-2)
+ * @param v Variância estimada pelos resultados do período
+ * @param delta Melhora estimada pelos resultados do período
+ * @return Nova volatilidade
+ */
+static double novaVolatilidadeGlicko2(double volatilidade, double phi, double v, double delta) {
+    double a = log(volatilidade * volatilidade);
+    double tau2 = RATING_TAU * RATING_TAU;
+    double phi2 = phi * phi, delta2 = delta * delta;
+    #define F_GLICKO(x) (exp(x) * (delta2 - phi2 - v - exp(x)) / \
+                         (2.0 * (phi2 + v + exp(x)) * (phi2 + v + exp(x))) - ((x) - a) / tau2)
+    double A = a, B;
+    if (delta2 > phi2 + v) {
+        B = log(delta2 - phi2 - v);
+    } else {
+        int k = 1;
+        while (F_GLICKO(a - k * RATING_TAU) < 0.0) k++;
+        B = a - k * RATING_TAU;
+    }
+    double fA = F_GLICKO(A), fB = F_GLICKO(B);
+    while (fabs(B - A) > 1e-6) {
+        double C = A + (A - B) * fA / (fB - fA);
+        double fC = F_GLICKO(C);
+        if (fC * fB <= 0.0) {
+            A = B;
+            fA = fB;
+        } else {
+            fA /= 2.0;
+        }
+        B = C;
+        fB = fC;
+    }
+    #undef F_GLICKO
+    return exp(A / 2.0);
+}
+
+/**
+ * Atualiza o rating Glicko-2 de um bot após uma partida
+ * 
+ * Rating e desvio mudam a cada partida (passos 6 e 7 do Glicko-2 com
+ * um único adversário, sem inflar o desvio); a volatilidade, que
+ * precisa de vários resultados para ser estimada, é recalculada a cada
+ * RATING_PERIODO partidas do bot, com os acumuladores do período, e só
+ * então infla o desvio. Assim o placar muda a cada resultado sem que o
+ * desvio pare de diminuir em torneios longos.
+ * 
+ * @param bot Rating a atualizar
+ * @param adversario Rating do adversário antes da partida
+ * @param pontos Resultado do bot (1, 0,5 ou 0)
+ */
+static void atualizarGlicko2(RatingBot* bot, const RatingBot* adversario, double pontos) {
+    double mu = (bot->rating - RATING_INICIAL) / RATING_ESCALA;
+    double phi = bot->desvio / RATING_ESCALA;
+    double muAdv = (adversario->rating - RATING_INICIAL) / RATING_ESCALA;
+    double phiAdv = adversario->desvio / RATING_ESCALA;
+    
+    double g = 1.0 / sqrt(1.0 + 3.0 * phiAdv * phiAdv / (M_PI * M_PI));
+    double esperado = 1.0 / (1.0 + exp(-g * (mu - muAdv)));
+    double informacao = g * g * esperado * (1.0 - esperado);
+    
+    double phiNovo = 1.0 / sqrt(1.0 / (phi * phi) + informacao);
+    bot->rating = RATING_INICIAL + RATING_ESCALA * (mu + phiNovo * phiNovo * g * (pontos - esperado));
+    bot->informacaoPeriodo += informacao;
+    bot->surpresaPeriodo += g * (pontos - esperado);
+    
+    if (++bot->partidasPeriodo == RATING_PERIODO) {
+        double v = 1.0 / bot->informacaoPeriodo;
+        bot->volatilidade = novaVolatilidadeGlicko2(bot->volatilidade, bot->desvioPeriodo,
+                                                    v, v * bot->surpresaPeriodo);
+        phiNovo = sqrt(phiNovo * phiNovo + bot->volatilidade * bot->volatilidade);
+        bot->desvioPeriodo = phiNovo;
+        bot->informacaoPeriodo = bot->surpresaPeriodo = 0.0;
+        bot->partidasPeriodo = 0;
+    }
+    bot->desvio = RATING_ESCALA * phiNovo;
+    bot->partidas++;
+    if (pontos == 1.0) bot->vitorias++;
+    else if (pontos == 0.5) bot->empates++;
+}
+
+/**
+ * Publica o placar atual (escrita de seqlock)
+ * 
+ * @param servico Serviço de ratings
+ */
+static void publicarPlacar(ServicoRatings* servico) {
+    unsigned int seq = atomic_load_explicit(&servico->seqPlacar, memory_order_relaxed);
+    atomic_store_explicit(&servico->seqPlacar, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    memcpy(&servico->placar, &servico->atual, sizeof(PlacarRatings));
+    atomic_store_explicit(&servico->seqPlacar, seq + 2, memory_order_release);
+}
+
+/**
+ * Retira o próximo resultado da fila (único consumidor)
+ * 
+ * @param servico Serviço de ratings
+ * @param botA Saída com o primeiro bot
+ * @param botB Saída com o segundo bot
+ * @param pontosA Saída com o resultado do primeiro bot
+ * @return false se a fila está vazia
+ */
+static bool retirarResultado(ServicoRatings* servico, int* botA, int* botB, double* pontosA) {
+    size_t posicao = servico->posicaoLeitura;
+    CelulaResultado* celula = &servico->fila[posicao & (RATING_FILA - 1)];
+    
+    if (atomic_load_explicit(&celula->sequencia, memory_order_acquire) != posicao + 1) {
+        return false;
+    }
+    *botA = celula->botA;
+    *botB = celula->botB;
+    *pontosA = celula->pontosA;
+    atomic_store_explicit(&celula->sequencia, posicao + RATING_FILA, memory_order_release);
+    servico->posicaoLeitura = posicao + 1;
+    return true;
+}
+
+/**
+ * Corpo da thread do serviço de ratings
+ * 
+ * Consome a fila até esvaziá-la, atualizando os dois ratings de cada
+ * partida com os valores anteriores a ela, e publica o placar uma vez
+ * por rajada de resultados.
+ * 
+ * @param argumento Ponteiro para o ServicoRatings
+ * @return NULL
+ */
+static void* executarServicoRatings(void* argumento) {
+    ServicoRatings* servico = (ServicoRatings*)argumento;
+    const struct timespec pausa = {0, 1000000L};
+    
+    for (;;) {
+        bool encerrar = atomic_load_explicit(&servico->encerrar, memory_order_acquire);
+        int botA, botB, processados = 0;
+        double pontosA;
+        
+        while (retirarResultado(servico, &botA, &botB, &pontosA)) {
+            RatingBot antesA = servico->atual.bots[botA];
+            atualizarGlicko2(&servico->atual.bots[botA], &servico->atual.bots[botB], pontosA);
+            atualizarGlicko2(&servico->atual.bots[botB], &antesA, 1.0 - pontosA);
+            servico->atual.partidas++;
+            processados++;
+        }
+        if (processados > 0) {
+            publicarPlacar(servico);
+        } else if (encerrar) {
+            break; // Encerramento só com a fila vazia: nenhum resultado se perde
+        } else {
+            nanosleep(&pausa, NULL);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Inicia o serviço de ratings com todos os bots no rating inicial
+ * 
+ * @param servico Serviço (não inicializado)
+ * @param numBots Quantidade de bots
+ * @return true se a thread foi criada
+ */
+bool iniciarServicoRatings(ServicoRatings* servico, int numBots) {
+    memset(servico, 0, sizeof(*servico));
+    for (size_t i = 0; i < RATING_FILA; i++) {
+        atomic_init(&servico->fila[i].sequencia, i);
+    }
+    servico->atual.numBots = numBots;
+    for (int b = 0; b < numBots; b++) {
+        servico->atual.bots[b].rating = RATING_INICIAL;
+        servico->atual.bots[b].desvio = RATING_RD_INICIAL;
+        servico->atual.bots[b].volatilidade = RATING_VOLATILIDADE_INICIAL;
+        servico->atual.bots[b].desvioPeriodo = RATING_RD_INICIAL / RATING_ESCALA;
+    }
+    publicarPlacar(servico);
+    return pthread_create(&servico->thread, NULL, executarServicoRatings, servico) == 0;
+}
+
+/**
+ * Envia o resultado de uma partida ao serviço (vários produtores)
+ * 
+ * Reserva uma célula com compare-and-swap na posição de escrita; com a
+ * fila cheia, cede o processador até o serviço consumir.
+ * 
+ * @param servico Serviço de ratings
+ * @param botA Primeiro bot
+ * @param botB Segundo bot
+ * @param pontosA Resultado do primeiro bot (1, 0,5 ou 0)
+ */
+void registrarResultadoRating(ServicoRatings* servico, int botA, int botB, double pontosA) {
+    size_t posicao = atomic_load_explicit(&servico->posicaoEscrita, memory_order_relaxed);
+    
+    for (;;) {
+        CelulaResultado* celula = &servico->fila[posicao & (RATING_FILA - 1)];
+        size_t sequencia = atomic_load_explicit(&celula->sequencia, memory_order_acquire);
+        intptr_t diferenca = (intptr_t)sequencia - (intptr_t)posicao;
+        
+        if (diferenca == 0) {
+            if (atomic_compare_exchange_weak_explicit(&servico->posicaoEscrita, &posicao, posicao + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                celula->botA = botA;
+                celula->botB = botB;
+                celula->pontosA = pontosA;
+                atomic_store_explicit(&celula->sequencia, posicao + 1, memory_order_release);
+                return;
+            }
+        } else if (diferenca < 0) {
+            sched_yield(); // Fila cheia
+            posicao = atomic_load_explicit(&servico->posicaoEscrita, memory_order_relaxed);
+        } else {
+            posicao = atomic_load_explicit(&servico->posicaoEscrita, memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * Lê o placar mais recente sem esperar o serviço (leitura de seqlock)
+ * 
+ * @param servico Serviço de ratings
+ * @param placar Cópia do placar
+ * @return true se a cópia é consistente
+ */
+bool lerPlacarRatings(ServicoRatings* servico, PlacarRatings* placar) {
+    for (int tentativa = 0; tentativa < 4; tentativa++) {
+        unsigned int antes = atomic_load_explicit(&servico->seqPlacar, memory_order_acquire);
+        if (antes & 1u) continue;
+        memcpy(placar, &servico->placar, sizeof(*placar));
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&servico->seqPlacar, memory_order_relaxed) == antes) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Encerra o serviço depois de processar todos os resultados enviados
+ * 
+ * @param servico Serviço de ratings
+ */
+void encerrarServicoRatings(ServicoRatings* servico) {
+    atomic_store_explicit(&servico->encerrar, true, memory_order_release);
+    pthread_join(servico->thread, NULL);
+}
+
+/*
+ * Struct: TarefaTorneio
+ *
+ * Torneio compartilhado pelos trabalhadores do pool: bots, serviço que
+ * recebe os resultados e progresso lido pelo painel.
+ */
+typedef struct {
+    char* tipos[TORNEIO_MAX_BOTS];
+    int numBots;
+    const OpcoesSimulacao* opcoes;
+    ServicoRatings* servico;
+    struct BlocoTorneio* blocos;
+    long numBlocos;
+    atomic_long concluidas;
+    atomic_bool erro;
+} TarefaTorneio;
+
+/*
+ * Struct: BlocoTorneio
+ *
+ * Tarefa do pool com as partidas [inicio, fim) do torneio.
+ */
+typedef struct BlocoTorneio {
+    TarefaPool tarefa;
+    TarefaTorneio* torneio;
+    long inicio;
+    long fim;
+} BlocoTorneio;
+
+/*
+ * Struct: BotsTorneio
+ *
+ * Bots de um trabalhador do pool (memória local dele), criados na
+ * primeira partida que ele joga e reaproveitados nas seguintes.
+ */
+typedef struct {
+    ControladorJogador* bots[TORNEIO_MAX_BOTS];
+    int criados;
+    bool preparados;
+} BotsTorneio;
+
+/**
+ * Cria os bots do trabalhador na primeira vez que ele joga
+ * 
+ * @param torneio Torneio
+ * @param trabalhador Trabalhador do pool
+ * @return true se todos os bots existem
+ */
+static bool prepararBotsTorneio(TarefaTorneio* torneio, TrabalhadorPool* trabalhador) {
+    BotsTorneio* locais = (BotsTorneio*)trabalhador->local;
+    const OpcoesSimulacao* opcoes = torneio->opcoes;
+    
+    if (!locais->preparados) {
+        locais->preparados = true;
+        while (locais->criados < torneio->numBots) {
+            uint64_t semente = opcoes->semente * 31 + (uint64_t)trabalhador->indice * TORNEIO_MAX_BOTS +
+                               (uint64_t)locais->criados;
+            ControladorJogador* bot = criarControlador(torneio->tipos[locais->criados], semente);
+            if (bot == NULL || controladorEhHumano(bot)) {
+                if (bot != NULL) {
+                    bot->liberar(bot);
+                }
+                atomic_store(&torneio->erro, true);
+                break;
+            }
+            locais->bots[locais->criados++] = bot;
+        }
+    }
+    return locais->criados == torneio->numBots;
+}
+
+/**
+ * Tarefa de um bloco de partidas do torneio
+ * 
+ * A partida N opõe o par N mod P (P pares de bots), com os lugares
+ * trocados a cada rodada completa, e usa sempre as mesmas sementes.
+ * O resultado vai para o serviço de ratings assim que a partida acaba.
+ * 
+ * @param trabalhador Trabalhador do pool (dono dos bots)
+ * @param argumento Ponteiro para o BlocoTorneio
+ */
+static void jogarBlocoTorneio(TrabalhadorPool* trabalhador, void* argumento) {
+    BlocoTorneio* bloco = (BlocoTorneio*)argumento;
+    TarefaTorneio* tarefa = bloco->torneio;
+    const OpcoesSimulacao* opcoes = tarefa->opcoes;
+    long numPares = (long)tarefa->numBots * (tarefa->numBots - 1) / 2;
+    
+    if (!prepararBotsTorneio(tarefa, trabalhador)) {
+        return;
+    }
+    ControladorJogador** bots = ((BotsTorneio*)trabalhador->local)->bots;
+    
+    for (long jogo = bloco->inicio; jogo < bloco->fim; jogo++) {
+        if (atomic_load_explicit(&tarefa->erro, memory_order_relaxed)) {
+            break;
+        }
+        
+        // Par (a, b) de índice jogo mod P, em ordem lexicográfica
+        long par = jogo % numPares;
+        int a = 0;
+        while (par >= tarefa->numBots - 1 - a) {
+            par -= tarefa->numBots - 1 - a;
+            a++;
+        }
+        int b = a + 1 + (int)par;
+        bool trocado = ((jogo / numPares) % 2) == 1;
+        ControladorJogador* controladores[2] = {bots[trocado ? b : a], bots[trocado ? a : b]};
+        
+        GeradorAleatorio sorteio, dados;
+        EstadoSimulacao estado;
+        inicializarGerador(&sorteio, (opcoes->semente + (uint64_t)jogo) * 3);
+        inicializarGerador(&dados, (opcoes->semente + (uint64_t)jogo) * 3 + 1);
+        gerarPartidaAleatoria(&estado, &regrasPadrao, 2, opcoes->numTerritorios, &sorteio);
+        
+        int vencedor = jogarPartidaControladores(&estado, &regrasPadrao, controladores, &dados,
+                                                 ROLLOUT_MAX_TURNOS, NULL);
+        double pontosA = (vencedor < 0) ? 0.5 : ((vencedor == 0) != trocado) ? 1.0 : 0.0;
+        registrarResultadoRating(tarefa->servico, a, b, pontosA);
+        atomic_fetch_add_explicit(&tarefa->concluidas, 1, memory_order_relaxed);
+    }
+}
+
+/**
+ * Raiz do torneio: bifurca os blocos de partidas
+ * 
+ * @param trabalhador Trabalhador 0 do pool
+ * @param argumento Ponteiro para a TarefaTorneio
+ */
+static void executarRaizTorneio(TrabalhadorPool* trabalhador, void* argumento) {
+    TarefaTorneio* tarefa = (TarefaTorneio*)argumento;
+    GrupoTarefas grupo;
+    atomic_init(&grupo.pendentes, 0);
+    
+    for (long b = 0; b < tarefa->numBlocos; b++) {
+        bifurcarTarefa(trabalhador, &grupo, &tarefa->blocos[b].tarefa);
+    }
+    aguardarGrupo(trabalhador, &grupo);
+}
+
+/**
+ * Corpo da thread do placar ao vivo do torneio
+ * 
+ * Lê o placar publicado sem bloqueio a cada TORNEIO_PAINEL_MS enquanto
+ * os trabalhadores do pool jogam (a thread principal é um deles).
+ * 
+ * @param argumento Ponteiro para a TarefaTorneio
+ * @return NULL
+ */
+static void* executarPainelTorneio(void* argumento) {
+    TarefaTorneio* tarefa = (TarefaTorneio*)argumento;
+    const struct timespec pausa = {TORNEIO_PAINEL_MS / 1000, (TORNEIO_PAINEL_MS % 1000) * 1000000L};
+    PlacarRatings placar;
+    
+    while (atomic_load(&tarefa->concluidas) < tarefa->opcoes->numJogos && !atomic_load(&tarefa->erro)) {
+        nanosleep(&pausa, NULL);
+        if (lerPlacarRatings(tarefa->servico, &placar) && placar.partidas > 0) {
+            int lider = 0;
+            for (int b = 1; b < placar.numBots; b++) {
+                if (placar.bots[b].rating > placar.bots[lider].rating) lider = b;
+            }
+            printf("⏳ %ld/%ld partidas | líder: %s (%.1f ± %.1f)\n", placar.partidas, tarefa->opcoes->numJogos,
+                   tarefa->tipos[lider], placar.bots[lider].rating, 2.0 * placar.bots[lider].desvio);
+            fflush(stdout);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Exibe o placar ordenado por rating
+ * 
+ * @param placar Placar lido do serviço
+ * @param tipos Nome de cada bot
+ */
+static void exibirPlacarRatings(const PlacarRatings* placar, char* const* tipos) {
+    int ordem[TORNEIO_MAX_BOTS];
+    
+    for (int b = 0; b < placar->numBots; b++) {
+        int k = b;
+        while (k > 0 && placar->bots[ordem[k - 1]].rating < placar->bots[b].rating) {
+            ordem[k] = ordem[k - 1];
+            k--;
+        }
+        ordem[k] = b;
+    }
+    printf("📊 %ld partidas avaliadas\n", placar->partidas);
+    for (int k = 0; k < placar->numBots; k++) {
+        const RatingBot* bot = &placar->bots[ordem[k]];
+        printf("   %2d. %-28s %7.1f ± %5.1f | %6ld partidas | %5.1f%% vitórias | %4.1f%% empates\n",
+               k + 1, tipos[ordem[k]], bot->rating, 2.0 * bot->desvio, bot->partidas,
+               bot->partidas > 0 ? 100.0 * bot->vitorias / bot->partidas : 0.0,
+               bot->partidas > 0 ? 100.0 * bot->empates / bot->partidas : 0.0);
+    }
+}
+
+/**
+ * Torneio todos contra todos entre bots, com ratings ao vivo
+ * 
+ * Blocos de TORNEIO_BLOCO partidas de 2 jogadores são tarefas do pool
+ * de roubo de tarefas; cada trabalhador joga com os seus próprios bots
+ * e envia cada resultado ao serviço de ratings, enquanto uma thread de
+ * painel mostra o placar publicado a cada TORNEIO_PAINEL_MS. Os ratings
+ * dependem da ordem em que os resultados chegam, então podem variar
+ * levemente entre execuções com mais de uma thread (as partidas em si
+ * não variam).
+ * 
+ * @param lista Tipos dos bots separados por vírgula
+ * @param opcoes Total de partidas, territórios e semente
+ * @param numThreads Threads de simulação
+ */
+void executarTorneio(char* lista, const OpcoesSimulacao* opcoes, int numThreads) {
+    ServicoRatings* servico;        // No heap: a fila tem RATING_FILA células
+    TarefaTorneio tarefa;
+    PlacarRatings placar;
+    pthread_t painel;
+    
+    memset(&tarefa, 0, sizeof(tarefa));
+    for (char* tipo = strtok(lista, ","); tipo != NULL; tipo = strtok(NULL, ",")) {
+        if (tarefa.numBots == TORNEIO_MAX_BOTS) {
+            printf("❌ Erro: No máximo %d bots por torneio.\n", TORNEIO_MAX_BOTS);
+            return;
+        }
+        tarefa.tipos[tarefa.numBots++] = tipo;
+    }
+    if (tarefa.numBots < 2) {
+        printf("❌ Erro: Informe ao menos 2 bots.\n");
+        return;
+    }
+    tarefa.opcoes = opcoes;
+    servico = (ServicoRatings*)aligned_alloc(_Alignof(ServicoRatings), sizeof(ServicoRatings));
+    tarefa.servico = servico;
+    tarefa.numBlocos = (opcoes->numJogos + TORNEIO_BLOCO - 1) / TORNEIO_BLOCO;
+    tarefa.blocos = (BlocoTorneio*)calloc(tarefa.numBlocos > 0 ? tarefa.numBlocos : 1, sizeof(BlocoTorneio));
+    PoolTrabalho* pool = criarPoolTrabalho(numThreads, opcoes->semente, sizeof(BotsTorneio), opcoes->numaIngenuo);
+    if (servico == NULL || tarefa.blocos == NULL || pool == NULL) {
+        printf("❌ Erro: Falha na alocação de memória para o torneio!\n");
+        free(servico);
+        free(tarefa.blocos);
+        liberarPoolTrabalho(pool);
+        return;
+    }
+    for (long b = 0; b < tarefa.numBlocos; b++) {
+        BlocoTorneio* bloco = &tarefa.blocos[b];
+        bloco->tarefa.executar = jogarBlocoTorneio;
+        bloco->tarefa.argumento = bloco;
+        bloco->torneio = &tarefa;
+        bloco->inicio = b * TORNEIO_BLOCO;
+        bloco->fim = (bloco->inicio + TORNEIO_BLOCO < opcoes->numJogos) ? bloco->inicio + TORNEIO_BLOCO
+                                                                         : opcoes->numJogos;
+    }
+    if (!iniciarServicoRatings(servico, tarefa.numBots)) {
+        printf("❌ Erro: Não foi possível iniciar o serviço de ratings\n");
+        liberarPoolTrabalho(pool);
+        free(servico);
+        free(tarefa.blocos);
+        return;
+    }
+    
+    printf("\n🏆 ═══════════════════════════════════════════════════════════\n");
+    printf("                   TORNEIO ENTRE BOTS (GLICKO-2)\n");
+    printf("═══════════════════════════════════════════════════════════🏆\n");
+    printf("🤖 %d bots | %ld partidas de 2 jogadores, %d territórios | %d threads\n",
+           tarefa.numBots, opcoes->numJogos, opcoes->numTerritorios, pool->iniciados + 1);
+    
+    struct timespec inicio, fim;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    
+    // Placar ao vivo: leitura sem bloqueio enquanto as partidas correm
+    bool temPainel = pthread_create(&painel, NULL, executarPainelTorneio, &tarefa) == 0;
+    executarRaizPool(pool, executarRaizTorneio, &tarefa);
+    if (temPainel) {
+        pthread_join(painel, NULL);
+    }
+    encerrarServicoRatings(servico);
+    
+    clock_gettime(CLOCK_MONOTONIC, &fim);
+    double segundos = (fim.tv_sec - inicio.tv_sec) + (fim.tv_nsec - inicio.tv_nsec) / 1e9;
+    
+    for (int i = 0; i <= pool->iniciados; i++) {
+        BotsTorneio* locais = (BotsTorneio*)pool->trabalhadores[i].local;
+        for (int j = 0; j < locais->criados; j++) {
+            locais->bots[j]->liberar(locais->bots[j]);
+        }
+    }
+    liberarPoolTrabalho(pool);
+    free(tarefa.blocos);
+    lerPlacarRatings(servico, &placar);
+    free(servico);
+    
+    if (atomic_load(&tarefa.erro)) {
+        printf("⚠️  Torneio interrompido por erro (tipo de bot inválido)\n");
+        return;
+    }
+    exibirPlacarRatings(&placar, tarefa.tipos);
+    printf("🚀 %.2f s (%.0f partidas/s)\n", segundos, placar.partidas / (segundos > 0 ? segundos : 1e-9));
+}
+
+// ============================================================================
+// IMPLEMENTAÇÃO DAS FUNÇÕES - CONTEXTO DE JOGO (MOTOR REENTRANTE)
+// ============================================================================
+
+/**
+ * Envia uma mensagem do motor para a saída de eventos do contexto
+ * 
+ * @param contexto Contexto da partida
+ * @param formato Formato no estilo printf
+ */
+void emitirEvento(const ContextoJogo* contexto, const char* formato, ...) {
+    if (contexto->saida.escrever != NULL) {
+        va_list argumentos;
+        va_start(argumentos, formato);
+        contexto->saida.escrever(contexto->saida.dados, formato, argumentos);
+        va_end(argumentos);
+    }
+}
+
+/**
+ * Limpa a tela pela saída de eventos do contexto
+ * 
+ * @param contexto Contexto da partida
+ */
+void limparTelaContexto(const ContextoJogo* contexto) {
+    if (contexto->saida.limpar != NULL) {
+        contexto->saida.limpar(contexto->saida.dados);
+    }
+}
+
+/**
+ * Espera o jogador continuar pela entrada do contexto
+ * 
+ * @param contexto Contexto da partida
+ */
+void pausarContexto(const ContextoJogo* contexto) {
+    if (contexto->entrada.pausar != NULL) {
+        contexto->entrada.pausar(contexto->entrada.dados);
+    }
+}
+
+/**
+ * Lê um inteiro em [minimo, maximo] pela entrada do contexto
+ * 
+ * @param contexto Contexto da partida
+ * @param minimo Menor valor aceito
+ * @param maximo Maior valor aceito
+ * @return Valor lido, ou minimo - 1 se não há entrada
+ */
+int lerNumeroContexto(const ContextoJogo* contexto, int minimo, int maximo) {
+    if (contexto->entrada.lerNumero == NULL) {
+        return minimo - 1;
+    }
+    return contexto->entrada.lerNumero(contexto->entrada.dados, minimo, maximo);
+}
+
+/**
+ * Pergunta s/N pela entrada do contexto
+ * 
+ * @param contexto Contexto da partida
+ * @return true se o jogador confirmou (false sem entrada)
+ */
+bool confirmarContexto(const ContextoJogo* contexto) {
+    return contexto->entrada.confirmar != NULL && contexto->entrada.confirmar(contexto->entrada.dados);
+}
+
+/**
+ * Cria uma partida completa sem interação: territórios e jogadores com
+ * nomes automáticos, missões e tropas sorteadas pelo gerador do próprio
+ * contexto (mesma distribuição de cadastrarJogadores e
+ * distribuirTerritorios)
+ * 
+ * Os controladores dos jogadores ficam NULL; quem cria o contexto os
+ * define antes de jogar.
+ * 
+ * @param contexto Contexto a ser preenchido
+ * @param numJogadores Número de jogadores
+ * @param numTerritorios Número de territórios
+ * @param semente Semente do gerador da partida
+ * @param regras Regras da partida
+ * @param saida Saída de eventos (saidaSilenciosa para descartar)
+ * @return true se a memória foi alocada
+ */
+bool criarContextoJogo(ContextoJogo* contexto, int numJogadores, int numTerritorios, uint64_t semente,
+                       const Regras* regras, SaidaEventos saida) {
+    const char* cores[] = {"Vermelho", "Azul", "Verde", "Amarelo", "Roxo", "Laranja"};
+    char missoes[TOTAL_MISSOES][MAX_MISSAO];
+    
+    memset(contexto, 0, sizeof(*contexto));
+    contexto->mapa = (Territorio*)calloc((size_t)numTerritorios, sizeof(Territorio));
+    contexto->jogadores = (Jogador*)calloc((size_t)numJogadores, sizeof(Jogador));
+    contexto->numTerritorios = numTerritorios;
+    contexto->numJogadores = numJogadores;
+    contexto->regras = regras;
+    contexto->saida = saida;
+    inicializarGerador(&contexto->gerador, semente);
+    if (contexto->mapa == NULL || contexto->jogadores == NULL) {
+        liberarContextoJogo(contexto);
+        return false;
+    }
+    
+    preencherMissoes(missoes);
+    for (int i = 0; i < numJogadores; i++) {
+        Jogador* jogador = &contexto->jogadores[i];
+        snprintf(jogador->nome, sizeof(jogador->nome), "Jogador %d", i + 1);
+        strcpy(jogador->cor, cores[i % 6]);
+        jogador->ativo = true;
+        jogador->missao = (char*)malloc(MAX_MISSAO * sizeof(char));
+        if (jogador->missao == NULL) {
+            liberarContextoJogo(contexto);
+            return false;
+        }
+        strcpy(jogador->missao, missoes[sortearIntervalo(&contexto->gerador, TOTAL_MISSOES)]);
+    }
+    for (int i = 0; i < numTerritorios; i++) {
+        snprintf(contexto->mapa[i].nome, sizeof(contexto->mapa[i].nome), "Território %d", i + 1);
+    }
+    distribuirTerritorios(contexto);
+    return true;
+}
+
+/**
+ * Libera o mapa, as missões e os controladores de um contexto
+ * 
+ * @param contexto Contexto criado por criarContextoJogo
+ */
+void liberarContextoJogo(ContextoJogo* contexto) {
+    for (int i = 0; contexto->jogadores != NULL && i < contexto->numJogadores; i++) {
+        free(contexto->jogadores[i].missao);
+        if (contexto->jogadores[i].controlador != NULL) {
+            contexto->jogadores[i].controlador->liberar(contexto->jogadores[i].controlador);
+        }
+    }
+    free(contexto->jogadores);
+    free(contexto->mapa);
+    contexto->jogadores = NULL;
+    contexto->mapa = NULL;
+}
+
+/**
+ * Conta os jogadores ainda ativos
+ * 
+ * @param contexto Contexto da partida
+ * @return Número de jogadores ativos
+ */
+int contarJogadoresAtivos(const ContextoJogo* contexto) {
+    int ativos = 0;
+    for (int i = 0; i < contexto->numJogadores; i++) {
+        if (contexto->jogadores[i].ativo) ativos++;
+    }
+    return ativos;
+}
+
+/**
+ * Joga a vez de um jogador, no jogo interativo e no motor
+ * 
+ * O primeiro ativo a partir de *jogadorDaVez ataca pelo seu
+ * controlador (executarBatalhaMultiplayer), as estatísticas são
+ * atualizadas e a vez passa adiante. Precisa de ao menos um ativo.
+ * 
+ * @param contexto Contexto da partida
+ * @param jogadorDaVez Entrada e saída: jogador da vez
+ * @param analisador Analisador em segundo plano (pode ser NULL)
+ * @return Índice do vencedor, ou -1 se ninguém venceu ainda
+ */
+int jogarTurnoContexto(ContextoJogo* contexto, int* jogadorDaVez, AnalisadorFundo* analisador) {
+    while (!contexto->jogadores[*jogadorDaVez].ativo) {
+        *jogadorDaVez = (*jogadorDaVez + 1) % contexto->numJogadores;
+    }
+    if (analisador != NULL) {
+        EstadoSimulacao estadoAtual;
+        montarEstadoSimulacao(&estadoAtual, contexto->mapa, contexto->numTerritorios, contexto->jogadores,
+                              contexto->numJogadores, *jogadorDaVez);
+        publicarEstadoAnalise(analisador, &estadoAtual);
+    }
+    
+    executarBatalhaMultiplayer(contexto, *jogadorDaVez, analisador);
+    atualizarEstatisticasJogadores(contexto);
+    *jogadorDaVez = (*jogadorDaVez + 1) % contexto->numJogadores;
+    return verificarVencedor(contexto);
+}
+
+/**
+ * Joga uma partida completa no motor de Territorio/Jogador
+ * 
+ * Os turnos são os do jogo interativo (jogarTurnoContexto), sem
+ * esperar entrada: cada jogador decide pelo seu controlador e as
+ * pausas dependem da entrada do contexto.
+ * 
+ * @param contexto Contexto com os controladores definidos
+ * @param maxTurnos Limite de turnos antes de declarar empate
+ * @param turnosJogados Saída com a duração da partida (pode ser NULL)
+ * @return Índice do vencedor, ou -1 sem vencedor
+ */
+int jogarPartidaContexto(ContextoJogo* contexto, int maxTurnos, int* turnosJogados) {
+    int vencedor = -1;
+    int jogadorDaVez = 0;
+    int turno;
+    
+    atualizarEstatisticasJogadores(contexto);
+    vencedor = verificarVencedor(contexto);
+    for (turno = 0; turno < maxTurnos && vencedor == -1 && contarJogadoresAtivos(contexto) > 1; turno++) {
+        vencedor = jogarTurnoContexto(contexto, &jogadorDaVez, NULL);
+    }
+    
+    if (turnosJogados != NULL) {
+        *turnosJogados = turno;
+    }
+    return vencedor;
+}
+
+/*
+ * Struct: TarefaEscalaMotor
+ *
+ * Partidas do motor completo repartidas entre as threads e totais
+ * usados para conferir que o resultado não depende da repartição.
+ */
+typedef struct {
+    const char* politica;
+    const OpcoesSimulacao* opcoes;
+    int numThreads;
+    atomic_int proximoIndice;
+    atomic_long proximaPartida;
+    atomic_long vitorias[MAX_JOGADORES];
+    atomic_long turnos;
+    atomic_bool erro;
+} TarefaEscalaMotor;
+
+/**
+ * Corpo de uma thread da medição de escala do motor
+ * 
+ * Cada partida tem seu próprio contexto, semeado pelo número da
+ * partida; os controladores da thread são reaproveitados, reiniciados
+ * a cada partida com as sementes e as regras dela.
+ * 
+ * @param argumento Ponteiro para a TarefaEscalaMotor
+ * @return NULL
+ */
+static void* executarTrabalhadorEscalaMotor(void* argumento) {
+    TarefaEscalaMotor* tarefa = (TarefaEscalaMotor*)argumento;
+    const OpcoesSimulacao* opcoes = tarefa->opcoes;
+    ControladorJogador* controladores[MAX_JOGADORES];
+    int criados = 0;
+    
+    if (!opcoes->numaIngenuo) {
+        fixarThreadNucleo(atomic_fetch_add(&tarefa->proximoIndice, 1), tarefa->numThreads, NULL);
+    }
+    while (criados < opcoes->numJogadores) {
+        controladores[criados] = criarControlador(tarefa->politica, 0);
+        if (controladores[criados] == NULL || controladorEhHumano(controladores[criados])) {
+            if (controladores[criados] != NULL) {
+                controladores[criados]->liberar(controladores[criados]);
+            }
+            atomic_store(&tarefa->erro, true);
+            break;
+        }
+        criados++;
+    }
+    
+    while (criados == opcoes->numJogadores) {
+        long jogo = atomic_fetch_add_explicit(&tarefa->proximaPartida, 1, memory_order_relaxed);
+        if (jogo >= opcoes->numJogos) {
+            break;
+        }
+        uint64_t semente = (opcoes->semente + (uint64_t)jogo) * 3;
+        ContextoJogo contexto;
+        if (!criarContextoJogo(&contexto, opcoes->numJogadores, opcoes->numTerritorios, semente,
+                               &regrasPadrao, saidaSilenciosa)) {
+            atomic_store(&tarefa->erro, true);
+            break;
+        }
+        for (int j = 0; j < opcoes->numJogadores; j++) {
+            reiniciarControlador(controladores[j], semente + 1 + (uint64_t)j);
+            definirRegrasControlador(controladores[j], contexto.regras);
+            contexto.jogadores[j].controlador = controladores[j];
+        }
+        
+        int duracao;
+        int vencedor = jogarPartidaContexto(&contexto, ROLLOUT_MAX_TURNOS, &duracao);
+        if (vencedor >= 0) {
+            atomic_fetch_add_explicit(&tarefa->vitorias[vencedor], 1, memory_order_relaxed);
+        }
+        atomic_fetch_add_explicit(&tarefa->turnos, duracao, memory_order_relaxed);
+        
+        for (int j = 0; j < opcoes->numJogadores; j++) {
+            contexto.jogadores[j].controlador = NULL; // Continuam com a thread
+        }
+        liberarContextoJogo(&contexto);
+    }
+    
+    for (int j = 0; j < criados; j++) {
+        controladores[j]->liberar(controladores[j]);
+    }
+    return NULL;
+}
+
+/**
+ * Mede a vazão do motor completo com 1, 2, 4... threads
+ * 
+ * As mesmas partidas são jogadas a cada quantidade de threads; como o
+ * motor não tem estado global, os totais de vitórias e turnos têm de
+ * ser idênticos, e a vazão deve crescer com os núcleos.
+ * 
+ * @param politica Tipo de controlador de todos os jogadores
+ * @param opcoes Partidas, jogadores, territórios e semente
+ * @param numThreads Maior quantidade de threads medida
+ */
+void executarEscalaMotor(const char* politica, const OpcoesSimulacao* opcoes, int numThreads) {
+    pthread_t threads[MAX_THREADS];
+    long vitoriasBase[MAX_JOGADORES] = {0};
+    long turnosBase = 0;
+    double vazaoBase = 0.0;
+    
+    if (numThreads > MAX_THREADS) numThreads = MAX_THREADS;
+    
+    printf("\n⚙️  ═══════════════════════════════════════════════════════════\n");
+    printf("                   ESCALA DO MOTOR REENTRANTE\n");
+    printf("═══════════════════════════════════════════════════════════⚙️\n");
+    printf("🤖 Política: %s | %ld partidas | %d jogadores, %d territórios\n",
+           politica, opcoes->numJogos, opcoes->numJogadores, opcoes->numTerritorios);
+    
+    for (int t = 1; t <= numThreads; t = (t < numThreads && t * 2 > numThreads) ? numThreads : t * 2) {
+        TarefaEscalaMotor tarefa;
+        memset(&tarefa, 0, sizeof(tarefa));
+        tarefa.politica = politica;
+        tarefa.opcoes = opcoes;
+        tarefa.numThreads = t;
+        
+        struct timespec inicio, fim;
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        int iniciadas = 0;
+        for (int k = 0; k < t; k++) {
+            if (pthread_create(&threads[k], NULL, executarTrabalhadorEscalaMotor, &tarefa) != 0) {
+                break;
+            }
+            iniciadas++;
+        }
+        for (int k = 0; k < iniciadas; k++) {
+            pthread_join(threads[k], NULL);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &fim);
+        
+        if (iniciadas == 0 || atomic_load(&tarefa.erro)) {
+            printf("❌ Erro: Não foi possível jogar com a política %s\n", politica);
+            return;
+        }
+        double segundos = (fim.tv_sec - inicio.tv_sec) + (fim.tv_nsec - inicio.tv_nsec) / 1e9;
+        double vazao = opcoes->numJogos / (segundos > 0 ? segundos : 1e-9);
+        bool identicos = (atomic_load(&tarefa.turnos) == turnosBase || t == 1);
+        for (int j = 0; j < opcoes->numJogadores; j++) {
+            long v = atomic_load(&tarefa.vitorias[j]);
+            if (t == 1) vitoriasBase[j] = v;
+            else if (v != vitoriasBase[j]) identicos = false;
+        }
+        if (t == 1) {
+            turnosBase = atomic_load(&tarefa.turnos);
+            vazaoBase = vazao;
+        }
+        
+        printf("🧵 %2d threads: %9.0f partidas/s | eficiência %5.1f%% | resultados %s\n",
+               t, vazao, 100.0 * vazao / (vazaoBase * t), identicos ? "idênticos ✅" : "DIFERENTES ❌");
+        if (t == numThreads) {
+            break;
+        }
+    }
+    printf("🏆 Turnos: %ld | vitórias por posição:", turnosBase);
+    for (int j = 0; j < opcoes->numJogadores; j++) {
+        printf(" %ld", vitoriasBase[j]);
+    }
+    printf("\n");
+}
+
+// ============================================================================
+// IMPLEMENTAÇÃO DAS FUNÇÕES - ESCALONADOR DE FIBRAS (PARTIDAS INTERATIVAS)
+// ============================================================================
+
+struct EscalonadorFibras;
+
+/*
+ * Struct: Fibra
+ *
+ * Uma partida do motor completo rodando como corrotina: o laço de
+ * jogarPartidaContexto executa na pilha própria da fibra e cede a
+ * thread sempre que espera a decisão de um jogador.
+ * - pilha: pilha de FIBRA_PILHA bytes (sentinela no endereço mais baixo,
+ *   logo acima de uma página de guarda sem acesso)
+ * - acordarNs: instante em que a decisão esperada fica pronta
+ * - pensar: sorteia a espera de cada decisão (não afeta a partida)
+ */
+typedef struct Fibra {
+    ucontext_t contexto;
+    struct EscalonadorFibras* escalonador;
+    uint64_t* pilha;
+    ContextoJogo jogo;
+    GeradorAleatorio pensar;
+    long acordarNs;
+    struct Fibra* proxima;          // Fila de prontas
+    int vencedor;
+    int duracao;
+    bool concluida;
+} Fibra;
+
+/*
+ * Struct: TarefaFibras
+ *
+ * Parâmetros comuns às threads de escalonamento.
+ * - ativos: threads que ainda têm partidas em andamento
+ */
+typedef struct {
+    const char* politica;
+    const OpcoesSimulacao* opcoes;
+    long pensarNs;
+    int numThreads;
+    atomic_int ativos;
+} TarefaFibras;
+
+/*
+ * Struct: EscalonadorFibras
+ *
+ * Escalonador de uma thread: as fibras não migram, então fila de
+ * prontas e heap de espera são acessados sem travas.
+ * - indice: a thread hospeda as partidas indice, indice + T, ...
+ * - dormindo: heap mínimo por acordarNs das fibras esperando decisão
+ * - pilhas: uma única região com as pilhas de todas as fibras da thread,
+ *   cada uma precedida por uma página de guarda PROT_NONE (guarda bytes):
+ *   um estouro vira falha de segmentação em vez de corromper a vizinha
+ * - passo: distância entre pilhas (guarda + pilha em páginas inteiras)
+ */
+typedef struct EscalonadorFibras {
+    ucontext_t contexto;
+    pthread_t thread;
+    TarefaFibras* tarefa;
+    int indice;
+    Fibra* fibras;
+    int numFibras;
+    char* pilhas;
+    size_t tamanhoPilhas;
+    size_t guarda;
+    size_t passo;
+    Fibra* primeiraPronta;
+    Fibra* ultimaPronta;
+    Fibra** dormindo;
+    int numDormindo;
+    int maxDormindo;
+    long trocas;
+    long decisoes;
+    long vitorias[MAX_JOGADORES];
+    long turnos;
+    bool estouro;
+    bool erro;
+} EscalonadorFibras;
+
+/*
+ * Struct: DadosJogadorFibra
+ *
+ * Controlador de um jogador hospedado em fibra: espera a decisão
+ * cedendo a thread e então consulta o controlador real.
+ */
+typedef struct {
+    Fibra* fibra;
+    ControladorJogador* interno;
+    long pensarNs;
+} DadosJogadorFibra;
+
+/**
+ * Relógio monotônico em nanossegundos
+ * 
+ * @return Instante atual
+ */
+static long instanteNs(void) {
+    struct timespec agora;
+    clock_gettime(CLOCK_MONOTONIC, &agora);
+    return agora.tv_sec * 1000000000L + agora.tv_nsec;
+}
+
+/**
+ * Memória residente do processo
+ * 
+ * @return Kilobytes residentes (0 se /proc não estiver disponível)
+ */
+static long memoriaResidenteKB(void) {
+    long paginas = 0, residentes = 0;
+    FILE* arquivo = fopen("/proc/self/statm", "r");
+    if (arquivo == NULL) {
+        return 0;
+    }
+    if (fscanf(arquivo, "%ld %ld", &paginas, &residentes) != 2) {
+        residentes = 0;
+    }
+    fclose(arquivo);
+    return residentes * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+/**
+ * Coloca uma fibra no fim da fila de prontas
+ * 
+ * @param escalonador Escalonador dono da fibra
+ * @param fibra Fibra pronta para continuar
+ */
+static void enfileirarFibraPronta(EscalonadorFibras* escalonador, Fibra* fibra) {
+    fibra->proxima = NULL;
+    if (escalonador->ultimaPronta != NULL) {
+        escalonador->ultimaPronta->proxima = fibra;
+    } else {
+        escalonador->primeiraPronta = fibra;
+    }
+    escalonador->ultimaPronta = fibra;
+}
+
+/**
+ * Insere uma fibra no heap de espera
+ * 
+ * @param escalonador Escalonador dono da fibra
+ * @param fibra Fibra com acordarNs definido
+ */
+static void inserirFibraDormindo(EscalonadorFibras* escalonador, Fibra* fibra) {
+    Fibra** heap = escalonador->dormindo;
+    int i = escalonador->numDormindo++;
+    while (i > 0 && heap[(i - 1) / 2]->acordarNs > fibra->acordarNs) {
+        heap[i] = heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    heap[i] = fibra;
+    if (escalonador->numDormindo > escalonador->maxDormindo) {
+        escalonador->maxDormindo = escalonador->numDormindo;
+    }
+}
+
+/**
+ * Retira a fibra que acorda primeiro do heap de espera
+ * 
+ * @param escalonador Escalonador com o heap não vazio
+ * @return Fibra retirada
+ */
+static Fibra* retirarFibraDormindo(EscalonadorFibras* escalonador) {
+    Fibra** heap = escalonador->dormindo;
+    Fibra* primeira = heap[0];
+    Fibra* ultima = heap[--escalonador->numDormindo];
+    int i = 0;
+    
+    for (;;) {
+        int filho = 2 * i + 1;
+        if (filho >= escalonador->numDormindo) break;
+        if (filho + 1 < escalonador->numDormindo && heap[filho + 1]->acordarNs < heap[filho]->acordarNs) {
+            filho++;
+        }
+        if (heap[filho]->acordarNs >= ultima->acordarNs) break;
+        heap[i] = heap[filho];
+        i = filho;
+    }
+    heap[i] = ultima;
+    return primeira;
+}
+
+/**
+ * Suspende a fibra até a decisão do jogador ficar pronta
+ * 
+ * Sem espera (pensarNs 0) a fibra só cede a vez às demais prontas.
+ * 
+ * @param fibra Fibra atual
+ * @param pensarNs Espera máxima sorteada por decisão
+ */
+static void aguardarDecisaoFibra(Fibra* fibra, long pensarNs) {
+    EscalonadorFibras* escalonador = fibra->escalonador;
+    escalonador->decisoes++;
+    if (pensarNs > 0) {
+        fibra->acordarNs = instanteNs() + (long)(proximoAleatorio(&fibra->pensar) % (uint64_t)pensarNs);
+        inserirFibraDormindo(escalonador, fibra);
+    } else {
+        enfileirarFibraPronta(escalonador, fibra);
+    }
+    swapcontext(&fibra->contexto, &escalonador->contexto);
+}
+
+/**
+ * Decide o ataque de um jogador hospedado em fibra
+ * 
+ * @param controlador Controlador com DadosJogadorFibra
+ * @param visao Estado compacto do jogador da vez
+ * @param atacante Saída com o território atacante
+ * @param defensor Saída com o território defensor
+ * @return true se o controlador real escolheu um ataque
+ */
+static bool decidirAtaqueFibra(ControladorJogador* controlador, const EstadoSimulacao* visao,
+                               int* atacante, int* defensor) {
+    DadosJogadorFibra* dados = (DadosJogadorFibra*)controlador->dados;
+    aguardarDecisaoFibra(dados->fibra, dados->pensarNs);
+    return dados->interno->decidirAtaque(dados->interno, visao, atacante, defensor);
+}
+
+/**
+ * Libera o controlador de fibra e o controlador real
+ * 
+ * @param controlador Controlador com DadosJogadorFibra
+ */
+static void liberarControladorFibra(ControladorJogador* controlador) {
+    DadosJogadorFibra* dados = (DadosJogadorFibra*)controlador->dados;
+    if (dados != NULL && dados->interno != NULL) {
+        dados->interno->liberar(dados->interno);
+    }
+    free(dados);
+    free(controlador);
+}
+
+/**
+ * Ponto de entrada das fibras
+ * 
+ * makecontext só repassa argumentos int, então o ponteiro da fibra
+ * chega dividido em duas metades de 32 bits. Ao retornar, uc_link
+ * devolve a thread ao escalonador.
+ * 
+ * @param alto 32 bits mais altos do ponteiro da Fibra
+ * @param baixo 32 bits mais baixos do ponteiro da Fibra
+ */
+static void iniciarFibra(unsigned int alto, unsigned int baixo) {
+    Fibra* fibra = (Fibra*)(uintptr_t)(((uint64_t)alto << 32) | baixo);
+    fibra->vencedor = jogarPartidaContexto(&fibra->jogo, ROLLOUT_MAX_TURNOS, &fibra->duracao);
+    fibra->concluida = true;
+}
+
+/**
+ * Prepara a partida e a corrotina de uma fibra
+ * 
+ * @param escalonador Escalonador dono da fibra
+ * @param fibra Fibra a preparar
+ * @param pilha Início (endereço mais baixo) da pilha da fibra
+ * @param tarefa Parâmetros comuns
+ * @param jogo Número da partida (define as sementes)
+ * @return true se a partida e os controladores foram criados
+ */
+static bool prepararFibra(EscalonadorFibras* escalonador, Fibra* fibra, uint64_t* pilha,
+                          const TarefaFibras* tarefa, long jogo) {
+    const OpcoesSimulacao* opcoes = tarefa->opcoes;
+    uint64_t semente = (opcoes->semente + (uint64_t)jogo) * 3;
+    
+    fibra->escalonador = escalonador;
+    fibra->pilha = pilha;
+    fibra->pilha[0] = FIBRA_SENTINELA;
+    inicializarGerador(&fibra->pensar, semente ^ 0xF1B4ULL);
+    if (!criarContextoJogo(&fibra->jogo, opcoes->numJogadores, opcoes->numTerritorios, semente,
+                           &regrasPadrao, saidaSilenciosa)) {
+        return false;
+    }
+    
+    for (int j = 0; j < opcoes->numJogadores; j++) {
+        ControladorJogador* controlador = (ControladorJogador*)calloc(1, sizeof(ControladorJogador));
+        DadosJogadorFibra* dados = (DadosJogadorFibra*)calloc(1, sizeof(DadosJogadorFibra));
+        if (controlador == NULL || dados == NULL) {
+            free(controlador);
+            free(dados);
+            return false;
+        }
+        controlador->nome = "jogador em fibra";
+        controlador->decidirAtaque = decidirAtaqueFibra;
+        controlador->liberar = liberarControladorFibra;
+        controlador->dados = dados;
+        dados->fibra = fibra;
+        dados->pensarNs = tarefa->pensarNs;
+        fibra->jogo.jogadores[j].controlador = controlador;
+        dados->interno = criarControlador(tarefa->politica, semente + 1 + (uint64_t)j);
+        if (dados->interno == NULL) {
+            return false;
+        }
+        definirRegrasControlador(dados->interno, fibra->jogo.regras);
+    }
+    
+    uintptr_t endereco = (uintptr_t)fibra;
+    getcontext(&fibra->contexto);
+    fibra->contexto.uc_stack.ss_sp = pilha;
+    fibra->contexto.uc_stack.ss_size = FIBRA_PILHA;
+    fibra->contexto.uc_link = &escalonador->contexto;
+    makecontext(&fibra->contexto, (void (*)(void))iniciarFibra, 2,
+                (unsigned int)((uint64_t)endereco >> 32), (unsigned int)(endereco & 0xFFFFFFFFu));
+    enfileirarFibraPronta(escalonador, fibra);
+    return true;
+}
+
+/**
+ * Corpo de uma thread de escalonamento
+ * 
+ * Cria todas as suas fibras (partidas indice, indice + T, ...) e as
+ * executa até o fim: retoma as prontas, acorda as que terminaram de
+ * esperar e dorme até a próxima decisão quando nenhuma está pronta.
+ * 
+ * @param argumento Ponteiro para o EscalonadorFibras
+ * @return NULL
+ */
+static void* executarEscalonadorFibras(void* argumento) {
+    EscalonadorFibras* escalonador = (EscalonadorFibras*)argumento;
+    TarefaFibras* tarefa = escalonador->tarefa;
+    int concluidas = 0;
+    
+    for (int i = 0; i < escalonador->numFibras; i++) {
+        uint64_t* pilha = (uint64_t*)(escalonador->pilhas + (size_t)i * escalonador->passo + escalonador->guarda);
+        if (!prepararFibra(escalonador, &escalonador->fibras[i], pilha, tarefa,
+                           escalonador->indice + (long)i * tarefa->numThreads)) {
+            escalonador->erro = true;
+            escalonador->numFibras = i + 1; // Libera até a que falhou
+            atomic_fetch_sub(&tarefa->ativos, 1);
+            return NULL;
+        }
+    }
+    
+    while (concluidas < escalonador->numFibras) {
+        long agora = instanteNs();
+        while (escalonador->numDormindo > 0 && escalonador->dormindo[0]->acordarNs <= agora) {
+            enfileirarFibraPronta(escalonador, retirarFibraDormindo(escalonador));
+        }
+        
+        Fibra* fibra = escalonador->primeiraPronta;
+        if (fibra == NULL) {
+            long espera = escalonador->dormindo[0]->acordarNs - agora;
+            struct timespec pausa = {espera / 1000000000L, espera % 1000000000L};
+            nanosleep(&pausa, NULL);
+            continue;
+        }
+        escalonador->primeiraPronta = fibra->proxima;
+        if (escalonador->primeiraPronta == NULL) {
+            escalonador->ultimaPronta = NULL;
+        }
+        
+        swapcontext(&escalonador->contexto, &fibra->contexto);
+        escalonador->trocas++;
+        // Estouro da pilha fixa é detectado aqui em vez de passar despercebido
+        if (fibra->pilha[0] != FIBRA_SENTINELA) {
+            escalonador->estouro = true;
+        }
+        if (fibra->concluida) {
+            if (fibra->vencedor >= 0) escalonador->vitorias[fibra->vencedor]++;
+            escalonador->turnos += fibra->duracao;
+            liberarContextoJogo(&fibra->jogo);
+            concluidas++;
+        }
+    }
+    atomic_fetch_sub(&tarefa->ativos, 1);
+    return NULL;
+}
+
+/**
+ * Hospeda --jogos partidas simultâneas em fibras sobre poucas threads
+ * 
+ * Cada partida do motor completo é uma corrotina com pilha fixa de
+ * FIBRA_PILHA bytes (com uma página de guarda abaixo) que cede a
+ * thread a cada decisão de jogador; a
+ * decisão fica pronta após uma espera sorteada de até pensarMs
+ * (simulando um humano) e então o bot TIPO escolhe o ataque. As
+ * partidas são distribuídas entre as threads (M:N) e não migram.
+ * 
+ * @param politica Bot que decide por todos os jogadores
+ * @param opcoes Partidas simultâneas, jogadores, territórios e semente
+ * @param pensarMs Espera máxima por decisão (0 = apenas ceder a vez)
+ * @param numThreads Threads de escalonamento
+ */
+void executarFibras(const char* politica, const OpcoesSimulacao* opcoes, long pensarMs, int numThreads) {
+    static EscalonadorFibras escalonadores[MAX_THREADS];
+    TarefaFibras tarefa = {politica, opcoes, pensarMs * 1000000L, 0, 0};
+    ControladorJogador* teste = criarControlador(politica, 0);
+    
+    if (teste == NULL) {
+        return;
+    }
+    // Bots com busca profunda ou threads próprias não cabem na pilha fixa
+    bool leve = !controladorEhHumano(teste) && (strcmp(politica, "aleatorio") == 0 ||
+                strcmp(politica, "estrategista") == 0 || strncmp(politica, "heuristico", 10) == 0);
+    teste->liberar(teste);
+    if (!leve) {
+        printf("❌ Erro: Fibras aceitam apenas aleatorio, estrategista ou heuristico\n");
+        return;
+    }
+    
+    if (numThreads > MAX_THREADS) numThreads = MAX_THREADS;
+    if (numThreads > opcoes->numJogos) numThreads = (int)opcoes->numJogos;
+    tarefa.numThreads = numThreads;
+    
+    printf("\n🧶 ═══════════════════════════════════════════════════════════\n");
+    printf("              PARTIDAS INTERATIVAS EM FIBRAS\n");
+    printf("═══════════════════════════════════════════════════════════🧶\n");
+    printf("🤖 Política: %s | %ld partidas simultâneas | %d threads | pilha %d KB | decisão em até %ld ms\n",
+           politica, opcoes->numJogos, numThreads, FIBRA_PILHA / 1024, pensarMs);
+    
+    long memoriaInicial = memoriaResidenteKB();
+    size_t guarda = (size_t)sysconf(_SC_PAGESIZE);
+    size_t passo = guarda + (FIBRA_PILHA + guarda - 1) / guarda * guarda;
+    bool falhou = false;
+    int iniciadas = 0;
+    for (int t = 0; t < numThreads; t++) {
+        EscalonadorFibras* escalonador = &escalonadores[t];
+        memset(escalonador, 0, sizeof(*escalonador));
+        escalonador->numFibras = (int)((opcoes->numJogos - t + numThreads - 1) / numThreads);
+        escalonador->guarda = guarda;
+        escalonador->passo = passo;
+        escalonador->tamanhoPilhas = (size_t)escalonador->numFibras * passo;
+        escalonador->fibras = (Fibra*)calloc(escalonador->numFibras, sizeof(Fibra));
+        escalonador->dormindo = (Fibra**)calloc(escalonador->numFibras, sizeof(Fibra*));
+        // Pilhas reservadas sem compromisso: só as páginas tocadas ocupam memória
+        void* pilhas = mmap(NULL, escalonador->tamanhoPilhas, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        escalonador->pilhas = (pilhas == MAP_FAILED) ? NULL : (char*)pilhas;
+        // Página de guarda abaixo de cada pilha (as pilhas crescem para baixo);
+        // cada guarda separa a região em mais áreas (limite vm.max_map_count)
+        for (int i = 0; escalonador->pilhas != NULL && i < escalonador->numFibras; i++) {
+            if (mprotect(escalonador->pilhas + (size_t)i * passo, guarda, PROT_NONE) != 0) {
+                munmap(escalonador->pilhas, escalonador->tamanhoPilhas);
+                escalonador->pilhas = NULL;
+            }
+        }
+        if (escalonador->fibras == NULL || escalonador->dormindo == NULL || escalonador->pilhas == NULL) {
+            escalonador->numFibras = 0;
+            falhou = true;
+            break;
+        }
+        
+        escalonador->tarefa = &tarefa;
+        escalonador->indice = t;
+        atomic_fetch_add(&tarefa.ativos, 1);
+        if (pthread_create(&escalonador->thread, NULL, executarEscalonadorFibras, escalonador) != 0) {
+            atomic_fetch_sub(&tarefa.ativos, 1);
+            falhou = true;
+            break;
+        }
+        iniciadas++;
+    }
+    
+    // Pico da memória residente, medido enquanto as partidas estão vivas
+    long inicio = instanteNs();
+    long memoriaPico = memoriaInicial;
+    struct timespec amostragem = {0, 20000000L};
+    while (atomic_load(&tarefa.ativos) > 0) {
+        long memoria = memoriaResidenteKB();
+        if (memoria > memoriaPico) memoriaPico = memoria;
+        nanosleep(&amostragem, NULL);
+    }
+    
+    long vitorias[MAX_JOGADORES] = {0};
+    long turnos = 0, decisoes = 0, trocas = 0, maxDormindo = 0;
+    bool estouro = false;
+    for (int t = 0; t < iniciadas; t++) {
+        EscalonadorFibras* escalonador = &escalonadores[t];
+        pthread_join(escalonador->thread, NULL);
+        falhou = falhou || escalonador->erro;
+        estouro = estouro || escalonador->estouro;
+        for (int j = 0; j < opcoes->numJogadores; j++) vitorias[j] += escalonador->vitorias[j];
+        turnos += escalonador->turnos;
+        decisoes += escalonador->decisoes;
+        trocas += escalonador->trocas;
+        maxDormindo += escalonador->maxDormindo;
+    }
+    double segundos = (instanteNs() - inicio) / 1e9;
+    
+    for (int t = 0; t < numThreads; t++) {
+        EscalonadorFibras* escalonador = &escalonadores[t];
+        if (escalonador->erro) {
+            for (int i = 0; i < escalonador->numFibras; i++) liberarContextoJogo(&escalonador->fibras[i].jogo);
+        }
+        if (escalonador->pilhas != NULL) munmap(escalonador->pilhas, escalonador->tamanhoPilhas);
+        free(escalonador->fibras);
+        free(escalonador->dormindo);
+    }
+    
+    if (falhou) {
+        printf("❌ Erro: Falha ao criar as partidas em fibras!\n");
+        return;
+    }
+    if (estouro) {
+        printf("⚠️  Aviso: Alguma fibra ultrapassou a pilha de %d KB!\n", FIBRA_PILHA / 1024);
+    }
+    printf("⏱️  %.2f s | %ld decisões (%.0f/s) | %ld trocas de contexto | até %ld partidas esperando\n",
+           segundos, decisoes, decisoes / (segundos > 0 ? segundos : 1e-9), trocas, maxDormindo);
+    printf("💾 Memória residente: %ld KB → pico %ld KB (%.1f KB por partida)\n",
+           memoriaInicial, memoriaPico, (double)(memoriaPico - memoriaInicial) / opcoes->numJogos);
+    printf("🏆 Turnos: %ld | vitórias por posição:", turnos);
+    for (int j = 0; j < opcoes->numJogadores; j++) {
+        printf(" %ld", vitorias[j]);
+    }
+    printf("\n");
+}
+
+// ============================================================================
+// IMPLEMENTAÇÃO DAS FUNÇÕES - SERVIDOR DE PARTIDAS (SOCKET UNIX + EPOLL/IO_URING)
+// ============================================================================
+
+/*
+ * Protocolo binário (ordem de bytes da máquina: cliente e servidor
+ * estão sempre no mesmo computador):
+ *   quadro        uint16 tamanho | uint8 tipo | carga (tamanho - 1 bytes)
+ *   NOVA_PARTIDA  C→S  uint64 semente, uint8 jogadores, uint8 territórios
+ *   ATAQUE        C→S  uint8 atacante, uint8 defensor (PROTO_SEM_ATAQUE passa)
+ *   ESTADO        S→C  int8 resultado da última batalha, uint8 jogador da vez,
+ *                      uint8 jogadores, uint8 territórios, uint8 missão[jogadores],
+ *                      uint8 ativos (um bit por jogador), uint8 dono[territórios],
+ *                      uint16 tropas[territórios]
+ *   FIM           S→C  int8 vencedor (-1 sem vencedor), uint16 turnos
+ *   ERRO          S→C  uint8 tipo do quadro recusado
+ * Cada NOVA_PARTIDA ou ATAQUE recebe exatamente uma resposta.
+ */
+
+/*
+ * Struct: RegistroDiario
+ * 
+ * Registro de 16 bytes do diário do servidor, um por comando aceito
+ * (NOVA_PARTIDA ou ATAQUE), na ordem em que as respostas saem.
+ */
+typedef struct {
+    uint32_t ordem;
+    uint32_t conexao;           // Vaga da conexão no servidor
+    uint16_t turno;
+    uint8_t tipo;
+    uint8_t atacante;
+    uint8_t defensor;
+    int8_t resultado;           // BATALHA_* do ataque
+    uint16_t reservado;
+} RegistroDiario;
+
+/*
+ * Struct: ConexaoServidor
+ *
+ * Um cliente e a partida que ele joga. Enquanto ocupada, a conexão
+ * pertence a um trabalhador, que processa o comando e escreve a
+ * resposta; o laço de eventos só volta a mexer nela quando o
+ * trabalhador a devolve. Os bytes de entrada e saída ficam fora da
+ * vaga, em BuffersConexao, para que só eles sejam registrados como
+ * buffer fixo no backend io_uring.
+ * - entrada: bytes recebidos ainda não processados (só o laço acessa)
+ * - saida: resposta pendente de envio
+ * - fechar: cliente saiu ou violou o protocolo; fecha quando livre
+ * - recebidoNs: instante em que o comando atual ficou completo
+ */
+typedef struct ConexaoServidor {
+    int fd;
+    bool ativa;
+    EstadoSimulacao estado;
+    GeradorAleatorio dados;
+    int turno;
+    bool emPartida;
+    uint8_t* entrada;
+    size_t usadoEntrada;
+    uint8_t* saida;
+    size_t usadoSaida;
+    size_t enviadoSaida;
+    int tipoComando;
+    uint8_t comando[PROTO_MAX_QUADRO];
+    size_t tamanhoComando;
+    RegistroDiario registro;
+    bool temRegistro;
+    long recebidoNs;
+    bool ocupada;
+    bool fechar;
+    bool removida;
+    bool aguardandoEscrita;
+    struct ConexaoServidor* proxima;    // Fila de comandos, de respostas ou de vagas livres
+} ConexaoServidor;
+
+/*
+ * Struct: BuffersConexao
+ *
+ * Bytes de entrada e de saída de uma vaga de conexão. O array de
+ * buffers é o único trecho das vagas registrado no io_uring: cerca de
+ * 2,6 MB com SERVIDOR_MAX_CONEXOES vagas, abaixo do limite padrão de
+ * memória travada (8 MB), que o registro consome.
+ */
+typedef struct {
+    uint8_t entrada[SERVIDOR_BUFFER];
+    uint8_t saida[SERVIDOR_SAIDA];
+} BuffersConexao;
+
+/*
+ * Struct: FilaConexoes
+ *
+ * Fila intrusiva de conexões entre o laço de eventos e os trabalhadores.
+ */
+typedef struct {
+    pthread_mutex_t trava;
+    pthread_cond_t sinal;
+    ConexaoServidor* primeira;
+    ConexaoServidor* ultima;
+} FilaConexoes;
+
+/*
+ * Struct: AnelUring
+ * 
+ * Filas de submissão e de conclusão do io_uring mapeadas do kernel,
+ * usadas sem liburing (chamadas de sistema diretas).
+ * - aSubmeter: entradas preenchidas ainda não entregues ao kernel
+ */
+typedef struct {
+    int fd;
+    unsigned entradas;
+    unsigned* sqCabeca;
+    unsigned* sqCauda;
+    unsigned sqMascara;
+    unsigned* sqIndices;
+    struct io_uring_sqe* sqes;
+    unsigned* cqCabeca;
+    unsigned* cqCauda;
+    unsigned cqMascara;
+    struct io_uring_cqe* cqes;
+    void* mapaSq;
+    size_t tamanhoMapaSq;
+    void* mapaCq;
+    size_t tamanhoMapaCq;
+    size_t tamanhoSqes;
+    unsigned aSubmeter;
+} AnelUring;
+
+/*
+ * Struct: DiarioServidor
+ * 
+ * Diário dos comandos em dois buffers alternados: enquanto um é
+ * gravado (de forma assíncrona no io_uring), o laço enche o outro.
+ * Cada buffer recebe seu deslocamento no arquivo ao ser selado, então
+ * gravações concluídas fora de ordem não embaralham o diário.
+ */
+typedef struct {
+    int fd;                     // -1 sem diário
+    RegistroDiario* buffers[2];
+    int atual;
+    size_t usados;
+    off_t deslocamento;
+    bool emVoo;
+    size_t tamanhoEmVoo;
+    uint32_t ordem;
+    bool erro;
+} DiarioServidor;
+
+/*
+ * Struct: ServidorPartidas
+ *
+ * Laço de eventos (thread principal) e trabalhadores que resolvem os
+ * turnos. O aviso é um eventfd pelo qual os trabalhadores acordam o
+ * laço quando há respostas prontas. O laço roda sobre epoll ou sobre
+ * io_uring; o resto do servidor é comum aos dois.
+ * - chamadas: chamadas de sistema feitas pelo laço de eventos
+ * - anelTravado: a fila de submissão do io_uring não andou; o laço encerra
+ * - escutaSuspensa: accept sem descritores ou memória; a escuta sai do
+ *   epoll até uma conexão fechar ou passar SERVIDOR_PAUSA_ACEITE_MS (no
+ *   io_uring, o accept volta após um IORING_OP_TIMEOUT de mesma duração)
+ */
+typedef struct {
+    bool usaUring;
+    int epoll;
+    AnelUring anel;
+    int escuta;
+    int aviso;
+    int sinal;
+    uint64_t leituraAviso;          // Destinos das leituras do io_uring
+    struct signalfd_siginfo leituraSinal;
+    FilaConexoes pendentes;
+    FilaConexoes concluidas;
+    bool encerrar;                  // Protegido pela trava de pendentes
+    pthread_t trabalhadores[MAX_THREADS];
+    int numTrabalhadores;
+    ConexaoServidor* conexoes;
+    BuffersConexao* buffers;        // Um por vaga; buffer fixo 0 do io_uring
+    ConexaoServidor* livres;
+    long conexoesAtivas;
+    long maxConexoes;
+    DiarioServidor diario;
+    HistogramaLatencia latencias;   // Do comando completo à resposta pronta para envio
+    long chamadas;
+    bool anelTravado;
+    bool escutaSuspensa;
+    long ativasNaPausa;             // conexoesAtivas ao suspender a escuta
+    struct __kernel_timespec pausaAceite;  // Duração do IORING_OP_TIMEOUT da pausa
+    atomic_long chamadasTrabalhadores;
+    atomic_long partidas;
+    atomic_long turnos;
+    atomic_long comandos;
+} ServidorPartidas;
+
+/**
+ * Monta um quadro do protocolo
+ * 
+ * @param destino Buffer com espaço para tamanho + 3 bytes
+ * @param tipo Tipo do quadro (PROTO_*)
+ * @param carga Bytes da carga
+ * @param tamanho Tamanho da carga (até PROTO_MAX_QUADRO - 1)
+ * @return Bytes escritos em destino
+ */
+size_t montarQuadro(uint8_t* destino, int tipo, const uint8_t* carga, size_t tamanho) {
+    uint16_t comprimento = (uint16_t)(tamanho + 1);
+    memcpy(destino, &comprimento, sizeof(comprimento));
+    destino[2] = (uint8_t)tipo;
+    memcpy(destino + 3, carga, tamanho);
+    return tamanho + 3;
+}
+
+/**
+ * Retira o primeiro quadro completo de um buffer de entrada
+ * 
+ * @param buffer Bytes recebidos (os restantes são movidos para o início)
+ * @param usado Bytes válidos no buffer (atualizado)
+ * @param tipo Saída com o tipo do quadro
+ * @param carga Saída com a carga (PROTO_MAX_QUADRO bytes)
+ * @param tamanho Saída com o tamanho da carga
+ * @return 1 se um quadro foi retirado, 0 se incompleto, -1 se malformado
+ */
+int extrairQuadro(uint8_t* buffer, size_t* usado, int* tipo, uint8_t* carga, size_t* tamanho) {
+    uint16_t comprimento;
+    if (*usado < sizeof(comprimento)) {
+        return 0;
+    }
+    memcpy(&comprimento, buffer, sizeof(comprimento));
+    if (comprimento < 1 || comprimento > PROTO_MAX_QUADRO) {
+        return -1;
+    }
+    if (*usado < sizeof(comprimento) + comprimento) {
+        return 0;
+    }
+    
+    *tipo = buffer[2];
+    *tamanho = comprimento - 1u;
+    memcpy(carga, buffer + 3, *tamanho);
+    *usado -= sizeof(comprimento) + comprimento;
+    memmove(buffer, buffer + sizeof(comprimento) + comprimento, *usado);
+    return 1;
+}
+
+/**
+ * Codifica o estado compacto na carga de um quadro ESTADO
+ * 
+ * @param destino Carga de saída (PROTO_MAX_QUADRO bytes)
+ * @param estado Estado da partida
+ * @param resultado Resultado da última batalha (BATALHA_*)
+ * @return Tamanho da carga
+ */
+size_t codificarEstadoProtocolo(uint8_t* destino, const EstadoSimulacao* estado, int resultado) {
+    size_t n = 0;
+    uint8_t ativos = 0;
+    
+    destino[n++] = (uint8_t)(int8_t)resultado;
+    destino[n++] = (uint8_t)estado->jogadorDaVez;
+    destino[n++] = (uint8_t)estado->numJogadores;
+    destino[n++] = (uint8_t)estado->numTerritorios;
+    for (int j = 0; j < estado->numJogadores; j++) {
+        destino[n++] = (uint8_t)estado->missao[j];
+        if (estado->ativo[j]) ativos |= (uint8_t)(1u << j);
+    }
+    destino[n++] = ativos;
+    for (int i = 0; i < estado->numTerritorios; i++) {
+        destino[n++] = (uint8_t)estado->dono[i];
+    }
+    for (int i = 0; i < estado->numTerritorios; i++) {
+        uint16_t tropas = (uint16_t)estado->tropas[i];
+        memcpy(destino + n, &tropas, sizeof(tropas));
+        n += sizeof(tropas);
+    }
+    return n;
+}
+
+/**
+ * Reconstrói o estado compacto (com hash) a partir de um quadro ESTADO
+ * 
+ * @param carga Carga recebida
+ * @param tamanho Tamanho da carga
+ * @param estado Saída com o estado
+ * @param resultado Saída com o resultado da última batalha
+ * @return false se a carga for inconsistente
+ */
+bool decodificarEstadoProtocolo(const uint8_t* carga, size_t tamanho, EstadoSimulacao* estado, int* resultado) {
+    if (tamanho < 4) {
+        return false;
+    }
+    int numJogadores = carga[2];
+    int numTerritorios = carga[3];
+    if (numJogadores < MIN_JOGADORES || numJogadores > MAX_JOGADORES ||
+        numTerritorios < 1 || numTerritorios > MAX_TERRITORIOS ||
+        tamanho != 4 + (size_t)numJogadores + 1 + 3 * (size_t)numTerritorios || carga[1] >= numJogadores) {
+        return false;
+    }
+    
+    memset(estado, 0, sizeof(*estado));
+    *resultado = (int8_t)carga[0];
+    estado->jogadorDaVez = carga[1];
+    estado->numJogadores = numJogadores;
+    estado->numTerritorios = numTerritorios;
+    size_t n = 4;
+    for (int j = 0; j < numJogadores; j++) {
+        estado->missao[j] = (int8_t)carga[n++];
+    }
+    for (int j = 0; j < numJogadores; j++) {
+        estado->ativo[j] = (carga[n] >> j) & 1u;
+    }
+    n++;
+    for (int i = 0; i < numTerritorios; i++) {
+        estado->dono[i] = (int8_t)carga[n++];
+    }
+    for (int i = 0; i < numTerritorios; i++) {
+        uint16_t tropas;
+        memcpy(&tropas, carga + n, sizeof(tropas));
+        estado->tropas[i] = tropas;
+        n += sizeof(tropas);
+    }
+    estado->hash = calcularHashEstado(estado);
+    return true;
+}
+
+/**
+ * Coloca uma conexão no fim de uma fila
+ * 
+ * @param fila Fila de destino
+ * @param conexao Conexão a enfileirar
+ * @return true se a fila estava vazia
+ */
+static bool enfileirarConexao(FilaConexoes* fila, ConexaoServidor* conexao) {
+    bool vazia;
+    conexao->proxima = NULL;
+    pthread_mutex_lock(&fila->trava);
+    vazia = (fila->primeira == NULL);
+    if (fila->ultima != NULL) {
+        fila->ultima->proxima = conexao;
+    } else {
+        fila->primeira = conexao;
+    }
+    fila->ultima = conexao;
+    pthread_cond_signal(&fila->sinal);
+    pthread_mutex_unlock(&fila->trava);
+    return vazia;
+}
+
+/**
+ * Acrescenta um quadro de resposta à saída da conexão
+ * 
+ * @param conexao Conexão (pertencente ao chamador)
+ * @param tipo Tipo do quadro
+ * @param carga Carga
+ * @param tamanho Tamanho da carga
+ */
+static void responderConexao(ConexaoServidor* conexao, int tipo, const uint8_t* carga, size_t tamanho) {
+    conexao->usadoSaida += montarQuadro(conexao->saida + conexao->usadoSaida, tipo, carga, tamanho);
+}
+
+/**
+ * Responde com o estado atual ou, se a partida acabou, com o resultado
+ * 
+ * Mesmo encerramento de jogarPartidaControladores: vencedor pelas
+ * missões ou limite de ROLLOUT_MAX_TURNOS turnos.
+ * 
+ * @param servidor Servidor
+ * @param conexao Conexão em partida
+ * @param resultado Resultado da última batalha
+ */
+static void responderEstadoServidor(ServidorPartidas* servidor, ConexaoServidor* conexao, int resultado) {
+    uint8_t carga[PROTO_MAX_QUADRO];
+    int vencedor = verificarVencedorEstado(&conexao->estado, &regrasPadrao);
+    
+    if (vencedor != -1 || conexao->turno >= ROLLOUT_MAX_TURNOS) {
+        uint16_t turnos = (uint16_t)conexao->turno;
+        carga[0] = (uint8_t)(int8_t)vencedor;
+        memcpy(carga + 1, &turnos, sizeof(turnos));
+        responderConexao(conexao, PROTO_FIM, carga, 1 + sizeof(turnos));
+        conexao->emPartida = false;
+        atomic_fetch_add_explicit(&servidor->partidas, 1, memory_order_relaxed);
+    } else {
+        responderConexao(conexao, PROTO_ESTADO, carga,
+                         codificarEstadoProtocolo(carga, &conexao->estado, resultado));
+    }
+}
+
+/**
+ * Executa o comando de uma conexão (em um trabalhador)
+ * 
+ * @param servidor Servidor
+ * @param conexao Conexão ocupada com o comando a executar
+ */
+static void processarComandoServidor(ServidorPartidas* servidor, ConexaoServidor* conexao) {
+    const uint8_t* comando = conexao->comando;
+    RegistroDiario* registro = &conexao->registro;
+    uint8_t recusado = (uint8_t)conexao->tipoComando;
+    
+    atomic_fetch_add_explicit(&servidor->comandos, 1, memory_order_relaxed);
+    memset(registro, 0, sizeof(*registro));
+    registro->tipo = (uint8_t)conexao->tipoComando;
+    conexao->temRegistro = true;
+    
+    if (conexao->tipoComando == PROTO_NOVA_PARTIDA && conexao->tamanhoComando == sizeof(uint64_t) + 2) {
+        uint64_t semente;
+        memcpy(&semente, comando, sizeof(semente));
+        int numJogadores = comando[8];
+        int numTerritorios = comando[9];
+        if (numJogadores >= MIN_JOGADORES && numJogadores <= MAX_JOGADORES &&
+            numTerritorios >= MIN_TERRITORIOS && numTerritorios <= MAX_TERRITORIOS &&
+            numTerritorios >= numJogadores) {
+            // Mesmas sementes das demais simulações: preparo em *3, dados em *3 + 1
+            GeradorAleatorio preparo;
+            inicializarGerador(&preparo, semente * 3);
+            inicializarGerador(&conexao->dados, semente * 3 + 1);
+            gerarPartidaAleatoria(&conexao->estado, &regrasPadrao, numJogadores, numTerritorios, &preparo);
+            conexao->turno = 0;
+            conexao->emPartida = true;
+            registro->resultado = BATALHA_INVALIDA;
+            responderEstadoServidor(servidor, conexao, BATALHA_INVALIDA);
+            return;
+        }
+    } else if (conexao->tipoComando == PROTO_ATAQUE && conexao->tamanhoComando == 2 && conexao->emPartida) {
+        EstadoSimulacao* estado = &conexao->estado;
+        int atacante = comando[0];
+        int defensor = comando[1];
+        int resultado = BATALHA_INVALIDA;
+        if (atacante < estado->numTerritorios && defensor < estado->numTerritorios &&
+            estado->dono[atacante] == estado->jogadorDaVez && estado->dono[defensor] != estado->jogadorDaVez) {
+            resultado = resolverBatalhaEstado(estado, &regrasPadrao, atacante, defensor, &conexao->dados);
+        }
+        registro->turno = (uint16_t)conexao->turno;
+        registro->atacante = (uint8_t)atacante;
+        registro->defensor = (uint8_t)defensor;
+        registro->resultado = (int8_t)resultado;
+        avancarJogadorDaVez(estado);
+        conexao->turno++;
+        atomic_fetch_add_explicit(&servidor->turnos, 1, memory_order_relaxed);
+        responderEstadoServidor(servidor, conexao, resultado);
+        return;
+    }
+    conexao->temRegistro = false;
+    responderConexao(conexao, PROTO_ERRO, &recusado, 1);
+}
+
+/**
+ * Corpo dos trabalhadores do servidor
+ * 
+ * O aviso ao laço só é escrito quando a fila de respostas estava
+ * vazia: com ela cheia, o laço já foi ou será acordado.
+ * 
+ * @param argumento Ponteiro para o ServidorPartidas
+ * @return NULL
+ */
+static void* executarTrabalhadorServidor(void* argumento) {
+    ServidorPartidas* servidor = (ServidorPartidas*)argumento;
+    FilaConexoes* pendentes = &servidor->pendentes;
+    
+    for (;;) {
+        pthread_mutex_lock(&pendentes->trava);
+        while (pendentes->primeira == NULL && !servidor->encerrar) {
+            pthread_cond_wait(&pendentes->sinal, &pendentes->trava);
+        }
+        ConexaoServidor* conexao = pendentes->primeira;
+        if (conexao == NULL) {
+            pthread_mutex_unlock(&pendentes->trava);
+            break;
+        }
+        pendentes->primeira = conexao->proxima;
+        if (pendentes->primeira == NULL) {
+            pendentes->ultima = NULL;
+        }
+        pthread_mutex_unlock(&pendentes->trava);
+        
+        processarComandoServidor(servidor, conexao);
+        if (enfileirarConexao(&servidor->concluidas, conexao)) {
+            uint64_t um = 1;
+            atomic_fetch_add_explicit(&servidor->chamadasTrabalhadores, 1, memory_order_relaxed);
+            if (write(servidor->aviso, &um, sizeof(um)) < 0) {
+                // Contador do eventfd saturado: o laço já vai acordar
+            }
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Grava um buffer do diário de forma síncrona
+ * 
+ * @param servidor Servidor
+ * @param buffer Registros a gravar
+ * @param tamanho Bytes a gravar
+ * @param deslocamento Posição no arquivo
+ */
+static void gravarDiarioSincrono(ServidorPartidas* servidor, const void* buffer, size_t tamanho, off_t deslocamento) {
+    size_t gravado = 0;
+    while (gravado < tamanho) {
+        ssize_t n = pwrite(servidor->diario.fd, (const char*)buffer + gravado, tamanho - gravado,
+                           deslocamento + (off_t)gravado);
+        servidor->chamadas++;
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            servidor->diario.erro = true;
+            return;
+        }
+        gravado += (size_t)n;
+    }
+}
+
+/**
+ * Obtém uma entrada livre na fila de submissão do io_uring
+ * 
+ * Sem SQPOLL o kernel só lê a fila dentro de io_uring_enter, então a
+ * cauda pode avançar antes de o chamador preencher a entrada.
+ * 
+ * @param servidor Servidor com backend io_uring
+ * @return Entrada zerada, já contada para a próxima submissão
+ */
+static struct io_uring_sqe* obterEntradaUring(ServidorPartidas* servidor);
+
+/**
+ * Sela o buffer atual do diário e o envia para gravação
+ * 
+ * No io_uring a gravação é assíncrona (WRITE_FIXED do buffer
+ * registrado), salvo quando o outro buffer ainda está em voo; no epoll
+ * é um pwrite por volta do laço, com todos os registros acumulados.
+ * 
+ * @param servidor Servidor
+ */
+static void selarDiario(ServidorPartidas* servidor) {
+    DiarioServidor* diario = &servidor->diario;
+    if (diario->fd < 0 || diario->usados == 0) {
+        return;
+    }
+    size_t tamanho = diario->usados * sizeof(RegistroDiario);
+    off_t deslocamento = diario->deslocamento;
+    diario->deslocamento += (off_t)tamanho;
+    
+    struct io_uring_sqe* entrada = NULL;
+    if (servidor->usaUring && !diario->emVoo) {
+        entrada = obterEntradaUring(servidor);
+    }
+    if (entrada != NULL) {
+        entrada->opcode = IORING_OP_WRITE_FIXED;
+        entrada->fd = diario->fd;
+        entrada->addr = (uintptr_t)diario->buffers[diario->atual];
+        entrada->len = (unsigned)tamanho;
+        entrada->off = (uint64_t)deslocamento;
+        entrada->buf_index = (uint16_t)(1 + diario->atual);
+        entrada->user_data = URING_DIARIO;
+        diario->emVoo = true;
+        diario->tamanhoEmVoo = tamanho;
+        diario->atual ^= 1;
+    } else {
+        gravarDiarioSincrono(servidor, diario->buffers[diario->atual], tamanho, deslocamento);
+    }
+    diario->usados = 0;
+}
+
+/**
+ * Fecha o comando devolvido por um trabalhador: diário e latência
+ * 
+ * @param servidor Servidor
+ * @param conexao Conexão recém-devolvida
+ */
+static void concluirComandoServidor(ServidorPartidas* servidor, ConexaoServidor* conexao) {
+    DiarioServidor* diario = &servidor->diario;
+    conexao->ocupada = false;
+    registrarLatencia(&servidor->latencias, instanteNs() - conexao->recebidoNs);
+    
+    if (diario->fd >= 0 && conexao->temRegistro) {
+        if (diario->usados == DIARIO_REGISTROS) {
+            selarDiario(servidor);
+        }
+        RegistroDiario* registro = &diario->buffers[diario->atual][diario->usados++];
+        *registro = conexao->registro;
+        registro->ordem = diario->ordem++;
+        registro->conexao = (uint32_t)(conexao - servidor->conexoes);
+    }
+}
+
+/**
+ * Ocupa uma vaga para uma conexão recém-aceita
+ * 
+ * @param servidor Servidor
+ * @param fd Socket aceito
+ * @return Conexão, ou NULL (socket fechado) se não há vagas
+ */
+static ConexaoServidor* registrarConexaoServidor(ServidorPartidas* servidor, int fd) {
+    ConexaoServidor* conexao = servidor->livres;
+    if (conexao == NULL) {
+        close(fd);
+        servidor->chamadas++;
+        return NULL;
+    }
+    servidor->livres = conexao->proxima;
+    memset(conexao, 0, sizeof(*conexao));
+    conexao->entrada = servidor->buffers[conexao - servidor->conexoes].entrada;
+    conexao->saida = servidor->buffers[conexao - servidor->conexoes].saida;
+    conexao->fd = fd;
+    conexao->ativa = true;
+    if (++servidor->conexoesAtivas > servidor->maxConexoes) {
+        servidor->maxConexoes = servidor->conexoesAtivas;
+    }
+    return conexao;
+}
+
+/**
+ * Fecha o socket e devolve a vaga de uma conexão que não está com um
+ * trabalhador nem tem operações pendentes
+ * 
+ * @param servidor Servidor
+ * @param conexao Conexão a liberar
+ */
+static void liberarConexaoServidor(ServidorPartidas* servidor, ConexaoServidor* conexao) {
+    close(conexao->fd);
+    servidor->chamadas++;
+    conexao->ativa = false;
+    conexao->proxima = servidor->livres;
+    servidor->livres = conexao;
+    servidor->conexoesAtivas--;
+}
+
+/**
+ * Retira do próximo quadro recebido um comando para os trabalhadores
+ * 
+ * Só com a conexão livre e a resposta anterior já enviada, o que
+ * limita cada cliente a um comando em andamento.
+ * 
+ * @param servidor Servidor
+ * @param conexao Conexão (pertencente ao laço de eventos)
+ * @return 1 se despachou, 0 se falta receber dados, -1 se o quadro é inválido
+ */
+static int despacharConexao(ServidorPartidas* servidor, ConexaoServidor* conexao) {
+    if (conexao->ocupada || conexao->fechar || conexao->usadoSaida > 0) {
+        return 1;
+    }
+    int lido = extrairQuadro(conexao->entrada, &conexao->usadoEntrada, &conexao->tipoComando,
+                             conexao->comando, &conexao->tamanhoComando);
+    if (lido > 0) {
+        conexao->ocupada = true;
+        conexao->recebidoNs = instanteNs();
+        enfileirarConexao(&servidor->pendentes, conexao);
+    }
+    return lido;
+}
+
+/**
+ * Marca a conexão para fechamento e a retira do epoll
+ * 
+ * @param servidor Servidor (backend epoll)
+ * @param conexao Conexão a fechar
+ */
+static void marcarFechamentoConexao(ServidorPartidas* servidor, ConexaoServidor* conexao) {
+    conexao->fechar = true;
+    if (!conexao->removida) {
+        epoll_ctl(servidor->epoll, EPOLL_CTL_DEL, conexao->fd, NULL);
+        servidor->chamadas++;
+        conexao->removida = true;
+    }
+}
+
+/**
+ * Envia o que for possível da saída da conexão
+ * 
+ * Se o socket encher, passa a esperar EPOLLOUT para continuar.
+ * 
+ * @param servidor Servidor (backend epoll)
+ * @param conexao Conexão livre com saída pendente
+ */
+static void enviarSaidaConexao(ServidorPartidas* servidor, ConexaoServidor* conexao) {
+    while (conexao->enviadoSaida < conexao->usadoSaida && !conexao->fechar) {
+        ssize_t n = send(conexao->fd, conexao->saida + conexao->enviadoSaida,
+                         conexao->usadoSaida - conexao->enviadoSaida, MSG_NOSIGNAL | MSG_DONTWAIT);
+        servidor->chamadas++;
+        if (n > 0) {
+            conexao->enviadoSaida += (size_t)n;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            if (!conexao->aguardandoEscrita) {
+                struct epoll_event evento = {EPOLLIN | EPOLLOUT | EPOLLRDHUP, {.ptr = conexao}};
+                epoll_ctl(servidor->epoll, EPOLL_CTL_MOD, conexao->fd, &evento);
+                servidor->chamadas++;
+                conexao->aguardandoEscrita = true;
+            }
+            return;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            marcarFechamentoConexao(servidor, conexao);
+            return;
+        }
+    }
+    
+    conexao->usadoSaida = conexao->enviadoSaida = 0;
+    if (conexao->aguardandoEscrita && !conexao->fechar) {
+        struct epoll_event evento = {EPOLLIN | EPOLLRDHUP, {.ptr = conexao}};
+        epoll_ctl(servidor->epoll, EPOLL_CTL_MOD, conexao->fd, &evento);
+        servidor->chamadas++;
+        conexao->aguardandoEscrita = false;
+    }
+}
+
+/**
+ * Despacha o próximo comando e fecha a conexão se for o caso
+ * 
+ * @param servidor Servidor (backend epoll)
+ * @param conexao Conexão livre
+ */
+static void avancarConexaoEpoll(ServidorPartidas* servidor, ConexaoServidor* conexao) {
+    if (despacharConexao(servidor, conexao) < 0) {
+        marcarFechamentoConexao(servidor, conexao);
+    }
+    if (conexao->fechar && !conexao->ocupada) {
+        liberarConexaoServidor(servidor, conexao);
+    }
+}
+
+/**
+ * Diz se uma falha de accept vem da falta de descritores ou memória
+ * 
+ * Repetir o accept na hora falharia de novo: a escuta continua pronta
+ * e o laço giraria sem progresso.
+ * 
+ * @param erro errno (ou -res do io_uring)
+ * @return true para EMFILE, ENFILE, ENOBUFS e ENOMEM
+ */
+static bool faltaRecursoAceite(int erro) {
+    return erro == EMFILE || erro == ENFILE || erro == ENOBUFS || erro == ENOMEM;
+}
+
+/**
+ * Aceita todas as conexões pendentes no socket de escuta
+ * 
+ * Sem descritores ou memória, tira a escuta do epoll; o laço a devolve
+ * quando uma conexão fecha ou após SERVIDOR_PAUSA_ACEITE_MS.
+ * 
+ * @param servidor Servidor (backend epoll)
+ */
+static void aceitarConexoesEpoll(ServidorPartidas* servidor) {
+    for (;;) {
+        int fd = accept4(servidor->escuta, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        servidor->chamadas++;
+        if (fd < 0) {
+            if (faltaRecursoAceite(errno)) {
+                epoll_ctl(servidor->epoll, EPOLL_CTL_DEL, servidor->escuta, NULL);
+                servidor->chamadas++;
+                servidor->escutaSuspensa = true;
+                servidor->ativasNaPausa = servidor->conexoesAtivas;
+                return;
+            }
+            if (errno == ECONNABORTED || errno == EINTR) {
+                continue; // Cliente desistiu na fila: tenta o próximo
+            }
+            return; // EAGAIN: nada mais a aceitar
+        }
+        ConexaoServidor* conexao = registrarConexaoServidor(servidor, fd);
+        if (conexao == NULL) {
+            continue;
+        }
+        struct epoll_event evento = {EPOLLIN | EPOLLRDHUP, {.ptr = conexao}};
+        servidor->chamadas++;
+        if (epoll_ctl(servidor->epoll, EPOLL_CTL_ADD, fd, &evento) != 0) {
+            liberarConexaoServidor(servidor, conexao);
+        }
+    }
+}
+
+/**
+ * Trata eventos de leitura e escrita de uma conexão
+ * 
+ * @param servidor Servidor (backend epoll)
+ * @param conexao Conexão
+ * @param eventos Máscara do epoll
+ */
+static void tratarEventoConexao(ServidorPartidas* servidor, ConexaoServidor* conexao, uint32_t eventos) {
+    if (eventos & EPOLLIN) {
+        if (conexao->usadoEntrada == SERVIDOR_BUFFER) {
+            marcarFechamentoConexao(servidor, conexao); // Cliente não espera as respostas
+        } else {
+            ssize_t n = recv(conexao->fd, conexao->entrada + conexao->usadoEntrada,
+                             SERVIDOR_BUFFER - conexao->usadoEntrada, MSG_DONTWAIT);
+            servidor->chamadas++;
+            if (n > 0) {
+                conexao->usadoEntrada += (size_t)n;
+            } else if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+                marcarFechamentoConexao(servidor, conexao);
+            }
+        }
+    } else if (eventos & (EPOLLERR | EPOLLHUP)) {
+        marcarFechamentoConexao(servidor, conexao);
+    }
+    if ((eventos & EPOLLOUT) && !conexao->ocupada) {
+        enviarSaidaConexao(servidor, conexao);
+    }
+    avancarConexaoEpoll(servidor, conexao);
+}
+
+/**
+ * Retira da fila todas as conexões devolvidas pelos trabalhadores
+ * 
+ * @param servidor Servidor
+ * @return Primeira conexão da lista (encadeada por proxima)
+ */
+static ConexaoServidor* retirarRespostasServidor(ServidorPartidas* servidor) {
+    pthread_mutex_lock(&servidor->concluidas.trava);
+    ConexaoServidor* conexao = servidor->concluidas.primeira;
+    servidor->concluidas.primeira = servidor->concluidas.ultima = NULL;
+    pthread_mutex_unlock(&servidor->concluidas.trava);
+    return conexao;
+}
+
+/**
+ * Laço de eventos sobre epoll
+ * 
+ * Uma chamada epoll_wait por volta, mais accept4/recv/send por
+ * conexão pronta e um pwrite do diário por volta.
+ * 
+ * @param servidor Servidor com epoll e descritores abertos
+ */
+static void executarLacoEpoll(ServidorPartidas* servidor) {
+    struct epoll_event eventos[SERVIDOR_EVENTOS];
+    char marcadores[3];             // Identificam escuta, aviso e sinal no epoll
+    int fds[3] = {servidor->escuta, servidor->aviso, servidor->sinal};
+    bool encerrar = false;
+    
+    for (int i = 0; i < 3; i++) {
+        struct epoll_event evento = {EPOLLIN, {.ptr = &marcadores[i]}};
+        epoll_ctl(servidor->epoll, EPOLL_CTL_ADD, fds[i], &evento);
+    }
+    
+    while (!encerrar) {
+        int espera = servidor->escutaSuspensa ? SERVIDOR_PAUSA_ACEITE_MS : -1;
+        int n = epoll_wait(servidor->epoll, eventos, SERVIDOR_EVENTOS, espera);
+        bool respostas = false;
+        servidor->chamadas++;
+        if (n < 0 && errno != EINTR) {
+            break;
+        }
+        for (int i = 0; i < n; i++) {
+            void* alvo = eventos[i].data.ptr;
+            if (alvo == &marcadores[0]) {
+                aceitarConexoesEpoll(servidor);
+            } else if (alvo == &marcadores[1]) {
+                respostas = true; // Depois dos demais: uma conexão liberada aqui ainda pode estar no lote
+            } else if (alvo == &marcadores[2]) {
+                // Consome o sinal: pendente, ele mataria o processo ao restaurar a máscara
+                if (read(servidor->sinal, &servidor->leituraSinal, sizeof(servidor->leituraSinal)) < 0) {
+                    // Já consumido: encerra do mesmo jeito
+                }
+                servidor->chamadas++;
+                encerrar = true;
+            } else {
+                tratarEventoConexao(servidor, (ConexaoServidor*)alvo, eventos[i].events);
+            }
+        }
+        
+        if (respostas) {
+            uint64_t avisos;
+            if (read(servidor->aviso, &avisos, sizeof(avisos)) < 0) {
+                // Sem avisos pendentes: a lista abaixo pode estar vazia
+            }
+            servidor->chamadas++;
+            ConexaoServidor* conexao = retirarRespostasServidor(servidor);
+            while (conexao != NULL) {
+                ConexaoServidor* proxima = conexao->proxima;
+                concluirComandoServidor(servidor, conexao);
+                enviarSaidaConexao(servidor, conexao);
+                avancarConexaoEpoll(servidor, conexao);
+                conexao = proxima;
+            }
+        }
+        if (servidor->escutaSuspensa && (n == 0 || servidor->conexoesAtivas < servidor->ativasNaPausa)) {
+            struct epoll_event evento = {EPOLLIN, {.ptr = &marcadores[0]}};
+            epoll_ctl(servidor->epoll, EPOLL_CTL_ADD, servidor->escuta, &evento);
+            servidor->chamadas++;
+            servidor->escutaSuspensa = false;
+        }
+        selarDiario(servidor);
+    }
+}
+
+/**
+ * Cria o anel do io_uring com chamadas de sistema diretas
+ * 
+ * @param anel Anel a preencher
+ * @param entradas Tamanho desejado da fila de submissão
+ * @return false se o kernel não oferece io_uring (ou está desativado)
+ */
+static bool criarAnelUring(AnelUring* anel, unsigned entradas) {
+    struct io_uring_params parametros;
+    memset(anel, 0, sizeof(*anel));
+    memset(&parametros, 0, sizeof(parametros));
+    
+    anel->fd = (int)syscall(__NR_io_uring_setup, entradas, &parametros);
+    if (anel->fd < 0) {
+        return false;
+    }
+    anel->entradas = parametros.sq_entries;
+    anel->tamanhoMapaSq = parametros.sq_off.array + parametros.sq_entries * sizeof(unsigned);
+    anel->tamanhoMapaCq = parametros.cq_off.cqes + parametros.cq_entries * sizeof(struct io_uring_cqe);
+    anel->tamanhoSqes = parametros.sq_entries * sizeof(struct io_uring_sqe);
+    bool mapaUnico = (parametros.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (mapaUnico && anel->tamanhoMapaCq > anel->tamanhoMapaSq) {
+        anel->tamanhoMapaSq = anel->tamanhoMapaCq;
+    }
+    
+    anel->mapaSq = mmap(NULL, anel->tamanhoMapaSq, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        anel->fd, IORING_OFF_SQ_RING);
+    anel->mapaCq = mapaUnico ? anel->mapaSq :
+                   mmap(NULL, anel->tamanhoMapaCq, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        anel->fd, IORING_OFF_CQ_RING);
+    void* sqes = mmap(NULL, anel->tamanhoSqes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      anel->fd, IORING_OFF_SQES);
+    if (anel->mapaSq == MAP_FAILED) anel->mapaSq = NULL;
+    if (anel->mapaCq == MAP_FAILED) anel->mapaCq = NULL;
+    anel->sqes = (sqes == MAP_FAILED) ? NULL : (struct io_uring_sqe*)sqes;
+    if (anel->mapaSq == NULL || anel->mapaCq == NULL || anel->sqes == NULL) {
+        return false;
+    }
+    
+    char* sq = (char*)anel->mapaSq;
+    char* cq = (char*)anel->mapaCq;
+    anel->sqCabeca = (unsigned*)(sq + parametros.sq_off.head);
+    anel->sqCauda = (unsigned*)(sq + parametros.sq_off.tail);
+    anel->sqMascara = *(unsigned*)(sq + parametros.sq_off.ring_mask);
+    anel->sqIndices = (unsigned*)(sq + parametros.sq_off.array);
+    anel->cqCabeca = (unsigned*)(cq + parametros.cq_off.head);
+    anel->cqCauda = (unsigned*)(cq + parametros.cq_off.tail);
+    anel->cqMascara = *(unsigned*)(cq + parametros.cq_off.ring_mask);
+    anel->cqes = (struct io_uring_cqe*)(cq + parametros.cq_off.cqes);
+    return true;
+}
+
+/**
+ * Desfaz os mapeamentos e fecha o anel do io_uring
+ * 
+ * Fechar o anel cancela as operações ainda pendentes no kernel.
+ * 
+ * @param anel Anel criado (mesmo que parcialmente) por criarAnelUring
+ */
+static void liberarAnelUring(AnelUring* anel) {
+    if (anel->sqes != NULL) munmap(anel->sqes, anel->tamanhoSqes);
+    if (anel->mapaCq != NULL && anel->mapaCq != anel->mapaSq) munmap(anel->mapaCq, anel->tamanhoMapaCq);
+    if (anel->mapaSq != NULL) munmap(anel->mapaSq, anel->tamanhoMapaSq);
+    if (anel->fd >= 0) close(anel->fd);
+    memset(anel, 0, sizeof(*anel));
+    anel->fd = -1;
+}
+
+/**
+ * Entrega ao kernel as entradas preenchidas e, se pedido, espera conclusões
+ * 
+ * É a única chamada de sistema por volta do laço io_uring: submissões
+ * de todas as conexões vão juntas.
+ * 
+ * @param servidor Servidor com backend io_uring
+ * @param minimo Conclusões a esperar (0 = só submeter)
+ * @return false se o kernel recusou o lote (EBUSY: conclusões em excesso)
+ */
+static bool submeterUring(ServidorPartidas* servidor, unsigned minimo) {
+    AnelUring* anel = &servidor->anel;
+    for (;;) {
+        int submetidas = (int)syscall(__NR_io_uring_enter, anel->fd, anel->aSubmeter, minimo,
+                                      minimo > 0 ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+        servidor->chamadas++;
+        if (submetidas >= 0) {
+            anel->aSubmeter -= (unsigned)submetidas;
+            return true;
+        }
+        if (errno != EINTR) {
+            return false;
+        }
+    }
+}
+
+/**
+ * Reserva a próxima entrada da fila de submissão
+ * 
+ * Com a fila cheia, entrega o lote ao kernel. Se ele recusar (EBUSY),
+ * espera com recuo exponencial (1 µs a 1 ms) para as conclusões já
+ * consumidas pelo laço liberarem espaço e, após URING_TENTATIVAS
+ * recusas seguidas, marca o anel como travado em vez de girar para
+ * sempre.
+ * 
+ * @param servidor Servidor com backend io_uring
+ * @return Entrada zerada, ou NULL se a fila não andou
+ */
+static struct io_uring_sqe* obterEntradaUring(ServidorPartidas* servidor) {
+    AnelUring* anel = &servidor->anel;
+    unsigned cauda = *anel->sqCauda;
+    struct timespec pausa = {0, 1000};
+    int recusas = 0;
+    
+    while (cauda - atomic_load_explicit((_Atomic unsigned*)anel->sqCabeca, memory_order_acquire) >= anel->entradas) {
+        if (submeterUring(servidor, 0)) {
+            recusas = 0;
+            continue;
+        }
+        if (servidor->anelTravado || ++recusas > URING_TENTATIVAS) {
+            servidor->anelTravado = true;
+            return NULL;
+        }
+        nanosleep(&pausa, NULL);
+        if (pausa.tv_nsec < 1000000) pausa.tv_nsec *= 2;
+    }
+    unsigned indice = cauda & anel->sqMascara;
+    struct io_uring_sqe* entrada = &anel->sqes[indice];
+    memset(entrada, 0, sizeof(*entrada));
+    anel->sqIndices[indice] = indice;
+    atomic_store_explicit((_Atomic unsigned*)anel->sqCauda, cauda + 1, memory_order_release);
+    anel->aSubmeter++;
+    return entrada;
+}
+
+/**
+ * Prepara uma leitura (ou outra operação sem buffer fixo) no io_uring
+ * 
+ * @param servidor Servidor com backend io_uring
+ * @param operacao IORING_OP_*
+ * @param fd Descritor
+ * @param destino Buffer
+ * @param tamanho Tamanho do buffer
+ * @param identificador user_data devolvido na conclusão
+ */
+static void postarOperacaoUring(ServidorPartidas* servidor, int operacao, int fd, void* destino,
+                                unsigned tamanho, uint64_t identificador) {
+    struct io_uring_sqe* entrada = obterEntradaUring(servidor);
+    if (entrada == NULL) {
+        return; // Anel travado: o laço encerra no fim da volta
+    }
+    entrada->opcode = (uint8_t)operacao;
+    entrada->fd = fd;
+    entrada->addr = (uintptr_t)destino;
+    entrada->len = tamanho;
+    entrada->user_data = identificador;
+    if (operacao == IORING_OP_ACCEPT) {
+        entrada->accept_flags = SOCK_CLOEXEC;
+    }
+}
+
+/**
+ * Prepara a leitura ou o envio de uma conexão com o buffer registrado
+ * 
+ * @param servidor Servidor com backend io_uring
+ * @param conexao Conexão (no array registrado como buffer 0)
+ * @param escrita true para enviar a saída, false para receber
+ */
+static void postarConexaoUring(ServidorPartidas* servidor, ConexaoServidor* conexao, bool escrita) {
+    struct io_uring_sqe* entrada = obterEntradaUring(servidor);
+    if (entrada == NULL) {
+        return; // Anel travado: a conexão é fechada no encerramento
+    }
+    entrada->fd = conexao->fd;
+    entrada->buf_index = 0;
+    if (escrita) {
+        entrada->opcode = IORING_OP_WRITE_FIXED;
+        entrada->addr = (uintptr_t)(conexao->saida + conexao->enviadoSaida);
+        entrada->len = (unsigned)(conexao->usadoSaida - conexao->enviadoSaida);
+        entrada->user_data = (uintptr_t)conexao | URING_ESCRITA;
+    } else {
+        entrada->opcode = IORING_OP_READ_FIXED;
+        entrada->addr = (uintptr_t)(conexao->entrada + conexao->usadoEntrada);
+        entrada->len = (unsigned)(SERVIDOR_BUFFER - conexao->usadoEntrada);
+        entrada->user_data = (uintptr_t)conexao | URING_LEITURA;
+    }
+}
+
+/**
+ * Despacha o próximo comando ou volta a receber
+ * 
+ * No io_uring cada conexão tem no máximo uma operação pendente, então
+ * fechar a conexão aqui nunca deixa uma leitura usando a vaga.
+ * 
+ * @param servidor Servidor com backend io_uring
+ * @param conexao Conexão livre e sem operações pendentes
+ */
+static void avancarConexaoUring(ServidorPartidas* servidor, ConexaoServidor* conexao) {
+    int despachou = despacharConexao(servidor, conexao);
+    if (despachou < 0 || (despachou == 0 && conexao->usadoEntrada == SERVIDOR_BUFFER)) {
+        liberarConexaoServidor(servidor, conexao);
+    } else if (despachou == 0) {
+        postarConexaoUring(servidor, conexao, false);
+    }
+}
+
+/**
+ * Laço de eventos sobre io_uring
+ * 
+ * Aceites, leituras, envios, avisos dos trabalhadores, sinais e o
+ * diário são operações do anel; cada volta faz uma única chamada
+ * io_uring_enter que submete o lote e espera conclusões.
+ * 
+ * @param servidor Servidor com o anel criado e os buffers registrados
+ */
+static void executarLacoUring(ServidorPartidas* servidor) {
+    AnelUring* anel = &servidor->anel;
+    bool encerrar = false;
+    
+    postarOperacaoUring(servidor, IORING_OP_ACCEPT, servidor->escuta, NULL, 0, URING_ACEITAR);
+    postarOperacaoUring(servidor, IORING_OP_READ, servidor->aviso, &servidor->leituraAviso,
+                        sizeof(servidor->leituraAviso), URING_AVISO);
+    postarOperacaoUring(servidor, IORING_OP_READ, servidor->sinal, &servidor->leituraSinal,
+                        sizeof(servidor->leituraSinal), URING_SINAL);
+    
+    struct timespec pausa = {0, 1000};
+    int recusas = 0;
+    servidor->pausaAceite.tv_sec = 0;
+    servidor->pausaAceite.tv_nsec = SERVIDOR_PAUSA_ACEITE_MS * 1000000LL;
+    while (!encerrar && !servidor->anelTravado) {
+        bool respostas = false;
+        if (submeterUring(servidor, 1)) {
+            recusas = 0;
+            pausa.tv_nsec = 1000;
+        } else if (++recusas > URING_TENTATIVAS) {
+            servidor->anelTravado = true; // Recusa que não passa: encerra em vez de girar
+            break;
+        } else {
+            // As conclusões já postadas, tratadas abaixo, liberam o kernel (EBUSY)
+            nanosleep(&pausa, NULL);
+            if (pausa.tv_nsec < 1000000) pausa.tv_nsec *= 2;
+        }
+        
+        unsigned cabeca = *anel->cqCabeca;
+        unsigned cauda = atomic_load_explicit((_Atomic unsigned*)anel->cqCauda, memory_order_acquire);
+        for (; cabeca != cauda; cabeca++) {
+            const struct io_uring_cqe* conclusao = &anel->cqes[cabeca & anel->cqMascara];
+            uint64_t identificador = conclusao->user_data;
+            int resultado = conclusao->res;
+            ConexaoServidor* conexao = (ConexaoServidor*)(uintptr_t)(identificador & ~(uint64_t)URING_MASCARA);
+            // Devolve a conclusão já: um EBUSY ao postar abaixo se resolve com o espaço liberado
+            atomic_store_explicit((_Atomic unsigned*)anel->cqCabeca, cabeca + 1, memory_order_release);
+            
+            switch (identificador & URING_MASCARA) {
+                case URING_ACEITAR:
+                    if (resultado >= 0 && (conexao = registrarConexaoServidor(servidor, resultado)) != NULL) {
+                        postarConexaoUring(servidor, conexao, false);
+                    }
+                    if (resultado < 0 && faltaRecursoAceite(-resultado)) {
+                        // Um novo accept falharia na hora: espera antes de repostar
+                        postarOperacaoUring(servidor, IORING_OP_TIMEOUT, -1, &servidor->pausaAceite, 1, URING_PAUSA);
+                    } else {
+                        postarOperacaoUring(servidor, IORING_OP_ACCEPT, servidor->escuta, NULL, 0, URING_ACEITAR);
+                    }
+                    break;
+                case URING_PAUSA:
+                    postarOperacaoUring(servidor, IORING_OP_ACCEPT, servidor->escuta, NULL, 0, URING_ACEITAR);
+                    break;
+                case URING_AVISO:
+                    respostas = true;
+                    postarOperacaoUring(servidor, IORING_OP_READ, servidor->aviso, &servidor->leituraAviso,
+                                        sizeof(servidor->leituraAviso), URING_AVISO);
+                    break;
+                case URING_SINAL:
+                    encerrar = true;
+                    break;
+                case URING_DIARIO:
+                    servidor->diario.emVoo = false;
+                    if (resultado != (int)servidor->diario.tamanhoEmVoo) {
+                        servidor->diario.erro = true;
+                    }
+                    break;
+                case URING_LEITURA:
+                    if (resultado <= 0) {
+                        liberarConexaoServidor(servidor, conexao);
+                    } else {
+                        conexao->usadoEntrada += (size_t)resultado;
+                        avancarConexaoUring(servidor, conexao);
+                    }
+                    break;
+                case URING_ESCRITA:
+                    if (resultado <= 0) {
+                        liberarConexaoServidor(servidor, conexao);
+                    } else if ((conexao->enviadoSaida += (size_t)resultado) < conexao->usadoSaida) {
+                        postarConexaoUring(servidor, conexao, true);
+                    } else {
+                        conexao->usadoSaida = conexao->enviadoSaida = 0;
+                        avancarConexaoUring(servidor, conexao);
+                    }
+                    break;
+            }
+        }
+        
+        if (respostas) {
+            ConexaoServidor* conexao = retirarRespostasServidor(servidor);
+            while (conexao != NULL) {
+                ConexaoServidor* proxima = conexao->proxima;
+                concluirComandoServidor(servidor, conexao);
+                postarConexaoUring(servidor, conexao, true);
+                conexao = proxima;
+            }
+        }
+        selarDiario(servidor);
+    }
+}
+
+/**
+ * Registra no io_uring os buffers das conexões e os do diário
+ * 
+ * @param servidor Servidor com o anel criado
+ * @return false se o kernel recusou o registro
+ */
+static bool registrarBuffersUring(ServidorPartidas* servidor) {
+    struct iovec buffers[3] = {
+        {servidor->buffers, SERVIDOR_MAX_CONEXOES * sizeof(BuffersConexao)},
+        {servidor->diario.buffers[0], DIARIO_REGISTROS * sizeof(RegistroDiario)},
+        {servidor->diario.buffers[1], DIARIO_REGISTROS * sizeof(RegistroDiario)}
+    };
+    return syscall(__NR_io_uring_register, servidor->anel.fd, IORING_REGISTER_BUFFERS, buffers, 3) == 0;
+}
+
+/**
+ * Abre o socket de escuta em um caminho do sistema de arquivos
+ * 
+ * Um socket antigo no mesmo caminho é removido; qualquer outro tipo de
+ * arquivo é preservado e a abertura falha.
+ * 
+ * @param caminho Caminho do socket
+ * @param naoBloqueante true para o epoll (aceita até EAGAIN)
+ * @return Descritor de escuta ou -1
+ */
+static int abrirSocketEscuta(const char* caminho, bool naoBloqueante) {
+    struct sockaddr_un endereco;
+    struct stat info;
+    
+    if (strlen(caminho) >= sizeof(endereco.sun_path)) {
+        return -1;
+    }
+    if (lstat(caminho, &info) == 0 && S_ISSOCK(info.st_mode)) {
+        unlink(caminho);
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | (naoBloqueante ? SOCK_NONBLOCK : 0), 0);
+    if (fd < 0) {
+        return -1;
+    }
+    memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    strcpy(endereco.sun_path, caminho);
+    if (bind(fd, (struct sockaddr*)&endereco, sizeof(endereco)) != 0 || listen(fd, SERVIDOR_FILA_ESCUTA) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * Executa o servidor de partidas até receber SIGINT ou SIGTERM
+ * 
+ * Um único laço de eventos aceita clientes, lê quadros e envia
+ * respostas; numThreads trabalhadores executam os comandos. Cada
+ * conexão joga uma partida por vez, pelo protocolo descrito acima. O
+ * laço usa io_uring (buffers registrados, submissões em lote) quando
+ * pedido e disponível, e epoll caso contrário. Ao encerrar informa as
+ * chamadas de sistema por turno e a latência de resposta.
+ * 
+ * @param caminho Caminho do socket Unix
+ * @param numThreads Trabalhadores que resolvem os turnos
+ * @param backend "io_uring", "epoll" ou "auto" (io_uring se houver)
+ * @param arquivoDiario Diário dos comandos (NULL = sem diário)
+ * @return 0 se encerrou normalmente, 1 em erro
+ */
+int executarServidor(const char* caminho, int numThreads, const char* backend, const char* arquivoDiario) {
+    ServidorPartidas servidor;
+    sigset_t sinais, mascaraAnterior;
+    bool querUring = (strcmp(backend, "epoll") != 0);
+    
+    memset(&servidor, 0, sizeof(servidor));
+    servidor.epoll = servidor.escuta = servidor.aviso = servidor.sinal = servidor.diario.fd = -1;
+    servidor.anel.fd = -1;
+    if (numThreads > MAX_THREADS) numThreads = MAX_THREADS;
+    
+    servidor.conexoes = (ConexaoServidor*)calloc(SERVIDOR_MAX_CONEXOES, sizeof(ConexaoServidor));
+    servidor.buffers = (BuffersConexao*)aligned_alloc(4096, SERVIDOR_MAX_CONEXOES * sizeof(BuffersConexao));
+    servidor.diario.buffers[0] = (RegistroDiario*)aligned_alloc(4096, DIARIO_REGISTROS * sizeof(RegistroDiario));
+    servidor.diario.buffers[1] = (RegistroDiario*)aligned_alloc(4096, DIARIO_REGISTROS * sizeof(RegistroDiario));
+    if (servidor.conexoes == NULL || servidor.buffers == NULL ||
+        servidor.diario.buffers[0] == NULL || servidor.diario.buffers[1] == NULL) {
+        printf("❌ Erro: Falha na alocação de memória para o servidor!\n");
+        free(servidor.conexoes);
+        free(servidor.buffers);
+        free(servidor.diario.buffers[0]);
+        free(servidor.diario.buffers[1]);
+        return 1;
+    }
+    for (int i = SERVIDOR_MAX_CONEXOES - 1; i >= 0; i--) {
+        servidor.conexoes[i].proxima = servidor.livres;
+        servidor.livres = &servidor.conexoes[i];
+    }
+    
+    if (querUring) {
+        servidor.usaUring = criarAnelUring(&servidor.anel, URING_ENTRADAS) && registrarBuffersUring(&servidor);
+        if (!servidor.usaUring) {
+            liberarAnelUring(&servidor.anel);
+            if (strcmp(backend, "io_uring") == 0) {
+                printf("⚠️  io_uring indisponível (%s); usando epoll\n", strerror(errno));
+            }
+        }
+    }
+    
+    // Sinais bloqueados em todas as threads e lidos pelo laço via signalfd
+    sigemptyset(&sinais);
+    sigaddset(&sinais, SIGINT);
+    sigaddset(&sinais, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &sinais, &mascaraAnterior);
+    
+    servidor.escuta = abrirSocketEscuta(caminho, !servidor.usaUring);
+    servidor.aviso = eventfd(0, EFD_CLOEXEC);
+    servidor.sinal = signalfd(-1, &sinais, SFD_CLOEXEC);
+    if (!servidor.usaUring) {
+        servidor.epoll = epoll_create1(EPOLL_CLOEXEC);
+    }
+    if (arquivoDiario != NULL) {
+        servidor.diario.fd = open(arquivoDiario, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    }
+    bool falhou = servidor.escuta < 0 || servidor.aviso < 0 || servidor.sinal < 0 ||
+                  (!servidor.usaUring && servidor.epoll < 0) || (arquivoDiario != NULL && servidor.diario.fd < 0);
+    
+    pthread_mutex_init(&servidor.pendentes.trava, NULL);
+    pthread_cond_init(&servidor.pendentes.sinal, NULL);
+    pthread_mutex_init(&servidor.concluidas.trava, NULL);
+    pthread_cond_init(&servidor.concluidas.sinal, NULL);
+    for (int i = 0; i < numThreads && !falhou; i++) {
+        if (pthread_create(&servidor.trabalhadores[i], NULL, executarTrabalhadorServidor, &servidor) != 0) {
+            break;
+        }
+        servidor.numTrabalhadores++;
+    }
+    
+    if (falhou || servidor.numTrabalhadores == 0) {
+        printf("❌ Erro: Não foi possível abrir o servidor em %s\n", caminho);
+    } else {
+        printf("\n🖧  ═══════════════════════════════════════════════════════════\n");
+        printf("                  SERVIDOR DE PARTIDAS\n");
+        printf("═══════════════════════════════════════════════════════════🖧\n");
+        printf("🔌 Ouvindo em %s com %d trabalhadores, backend %s%s%s (Ctrl+C encerra)\n",
+               caminho, servidor.numTrabalhadores, servidor.usaUring ? "io_uring" : "epoll",
+               arquivoDiario != NULL ? ", diário em " : "", arquivoDiario != NULL ? arquivoDiario : "");
+        fflush(stdout);
+        if (servidor.usaUring) {
+            executarLacoUring(&servidor);
+            if (servidor.anelTravado) {
+                printf("❌ Erro: a fila de submissão do io_uring não andou após %d tentativas!\n", URING_TENTATIVAS);
+                falhou = true;
+            }
+        } else {
+            executarLacoEpoll(&servidor);
+        }
+    }
+    
+    pthread_mutex_lock(&servidor.pendentes.trava);
+    servidor.encerrar = true;
+    pthread_cond_broadcast(&servidor.pendentes.sinal);
+    pthread_mutex_unlock(&servidor.pendentes.trava);
+    for (int i = 0; i < servidor.numTrabalhadores; i++) {
+        pthread_join(servidor.trabalhadores[i], NULL);
+    }
+    
+    // Fechar o anel cancela as leituras pendentes antes de liberar as vagas
+    bool usouUring = servidor.usaUring;
+    if (usouUring) {
+        while (servidor.diario.emVoo) {
+            unsigned cabeca = *servidor.anel.cqCabeca;
+            unsigned cauda = atomic_load_explicit((_Atomic unsigned*)servidor.anel.cqCauda, memory_order_acquire);
+            for (; cabeca != cauda; cabeca++) {
+                if (servidor.anel.cqes[cabeca & servidor.anel.cqMascara].user_data == URING_DIARIO) {
+                    servidor.diario.emVoo = false;
+                }
+            }
+            atomic_store_explicit((_Atomic unsigned*)servidor.anel.cqCabeca, cabeca, memory_order_release);
+            if (servidor.diario.emVoo) submeterUring(&servidor, 1);
+        }
+        liberarAnelUring(&servidor.anel);
+        servidor.usaUring = false;
+    }
+    for (ConexaoServidor* conexao = retirarRespostasServidor(&servidor); conexao != NULL; conexao = conexao->proxima) {
+        concluirComandoServidor(&servidor, conexao);
+    }
+    selarDiario(&servidor);
+    for (int i = 0; i < SERVIDOR_MAX_CONEXOES; i++) {
+        if (servidor.conexoes[i].ativa) close(servidor.conexoes[i].fd);
+    }
+    
+    if (servidor.diario.fd >= 0) {
+        fdatasync(servidor.diario.fd);
+        close(servidor.diario.fd);
+    }
+    if (servidor.escuta >= 0) {
+        close(servidor.escuta);
+        unlink(caminho);
+    }
+    if (servidor.epoll >= 0) close(servidor.epoll);
+    if (servidor.aviso >= 0) close(servidor.aviso);
+    if (servidor.sinal >= 0) close(servidor.sinal);
+    pthread_mutex_destroy(&servidor.pendentes.trava);
+    pthread_cond_destroy(&servidor.pendentes.sinal);
+    pthread_mutex_destroy(&servidor.concluidas.trava);
+    pthread_cond_destroy(&servidor.concluidas.sinal);
+    pthread_sigmask(SIG_SETMASK, &mascaraAnterior, NULL);
+    free(servidor.conexoes);
+    free(servidor.buffers);
+    free(servidor.diario.buffers[0]);
+    free(servidor.diario.buffers[1]);
+    if (falhou || servidor.numTrabalhadores == 0) {
+        return 1;
+    }
+    
+    long turnos = atomic_load(&servidor.turnos);
+    long chamadasTrabalhadores = atomic_load(&servidor.chamadasTrabalhadores);
+    printf("\n📊 Partidas: %ld | Turnos: %ld | Comandos: %ld | Conexões simultâneas (máx): %ld\n",
+           atomic_load(&servidor.partidas), turnos, atomic_load(&servidor.comandos), servidor.maxConexoes);
+    printf("🔧 Backend %s: %ld chamadas de sistema no laço + %ld dos trabalhadores = %.2f por turno\n",
+           usouUring ? "io_uring" : "epoll", servidor.chamadas, chamadasTrabalhadores,
+           (double)(servidor.chamadas + chamadasTrabalhadores) / (turnos > 0 ? turnos : 1));
+    if (servidor.latencias.total > 0) {
+        printf("⏱️  Resposta no servidor: p50 %.1f µs | p99 %.1f µs | p99,9 %.1f µs | máx %.1f µs\n",
+               percentilLatencia(&servidor.latencias, 0.5) / 1e3, percentilLatencia(&servidor.latencias, 0.99) / 1e3,
+               percentilLatencia(&servidor.latencias, 0.999) / 1e3, servidor.latencias.maximoNs / 1e3);
+    }
+    if (arquivoDiario != NULL) {
+        printf("📒 Diário: %u registros em %s%s\n", servidor.diario.ordem, arquivoDiario,
+               servidor.diario.erro ? " (⚠️  falha de gravação)" : "");
+    }
+    printf("✅ Servidor encerrado!\n");
+    return 0;
+}
+
+/*
+ * Struct: ClienteCarga
+ *
+ * Uma conexão do gerador de carga: joga partidas em sequência com o
+ * bot escolhido decidindo por todos os jogadores.
+ */
+typedef struct {
+    int fd;
+    ControladorJogador* bot;
+    uint8_t entrada[SERVIDOR_BUFFER];
+    size_t usado;
+    long enviadoNs;
+} ClienteCarga;
+
+/*
+ * Struct: TarefaCarga
+ *
+ * Partidas do gerador de carga repartidas entre as threads.
+ */
+typedef struct {
+    const char* caminho;
+    const char* politica;
+    const OpcoesSimulacao* opcoes;
+    atomic_long proximaPartida;
+} TarefaCarga;
+
+/*
+ * Struct: TrabalhadorCarga
+ *
+ * Thread do gerador de carga com seu epoll, suas conexões e seus totais.
+ */
+typedef struct {
+    TarefaCarga* tarefa;
+    pthread_t thread;
+    int conexoes;
+    HistogramaLatencia latencias;   // Ida e volta de cada comando
+    long vitorias[MAX_JOGADORES];
+    long empates;
+    long turnos;
+    long partidas;
+    bool erro;
+} TrabalhadorCarga;
+
+/**
+ * Conecta ao socket Unix do servidor
+ * 
+ * @param caminho Caminho do socket
+ * @return Descritor conectado ou -1
+ */
+static int conectarServidor(const char* caminho) {
+    struct sockaddr_un endereco;
+    if (strlen(caminho) >= sizeof(endereco.sun_path)) {
+        return -1;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    strcpy(endereco.sun_path, caminho);
+    if (connect(fd, (struct sockaddr*)&endereco, sizeof(endereco)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * Envia um quadro pelo socket (bloqueante; quadros são pequenos)
+ * 
+ * @param cliente Conexão do gerador de carga
+ * @param tipo Tipo do quadro
+ * @param carga Carga
+ * @param tamanho Tamanho da carga
+ * @return false se o servidor fechou a conexão
+ */
+static bool enviarQuadroCliente(ClienteCarga* cliente, int tipo, const uint8_t* carga, size_t tamanho) {
+    uint8_t quadro[PROTO_MAX_QUADRO + 2];
+    size_t total = montarQuadro(quadro, tipo, carga, tamanho);
+    size_t enviado = 0;
+    
+    cliente->enviadoNs = instanteNs();
+    while (enviado < total) {
+        ssize_t n = send(cliente->fd, quadro + enviado, total - enviado, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        enviado += (size_t)n;
+    }
+    return true;
+}
+
+/**
+ * Pede ao servidor a próxima partida da carga, se ainda houver
+ * 
+ * @param trabalhador Thread do gerador de carga
+ * @param cliente Conexão livre
+ * @return false se as partidas acabaram ou o envio falhou
+ */
+static bool iniciarPartidaCarga(TrabalhadorCarga* trabalhador, ClienteCarga* cliente) {
+    const OpcoesSimulacao* opcoes = trabalhador->tarefa->opcoes;
+    long jogo = atomic_fetch_add_explicit(&trabalhador->tarefa->proximaPartida, 1, memory_order_relaxed);
+    if (jogo >= opcoes->numJogos) {
+        return false;
+    }
+    
+    uint64_t semente = opcoes->semente + (uint64_t)jogo;
+    uint8_t carga[sizeof(uint64_t) + 2];
+    memcpy(carga, &semente, sizeof(semente));
+    carga[8] = (uint8_t)opcoes->numJogadores;
+    carga[9] = (uint8_t)opcoes->numTerritorios;
+    // Bot reiniciado pela partida (gerador e estado das buscas): o resultado
+    // não depende da conexão que a jogou nem das partidas anteriores dela
+    reiniciarControlador(cliente->bot, semente * 3 + 2);
+    return enviarQuadroCliente(cliente, PROTO_NOVA_PARTIDA, carga, sizeof(carga));
+}
+
+/**
+ * Trata um quadro recebido pelo gerador de carga
+ * 
+ * @param trabalhador Thread do gerador de carga
+ * @param cliente Conexão que recebeu o quadro
+ * @param tipo Tipo do quadro
+ * @param carga Carga
+ * @param tamanho Tamanho da carga
+ * @return false quando a conexão deve ser fechada
+ */
+static bool tratarQuadroCarga(TrabalhadorCarga* trabalhador, ClienteCarga* cliente, int tipo,
+                              const uint8_t* carga, size_t tamanho) {
+    registrarLatencia(&trabalhador->latencias, instanteNs() - cliente->enviadoNs);
+    
+    if (tipo == PROTO_ESTADO) {
+        EstadoSimulacao estado;
+        int resultado, atacante, defensor;
+        uint8_t ataque[2] = {PROTO_SEM_ATAQUE, PROTO_SEM_ATAQUE};
+        if (!decodificarEstadoProtocolo(carga, tamanho, &estado, &resultado)) {
+            trabalhador->erro = true;
+            return false;
+        }
+        if (cliente->bot->decidirAtaque(cliente->bot, &estado, &atacante, &defensor)) {
+            ataque[0] = (uint8_t)atacante;
+            ataque[1] = (uint8_t)defensor;
+        }
+        return enviarQuadroCliente(cliente, PROTO_ATAQUE, ataque, sizeof(ataque));
+    }
+    if (tipo == PROTO_FIM && tamanho == 3) {
+        int vencedor = (int8_t)carga[0];
+        uint16_t turnos;
+        memcpy(&turnos, carga + 1, sizeof(turnos));
+        if (vencedor >= 0 && vencedor < MAX_JOGADORES) trabalhador->vitorias[vencedor]++;
+        else trabalhador->empates++;
+        trabalhador->turnos += turnos;
+        trabalhador->partidas++;
+        return iniciarPartidaCarga(trabalhador, cliente);
+    }
+    trabalhador->erro = true; // ERRO ou quadro inesperado
+    return false;
+}
+
+/**
+ * Corpo de uma thread do gerador de carga
+ * 
+ * Abre suas conexões, começa uma partida em cada uma e atende as
+ * respostas pelo epoll até as partidas acabarem.
+ * 
+ * @param argumento Ponteiro para o TrabalhadorCarga
+ * @return NULL
+ */
+static void* executarTrabalhadorCarga(void* argumento) {
+    TrabalhadorCarga* trabalhador = (TrabalhadorCarga*)argumento;
+    TarefaCarga* tarefa = trabalhador->tarefa;
+    ClienteCarga* clientes = (ClienteCarga*)calloc(trabalhador->conexoes, sizeof(ClienteCarga));
+    struct epoll_event eventos[SERVIDOR_EVENTOS];
+    int epoll = epoll_create1(EPOLL_CLOEXEC);
+    int ativas = 0;
+    
+    if (clientes == NULL || epoll < 0) {
+        trabalhador->erro = true;
+        free(clientes);
+        if (epoll >= 0) close(epoll);
+        return NULL;
+    }
+    for (int i = 0; i < trabalhador->conexoes; i++) {
+        clientes[i].fd = -1; // Conexões não abertas se o laço abaixo parar antes
+    }
+    
+    for (int i = 0; i < trabalhador->conexoes; i++) {
+        ClienteCarga* cliente = &clientes[i];
+        cliente->fd = conectarServidor(tarefa->caminho);
+        cliente->bot = criarControlador(tarefa->politica, 0);
+        if (cliente->fd < 0 || cliente->bot == NULL) {
+            trabalhador->erro = true;
+            break;
+        }
+        struct epoll_event evento = {EPOLLIN, {.ptr = cliente}};
+        epoll_ctl(epoll, EPOLL_CTL_ADD, cliente->fd, &evento);
+        if (!iniciarPartidaCarga(trabalhador, cliente)) {
+            break;
+        }
+        ativas++;
+    }
+    
+    while (ativas > 0 && !trabalhador->erro) {
+        int n = epoll_wait(epoll, eventos, SERVIDOR_EVENTOS, -1);
+        if (n < 0 && errno != EINTR) {
+            trabalhador->erro = true;
+        }
+        for (int i = 0; i < n; i++) {
+            ClienteCarga* cliente = (ClienteCarga*)eventos[i].data.ptr;
+            ssize_t lidos = recv(cliente->fd, cliente->entrada + cliente->usado,
+                                 SERVIDOR_BUFFER - cliente->usado, 0);
+            bool continuar = (lidos > 0);
+            if (!continuar) {
+                trabalhador->erro = true; // Servidor fechou no meio de uma partida
+            } else {
+                cliente->usado += (size_t)lidos;
+            }
+            
+            int tipo;
+            uint8_t carga[PROTO_MAX_QUADRO];
+            size_t tamanho;
+            int lido;
+            while (continuar && (lido = extrairQuadro(cliente->entrada, &cliente->usado, &tipo, carga, &tamanho)) != 0) {
+                continuar = (lido > 0) && tratarQuadroCarga(trabalhador, cliente, tipo, carga, tamanho);
+            }
+            if (!continuar) {
+                epoll_ctl(epoll, EPOLL_CTL_DEL, cliente->fd, NULL);
+                close(cliente->fd);
+                cliente->fd = -1;
+                ativas--;
+            }
+        }
+    }
+    
+    for (int i = 0; i < trabalhador->conexoes; i++) {
+        if (clientes[i].fd >= 0) close(clientes[i].fd);
+        if (clientes[i].bot != NULL) clientes[i].bot->liberar(clientes[i].bot);
+    }
+    close(epoll);
+    free(clientes);
+    return NULL;
+}
+
+/**
+ * Gera carga contra um servidor de partidas e mede a latência
+ * 
+ * Joga opcoes->numJogos partidas por `conexoes` conexões simultâneas
+ * repartidas entre numThreads threads, cada uma com seu epoll. As
+ * sementes das partidas são as mesmas para qualquer repartição, então
+ * os totais de vitórias só dependem da semente.
+ * 
+ * @param caminho Caminho do socket do servidor
+ * @param politica Bot que decide por todos os jogadores
+ * @param opcoes Partidas, jogadores, territórios e semente
+ * @param conexoes Conexões simultâneas
+ * @param numThreads Threads do gerador de carga
+ */
+void executarCargaServidor(const char* caminho, const char* politica, const OpcoesSimulacao* opcoes,
+                           int conexoes, int numThreads) {
+    TarefaCarga tarefa;
+    TrabalhadorCarga* trabalhadores;
+    ControladorJogador* teste = criarControlador(politica, 0);
+    
+    if (teste == NULL) {
+        return;
+    }
+    bool humano = controladorEhHumano(teste);
+    teste->liberar(teste);
+    if (humano) {
+        printf("❌ Erro: O gerador de carga não aceita jogadores humanos.\n");
+        return;
+    }
+    if (numThreads > MAX_THREADS) numThreads = MAX_THREADS;
+    if (numThreads > conexoes) numThreads = conexoes;
+    
+    trabalhadores = (TrabalhadorCarga*)calloc(numThreads, sizeof(TrabalhadorCarga));
+    if (trabalhadores == NULL) {
+        printf("❌ Erro: Falha na alocação de memória para o gerador de carga!\n");
+        return;
+    }
+    tarefa.caminho = caminho;
+    tarefa.politica = politica;
+    tarefa.opcoes = opcoes;
+    atomic_init(&tarefa.proximaPartida, 0);
+    
+    printf("\n📨 ═══════════════════════════════════════════════════════════\n");
+    printf("                  GERADOR DE CARGA\n");
+    printf("═══════════════════════════════════════════════════════════📨\n");
+    printf("🤖 Política: %s | %ld partidas | %d conexões | %d threads | %s\n",
+           politica, opcoes->numJogos, conexoes, numThreads, caminho);
+    
+    long inicio = instanteNs();
+    int iniciadas = 0;
+    for (int t = 0; t < numThreads; t++) {
+        trabalhadores[t].tarefa = &tarefa;
+        trabalhadores[t].conexoes = conexoes / numThreads + (t < conexoes % numThreads ? 1 : 0);
+        if (pthread_create(&trabalhadores[t].thread, NULL, executarTrabalhadorCarga, &trabalhadores[t]) != 0) {
+            break;
+        }
+        iniciadas++;
+    }
+    
+    HistogramaLatencia latencias;
+    long vitorias[MAX_JOGADORES] = {0};
+    long empates = 0, turnos = 0, partidas = 0;
+    bool erro = (iniciadas == 0);
+    memset(&latencias, 0, sizeof(latencias));
+    for (int t = 0; t < iniciadas; t++) {
+        TrabalhadorCarga* trabalhador = &trabalhadores[t];
+        pthread_join(trabalhador->thread, NULL);
+        erro = erro || trabalhador->erro;
+        for (int k = 0; k < LATENCIA_FAIXAS * LATENCIA_SUBFAIXAS; k++) {
+            latencias.contagem[k] += trabalhador->latencias.contagem[k];
+        }
+        latencias.total += trabalhador->latencias.total;
+        if (trabalhador->latencias.maximoNs > latencias.maximoNs) {
+            latencias.maximoNs = trabalhador->latencias.maximoNs;
+        }
+        for (int j = 0; j < opcoes->numJogadores; j++) vitorias[j] += trabalhador->vitorias[j];
+        empates += trabalhador->empates;
+        turnos += trabalhador->turnos;
+        partidas += trabalhador->partidas;
+    }
+    double segundos = (instanteNs() - inicio) / 1e9;
+    free(trabalhadores);
+    
+    if (erro) {
+        printf("❌ Erro: Falha na comunicação com o servidor em %s\n", caminho);
+    }
+    if (partidas == 0) {
+        return;
+    }
+    printf("⏱️  %.2f s | %ld partidas (%.0f/s) | %ld turnos (%.0f/s)\n",
+           segundos, partidas, partidas / segundos, turnos, turnos / segundos);
+    printf("📶 Ida e volta: p50 %.1f µs | p99 %.1f µs | p99,9 %.1f µs | máx %.1f µs\n",
+           percentilLatencia(&latencias, 0.5) / 1e3, percentilLatencia(&latencias, 0.99) / 1e3,
+           percentilLatencia(&latencias, 0.999) / 1e3, latencias.maximoNs / 1e3);
+    printf("🏆 Sem vencedor: %ld | vitórias por posição:", empates);
+    for (int j = 0; j < opcoes->numJogadores; j++) {
+        printf(" %ld", vitorias[j]);
+    }
+    printf("\n");
+}
+
+// ============================================================================
+// IMPLEMENTAÇÃO DAS FUNÇÕES - LOTES DE ATAQUES (VERIFICAÇÃO VETORIZADA)
+// ============================================================================
+
+/**
+ * Bit de um território nas máscaras do lote (0 fora do alcance)
+ * 
+ * @param territorio Índice do território
+ * @return Máscara com o bit do território
+ */
+static uint32_t bitTerritorioLote(int territorio) {
+    return (territorio < 32) ? (1u << territorio) : 0u;
+}
+
+/**
+ * Máscaras de bits do estado usadas pelas verificações do lote
+ * 
+ * MAX_TERRITORIOS cabe em 32 bits: bit i é o território i.
+ * 
+ * @param estado Estado compacto
+ * @param proprios Saída com os territórios de cada jogador (LOTE_JOGADORES
+ *                 posições; as que passam de numJogadores ficam vazias)
+ * @return Territórios com mais de 1 tropa, os únicos que podem atacar
+ */
+static uint32_t mascarasEstadoLote(const EstadoSimulacao* estado, uint32_t proprios[LOTE_JOGADORES]) {
+    uint32_t fortes = 0;
+    memset(proprios, 0, LOTE_JOGADORES * sizeof(uint32_t));
+    for (int i = 0; i < estado->numTerritorios; i++) {
+        if (estado->dono[i] >= 0) {
+            proprios[estado->dono[i]] |= 1u << i;
+        }
+        fortes |= (uint32_t)(estado->tropas[i] > 1) << i;
+    }
+    return fortes;
+}
+
+/**
+ * Verifica ordens contra as regras de validarAtaque - versão escalar
+ * 
+ * Sem desvios: atacante próprio com mais de 1 tropa, defensor de outro
+ * jogador, ambos dentro do mapa. Jogadores inexistentes não têm
+ * territórios, então suas ordens nunca são válidas.
+ * 
+ * @param proprios Territórios de cada jogador (mascarasEstadoLote)
+ * @param fortes Territórios que podem atacar
+ * @param numTerritorios Territórios do mapa
+ * @param jogador Jogador de cada ordem
+ * @param atacante Atacante de cada ordem
+ * @param defensor Defensor de cada ordem
+ * @param n Quantidade de ordens
+ * @param validas Saída: um bit por ordem ((n + 7) / 8 bytes)
+ */
+static void validarOrdensEscalar(const uint32_t* proprios, uint32_t fortes, int numTerritorios,
+                                 const uint8_t* jogador, const uint8_t* atacante, const uint8_t* defensor,
+                                 int n, uint8_t* validas) {
+    memset(validas, 0, (size_t)(n + 7) / 8);
+    for (int k = 0; k < n; k++) {
+        uint32_t meus = proprios[jogador[k] & (LOTE_JOGADORES - 1)] & -(uint32_t)(jogador[k] < LOTE_JOGADORES);
+        uint32_t dentro = (uint32_t)(atacante[k] < numTerritorios) & (uint32_t)(defensor[k] < numTerritorios);
+        uint32_t valida = dentro & ((meus & fortes) >> (atacante[k] & 31)) & ~(meus >> (defensor[k] & 31)) & 1u;
+        validas[k >> 3] |= (uint8_t)(valida << (k & 7));
+    }
+}
+
+#ifdef NN_SUPORTE_AVX2
+/**
+ * Verificação de 8 ordens por instrução com AVX2: a tabela de
+ * territórios por jogador tem 8 entradas e cabe num registrador
+ * (permutevar faz a consulta sem gather), e srlv devolve 0 para
+ * deslocamentos de 32 ou mais, como o bit de um território inexistente.
+ */
+__attribute__((target("avx2")))
+static void validarOrdensAvx2(const uint32_t* proprios, uint32_t fortes, int numTerritorios,
+                              const uint8_t* jogador, const uint8_t* atacante, const uint8_t* defensor,
+                              int n, uint8_t* validas) {
+    const __m256i tabela = _mm256_loadu_si256((const __m256i*)proprios);
+    const __m256i mascaraFortes = _mm256_set1_epi32((int)fortes);
+    const __m256i limite = _mm256_set1_epi32(numTerritorios);
+    const __m256i jogadores = _mm256_set1_epi32(LOTE_JOGADORES);
+    int k = 0;
+    
+    for (; k + 8 <= n; k += 8) {
+        __m256i j = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(jogador + k)));
+        __m256i a = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(atacante + k)));
+        __m256i d = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(defensor + k)));
+        __m256i meus = _mm256_and_si256(_mm256_permutevar8x32_epi32(tabela, j), _mm256_cmpgt_epi32(jogadores, j));
+        __m256i dentro = _mm256_and_si256(_mm256_cmpgt_epi32(limite, a), _mm256_cmpgt_epi32(limite, d));
+        __m256i podeAtacar = _mm256_srlv_epi32(_mm256_and_si256(meus, mascaraFortes), a);
+        __m256i valida = _mm256_and_si256(_mm256_andnot_si256(_mm256_srlv_epi32(meus, d), podeAtacar), dentro);
+        validas[k >> 3] = (uint8_t)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_slli_epi32(valida, 31)));
+    }
+    validarOrdensEscalar(proprios, fortes, numTerritorios, jogador + k, atacante + k, defensor + k,
+                         n - k, validas + (k >> 3));
+}
+#endif
+
+static void (*validarOrdensLote)(const uint32_t*, uint32_t, int, const uint8_t*, const uint8_t*,
+                                 const uint8_t*, int, uint8_t*) = validarOrdensEscalar;
+static pthread_once_t validacaoLoteEscolhida = PTHREAD_ONCE_INIT;
+
+/**
+ * Escolhe a versão da verificação suportada pelo processador
+ */
+static void escolherValidacaoLote(void) {
+#ifdef NN_SUPORTE_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        validarOrdensLote = validarOrdensAvx2;
+    }
+#endif
+}
+
+/**
+ * Agrupa as ordens de um lote em ondas sem conflito
+ * 
+ * Cada ordem vai para a onda seguinte à última onda que já usa um dos
+ * seus territórios; ordens que disputam um território ficam, portanto,
+ * na ordem do lote, e as de uma mesma onda não se tocam. As ocupações
+ * das ondas são máscaras de bits, então cada teste custa um AND.
+ * 
+ * @param lote Ordens na ordem de prioridade
+ * @param porOnda Saída com as ordens reordenadas por onda (estável)
+ * @param origem Saída: posição no lote de cada ordem de porOnda
+ * @param limites Saída: fim de cada onda em porOnda
+ * @param resultados Saída com a onda de cada ordem do lote (ver LOTE_ONDA)
+ * @return Quantidade de ondas
+ */
+int agruparOndasLote(const LoteAtaques* lote, LoteAtaques* porOnda, uint16_t* origem, uint16_t* limites,
+                     uint16_t* resultados) {
+    uint32_t ocupadas[LOTE_MAX_ORDENS];
+    int numOrdens = (lote->numOrdens < LOTE_MAX_ORDENS) ? lote->numOrdens : LOTE_MAX_ORDENS;
+    int numOndas = 0;
+    
+    for (int i = 0; i < numOrdens; i++) {
+        uint32_t territorios = bitTerritorioLote(lote->atacante[i]) | bitTerritorioLote(lote->defensor[i]);
+        int onda = numOndas;
+        while (onda > 0 && (ocupadas[onda - 1] & territorios) == 0) {
+            onda--;
+        }
+        if (onda == numOndas) {
+            ocupadas[numOndas] = 0;
+            limites[numOndas++] = 0;
+        }
+        ocupadas[onda] |= territorios;
+        limites[onda]++;
+        resultados[i] = (uint16_t)(onda << LOTE_BITS_CODIGO | LOTE_INVALIDA);
+    }
+    
+    // Contagens viram limites; a posição de cada onda avança a partir do início
+    uint16_t proxima[LOTE_MAX_ORDENS];
+    for (int w = 0, soma = 0; w < numOndas; w++) {
+        proxima[w] = (uint16_t)soma;
+        soma += limites[w];
+        limites[w] = (uint16_t)soma;
+    }
+    for (int i = 0; i < numOrdens; i++) {
+        int k = proxima[LOTE_ONDA(resultados[i])]++;
+        porOnda->jogador[k] = lote->jogador[i];
+        porOnda->atacante[k] = lote->atacante[i];
+        porOnda->defensor[k] = lote->defensor[i];
+        porOnda->identificador[k] = lote->identificador[i];
+        origem[k] = (uint16_t)i;
+    }
+    porOnda->numOrdens = numOrdens;
+    return numOndas;
+}
+
+/**
+ * Verifica e rola os dados de um trecho de uma onda, sem alterar o estado
+ * 
+ * Pode rodar em paralelo com outros trechos da mesma onda: só lê o
+ * estado e escreve os resultados das próprias ordens. Os dados de cada
+ * ordem vêm de um gerador semeado por semente + identificador.
+ * 
+ * @param estado Estado antes da onda
+ * @param porOnda Ordens agrupadas por agruparOndasLote
+ * @param inicio Primeira ordem do trecho em porOnda
+ * @param fim Fim do trecho
+ * @param semente Semente do lote
+ * @param origem Posição no lote de cada ordem de porOnda
+ * @param resultados Resultados do lote (código BATALHA_* ou LOTE_INVALIDA)
+ */
+void avaliarOrdensLote(const EstadoSimulacao* estado, const LoteAtaques* porOnda, int inicio, int fim,
+                       uint64_t semente, const uint16_t* origem, uint16_t* resultados) {
+    uint32_t proprios[LOTE_JOGADORES];
+    uint8_t validas[LOTE_MAX_ORDENS / 8];
+    uint32_t fortes = mascarasEstadoLote(estado, proprios);
+    
+    pthread_once(&validacaoLoteEscolhida, escolherValidacaoLote);
+    validarOrdensLote(proprios, fortes, estado->numTerritorios, porOnda->jogador + inicio,
+                      porOnda->atacante + inicio, porOnda->defensor + inicio, fim - inicio, validas);
+    
+    for (int k = inicio; k < fim; k++) {
+        int codigo = LOTE_INVALIDA;
+        if ((validas[(k - inicio) >> 3] >> ((k - inicio) & 7)) & 1) {
+            GeradorAleatorio dados;
+            inicializarGerador(&dados, semente + porOnda->identificador[k]);
+            codigo = rolarBatalha(&dados);
+        }
+        uint16_t* resultado = &resultados[origem[k]];
+        *resultado = (uint16_t)((*resultado & ~LOTE_MASCARA_CODIGO) | codigo);
+    }
+}
+
+/**
+ * Aplica ao estado um trecho de onda já avaliado
+ * 
+ * @param estado Estado compacto
+ * @param regras Regras da partida
+ * @param porOnda Ordens agrupadas por agruparOndasLote
+ * @param inicio Primeira ordem do trecho em porOnda
+ * @param fim Fim do trecho
+ * @param origem Posição no lote de cada ordem de porOnda
+ * @param resultados Resultados do lote (avaliarOrdensLote)
+ * @return Batalhas aplicadas
+ */
+int aplicarOrdensLote(EstadoSimulacao* estado, const Regras* regras, const LoteAtaques* porOnda, int inicio,
+                      int fim, const uint16_t* origem, const uint16_t* resultados) {
+    int batalhas = 0;
+    for (int k = inicio; k < fim; k++) {
+        int codigo = resultados[origem[k]] & LOTE_MASCARA_CODIGO;
+        if (codigo != LOTE_INVALIDA) {
+            aplicarResultadoBatalha(estado, regras, porOnda->atacante[k], porOnda->defensor[k], codigo);
+            batalhas++;
+        }
+    }
+    return batalhas;
+}
+
+/**
+ * Resolve um lote de ordens de ataque, sem entrada/saída
+ * 
+ * Agrupa as ordens em ondas sem conflito e, onda a onda, verifica as
+ * ordens contra o estado atual (dono e tropas, de forma vetorizada),
+ * rola os dados e aplica os resultados. Ordens que perderam a
+ * validade em uma onda anterior ficam como LOTE_INVALIDA.
+ * 
+ * @param estado Estado compacto (modificado)
+ * @param regras Regras da partida
+ * @param lote Ordens em ordem de prioridade (até LOTE_MAX_ORDENS)
+ * @param semente Semente dos dados do lote
+ * @param resultados Saída, um uint16_t por ordem: onda << LOTE_BITS_CODIGO
+ *                   | BATALHA_EMPATE, BATALHA_CONQUISTA, BATALHA_DEFESA ou LOTE_INVALIDA
+ * @return Quantidade de ondas
+ */
+int resolverLoteAtaques(EstadoSimulacao* estado, const Regras* regras, const LoteAtaques* lote, uint64_t semente,
+                        uint16_t* resultados) {
+    LoteAtaques porOnda;
+    uint16_t origem[LOTE_MAX_ORDENS];
+    uint16_t limites[LOTE_MAX_ORDENS];
+    int numOndas = agruparOndasLote(lote, &porOnda, origem, limites, resultados);
+    
+    for (int w = 0, inicio = 0; w < numOndas; inicio = limites[w++]) {
+        avaliarOrdensLote(estado, &porOnda, inicio, limites[w], semente, origem, resultados);
+        aplicarOrdensLote(estado, regras, &porOnda, inicio, limites[w], origem, resultados);
+    }
+    return numOndas;
+}
+
+// ============================================================================
+// IMPLEMENTAÇÃO DAS FUNÇÕES - ORDENS SIMULTÂNEAS (RESOLUÇÃO PARALELA DETERMINÍSTICA)
+// ============================================================================
+
+/*
+ * Struct: PartidaSimultanea
+ * 
+ * Partida em rodadas simultâneas. Vive na pilha da tarefa que a joga;
+ * as subtarefas só escrevem nos próprios campos (as ordens pedidas pelo
+ * seu jogador ou os resultados das ordens do seu bloco).
+ * - pedidas: atacante e defensor de cada ordem de cada jogador, decididas
+ *   sobre o mesmo estado
+ * - porOnda/origem/resultados: o lote da rodada agrupado por
+ *   agruparOndasLote; o identificador de uma ordem é jogador *
+ *   ORDENS_POR_JOGADOR + posição, o que fixa seus dados junto com a
+ *   semente da partida e a rodada, qualquer que seja a thread
+ */
+typedef struct {
+    EstadoSimulacao estado;
+    ControladorJogador* controladores[MAX_JOGADORES];
+    uint64_t sementeDados;
+    int rodada;
+    uint8_t pedidas[MAX_JOGADORES][ORDENS_POR_JOGADOR][2];
+    int numPedidas[MAX_JOGADORES];
+    LoteAtaques porOnda;
+    uint16_t origem[LOTE_MAX_ORDENS];
+    uint16_t resultados[LOTE_MAX_ORDENS];
+    uint64_t sementeRodada;
+    int numOrdens;
+    long totalOrdens;
+    long batalhas;
+    long ondas;
+    long adiadas;               // Ordens fora da primeira onda (conflitos)
+} PartidaSimultanea;
+
+/*
+ * Struct: ItemSimultaneo
+ * 
+ * Tarefa do pool dentro de uma rodada: a decisão de um jogador ou um
+ * bloco [inicio, fim) das ordens de uma onda.
+ */
+typedef struct {
+    TarefaPool tarefa;
+    PartidaSimultanea* partida;
+    int jogador;
+    int inicio;
+    int fim;
+} ItemSimultaneo;
+
+/*
+ * Struct: EstatisticasSimultaneo
+ * 
+ * Totais das partidas terminadas por um trabalhador do pool, nas
+ * estatísticas locais dele (sem atômicos nem linhas de cache
+ * disputadas entre nós); somados ao fim da execução.
+ * - assinatura: XOR dos hashes finais das partidas (independe da ordem
+ *   em que terminam, então compara execuções com threads diferentes)
+ */
+typedef struct {
+    long vitorias[MAX_JOGADORES];
+    long empates;
+    long rodadas;
+    long ordens;
+    long batalhas;
+    long ondas;
+    long adiadas;
+    uint64_t assinatura;
+} EstatisticasSimultaneo;
+
+/*
+ * Struct: TrabalhoSimultaneo
+ * 
+ * Dados compartilhados do modo simultâneo. A raiz bifurca blocos de
+ * SIMULTANEO_BLOCO partidas; cada rodada bifurca decisões e ondas.
+ */
+typedef struct {
+    const char* politica;
+    const OpcoesSimulacao* opcoes;
+    struct BlocoSimultaneo* blocos;
+    long numBlocos;
+    atomic_bool erro;
+} TrabalhoSimultaneo;
+
+/*
+ * Struct: BlocoSimultaneo
+ * 
+ * Tarefa do pool com SIMULTANEO_BLOCO partidas consecutivas.
+ */
+typedef struct BlocoSimultaneo {
+    TarefaPool tarefa;
+    TrabalhoSimultaneo* trabalho;
+    long indice;
+} BlocoSimultaneo;
+
+/**
+ * Tarefa de decisão: as ordens de um jogador para a rodada
+ * 
+ * O controlador é consultado até ORDENS_POR_JOGADOR vezes sobre uma
+ * cópia do estado em que ele é o jogador da vez; cada atacante já
+ * comprometido fica com 1 tropa na cópia e sai das próximas escolhas.
+ * 
+ * @param trabalhador Trabalhador do pool (não usado: a decisão é folha)
+ * @param argumento Ponteiro para o ItemSimultaneo do jogador
+ */
+static void decidirOrdensSimultaneas(TrabalhadorPool* trabalhador, void* argumento) {
+    (void)trabalhador;
+    ItemSimultaneo* item = (ItemSimultaneo*)argumento;
+    PartidaSimultanea* partida = item->partida;
+    ControladorJogador* controlador = partida->controladores[item->jogador];
+    int jogador = item->jogador;
+    EstadoSimulacao visao = partida->estado;
+    
+    definirJogadorDaVez(&visao, jogador);
+    for (int k = 0; k < ORDENS_POR_JOGADOR; k++) {
+        int atacante, defensor;
+        if (!controlador->decidirAtaque(controlador, &visao, &atacante, &defensor) ||
+            atacante < 0 || atacante >= visao.numTerritorios || defensor < 0 || defensor >= visao.numTerritorios ||
+            visao.dono[atacante] != jogador || visao.tropas[atacante] <= 1 || visao.dono[defensor] == jogador) {
+            break;
+        }
+        partida->pedidas[jogador][k][0] = (uint8_t)atacante;
+        partida->pedidas[jogador][k][1] = (uint8_t)defensor;
+        partida->numPedidas[jogador]++;
+        definirTropasEstado(&visao, atacante, 1);
+    }
+}
+
+/**
+ * Tarefa de resolução: verifica e rola os dados de um bloco de uma onda
+ * 
+ * @param trabalhador Trabalhador do pool (não usado: o bloco é folha)
+ * @param argumento Ponteiro para o ItemSimultaneo do bloco
+ */
+static void resolverBlocoOnda(TrabalhadorPool* trabalhador, void* argumento) {
+    (void)trabalhador;
+    ItemSimultaneo* item = (ItemSimultaneo*)argumento;
+    PartidaSimultanea* partida = item->partida;
+    avaliarOrdensLote(&partida->estado, &partida->porOnda, item->inicio, item->fim, partida->sementeRodada,
+                      partida->origem, partida->resultados);
+}
+
+/**
+ * Verifica se nenhum território pode mais atacar
+ * 
+ * Sem reforços, um mapa em que todos têm 1 tropa não muda mais; a
+ * partida termina sem vencedor em vez de esperar o limite de rodadas.
+ * 
+ * @param estado Estado compacto
+ * @return true se nenhum território tem mais de 1 tropa
+ */
+static bool mapaTravadoSimultaneo(const EstadoSimulacao* estado) {
+    for (int i = 0; i < estado->numTerritorios; i++) {
+        if (estado->tropas[i] > 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Joga uma rodada simultânea
+ * 
+ * 1. Cada jogador ativo decide suas ordens sobre o mesmo estado (uma
+ *    tarefa por jogador).
+ * 2. As ordens formam um lote em ordem de prioridade, que gira a cada
+ *    rodada (jogador rodada % n primeiro), agrupado em ondas sem
+ *    conflito por agruparOndasLote.
+ * 3. Cada onda é verificada e tem os dados rolados em blocos paralelos
+ *    de ORDENS_BLOCO ordens, e é aplicada em ordem de prioridade depois
+ *    do join.
+ * O resultado depende só do estado, das decisões e das sementes, nunca
+ * do número de threads.
+ * 
+ * @param trabalhador Trabalhador que joga a partida
+ * @param partida Partida em andamento
+ * @param regras Regras da partida
+ */
+static void jogarRodadaSimultanea(TrabalhadorPool* trabalhador, PartidaSimultanea* partida, const Regras* regras) {
+    EstadoSimulacao* estado = &partida->estado;
+    int numJogadores = estado->numJogadores;
+    ItemSimultaneo itens[MAX_JOGADORES * ORDENS_POR_JOGADOR];
+    GrupoTarefas grupo;
+    atomic_init(&grupo.pendentes, 0);
+    
+    // 1. Decisões em paralelo; a última roda na própria tarefa
+    int ultimo = -1;
+    for (int j = 0; j < numJogadores; j++) {
+        partida->numPedidas[j] = 0;
+        if (!estado->ativo[j]) {
+            continue;
+        }
+        ItemSimultaneo* item = &itens[j];
+        item->tarefa.executar = decidirOrdensSimultaneas;
+        item->tarefa.argumento = item;
+        item->partida = partida;
+        item->jogador = j;
+        if (ultimo >= 0) {
+            bifurcarTarefa(trabalhador, &grupo, &itens[ultimo].tarefa);
+        }
+        ultimo = j;
+    }
+    if (ultimo >= 0) {
+        decidirOrdensSimultaneas(trabalhador, &itens[ultimo]);
+    }
+    aguardarGrupo(trabalhador, &grupo);
+    
+    // 2. Prioridade e ondas (agruparOndasLote)
+    LoteAtaques lote;
+    uint16_t limites[LOTE_MAX_ORDENS];
+    lote.numOrdens = 0;
+    for (int p = 0; p < numJogadores; p++) {
+        int j = (partida->rodada + p) % numJogadores;
+        for (int k = 0; k < partida->numPedidas[j]; k++) {
+            lote.jogador[lote.numOrdens] = (uint8_t)j;
+            lote.atacante[lote.numOrdens] = partida->pedidas[j][k][0];
+            lote.defensor[lote.numOrdens] = partida->pedidas[j][k][1];
+            lote.identificador[lote.numOrdens] = (uint16_t)(j * ORDENS_POR_JOGADOR + k);
+            lote.numOrdens++;
+        }
+    }
+    int numOrdens = lote.numOrdens;
+    int numOndas = agruparOndasLote(&lote, &partida->porOnda, partida->origem, limites, partida->resultados);
+    partida->sementeRodada = partida->sementeDados * 0x9E3779B97F4A7C15ULL + ((uint64_t)partida->rodada << 8);
+    partida->numOrdens = numOrdens;
+    if (numOndas > 0) {
+        partida->adiadas += numOrdens - limites[0];
+    }
+    
+    // 3. Ondas: verificação e dados em paralelo, aplicação em ordem de prioridade
+    for (int inicio = 0, w = 0; w < numOndas; inicio = limites[w++]) {
+        int fim = limites[w];
+        int numBlocos = 0;
+        for (int b = inicio; b < fim; b += ORDENS_BLOCO) {
+            ItemSimultaneo* item = &itens[numBlocos++];
+            item->tarefa.executar = resolverBlocoOnda;
+            item->tarefa.argumento = item;
+            item->partida = partida;
+            item->inicio = b;
+            item->fim = (b + ORDENS_BLOCO < fim) ? b + ORDENS_BLOCO : fim;
+            if (item->fim < fim) {
+                bifurcarTarefa(trabalhador, &grupo, &item->tarefa);
+            } else {
+                resolverBlocoOnda(trabalhador, item);
+            }
+        }
+        aguardarGrupo(trabalhador, &grupo);
+        partida->batalhas += aplicarOrdensLote(estado, regras, &partida->porOnda, inicio, fim,
+                                               partida->origem, partida->resultados);
+    }
+    
+    partida->totalOrdens += numOrdens;
+    partida->ondas += numOndas;
+    partida->rodada++;
+}
+
+/**
+ * Tarefa de um bloco de partidas simultâneas
+ * 
+ * Mesmas sementes das demais simulações: preparo em *3, dados em *3 + 1
+ * e bots em *31 + jogador.
+ * 
+ * @param trabalhador Trabalhador do pool (bifurca as rodadas; recebe os totais)
+ * @param argumento Ponteiro para o BlocoSimultaneo
+ */
+static void jogarBlocoSimultaneo(TrabalhadorPool* trabalhador, void* argumento) {
+    BlocoSimultaneo* bloco = (BlocoSimultaneo*)argumento;
+    TrabalhoSimultaneo* trabalho = bloco->trabalho;
+    const OpcoesSimulacao* opcoes = trabalho->opcoes;
+    EstatisticasSimultaneo* estatisticas = (EstatisticasSimultaneo*)trabalhador->local;
+    long inicio = bloco->indice * SIMULTANEO_BLOCO;
+    long fim = inicio + SIMULTANEO_BLOCO;
+    if (fim > opcoes->numJogos) fim = opcoes->numJogos;
+    
+    for (long jogo = inicio; jogo < fim; jogo++) {
+        PartidaSimultanea partida;
+        GeradorAleatorio preparo;
+        uint64_t semente = opcoes->semente + (uint64_t)jogo;
+        bool criados = true;
+        
+        memset(&partida, 0, sizeof(partida));
+        inicializarGerador(&preparo, semente * 3);
+        gerarPartidaAleatoria(&partida.estado, &regrasPadrao, opcoes->numJogadores, opcoes->numTerritorios, &preparo);
+        partida.sementeDados = semente * 3 + 1;
+        for (int j = 0; j < opcoes->numJogadores; j++) {
+            partida.controladores[j] = criarControlador(trabalho->politica, semente * 31 + (uint64_t)j);
+            criados = criados && partida.controladores[j] != NULL;
+        }
+        
+        int vencedor = -1;
+        while (criados && (vencedor = verificarVencedorEstado(&partida.estado, &regrasPadrao)) == -1 &&
+               partida.rodada < ROLLOUT_MAX_TURNOS && !mapaTravadoSimultaneo(&partida.estado)) {
+            jogarRodadaSimultanea(trabalhador, &partida, &regrasPadrao);
+        }
+        
+        for (int j = 0; j < opcoes->numJogadores; j++) {
+            if (partida.controladores[j] != NULL) {
+                partida.controladores[j]->liberar(partida.controladores[j]);
+            }
+        }
+        if (!criados) {
+            atomic_store(&trabalho->erro, true);
+            return;
+        }
+        if (vencedor >= 0) estatisticas->vitorias[vencedor]++;
+        else estatisticas->empates++;
+        estatisticas->rodadas += partida.rodada;
+        estatisticas->ordens += partida.totalOrdens;
+        estatisticas->batalhas += partida.batalhas;
+        estatisticas->ondas += partida.ondas;
+        estatisticas->adiadas += partida.adiadas;
+        // Multiplicador ímpar por partida: estados iguais em partidas diferentes não se cancelam
+        estatisticas->assinatura ^= partida.estado.hash * (2 * (uint64_t)jogo + 1);
+    }
+}
+
+/**
+ * Raiz do modo simultâneo: bifurca os blocos de partidas
+ * 
+ * @param trabalhador Trabalhador 0 do pool
+ * @param argumento Ponteiro para o TrabalhoSimultaneo
+ */
+static void executarRaizSimultaneo(TrabalhadorPool* trabalhador, void* argumento) {
+    TrabalhoSimultaneo* trabalho = (TrabalhoSimultaneo*)argumento;
+    GrupoTarefas grupo;
+    atomic_init(&grupo.pendentes, 0);
+    
+    for (long b = 0; b < trabalho->numBlocos; b++) {
+        bifurcarTarefa(trabalhador, &grupo, &trabalho->blocos[b].tarefa);
+    }
+    aguardarGrupo(trabalhador, &grupo);
+}
+
+/**
+ * Joga partidas em rodadas simultâneas entre bots
+ * 
+ * Em cada rodada todos os jogadores enviam até ORDENS_POR_JOGADOR
+ * ordens; batalhas sem territórios em comum são resolvidas em paralelo
+ * e conflitos seguem a prioridade da rodada (ver jogarRodadaSimultanea).
+ * Partidas, decisões e ondas são tarefas aninhadas no pool de roubo de
+ * tarefas. A assinatura final é a mesma para qualquer --threads.
+ * 
+ * @param politica Bot de todos os jogadores (aleatorio, estrategista, heuristico)
+ * @param opcoes Partidas, jogadores, territórios, semente e posicionamento NUMA
+ * @param numThreads Trabalhadores do pool
+ * @param medicao Saída opcional para a bancada NUMA (NULL ignora)
+ */
+void executarSimultaneo(const char* politica, const OpcoesSimulacao* opcoes, int numThreads, MedicaoNuma* medicao) {
+    TrabalhoSimultaneo trabalho;
+    ControladorJogador* teste = criarControlador(politica, 0);
+    
+    if (teste == NULL) {
+        return;
+    }
+    // Bots com busca própria não cabem numa cópia por partida e por jogador
+    bool leve = !controladorEhHumano(teste) && (strcmp(politica, "aleatorio") == 0 ||
+                strcmp(politica, "estrategista") == 0 || strncmp(politica, "heuristico", 10) == 0);
+    teste->liberar(teste);
+    if (!leve) {
+        printf("❌ Erro: O modo simultâneo aceita apenas aleatorio, estrategista ou heuristico\n");
+        return;
+    }
+    
+    memset(&trabalho, 0, sizeof(trabalho));
+    trabalho.politica = politica;
+    trabalho.opcoes = opcoes;
+    trabalho.numBlocos = (opcoes->numJogos + SIMULTANEO_BLOCO - 1) / SIMULTANEO_BLOCO;
+    trabalho.blocos = (BlocoSimultaneo*)calloc(trabalho.numBlocos, sizeof(BlocoSimultaneo));
+    PoolTrabalho* pool = criarPoolTrabalho(numThreads, opcoes->semente, sizeof(EstatisticasSimultaneo),
+                                           opcoes->numaIngenuo);
+    if (trabalho.blocos == NULL || pool == NULL) {
+        printf("❌ Erro: Falha na alocação de memória para o modo simultâneo!\n");
+        free(trabalho.blocos);
+        liberarPoolTrabalho(pool);
+        return;
+    }
+    for (long b = 0; b < trabalho.numBlocos; b++) {
+        trabalho.blocos[b].tarefa.executar = jogarBlocoSimultaneo;
+        trabalho.blocos[b].tarefa.argumento = &trabalho.blocos[b];
+        trabalho.blocos[b].trabalho = &trabalho;
+        trabalho.blocos[b].indice = b;
+    }
+    
+    printf("\n⚔️  ═══════════════════════════════════════════════════════════\n");
+    printf("              RODADAS COM ORDENS SIMULTÂNEAS\n");
+    printf("═══════════════════════════════════════════════════════════⚔️\n");
+    printf("🤖 Política: %s | %ld partidas | %d jogadores | %d territórios | até %d ordens por jogador | %d threads\n",
+           politica, opcoes->numJogos, opcoes->numJogadores, opcoes->numTerritorios, ORDENS_POR_JOGADOR,
+           pool->numTrabalhadores);
+    
+    long inicio = instanteNs();
+    executarRaizPool(pool, executarRaizSimultaneo, &trabalho);
+    double segundos = (instanteNs() - inicio) / 1e9;
+    
+    long executadas = 0, roubadas = 0;
+    EstatisticasSimultaneo total;
+    memset(&total, 0, sizeof(total));
+    for (int i = 0; i <= pool->iniciados; i++) {
+        const EstatisticasSimultaneo* local = (const EstatisticasSimultaneo*)pool->trabalhadores[i].local;
+        executadas += pool->trabalhadores[i].executadas;
+        roubadas += pool->trabalhadores[i].roubadas;
+        for (int j = 0; j < MAX_JOGADORES; j++) {
+            total.vitorias[j] += local->vitorias[j];
+        }
+        total.empates += local->empates;
+        total.rodadas += local->rodadas;
+        total.ordens += local->ordens;
+        total.batalhas += local->batalhas;
+        total.ondas += local->ondas;
+        total.adiadas += local->adiadas;
+        total.assinatura ^= local->assinatura;
+    }
+    long paginas;
+    long paginasRemotas = contarPaginasRemotasPool(pool, &paginas);
+    liberarPoolTrabalho(pool);
+    free(trabalho.blocos);
+    
+    if (atomic_load(&trabalho.erro)) {
+        printf("❌ Erro: Falha ao criar os bots das partidas!\n");
+        return;
+    }
+    long rodadas = total.rodadas;
+    long ordens = total.ordens;
+    printf("⏱️  %.2f s | %ld rodadas (%.0f/s) | %ld ordens | %ld batalhas resolvidas\n",
+           segundos, rodadas, rodadas / (segundos > 0 ? segundos : 1e-9), ordens, total.batalhas);
+    printf("🌊 Ondas por rodada: %.2f | ordens adiadas por conflito: %.1f%%\n",
+           (double)total.ondas / (rodadas > 0 ? rodadas : 1), 100.0 * total.adiadas / (ordens > 0 ? ordens : 1));
+    printf("🏆 Sem vencedor: %ld | vitórias por posição:", total.empates);
+    for (int j = 0; j < opcoes->numJogadores; j++) {
+        printf(" %ld", total.vitorias[j]);
+    }
+    printf("\n");
+    printf("🔏 Assinatura dos estados finais: %016llx\n", (unsigned long long)total.assinatura);
+    printf("🔀 Tarefas: %ld executadas, %ld roubadas entre trabalhadores\n", executadas, roubadas);
+    exibirPosicionamentoNuma(opcoes->numaIngenuo, paginas, paginasRemotas);
+    if (medicao != NULL) {
+        medicao->segundos = segundos;
+        medicao->paginas = paginas;
+        medicao->paginasRemotas = paginasRemotas;
+    }
+}
+
+// ============================================================================
+// IMPLEMENTAÇÃO DAS FUNÇÕES - MAPA MASSIVO EM SHARDS (TROCA DE HALO)
+// ============================================================================
+
+#define MASSIVO_FIM_TURNO UINT32_MAX  // Coluna que fecha as mudanças de um turno na fila
+
+/*
+ * Struct: MudancaHalo
+ * 
+ * Território da borda de um shard que mudou no turno, enviado ao
+ * vizinho que guarda a mesma linha como halo.
+ */
+typedef struct {
+    uint32_t coluna;            // MASSIVO_FIM_TURNO encerra o turno
+    uint16_t tropas;
+    uint8_t dono;
+    uint8_t reservado;
+} MudancaHalo;
+
+/*
+ * Struct: FilaHalo
+ * 
+ * Fila circular sem bloqueio com um produtor (o shard vizinho) e um
+ * consumidor (o dono da fila). Comporta as mudanças de dois turnos: a
+ * barreira do turno impede o produtor de abrir vantagem maior.
+ */
+typedef struct {
+    _Alignas(64) atomic_size_t cabeca;  // Só o consumidor escreve
+    _Alignas(64) atomic_size_t cauda;   // Só o produtor escreve
+    _Alignas(64) MudancaHalo* itens;
+    size_t mascara;
+} FilaHalo;
+
+/*
+ * Struct: ShardMassivo
+ * 
+ * Faixa de linhas consecutivas do mapa massivo, com a thread que a
+ * resolve. O shard guarda uma linha de halo acima e outra abaixo das
+ * suas: cópias das bordas dos vizinhos, atualizadas pelas filas.
+ * - dono/tropas: (numLinhas + 2) linhas de largura territórios; as
+ *   linhas 0 e numLinhas + 1 são o halo
+ * - donoBorda/tropasBorda: primeira e última linha próprias no início
+ *   do turno, para enviar só o que mudou
+ * - entrada: mudanças vindas do vizinho de cima [0] e de baixo [1]
+ * - no: nó NUMA em que a thread do shard terminou
+ */
+typedef struct {
+    struct MapaMassivo* mapa;
+    int indice;
+    long linhaInicial;
+    long numLinhas;
+    pthread_t thread;
+    uint8_t* dono;
+    uint16_t* tropas;
+    uint8_t* donoBorda;
+    uint16_t* tropasBorda;
+    FilaHalo entrada[2];
+    long batalhas;
+    long conquistas;
+    long mudancasEnviadas;
+    long territorios[MAX_JOGADORES];
+    uint64_t assinatura;
+    int no;
+} ShardMassivo;
+
+/*
+ * Struct: MapaMassivo
+ * 
+ * Grade largura x altura de territórios (vizinhos nas quatro direções)
+ * dividida em shards horizontais, um por thread.
+ * - ingenuo: nenhuma thread é fixada (linha de base da bancada NUMA);
+ *   cada thread ainda aloca o próprio shard, como antes da fixação
+ * - batalhas a residenteKB: totais de uma execução, somados dos shards
+ */
+typedef struct MapaMassivo {
+    int largura;
+    long altura;
+    int numJogadores;
+    uint64_t semente;
+    int turnos;
+    ShardMassivo* shards;
+    int numShards;
+    pthread_barrier_t barreira;
+    atomic_int partida;         // 0 aguardando as threads, 1 iniciar, -1 cancelar
+    atomic_bool erro;
+    long inicioNs;
+    long fimNs;
+    bool ingenuo;
+    bool fixouPrincipal;
+    cpu_set_t afinidadePrincipal;       // Da thread principal (shard 0), restaurada no fim
+    long batalhas;
+    long conquistas;
+    long mudancas;
+    long territorios[MAX_JOGADORES];
+    uint64_t assinatura;
+    long paginas;
+    long paginasRemotas;
+    long residenteKB;
+} MapaMassivo;
+
+/**
+ * Coloca uma mudança na fila do vizinho (só o produtor chama)
+ * 
+ * @param fila Fila de entrada do vizinho
+ * @param mudanca Território alterado ou marca de fim de turno
+ */
+static void enfileirarMudancaHalo(FilaHalo* fila, MudancaHalo mudanca) {
+    size_t cauda = atomic_load_explicit(&fila->cauda, memory_order_relaxed);
+    while (cauda - atomic_load_explicit(&fila->cabeca, memory_order_acquire) > fila->mascara) {
+        sched_yield();
+    }
+    fila->itens[cauda & fila->mascara] = mudanca;
+    atomic_store_explicit(&fila->cauda, cauda + 1, memory_order_release);
+}
+
+/**
+ * Retira a próxima mudança da fila (só o dono da fila chama)
+ * 
+ * @param fila Fila de entrada do shard
+ * @return Mudança mais antiga
+ */
+static MudancaHalo retirarMudancaHalo(FilaHalo* fila) {
+    size_t cabeca = atomic_load_explicit(&fila->cabeca, memory_order_relaxed);
+    while (cabeca == atomic_load_explicit(&fila->cauda, memory_order_acquire)) {
+        sched_yield();
+    }
+    MudancaHalo mudanca = fila->itens[cabeca & fila->mascara];
+    atomic_store_explicit(&fila->cabeca, cabeca + 1, memory_order_release);
+    return mudanca;
+}
+
+/**
+ * Distribuição inicial de um território do mapa massivo
+ * 
+ * Depende só da semente e da posição, então cada shard monta suas
+ * linhas e o halo sem consultar os vizinhos. Os donos vêm em blocos de
+ * MASSIVO_BLOCO_DONO x MASSIVO_BLOCO_DONO territórios, o que forma
+ * frentes de batalha em vez de um mapa salpicado.
+ * 
+ * @param mapa Dimensões, jogadores e semente
+ * @param linha Linha global do território
+ * @param coluna Coluna do território
+ * @param dono Saída: jogador dono
+ * @param tropas Saída: tropas iniciais
+ */
+static void sortearTerritorioMassivo(const MapaMassivo* mapa, long linha, int coluna, uint8_t* dono,
+                                     uint16_t* tropas) {
+    long blocosPorLinha = (mapa->largura + MASSIVO_BLOCO_DONO - 1) / MASSIVO_BLOCO_DONO;
+    long bloco = (linha / MASSIVO_BLOCO_DONO) * blocosPorLinha + coluna / MASSIVO_BLOCO_DONO;
+    long celula = linha * mapa->largura + coluna;
+    GeradorAleatorio gerador;
+    
+    // Sementes pares para os blocos e ímpares para os territórios: nunca coincidem
+    inicializarGerador(&gerador, mapa->semente * 3 + 2 * (uint64_t)bloco);
+    *dono = (uint8_t)sortearIntervalo(&gerador, mapa->numJogadores);
+    inicializarGerador(&gerador, mapa->semente * 3 + 2 * (uint64_t)celula + 1);
+    *tropas = (uint16_t)(regrasPadrao.tropasIniciaisMin +
+                         sortearIntervalo(&gerador, regrasPadrao.tropasIniciaisMax - regrasPadrao.tropasIniciaisMin + 1));
+}
+
+/**
+ * Resolve a batalha entre dois territórios vizinhos do mapa massivo
+ * 
+ * O mais forte ataca (empate: o primeiro do par) com os dados de
+ * rolarBatalha e as tropas de tropasAposBatalha, como no estado compacto.
+ * Os dados vêm só da semente do par, então os dois shards de uma
+ * fronteira chegam ao mesmo resultado para o par que a cruza.
+ * 
+ * @param dono Donos do shard (com halo)
+ * @param tropas Tropas do shard (com halo)
+ * @param a Índice local do primeiro território do par
+ * @param b Índice local do segundo território do par
+ * @param semente Semente do par neste turno
+ * @return BATALHA_CONQUISTA, BATALHA_DEFESA, BATALHA_EMPATE ou BATALHA_INVALIDA (sem batalha)
+ */
+static int resolverParMassivo(uint8_t* dono, uint16_t* tropas, size_t a, size_t b, uint64_t semente) {
+    if (dono[a] == dono[b]) {
+        return BATALHA_INVALIDA;
+    }
+    size_t atacante = (tropas[a] >= tropas[b]) ? a : b;
+    size_t defensor = (atacante == a) ? b : a;
+    if (tropas[atacante] <= 1) {
+        return BATALHA_INVALIDA;
+    }
+    
+    GeradorAleatorio dados;
+    inicializarGerador(&dados, semente);
+    int resultado = rolarBatalha(&dados);
+    int tropasDefensor = 0;
+    tropas[atacante] = (uint16_t)tropasAposBatalha(&regrasPadrao, resultado, tropas[atacante], &tropasDefensor);
+    if (resultado == BATALHA_CONQUISTA) {
+        dono[defensor] = dono[atacante];
+        tropas[defensor] = (uint16_t)tropasDefensor;
+    }
+    return resultado;
+}
+
+/**
+ * Envia ao vizinho os territórios de uma borda que mudaram no turno
+ * 
+ * @param shard Shard produtor
+ * @param linhaLocal Linha própria da borda (1 ou numLinhas)
+ * @param lado Cópia da borda no início do turno (0 primeira, 1 última)
+ * @param destino Fila de entrada do vizinho
+ */
+static void enviarBordaMassiva(ShardMassivo* shard, long linhaLocal, int lado, FilaHalo* destino) {
+    int largura = shard->mapa->largura;
+    const uint8_t* dono = shard->dono + linhaLocal * largura;
+    const uint16_t* tropas = shard->tropas + linhaLocal * largura;
+    const uint8_t* donoAntes = shard->donoBorda + lado * largura;
+    const uint16_t* tropasAntes = shard->tropasBorda + lado * largura;
+    
+    for (int x = 0; x < largura; x++) {
+        if (dono[x] != donoAntes[x] || tropas[x] != tropasAntes[x]) {
+            MudancaHalo mudanca = {.coluna = (uint32_t)x, .tropas = tropas[x], .dono = dono[x]};
+            enfileirarMudancaHalo(destino, mudanca);
+            shard->mudancasEnviadas++;
+        }
+    }
+    MudancaHalo fim = {.coluna = MASSIVO_FIM_TURNO};
+    enfileirarMudancaHalo(destino, fim);
+}
+
+/**
+ * Aplica ao halo as mudanças de um turno recebidas de um vizinho
+ * 
+ * @param shard Shard consumidor
+ * @param linhaLocal Linha de halo (0 ou numLinhas + 1)
+ * @param fila Fila de entrada do lado correspondente
+ */
+static void receberHaloMassivo(ShardMassivo* shard, long linhaLocal, FilaHalo* fila) {
+    size_t base = (size_t)linhaLocal * shard->mapa->largura;
+    for (;;) {
+        MudancaHalo mudanca = retirarMudancaHalo(fila);
+        if (mudanca.coluna == MASSIVO_FIM_TURNO) {
+            return;
+        }
+        shard->dono[base + mudanca.coluna] = mudanca.dono;
+        shard->tropas[base + mudanca.coluna] = mudanca.tropas;
+    }
+}
+
+/**
+ * Aloca e preenche a memória de um shard
+ * 
+ * Roda na thread do shard. Com posicionamento local ela já está fixada
+ * num núcleo, então as linhas e a fila de entrada ficam no nó de quem
+ * as usa; no ingênuo a thread pode migrar depois de tocá-las.
+ * 
+ * @param shard Shard a preparar
+ * @return true se toda a memória foi alocada
+ */
+static bool prepararShardMassivo(ShardMassivo* shard) {
+    const MapaMassivo* mapa = shard->mapa;
+    int largura = mapa->largura;
+    size_t celulas = (size_t)(shard->numLinhas + 2) * largura;
+    size_t capacidade = 1;
+    while (capacidade < 2 * ((size_t)largura + 1)) capacidade <<= 1;
+    
+    shard->dono = (uint8_t*)malloc(celulas);
+    shard->tropas = (uint16_t*)malloc(celulas * sizeof(uint16_t));
+    shard->donoBorda = (uint8_t*)malloc(2 * (size_t)largura);
+    shard->tropasBorda = (uint16_t*)malloc(2 * (size_t)largura * sizeof(uint16_t));
+    for (int lado = 0; lado < 2; lado++) {
+        atomic_init(&shard->entrada[lado].cabeca, 0);
+        atomic_init(&shard->entrada[lado].cauda, 0);
+        shard->entrada[lado].itens = (MudancaHalo*)malloc(capacidade * sizeof(MudancaHalo));
+        shard->entrada[lado].mascara = capacidade - 1;
+    }
+    if (shard->dono == NULL || shard->tropas == NULL || shard->donoBorda == NULL || shard->tropasBorda == NULL ||
+        shard->entrada[0].itens == NULL || shard->entrada[1].itens == NULL) {
+        return false;
+    }
+    
+    for (long i = 0; i <= shard->numLinhas + 1; i++) {
+        long linha = shard->linhaInicial + i - 1;
+        size_t base = (size_t)i * largura;
+        for (int x = 0; x < largura; x++) {
+            if (linha >= 0 && linha < mapa->altura) {
+                sortearTerritorioMassivo(mapa, linha, x, &shard->dono[base + x], &shard->tropas[base + x]);
+            } else {
+                shard->dono[base + x] = 0;      // Fora do mapa: nunca participa de pares
+                shard->tropas[base + x] = 0;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Um turno do shard: reforço, pares da vez e envio das bordas
+ * 
+ * Turnos pares usam pares horizontais e ímpares, verticais; a paridade
+ * (turno / 2) escolhe quais colunas ou linhas abrem o par. Assim cada
+ * território participa de no máximo uma batalha por turno e o novo
+ * estado depende só do par. O par vertical que cruza a fronteira é
+ * resolvido pelos dois shards (ambos têm os dois territórios, um deles
+ * no halo) e contado só pelo de cima.
+ * 
+ * @param shard Shard da thread
+ * @param turno Turno atual
+ */
+static void jogarTurnoShardMassivo(ShardMassivo* shard, int turno) {
+    MapaMassivo* mapa = shard->mapa;
+    int largura = mapa->largura;
+    long numLinhas = shard->numLinhas;
+    uint8_t* dono = shard->dono;
+    uint16_t* tropas = shard->tropas;
+    long paridade = (turno / 2) & 1;
+    uint64_t sementeTurno = (mapa->semente * 3 + 1) * 0x9E3779B97F4A7C15ULL +
+                            (uint64_t)turno * (uint64_t)(mapa->altura * largura);
+    
+    // Reforço também no halo (o vizinho reforça antes de resolver os pares da fronteira),
+    // exceto nas linhas de fora do mapa acima do primeiro shard e abaixo do último
+    if (turno % MASSIVO_REFORCO == 0) {
+        size_t primeira = (shard->indice == 0) ? (size_t)largura : 0;
+        size_t fim = (size_t)(numLinhas + (shard->indice == mapa->numShards - 1 ? 1 : 2)) * largura;
+        for (size_t c = primeira; c < fim; c++) {
+            if (tropas[c] < MASSIVO_MAX_TROPAS) tropas[c]++;
+        }
+    }
+    
+    // Bordas depois do reforço, que o halo já recebeu: só as batalhas geram mudanças
+    memcpy(shard->donoBorda, dono + largura, (size_t)largura);
+    memcpy(shard->donoBorda + largura, dono + numLinhas * largura, (size_t)largura);
+    memcpy(shard->tropasBorda, tropas + largura, (size_t)largura * sizeof(uint16_t));
+    memcpy(shard->tropasBorda + largura, tropas + numLinhas * largura, (size_t)largura * sizeof(uint16_t));
+    
+    if ((turno & 1) == 0) {
+        for (long i = 1; i <= numLinhas; i++) {
+            uint64_t celulaLinha = (uint64_t)(shard->linhaInicial + i - 1) * largura;
+            for (long x = paridade; x + 1 < largura; x += 2) {
+                size_t a = (size_t)i * largura + x;
+                int resultado = resolverParMassivo(dono, tropas, a, a + 1, sementeTurno + celulaLinha + x);
+                if (resultado != BATALHA_INVALIDA) shard->batalhas++;
+                if (resultado == BATALHA_CONQUISTA) shard->conquistas++;
+            }
+        }
+    } else {
+        for (long i = 0; i <= numLinhas; i++) {
+            long linha = shard->linhaInicial + i - 1;
+            if (linha < 0 || linha + 1 >= mapa->altura || (linha & 1) != paridade) {
+                continue;
+            }
+            for (long x = 0; x < largura; x++) {
+                size_t a = (size_t)i * largura + x;
+                int resultado = resolverParMassivo(dono, tropas, a, a + largura,
+                                                   sementeTurno + (uint64_t)linha * largura + x);
+                if (i >= 1 && resultado != BATALHA_INVALIDA) shard->batalhas++;
+                if (i >= 1 && resultado == BATALHA_CONQUISTA) shard->conquistas++;
+            }
+        }
+    }
+    
+    if (shard->indice > 0) {
+        enviarBordaMassiva(shard, 1, 0, &mapa->shards[shard->indice - 1].entrada[1]);
+    }
+    if (shard->indice < mapa->numShards - 1) {
+        enviarBordaMassiva(shard, numLinhas, 1, &mapa->shards[shard->indice + 1].entrada[0]);
+    }
+}
+
+/**
+ * Thread de um shard: prepara a faixa e joga todos os turnos
+ * 
+ * Entre turnos há uma barreira; depois dela as mudanças do vizinho já
+ * estão na fila e o halo é atualizado antes do próximo turno.
+ * 
+ * @param argumento Ponteiro para o ShardMassivo
+ * @return NULL
+ */
+static void* executarShardMassivo(void* argumento) {
+    ShardMassivo* shard = (ShardMassivo*)argumento;
+    MapaMassivo* mapa = shard->mapa;
+    int partida;
+    
+    // A barreira só vale depois que todas as threads existem
+    while ((partida = atomic_load(&mapa->partida)) == 0) {
+        sched_yield();
+    }
+    if (partida < 0) {
+        return NULL;
+    }
+    if (!mapa->ingenuo) {
+        // Shards vizinhos ficam no mesmo nó sempre que possível: a fronteira entre nós é uma só
+        int no = fixarThreadNucleo(shard->indice, mapa->numShards,
+                                   (shard->indice == 0) ? &mapa->afinidadePrincipal : NULL);
+        if (shard->indice == 0) mapa->fixouPrincipal = no >= 0;
+    }
+    if (!prepararShardMassivo(shard)) {
+        atomic_store(&mapa->erro, true);
+    }
+    pthread_barrier_wait(&mapa->barreira);
+    if (atomic_load(&mapa->erro)) {
+        return NULL;
+    }
+    if (shard->indice == 0) {
+        mapa->inicioNs = instanteNs();
+    }
+    
+    for (int turno = 0; turno < mapa->turnos; turno++) {
+        jogarTurnoShardMassivo(shard, turno);
+        pthread_barrier_wait(&mapa->barreira);
+        if (shard->indice > 0) {
+            receberHaloMassivo(shard, 0, &shard->entrada[0]);
+        }
+        if (shard->indice < mapa->numShards - 1) {
+            receberHaloMassivo(shard, shard->numLinhas + 1, &shard->entrada[1]);
+        }
+    }
+    if (shard->indice == 0) {
+        mapa->fimNs = instanteNs();
+    }
+    shard->no = noDaThreadAtual();
+    
+    // Resumo só das linhas próprias; a assinatura é um XOR, então não depende da divisão
+    for (long i = 1; i <= shard->numLinhas; i++) {
+        for (int x = 0; x < mapa->largura; x++) {
+            size_t c = (size_t)i * mapa->largura + x;
+            uint64_t celula = (uint64_t)(shard->linhaInicial + i - 1) * mapa->largura + x;
+            GeradorAleatorio mistura;
+            inicializarGerador(&mistura, (celula << 24) ^ ((uint64_t)shard->dono[c] << 16) ^ shard->tropas[c]);
+            shard->assinatura ^= mistura.estado;
+            shard->territorios[shard->dono[c]]++;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Uma execução do mapa massivo com uma quantidade de shards
+ * 
+ * Divide as linhas entre os shards, roda as threads e soma os totais
+ * dos shards em mapa antes de liberar a memória deles.
+ * 
+ * @param mapa Mapa com grade, jogadores, semente, turnos e posicionamento
+ * @param numShards Shards (uma thread por shard)
+ * @return false se faltou memória ou thread
+ */
+static bool simularMapaMassivo(MapaMassivo* mapa, int numShards) {
+    mapa->numShards = numShards;
+    mapa->shards = (ShardMassivo*)calloc(numShards, sizeof(ShardMassivo));
+    mapa->fixouPrincipal = false;
+    atomic_init(&mapa->partida, 0);
+    atomic_init(&mapa->erro, false);
+    if (mapa->shards == NULL) {
+        return false;
+    }
+    
+    for (int s = 0; s < numShards; s++) {
+        mapa->shards[s].mapa = mapa;
+        mapa->shards[s].indice = s;
+        mapa->shards[s].linhaInicial = mapa->altura * s / numShards;
+        mapa->shards[s].numLinhas = mapa->altura * (s + 1) / numShards - mapa->shards[s].linhaInicial;
+    }
+    
+    // O shard 0 roda na thread principal, como no resolvedor exato
+    pthread_barrier_init(&mapa->barreira, NULL, (unsigned int)numShards);
+    int criadas = 1;
+    for (int s = 1; s < numShards; s++) {
+        if (pthread_create(&mapa->shards[s].thread, NULL, executarShardMassivo, &mapa->shards[s]) != 0) {
+            break;
+        }
+        criadas++;
+    }
+    if (criadas < numShards) {
+        // Sem todas as threads a barreira nunca abriria
+        atomic_store(&mapa->erro, true);
+        atomic_store(&mapa->partida, -1);
+    } else {
+        atomic_store(&mapa->partida, 1);
+        executarShardMassivo(&mapa->shards[0]);
+    }
+    for (int s = 1; s < criadas; s++) {
+        pthread_join(mapa->shards[s].thread, NULL);
+    }
+    pthread_barrier_destroy(&mapa->barreira);
+    if (mapa->fixouPrincipal) {
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &mapa->afinidadePrincipal);
+    }
+    
+    mapa->batalhas = mapa->conquistas = mapa->mudancas = 0;
+    mapa->paginas = mapa->paginasRemotas = 0;
+    mapa->assinatura = 0;
+    memset(mapa->territorios, 0, sizeof(mapa->territorios));
+    for (int s = 0; s < numShards; s++) {
+        ShardMassivo* shard = &mapa->shards[s];
+        mapa->batalhas += shard->batalhas;
+        mapa->conquistas += shard->conquistas;
+        mapa->mudancas += shard->mudancasEnviadas;
+        mapa->assinatura ^= shard->assinatura;
+        for (int j = 0; j < mapa->numJogadores; j++) {
+            mapa->territorios[j] += shard->territorios[j];
+        }
+        size_t celulas = (size_t)(shard->numLinhas + 2) * mapa->largura;
+        long totalDono, totalTropas;
+        long foraDono = contarPaginasRemotas(shard->dono, celulas, shard->no, &totalDono);
+        long foraTropas = contarPaginasRemotas(shard->tropas, celulas * sizeof(uint16_t), shard->no, &totalTropas);
+        if (mapa->paginasRemotas >= 0 && foraDono >= 0 && foraTropas >= 0) {
+            mapa->paginasRemotas += foraDono + foraTropas;
+            mapa->paginas += totalDono + totalTropas;
+        } else {
+            mapa->paginasRemotas = -1;
+        }
+    }
+    mapa->residenteKB = memoriaResidenteKB();
+    for (int s = 0; s < numShards; s++) {
+        free(mapa->shards[s].dono);
+        free(mapa->shards[s].tropas);
+        free(mapa->shards[s].donoBorda);
+        free(mapa->shards[s].tropasBorda);
+        free(mapa->shards[s].entrada[0].itens);
+        free(mapa->shards[s].entrada[1].itens);
+    }
+    free(mapa->shards);
+    mapa->shards = NULL;
+    return !atomic_load(&mapa->erro);
+}
+
+/**
+ * Simula um mapa massivo dividido em shards entre threads
+ * 
+ * O mapa é uma grade de MASSIVO_LARGURA colunas; cada thread é dona de
+ * uma faixa de linhas e resolve as batalhas dentro dela, trocando com
+ * os vizinhos apenas os territórios de borda que mudaram (filas de um
+ * produtor e um consumidor, esvaziadas após a barreira de cada turno).
+ * Como no motor, mede a vazão com 1, 2, 4... threads até numThreads;
+ * o resultado e a assinatura têm de ser os mesmos em todas. Cada thread
+ * aloca o próprio shard (first-touch) e, salvo com --numa ingenuo, antes
+ * se fixa num núcleo, o que mantém o shard no nó NUMA dela.
+ * 
+ * @param numTerritorios Territórios desejados (arredondado para linhas inteiras)
+ * @param turnos Turnos simulados
+ * @param opcoes Jogadores, semente e posicionamento NUMA
+ * @param numThreads Maior quantidade de shards (uma thread por shard)
+ * @param medicao Saída opcional para a bancada NUMA, que mede só numThreads (NULL ignora)
+ */
+void executarMapaMassivo(long numTerritorios, int turnos, const OpcoesSimulacao* opcoes, int numThreads,
+                         MedicaoNuma* medicao) {
+    MapaMassivo mapa;
+    double vazaoBase = 0.0;
+    uint64_t assinaturaBase = 0;
+    bool identicos = true;
+    
+    memset(&mapa, 0, sizeof(mapa));
+    mapa.largura = MASSIVO_LARGURA;
+    mapa.altura = (numTerritorios + MASSIVO_LARGURA - 1) / MASSIVO_LARGURA;
+    mapa.numJogadores = opcoes->numJogadores;
+    mapa.semente = opcoes->semente;
+    mapa.turnos = turnos;
+    mapa.ingenuo = opcoes->numaIngenuo;
+    int maxShards = (numThreads < mapa.altura) ? numThreads : (int)mapa.altura;
+    
+    long total = mapa.altura * mapa.largura;
+    printf("\n🌍 ═══════════════════════════════════════════════════════════\n");
+    printf("              MAPA MASSIVO EM SHARDS\n");
+    printf("═══════════════════════════════════════════════════════════🌍\n");
+    printf("🗺️  %ld territórios (%d x %ld) | %d jogadores | %d turnos | até %d shards/threads\n",
+           total, mapa.largura, mapa.altura, mapa.numJogadores, turnos, maxShards);
+    if (medicao == NULL && contarNucleos() < maxShards) {
+        printf("ℹ️  Só %d núcleo(s): acima disso as threads dividem núcleos e a eficiência cai.\n", contarNucleos());
+    }
+    
+    for (int t = (medicao != NULL) ? maxShards : 1; ; t = (t < maxShards && t * 2 > maxShards) ? maxShards : t * 2) {
+        if (!simularMapaMassivo(&mapa, t)) {
+            printf("❌ Erro: Falha ao preparar os shards do mapa massivo!\n");
+            return;
+        }
+        double segundos = (mapa.fimNs - mapa.inicioNs) / 1e9;
+        double vazao = (double)total * turnos / (segundos > 0 ? segundos : 1e-9) / 1e6;
+        if (vazaoBase == 0.0) {
+            vazaoBase = vazao;
+            assinaturaBase = mapa.assinatura;
+        }
+        identicos = identicos && mapa.assinatura == assinaturaBase;
+        if (medicao == NULL) {
+            printf("🧵 %2d threads: %7.1f M territórios-turno/s | eficiência %5.1f%% | resultados %s\n",
+                   t, vazao, 100.0 * vazao / (vazaoBase * t), mapa.assinatura == assinaturaBase ? "idênticos ✅" : "DIFERENTES ❌");
+        }
+        if (t >= maxShards) {
+            break;
+        }
+    }
+    
+    // Detalhes da execução com mais threads
+    double segundos = (mapa.fimNs - mapa.inicioNs) / 1e9;
+    long bordas = 2L * (mapa.numShards - 1) * mapa.largura * turnos;
+    printf("⏱️  %.2f s | %.1f M territórios-turno/s | %ld batalhas | %ld conquistas\n",
+           segundos, (double)total * turnos / (segundos > 0 ? segundos : 1e-9) / 1e6, mapa.batalhas, mapa.conquistas);
+    printf("🔁 Halo: %ld mudanças enviadas (%.1f%% das bordas completas) | memória: %.1f MB\n",
+           mapa.mudancas, 100.0 * mapa.mudancas / (bordas > 0 ? bordas : 1), mapa.residenteKB / 1024.0);
+    printf("🏆 Territórios por jogador:");
+    for (int j = 0; j < mapa.numJogadores; j++) {
+        printf(" %ld", mapa.territorios[j]);
+    }
+    printf("\n");
+    printf("🔏 Assinatura do mapa final: %016llx%s\n", (unsigned long long)mapa.assinatura,
+           identicos ? "" : " (DIFERE entre as quantidades de threads ❌)");
+    exibirPosicionamentoNuma(mapa.ingenuo, mapa.paginas, mapa.paginasRemotas);
+    if (medicao != NULL) {
+        medicao->segundos = segundos;
+        medicao->paginas = mapa.paginas;
+        medicao->paginasRemotas = mapa.paginasRemotas;
+    }
+}
+
+// ============================================================================
+// IMPLEMENTAÇÃO DAS FUNÇÕES - TOPOLOGIA NUMA E FIXAÇÃO DE NÚCLEOS
+// ============================================================================
+
+/*
+ * Struct: TopologiaNuma
+ * 
+ * Nós NUMA com pelo menos uma CPU permitida ao processo, lidos de
+ * /sys/devices/system/node (sem libnuma). Sem essa árvore, um único nó
+ * com todas as CPUs permitidas.
+ * - cpus: CPUs permitidas agrupadas por nó; as do nó k ficam em
+ *   [inicioNo[k], inicioNo[k + 1])
+ * - idNo: número do nó no sistema (podem faltar números)
+ */
+typedef struct {
+    int numNos;
+    int numCpus;
+    int cpus[NUMA_MAX_CPUS];
+    int inicioNo[NUMA_MAX_NOS + 1];
+    int idNo[NUMA_MAX_NOS];
+    int noDaCpu[NUMA_MAX_CPUS];
+} TopologiaNuma;
+
+static TopologiaNuma topologiaNuma;
+static pthread_once_t topologiaDetectada = PTHREAD_ONCE_INIT;
+
+/**
+ * Lê a topologia uma única vez (chamada por pthread_once)
+ * 
+ * O formato de cpulist é uma lista de faixas, como "0-7,16-23".
+ */
+static void detectarTopologiaNuma(void) {
+    TopologiaNuma* topologia = &topologiaNuma;
+    cpu_set_t permitidas;
+    
+    if (sched_getaffinity(0, sizeof(permitidas), &permitidas) != 0) {
+        CPU_ZERO(&permitidas);
+        for (int cpu = 0; cpu < contarNucleos() && cpu < CPU_SETSIZE; cpu++) CPU_SET(cpu, &permitidas);
+    }
+    
+    for (int id = 0; id < NUMA_MAX_NOS; id++) {
+        char caminho[64];
+        char lista[1024];
+        snprintf(caminho, sizeof(caminho), "/sys/devices/system/node/node%d/cpulist", id);
+        FILE* arquivo = fopen(caminho, "r");
+        if (arquivo == NULL) {
+            continue;
+        }
+        bool lida = fgets(lista, sizeof(lista), arquivo) != NULL;
+        fclose(arquivo);
+        
+        int antes = topologia->numCpus;
+        for (char* faixa = lida ? strtok(lista, ",\n") : NULL; faixa != NULL; faixa = strtok(NULL, ",\n")) {
+            int primeira, ultima;
+            int lidos = sscanf(faixa, "%d-%d", &primeira, &ultima);
+            if (lidos < 1) continue;
+            if (lidos == 1) ultima = primeira;
+            for (int cpu = primeira; cpu <= ultima && cpu < NUMA_MAX_CPUS; cpu++) {
+                if (cpu >= 0 && cpu < CPU_SETSIZE && CPU_ISSET(cpu, &permitidas)) {
+                    topologia->cpus[topologia->numCpus++] = cpu;
+                    topologia->noDaCpu[cpu] = id;
+                }
+            }
+        }
+        if (topologia->numCpus > antes) {
+            topologia->idNo[topologia->numNos++] = id;
+            topologia->inicioNo[topologia->numNos] = topologia->numCpus;
+        }
+    }
+    
+    if (topologia->numNos == 0) {
+        for (int cpu = 0; cpu < NUMA_MAX_CPUS && cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &permitidas)) topologia->cpus[topologia->numCpus++] = cpu;
+        }
+        topologia->numNos = 1;
+        topologia->idNo[0] = 0;
+        topologia->inicioNo[1] = topologia->numCpus;
+    }
+}
+
+/**
+ * Quantidade de nós NUMA com CPUs permitidas ao processo
+ * 
+ * @return Nós (1 em máquinas sem NUMA)
+ */
+int contarNosNuma(void) {
+    pthread_once(&topologiaDetectada, detectarTopologiaNuma);
+    return topologiaNuma.numNos;
+}
+
+/**
+ * Fixa a thread chamadora no núcleo do trabalhador
+ * 
+ * Os trabalhadores são divididos em faixas contíguas, uma por nó e de
+ * tamanhos quase iguais; dentro do nó, cada um recebe a próxima CPU
+ * (dando a volta se houver mais trabalhadores que CPUs). Vizinhos de
+ * índice, como shards adjacentes, ficam no mesmo nó.
+ * 
+ * @param indice Índice do trabalhador (0..total-1)
+ * @param total Trabalhadores do grupo
+ * @param anterior Saída opcional: afinidade antes da fixação, para restaurar
+ * @return Nó NUMA do núcleo escolhido, ou -1 se a fixação falhou
+ */
+int fixarThreadNucleo(int indice, int total, cpu_set_t* anterior) {
+    pthread_once(&topologiaDetectada, detectarTopologiaNuma);
+    const TopologiaNuma* topologia = &topologiaNuma;
+    if (topologia->numCpus == 0 || total < 1) {
+        return -1;
+    }
+    
+    int no = (int)((long)indice * topologia->numNos / total);
+    int primeiroDoNo = (int)(((long)no * total + topologia->numNos - 1) / topologia->numNos);
+    int cpusNoNo = topologia->inicioNo[no + 1] - topologia->inicioNo[no];
+    int cpu = topologia->cpus[topologia->inicioNo[no] + (indice - primeiroDoNo) % cpusNoNo];
+    
+    if (anterior != NULL && pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), anterior) != 0) {
+        return -1;
+    }
+    cpu_set_t conjunto;
+    CPU_ZERO(&conjunto);
+    CPU_SET(cpu, &conjunto);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(conjunto), &conjunto) != 0) {
+        return -1;
+    }
+    return topologia->idNo[no];
+}
+
+/**
+ * Nó NUMA da CPU em que a thread está rodando agora
+ * 
+ * @return Número do nó (0 se desconhecido)
+ */
+int noDaThreadAtual(void) {
+    pthread_once(&topologiaDetectada, detectarTopologiaNuma);
+    int cpu = sched_getcpu();
+    return (cpu >= 0 && cpu < NUMA_MAX_CPUS) ? topologiaNuma.noDaCpu[cpu] : 0;
+}
+
+/**
+ * Conta as páginas de uma região que estão fora de um nó
+ * 
+ * Usa move_pages sem destino, que só consulta o nó de cada página.
+ * Páginas ainda não tocadas não entram na conta.
+ * 
+ * @param inicio Início da região
+ * @param tamanho Bytes da região
+ * @param no Nó de quem usa a região
+ * @param paginas Saída: páginas presentes consultadas
+ * @return Páginas em outro nó, ou -1 se o kernel não informa o nó das páginas
+ */
+long contarPaginasRemotas(const void* inicio, size_t tamanho, int no, long* paginas) {
+    size_t pagina = (size_t)sysconf(_SC_PAGESIZE);
+    uintptr_t primeira = (uintptr_t)inicio & ~(uintptr_t)(pagina - 1);
+    uintptr_t fim = (uintptr_t)inicio + tamanho;
+    void* enderecos[NUMA_PAGINAS_CONSULTA];
+    int estados[NUMA_PAGINAS_CONSULTA];
+    long remotas = 0;
+    
+    *paginas = 0;
+    if (inicio == NULL || tamanho == 0) {
+        return 0;
+    }
+    for (uintptr_t endereco = primeira; endereco < fim;) {
+        unsigned long quantidade = 0;
+        for (; endereco < fim && quantidade < NUMA_PAGINAS_CONSULTA; endereco += pagina) {
+            enderecos[quantidade++] = (void*)endereco;
+        }
+        if (syscall(SYS_move_pages, 0, quantidade, enderecos, NULL, estados, 0) != 0) {
+            return -1;
+        }
+        for (unsigned long i = 0; i < quantidade; i++) {
+            if (estados[i] < 0) continue;   // -ENOENT: página nunca tocada
+            (*paginas)++;
+            if (estados[i] != no) remotas++;
+        }
+    }
+    return remotas;
+}
+
+/**
+ * Exibe o posicionamento NUMA de uma execução
+ * 
+ * @param ingenuo Execução sem fixar núcleos
+ * @param paginas Páginas consultadas da memória dos trabalhadores
+ * @param paginasRemotas Páginas fora do nó de quem as usa (-1 desconhecido)
+ */
+void exibirPosicionamentoNuma(bool ingenuo, long paginas, long paginasRemotas) {
+    printf("🧭 NUMA: %d nó(s) | %s | ", contarNosNuma(),
+           ingenuo ? "posicionamento ingênuo (sem fixar núcleos)" : "núcleos fixados, memória no nó de cada thread");
+    if (paginasRemotas < 0) {
+        printf("nó das páginas indisponível\n");
+    } else {
+        printf("páginas remotas: %ld de %ld (%.1f%%)\n", paginasRemotas, paginas,
+               100.0 * paginasRemotas / (paginas > 0 ? paginas : 1));
+    }
+}
+
+/**
+ * Bancada NUMA: as mesmas cargas com posicionamento ingênuo e local
+ * 
+ * Roda o mapa massivo e as partidas simultâneas (bot estrategista)
+ * primeiro como antes (threads soltas; no pool, a thread principal
+ * prepara deques e estatísticas) e depois com núcleos fixados e
+ * first-touch. As páginas contadas são as que os trabalhadores usam ao
+ * simular: os shards do mapa e as pilhas em que as partidas e as
+ * cópias do mapa vivem. A fração remota mede o tráfego entre soquetes
+ * que essa memória provoca; os resultados das simulações não mudam.
+ * 
+ * @param numTerritorios Territórios do mapa massivo
+ * @param turnos Turnos do mapa massivo
+ * @param opcoes Partidas simultâneas, jogadores, territórios e semente
+ * @param numThreads Threads das duas cargas
+ */
+void executarBancadaNuma(long numTerritorios, int turnos, const OpcoesSimulacao* opcoes, int numThreads) {
+    const char* cargas[2] = {"mapa massivo        ", "partidas simultâneas"};  // Mesma largura na tela
+    MedicaoNuma medicoes[2][2];         // [carga][0 ingênuo, 1 local]
+    OpcoesSimulacao variante = *opcoes;
+    
+    memset(medicoes, 0, sizeof(medicoes));
+    printf("\n🧭 ═══════════════════════════════════════════════════════════\n");
+    printf("              BANCADA NUMA (ANTES E DEPOIS)\n");
+    printf("═══════════════════════════════════════════════════════════🧭\n");
+    printf("🖥️  %d nó(s) NUMA:", contarNosNuma());
+    for (int k = 0; k < topologiaNuma.numNos; k++) {
+        printf(" nó %d com %d CPU(s)%s", topologiaNuma.idNo[k], topologiaNuma.inicioNo[k + 1] - topologiaNuma.inicioNo[k],
+               (k + 1 < topologiaNuma.numNos) ? "," : "\n");
+    }
+    
+    for (int modo = 0; modo < 2; modo++) {
+        variante.numaIngenuo = (modo == 0);
+        executarMapaMassivo(numTerritorios, turnos, &variante, numThreads, &medicoes[0][modo]);
+        executarSimultaneo("estrategista", &variante, numThreads, &medicoes[1][modo]);
+    }
+    
+    printf("\n📊 Antes (ingênuo) e depois (local):\n");
+    printf("   carga                | posição |     tempo | páginas remotas\n");
+    for (int c = 0; c < 2; c++) {
+        for (int modo = 0; modo < 2; modo++) {
+            const MedicaoNuma* medicao = &medicoes[c][modo];
+            printf("   %s | %s | %7.2f s | ", cargas[c], modo == 0 ? "ingênuo" : "local  ", medicao->segundos);
+            if (medicao->paginasRemotas < 0) {
+                printf("indisponível\n");
+            } else {
+                printf("%.1f%% de %ld\n", 100.0 * medicao->paginasRemotas / (medicao->paginas > 0 ? medicao->paginas : 1),
+                       medicao->paginas);
+            }
+        }
+    }
+    if (contarNosNuma() == 1) {
+        printf("ℹ️  Com um único nó toda página é local; a diferença aparece em máquinas com vários soquetes.\n");
+    }
+}